@@ -0,0 +1,55 @@
+// Compares the throughput of ParseOptions::fastMode with the diagnostic mode, see "Caching" in README.md.
+//
+// Build and run from the repository root, e.g.:
+//   g++ -std=c++17 -O2 -Iinclude/header-only bench/fast_mode.cpp -o fast_mode -pthread && ./fast_mode
+//   cl /std:c++17 /O2 /EHsc /Iinclude\header-only bench\fast_mode.cpp && fast_mode.exe
+
+#include "brigadier/CommandDispatcher.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+
+using namespace brigadier;
+
+static int Run(CommandContext<int>& ctx)
+{
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 200000;
+
+    CommandDispatcher<int> dispatcher;
+    auto give = dispatcher.Register("give");
+    give.Then<Argument, Integer>("id").Then<Argument, Integer>("count").Executes(Run);
+    give.Then<Argument, Bool>("all").Executes(Run);
+    give.Then<Argument, Word>("item").Then<Argument, Integer>("count").Executes(Run);
+    dispatcher.Register("run").Redirect(dispatcher.GetRoot());
+
+    // valid and invalid input, invalid input is where the diagnostic mode does the most extra work
+    const std::string_view valid[] = { "give 1 64", "give stone 64", "run give true" };
+    const std::string_view invalid[] = { "give stone x", "give 1 2 3" };
+
+    for (auto inputs : { std::make_pair(std::begin(valid), std::end(valid)), std::make_pair(std::begin(invalid), std::end(invalid)) }) {
+        for (bool fast : { false, true }) {
+            ParseOptions options;
+            options.fastMode = fast;
+            dispatcher.SetParseOptions(options);
+
+            size_t parses = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; ++i) {
+                for (auto input = inputs.first; input != inputs.second; ++input) {
+                    dispatcher.Parse(*input, 0);
+                    ++parses;
+                }
+            }
+            std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+            std::printf("%-7s input, %-10s mode: %9.0f parses/s\n", inputs.first == std::begin(valid) ? "valid" : "invalid", fast ? "fast" : "diagnostic", parses / time.count());
+        }
+    }
+    return 0;
+}
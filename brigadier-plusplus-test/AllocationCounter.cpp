@@ -0,0 +1,45 @@
+#include "AllocationCounter.hpp"
+
+#include <cstdlib>
+#include <new>
+
+// Counted per thread, so tests running other threads do not change the numbers seen by a test
+static thread_local std::size_t allocationCount = 0;
+
+std::size_t GetAllocationCount()
+{
+    return allocationCount;
+}
+
+void* operator new(std::size_t size)
+{
+    ++allocationCount;
+    if (void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
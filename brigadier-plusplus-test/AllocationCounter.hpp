@@ -0,0 +1,6 @@
+#pragma once
+
+#include <cstddef>
+
+// Number of allocations made with the global operator new on the calling thread, replaced in AllocationCounter.cpp
+std::size_t GetAllocationCount();
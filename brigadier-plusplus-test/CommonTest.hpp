@@ -1,10 +1,13 @@
 #pragma once
 
 #include "CppUnitTest.h"
+#include "AllocationCounter.hpp"
 
 #include <string_view>
 #include <map>
 #include <set>
+#include <atomic>
+#include <thread>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
@@ -2,6 +2,8 @@
 
 // Tests
 #include "brigadier/StringReader.hpp"
+#include "brigadier/StringTokens.hpp"
+#include "brigadier/StringInterner.hpp"
 #include "brigadier/CommandDispatcher.hpp"
 #include "brigadier/Suggestion/Suggestion.hpp"
 #include "brigadier/Suggestion/Suggestions.hpp"
@@ -10,6 +12,8 @@
 #include "brigadier/Tree/ArgumentCommandNode.hpp"
 #include "brigadier/Tree/LiteralCommandNode.hpp"
 #include "brigadier/Tree/RootCommandNode.hpp"
+#include "brigadier/Tree/CommandTreeImage.hpp"
+#include "brigadier/Tree/StaticCommandNode.hpp"
 #include "brigadier/Context/CommandContext.hpp"
 #include "brigadier/Context/ParsedArgument.hpp"
 #include "brigadier/Context/ParsedCommandNode.hpp"
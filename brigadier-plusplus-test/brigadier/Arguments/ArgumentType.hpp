@@ -101,6 +101,69 @@ namespace brigadier
             Assert::AreEqual(reader.CanRead(), false);
         }
         
+        TEST_METHOD(testParseWordView)
+        {
+            std::string input = "hello world";
+            StringReader reader(input);
+            auto result = WordView().Parse(reader);
+            Assert::IsTrue(result == "hello");
+            Assert::IsFalse(result.IsOwned());
+            Assert::IsTrue(result.Get().data() == input.data());
+            Assert::AreEqual(reader.GetCursor(), 5);
+        }
+
+        TEST_METHOD(testParseStringView)
+        {
+            std::string input = "\"hello world\" after";
+            StringReader reader(input);
+            auto result = StringView().Parse(reader);
+            Assert::IsTrue(result == "hello world");
+            Assert::IsFalse(result.IsOwned());
+            Assert::IsTrue(result.Get().data() == input.data() + 1);
+            Assert::AreEqual(reader.GetCursor(), 13);
+
+            StringReader unquoted("hello world");
+            Assert::IsTrue(StringView().Parse(unquoted) == "hello");
+        }
+
+        TEST_METHOD(testParseStringViewEscaped)
+        {
+            StringReader reader("'it\\'s' after");
+            auto result = StringView().Parse(reader);
+            Assert::IsTrue(result == "it's");
+            Assert::IsTrue(result.IsOwned());
+            Assert::AreEqual(reader.GetCursor(), 7);
+
+            StringReader unterminated("\"hello");
+            try {
+                StringView().Parse(unterminated);
+                Assert::Fail();
+            }
+            catch (CommandSyntaxException const&) {}
+        }
+
+        TEST_METHOD(testParseGreedyStringView)
+        {
+            std::string input = "Hello world! This is a test.";
+            StringReader reader(input);
+            auto result = GreedyStringView().Parse(reader);
+            Assert::IsTrue(result == input);
+            Assert::IsTrue(result.Get().data() == input.data());
+            Assert::AreEqual(reader.CanRead(), false);
+        }
+
+        TEST_METHOD(testParseViewsDoNotAllocate)
+        {
+            std::string input = "\"a phrase long enough to be allocated if it was copied\"";
+            StringReader quoted(input);
+            StringReader greedy(input);
+            std::size_t before = GetAllocationCount();
+            auto phrase = StringView().Parse(quoted);
+            auto rest = GreedyStringView().Parse(greedy);
+            Assert::AreEqual(GetAllocationCount(), before);
+            Assert::AreEqual(phrase.Get().size() + 2, rest.Get().size());
+        }
+
         TEST_METHOD(testEscapeIfRequired_notRequired)
         {
             Assert::AreEqual(String::EscapeIfRequired("hello"), { "hello" });
@@ -127,4 +190,150 @@ namespace brigadier
             Assert::AreEqual(String::EscapeIfRequired("\""), { "\"\\\"\"" });
         }
     };
+
+    // replaces Parse of a built-in type, so its inherited TryParse must not be used
+    class DoubledIntegerArgumentType : public ArithmeticArgumentType<int>
+    {
+    public:
+        int Parse(StringReader& reader)
+        {
+            return ArithmeticArgumentType<int>::Parse(reader) * 2;
+        }
+    };
+
+    TEST_CLASS(ArgumentTryParseTest)
+    {
+        TEST_METHOD(detection)
+        {
+            static_assert(HasTryParse<Integer>::value);
+            static_assert(HasTryParse<BoolArgumentType>::value);
+            static_assert(HasTryParse<Word>::value);
+            static_assert(HasTryParse<StringView>::value);
+            static_assert(HasTryParse<CharArgumentType>::value);
+            static_assert(!HasTryParse<DoubledIntegerArgumentType>::value);
+            Assert::IsTrue(HasTryParse<ArgumentType<int>>::value);
+        }
+
+        TEST_METHOD(sameAsParse)
+        {
+            StringReader reader("-5 x \"a\\\\b\" \"open");
+            int value = 0;
+            ExceptionRecord error;
+            Assert::IsFalse(Integer(0, 100).TryParse(reader, value, error));
+            Assert::IsTrue(error.GetError() == SyntaxError::ValueTooLow);
+            Assert::AreEqual(error.GetCursor(), 0);
+            try {
+                Integer(0, 100).Parse(reader);
+                Assert::Fail();
+            }
+            catch (CommandSyntaxException& ex) {
+                Assert::AreEqual(ex.What(), CommandSyntaxException(error, reader.GetString()).What());
+            }
+
+            reader.SetCursor(3);
+            bool flag = false;
+            Assert::IsFalse(BoolArgumentType().TryParse(reader, flag, error));
+            Assert::IsTrue(error.GetError() == SyntaxError::ReaderInvalidValue);
+            Assert::AreEqual(error.GetCursor(), 3);
+
+            reader.SetCursor(5);
+            std::string text;
+            Assert::IsTrue(String().TryParse(reader, text, error));
+            Assert::AreEqual(text, std::string("a\\b"));
+
+            reader.SetCursor(reader.GetCursor() + 1);
+            Assert::IsFalse(String().TryParse(reader, text, error));
+            Assert::IsTrue(error.GetError() == SyntaxError::ReaderExpectedEndOfQuote);
+            try {
+                reader.SetCursor(12);
+                String().Parse(reader);
+                Assert::Fail();
+            }
+            catch (CommandSyntaxException& ex) {
+                Assert::AreEqual(ex.What(), CommandSyntaxException(error, reader.GetString()).What());
+            }
+        }
+
+        TEST_METHOD(fallback)
+        {
+            CommandDispatcher<int> subject;
+            subject.Register<Argument, DoubledIntegerArgumentType>("value").Executes([](CommandContext<int>& ctx) -> int { return ctx.GetArgument<DoubledIntegerArgumentType>("value"); });
+
+            Assert::AreEqual(subject.Execute("5", 0), 10);
+            auto parse = subject.Parse("x", 0);
+            Assert::AreEqual(parse.GetExceptions().size(), size_t(1));
+            Assert::IsTrue(parse.GetExceptions().begin()->second.GetError() == SyntaxError::ReaderExpectedValue);
+        }
+    };
+
+    TEST_CLASS(ArgumentFirstCharactersTest)
+    {
+        TEST_METHOD(arithmetic)
+        {
+            static_assert(Integer::GetFirstCharacters().Contains('7'));
+            static_assert(Integer::GetFirstCharacters().Contains('-'));
+            static_assert(!Integer::GetFirstCharacters().Contains('.'));
+            static_assert(!Number<unsigned>::GetFirstCharacters().Contains('-'));
+            static_assert(Float::GetFirstCharacters().Contains('.'));
+            Assert::IsFalse(Integer::GetFirstCharacters().Contains('a'));
+        }
+
+        TEST_METHOD(string)
+        {
+            static_assert(Word::GetFirstCharacters().Contains('a'));
+            static_assert(Word::GetFirstCharacters().Contains(' '));
+            static_assert(!Word::GetFirstCharacters().Contains('"'));
+            static_assert(String::GetFirstCharacters().Contains('"'));
+            static_assert(GreedyString::GetFirstCharacters().Contains('!'));
+            Assert::IsFalse(Word::GetFirstCharacters().Contains('!'));
+        }
+
+        TEST_METHOD(matchesParse)
+        {
+            // every character a type refuses must make Parse fail
+            for (int c = 1; c < 256; ++c) {
+                std::string input(1, char(c));
+                input += "1";
+                if (!Integer::GetFirstCharacters().Contains(char(c))) {
+                    StringReader reader(input);
+                    try {
+                        Integer().Parse(reader);
+                        Assert::Fail();
+                    }
+                    catch (CommandSyntaxException const&) {}
+                }
+                if (!BoolArgumentType::GetFirstCharacters().Contains(char(c))) {
+                    StringReader reader(input);
+                    try {
+                        BoolArgumentType().Parse(reader);
+                        Assert::Fail();
+                    }
+                    catch (CommandSyntaxException const&) {}
+                }
+            }
+        }
+    };
+
+    TEST_CLASS(ArgumentTypeRegistryTest)
+    {
+        TEST_METHOD(registerOnNodeCreation)
+        {
+            ArgumentCommandNode<int, Long> node("value", 0, 10);
+            auto entry = ArgumentTypeRegistry::Find(GetArgumentTypeId<Long>());
+            Assert::IsNotNull(entry);
+            Assert::AreEqual(entry->name, std::string_view("Long"));
+
+            std::string parameters;
+            entry->writeParameters(&node.GetType(), parameters);
+            Long decoded;
+            entry->readParameters(parameters, &decoded);
+            Assert::AreEqual(decoded.GetMinimum(), 0LL);
+            Assert::AreEqual(decoded.GetMaximum(), 10LL);
+        }
+
+        TEST_METHOD(findUnknown)
+        {
+            Assert::IsNull(ArgumentTypeRegistry::Find(GetArgumentTypeId<Number<unsigned short>>()));
+        }
+    };
 }
@@ -1,4 +1,4 @@
-#pragma once
+﻿#pragma once
 #include "CommonTest.hpp"
 
 namespace brigadier
@@ -33,6 +33,591 @@ namespace brigadier
             Assert::AreEqual(subject.Execute("base bar", source), 42);
         }
 
+        TEST_METHOD(testExecuteFirstOfAmbiguousArguments) {
+            CommandDispatcher<int> subject;
+            auto base = subject.Register("base");
+            base.Then<Argument, Integer>("a").Then<Argument, Integer>("b").Executes(command);
+            base.Then<Argument, Word>("c").Executes(wrongcommand);
+
+            Assert::AreEqual(subject.Execute("base 1 2", source), 42);
+        }
+
+        TEST_METHOD(testSkipInadmissibleArgument) {
+            CommandDispatcher<int> subject;
+            auto base = subject.Register("base");
+            base.Then<Argument, Integer>("a").Executes(wrongcommand);
+            base.Then<Argument, Word>("b").Executes(command);
+
+            auto parse = subject.Parse("base foo", source);
+            Assert::IsTrue(parse.GetExceptions().empty());
+            Assert::AreEqual(subject.Execute(parse), 42);
+        }
+
+        TEST_METHOD(testExecuteInadmissibleArgument) {
+            CommandDispatcher<int> subject;
+            subject.Register<Argument, Integer>("a").Executes(wrongcommand);
+
+            // the skipped argument still reports why it failed
+            auto parse = subject.Parse("foo", source);
+            Assert::AreEqual(parse.GetExceptions().size(), size_t(1));
+            try {
+                subject.Execute(parse);
+                Assert::Fail();
+            }
+            catch (CommandSyntaxException const& ex) {
+                Assert::AreEqual(ex.GetCursor(), 0);
+            }
+        }
+
+        TEST_METHOD(testParseMemoizeSharedNodes) {
+            static int requirementCalls;
+            Predicate<int&> counted = [](int& src) { ++requirementCalls; return true; };
+
+            // every level has two arguments accepting the same word, and both lead to the same next level
+            auto end = MakeLiteral<int>("end");
+            end.Executes(command);
+            std::shared_ptr<LiteralCommandNode<int>> next = end.GetNode();
+            for (int i = 0; i < 16; ++i) {
+                auto level = MakeLiteral<int>("x");
+                level.Then<Argument, Word>("a").Requires(counted).GetNode()->AddChild(next);
+                level.Then<Argument, Word>("b").Requires(counted).GetNode()->AddChild(next);
+                next = level.GetNode();
+            }
+            std::string input;
+            for (int i = 0; i < 16; ++i) {
+                input += "x w ";
+            }
+            input += "end";
+
+            CommandDispatcher<int> subject;
+            subject.GetRoot()->AddChild(next);
+            subject.SetParseOptions({ true });
+
+            requirementCalls = 0;
+            auto parse = subject.Parse(input, source);
+            Assert::AreEqual(requirementCalls, 32);
+            Assert::IsFalse(parse.GetReader().CanRead());
+            Assert::AreEqual(parse.GetContext().GetNodes().size(), size_t(33));
+            Assert::AreEqual(subject.Execute(parse), 42);
+
+            // same result as without memoization
+            subject.SetParseOptions({});
+            auto expected = subject.Parse("x w x w end", source);
+            subject.SetParseOptions({ true });
+            auto actual = subject.Parse("x w x w end", source);
+            Assert::AreEqual(expected.GetReader().GetCursor(), actual.GetReader().GetCursor());
+            Assert::AreEqual(expected.GetContext().GetNodes().size(), actual.GetContext().GetNodes().size());
+            for (size_t i = 0; i < expected.GetContext().GetNodes().size(); ++i) {
+                Assert::IsTrue(expected.GetContext().GetNodes()[i].GetNode() == actual.GetContext().GetNodes()[i].GetNode());
+            }
+        }
+
+        TEST_METHOD(testParseMemoizeRedirect) {
+            CommandDispatcher<int> subject;
+            subject.SetParseOptions({ true });
+            subject.Register("actual").Executes(command);
+            subject.Register("redirected").Redirect(subject.GetRoot());
+
+            auto parse = subject.Parse("redirected actual", source);
+            Assert::AreEqual(parse.GetContext().GetRange().GetEnd(), 10);
+            Assert::IsNotNull(parse.GetContext().GetChild());
+            Assert::AreEqual(parse.GetContext().GetChild()->GetRange().GetStart(), 11);
+            Assert::AreEqual(subject.Execute(parse), 42);
+
+            try {
+                subject.Execute("redirected foo", source);
+                Assert::Fail();
+            }
+            catch (CommandSyntaxException const& ex) {
+                Assert::AreEqual(ex.GetCursor(), 11);
+            }
+        }
+
+        TEST_METHOD(testParseRedirectLimit) {
+            CommandDispatcher<int> subject;
+            subject.Register("actual").Executes(command);
+            subject.Register("run").Redirect(subject.GetRoot());
+
+            ParseOptions options;
+            options.maxRedirectDepth = 3;
+            subject.SetParseOptions(options);
+            Assert::AreEqual(subject.Execute("run run run actual", source), 42);
+            try {
+                subject.Parse("run run run run actual", source);
+                Assert::Fail();
+            }
+            catch (CommandSyntaxException const& ex) {
+                Assert::AreEqual(ex.GetCursor(), 16);
+            }
+        }
+
+        TEST_METHOD(testParseVisitLimit) {
+            CommandDispatcher<int> subject;
+            auto base = subject.Register("base");
+            base.Then<Argument, Integer>("a").Executes(command);
+            base.Then<Argument, Word>("b").Executes(command);
+
+            ParseOptions options;
+            options.maxNodeVisits = 3;
+            subject.SetParseOptions(options);
+            Assert::AreEqual(subject.Execute("base 1", source), 42); // base, a, b
+
+            options.maxNodeVisits = 2;
+            subject.SetParseOptions(options);
+            Assert::AreEqual(subject.Execute("base foo", source), 42); // base, b, as a cannot start with 'f'
+            try {
+                subject.Parse("base 1", source);
+                Assert::Fail();
+            }
+            catch (CommandSyntaxException const& ex) {
+                Assert::AreEqual(ex.GetCursor(), 5);
+            }
+        }
+
+        TEST_METHOD(testParseTimeLimit) {
+            // exponential without memoization, see testParseMemoizeSharedNodes
+            auto end = MakeLiteral<int>("end");
+            end.Executes(command);
+            std::shared_ptr<LiteralCommandNode<int>> next = end.GetNode();
+            for (int i = 0; i < 20; ++i) {
+                auto level = MakeLiteral<int>("x");
+                level.Then<Argument, Word>("a").GetNode()->AddChild(next);
+                level.Then<Argument, Word>("b").GetNode()->AddChild(next);
+                next = level.GetNode();
+            }
+            std::string input;
+            for (int i = 0; i < 20; ++i) {
+                input += "x w ";
+            }
+            input += "end";
+
+            CommandDispatcher<int> subject;
+            subject.GetRoot()->AddChild(next);
+            ParseOptions options;
+            options.maxTime = std::chrono::milliseconds(1);
+            subject.SetParseOptions(options);
+
+            auto start = std::chrono::steady_clock::now();
+            try {
+                subject.Parse(input, source);
+                Assert::Fail();
+            }
+            catch (CommandSyntaxException const&) {}
+            Assert::IsTrue(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+        }
+
+        TEST_METHOD(testParseFastMode) {
+            static int requirementCalls = 0;
+            requirementCalls = 0;
+            CommandDispatcher<int> subject;
+            auto base = subject.Register("base");
+            base.Then<Argument, Integer>("a").Requires([](int&) { ++requirementCalls; return true; }).Executes(command);
+            base.Then<Argument, Word>("b").Requires([](int&) { ++requirementCalls; return true; }).Executes(subcommand);
+            base.Then<Argument, Integer>("c").Then<Literal>("end").Executes(command);
+
+            auto expected = subject.Parse("base 1", source);
+            Assert::AreEqual(requirementCalls, 2);
+            auto expectedFailed = subject.Parse("base 1 2", source);
+
+            ParseOptions options;
+            options.fastMode = true;
+            subject.SetParseOptions(options);
+            requirementCalls = 0;
+            auto parse = subject.Parse("base 1", source);
+            Assert::AreEqual(requirementCalls, 1); // b is not tried once a parsed the rest of the input
+            Assert::AreEqual(parse.GetReader().GetCursor(), expected.GetReader().GetCursor());
+            Assert::AreEqual(parse.GetContext().GetNodes().size(), expected.GetContext().GetNodes().size());
+            Assert::AreEqual(subject.Execute(parse), 42);
+            Assert::AreEqual(subject.Execute("base 1 end", source), 42);
+
+            // no diagnostics, only the position where parsing stopped
+            auto failed = subject.Parse("base 1 2", source);
+            Assert::IsTrue(failed.GetExceptions().empty());
+            Assert::AreEqual(failed.GetReader().GetCursor(), expectedFailed.GetReader().GetCursor());
+            try {
+                subject.Execute(failed);
+                Assert::Fail();
+            }
+            catch (CommandSyntaxException const& ex) {
+                Assert::AreEqual(ex.GetCursor(), 7);
+            }
+        }
+
+        TEST_METHOD(testParseFastModeSameContext) {
+            CommandDispatcher<int> subject;
+            auto give = subject.Register("give");
+            give.Then<Argument, Integer>("id").Then<Argument, Integer>("count").Executes(command);
+            give.Then<Argument, Bool>("all").Executes(command);
+            give.Then<Argument, Word>("item").Then<Argument, Integer>("count").Executes(subcommand);
+            subject.Register("run").Redirect(subject.GetRoot());
+
+            // a later sibling with a redirect takes over the level even after an earlier one parsed the rest of the input
+            auto tp = subject.Register("tp");
+            tp.Then<Argument, GreedyString>("a").Executes(command);
+            tp.Then<Argument, Word>("b").Redirect(subject.GetRoot());
+            subject.Register("stop").Executes(subcommand);
+
+            ParseOptions fast;
+            fast.fastMode = true;
+            for (auto input : { "give 1 64", "give stone 64", "run give true", "run run give 1 2", "tp x stop" }) {
+                subject.SetParseOptions({});
+                auto expected = subject.Parse(input, source);
+                subject.SetParseOptions(fast);
+                auto parse = subject.Parse(input, source);
+
+                Assert::IsFalse(parse.GetReader().CanRead());
+                Assert::AreEqual(parse.GetContext().GetNodes().size(), expected.GetContext().GetNodes().size());
+                for (size_t i = 0; i < parse.GetContext().GetNodes().size(); ++i) {
+                    Assert::IsTrue(parse.GetContext().GetNodes()[i].GetNode() == expected.GetContext().GetNodes()[i].GetNode());
+                }
+                Assert::AreEqual(subject.Execute(parse), subject.Execute(expected));
+            }
+            Assert::AreEqual(subject.Execute("tp x stop", source), 100);
+        }
+
+        TEST_METHOD(testParseFastModeSharedNodes) {
+            // exponential in the diagnostic mode, see testParseTimeLimit
+            auto end = MakeLiteral<int>("end");
+            end.Executes(command);
+            std::shared_ptr<LiteralCommandNode<int>> next = end.GetNode();
+            for (int i = 0; i < 20; ++i) {
+                auto level = MakeLiteral<int>("x");
+                level.Then<Argument, Word>("a").GetNode()->AddChild(next);
+                level.Then<Argument, Word>("b").GetNode()->AddChild(next);
+                next = level.GetNode();
+            }
+            std::string input;
+            for (int i = 0; i < 20; ++i) {
+                input += "x w ";
+            }
+            input += "end";
+
+            CommandDispatcher<int> subject;
+            subject.GetRoot()->AddChild(next);
+            ParseOptions options;
+            options.fastMode = true;
+            options.maxNodeVisits = 100;
+            subject.SetParseOptions(options);
+            Assert::AreEqual(subject.Execute(input, source), 42);
+        }
+
+        TEST_METHOD(testParseLongRedirectChain) {
+            CommandDispatcher<int> subject;
+            subject.Register("actual").Executes(command);
+            subject.Register("run").Redirect(subject.GetRoot());
+
+            // deeper than the call stack would allow for a recursive parser
+            std::string input;
+            for (int i = 0; i < 100000; ++i) {
+                input += "run ";
+            }
+            input += "actual";
+
+            auto parse = subject.Parse(input, source);
+            Assert::IsFalse(parse.GetReader().CanRead());
+            Assert::AreEqual(subject.Execute(parse), 42);
+        }
+
+        TEST_METHOD(testParseInsideRequirement) {
+            static CommandDispatcher<int>* nested;
+            CommandDispatcher<int> inner;
+            inner.Register("a").Then<Argument, Integer>("b").Executes(command);
+            nested = &inner;
+
+            CommandDispatcher<int> subject;
+            subject.Register("base").Then<Literal>("x").Requires([](int& src) {
+                return !nested->Parse("a 1", src).GetReader().CanRead();
+            }).Then<Argument, Integer>("y").Executes(command);
+
+            Assert::AreEqual(subject.Execute("base x 5", source), 42);
+        }
+
+        TEST_METHOD(testParseResultsIndependent) {
+            CommandDispatcher<int> subject;
+            auto base = subject.Register("base");
+            base.Then<Argument, Integer>("a").Then<Argument, Integer>("b").Executes(command);
+            base.Then<Argument, Word>("c").Executes(command);
+            subject.Register("run").Redirect(subject.GetRoot());
+
+            // candidates reuse storage between parses, which must not leak into earlier results
+            auto first = subject.Parse("run base 1 2", source);
+            auto second = subject.Parse("run base 3 4", source);
+            auto third = subject.Parse("base word", source);
+            auto failed = subject.Parse("base 1 x", source);
+            auto* child = first.GetContext().GetChild();
+            Assert::IsNotNull(child);
+            Assert::AreEqual(child->GetArgument<Integer>("a"), 1);
+            Assert::AreEqual(child->GetArgument<Integer>("b"), 2);
+            Assert::AreEqual(child->GetNodes().size(), size_t(3));
+            Assert::AreEqual(second.GetContext().GetChild()->GetArgument<Integer>("a"), 3);
+            Assert::AreEqual(third.GetContext().GetNodes().size(), size_t(2));
+            Assert::AreEqual(failed.GetReader().GetCursor(), 7);
+            Assert::AreEqual(subject.Execute(first), 42);
+        }
+
+        TEST_METHOD(testParseInto) {
+            CommandDispatcher<int> subject;
+            subject.Register("foo").Then<Literal>("bar").Executes(command);
+            subject.Register("baz").Then<Argument, Integer>("value").Executes(command);
+
+            auto parse = subject.Parse("baz 5", source);
+            subject.ParseInto(parse, "foo bar", source);
+            Assert::IsFalse(parse.GetReader().CanRead());
+            Assert::AreEqual(parse.GetContext().GetNodes().size(), size_t(2));
+            Assert::AreEqual(subject.Execute(parse), 42);
+
+            size_t allocations = GetAllocationCount();
+            subject.ParseInto(parse, "foo bar", source);
+            Assert::AreEqual(GetAllocationCount() - allocations, size_t(0));
+
+            subject.ParseInto(parse, "baz 7", source);
+            CommandContext<int> context = parse.GetContext();
+            Assert::AreEqual(context.GetArgument<Integer>("value"), 7);
+            Assert::AreEqual(context.GetNodes().size(), size_t(2));
+        }
+
+        TEST_METHOD(testParseIntoSharedContext) {
+            CommandDispatcher<int> subject;
+            subject.Register("foo").Then<Argument, Integer>("value").Executes(command);
+
+            auto parse = subject.Parse("foo 1", source);
+            CommandContext<int> copy = parse.GetContext();
+            subject.ParseInto(parse, "foo 2", source);
+            CommandContext<int> context = parse.GetContext();
+            Assert::AreEqual(copy.GetArgument<Integer>("value"), 1);
+            Assert::AreEqual(context.GetArgument<Integer>("value"), 2);
+        }
+
+        TEST_METHOD(testParseStringViewArgument) {
+            CommandDispatcher<int> subject;
+            subject.Register("say").Then<Argument, GreedyStringView>("message").Executes(command);
+
+            std::string input = "say hello there";
+            auto parse = subject.Parse(input, source);
+            CommandContext<int> context = parse.GetContext();
+            auto message = context.GetArgument<GreedyStringView>("message");
+            Assert::IsTrue(message == "hello there");
+            Assert::IsTrue(message.Get().data() == input.data() + 4);
+            Assert::AreEqual(subject.Execute(parse), 42);
+        }
+
+        TEST_METHOD(testParseQuotedArguments) {
+            CommandDispatcher<int> subject;
+            subject.Register("msg").Then<Argument, StringView>("target").Then<Argument, String>("message").Executes(command);
+
+            std::string input = "msg \"some one\" \"say \\\"hi\\\"\"";
+            auto parse = subject.Parse(input, source);
+            CommandContext<int> context = parse.GetContext();
+            auto target = context.GetArgument<StringView>("target");
+            Assert::IsTrue(target == "some one");
+            Assert::IsTrue(target.Get().data() == input.data() + 5);
+            Assert::AreEqual(context.GetArgument<String>("message"), std::string("say \"hi\""));
+            Assert::IsFalse(parse.GetReader().CanRead());
+            Assert::AreEqual(subject.Execute(parse), 42);
+        }
+
+        TEST_METHOD(testExecuteReusesMemory) {
+            CommandDispatcher<int> subject;
+            subject.Register("foo").Then<Literal>("bar").Executes(command);
+            subject.Register("run").Redirect(subject.GetRoot());
+
+            for (std::string_view input : { "foo bar", "run foo bar" }) {
+                // the first calls fill the buffers of this thread
+                subject.Execute(input, source);
+                subject.Execute(input, source);
+
+                size_t allocations = GetAllocationCount();
+                Assert::AreEqual(subject.Execute(input, source), 42);
+                size_t pooled = GetAllocationCount() - allocations;
+
+                allocations = GetAllocationCount();
+                auto parse = subject.Parse(input, source);
+                Assert::AreEqual(subject.Execute(parse), 42);
+                size_t separate = GetAllocationCount() - allocations;
+
+                Assert::IsTrue(pooled < separate);
+                if (input == "foo bar")
+                    Assert::AreEqual(pooled, size_t(0));
+            }
+        }
+
+        TEST_METHOD(testExecuteReleasesSource) {
+            struct Session
+            {
+                explicit Session(std::shared_ptr<int> player) : player(std::move(player)) {}
+                std::shared_ptr<int> player;
+            };
+            CommandDispatcher<Session> subject;
+            subject.Register("foo").Then<Literal>("bar").Executes([](CommandContext<Session>&) { return 1; });
+            subject.Register("run").Redirect(subject.GetRoot());
+
+            auto player = std::make_shared<int>(0);
+            std::weak_ptr<int> released = player;
+            Assert::AreEqual(subject.Execute("run foo bar", Session(std::move(player))), 1);
+            // buffers pooled by this thread do not keep the source alive
+            Assert::IsTrue(released.expired());
+        }
+
+        TEST_METHOD(testExecuteNested) {
+            static CommandDispatcher<int> subject;
+            subject.Register("inner").Executes(command);
+            subject.Register("outer").Executes([](CommandContext<int>& ctx) -> int {
+                return subject.Execute("inner", ctx.GetSource()) + 1;
+            });
+
+            Assert::AreEqual(subject.Execute("outer", source), 43);
+            Assert::AreEqual(subject.Execute("outer", source), 43);
+        }
+
+        TEST_METHOD(testTryExecute) {
+            CommandDispatcher<int> subject;
+            subject.Register("foo").Executes(command);
+            subject.Register<Argument, Integer>("value", 0, 10).Executes(command);
+            subject.Register("bar").Then<Argument, Integer>("value").Executes(command);
+
+            ExecuteResult result = subject.TryExecute("foo", source);
+            Assert::IsTrue(result.IsSuccess());
+            Assert::AreEqual(result.result, 42);
+            Assert::AreEqual(result.successes, 1);
+            Assert::AreEqual(result.failures, 0);
+
+            result = subject.TryExecute("baz", source);
+            Assert::IsFalse(result.IsSuccess());
+            Assert::IsTrue(result.error == SyntaxError::ReaderExpectedValue); // of the only candidate, value
+            Assert::AreEqual(result.cursor, 0);
+            Assert::AreEqual(result.failures, 1);
+
+            result = subject.TryExecute("11", source);
+            Assert::IsFalse(result.IsSuccess());
+            Assert::IsTrue(result.error == SyntaxError::ValueTooHigh);
+            Assert::AreEqual(result.cursor, 0);
+
+            result = subject.TryExecute("bar 1 2", source);
+            Assert::IsFalse(result.IsSuccess());
+            Assert::IsTrue(result.error == SyntaxError::DispatcherUnknownArgument);
+            Assert::AreEqual(result.cursor, 6);
+
+            auto parse = subject.Parse("foo", source);
+            result = subject.TryExecute(parse);
+            Assert::AreEqual(result.result, 42);
+        }
+
+        TEST_METHOD(testTryExecuteCommandFailure) {
+            CommandDispatcher<int> subject;
+            subject.Register("fail").Executes([](CommandContext<int>& ctx) -> int { return ctx.Fail(); });
+            subject.Register("throw").Executes([](CommandContext<int>& ctx) -> int { throw CommandSyntaxException::BuiltInExceptions::ReaderExpectedValue(nullptr); });
+            subject.Register("source").Executes([](CommandContext<int>& ctx) -> int { return ctx.GetSource() == 2 ? ctx.Fail() : ctx.GetSource(); });
+            subject.Register("fork").Fork(subject.GetRoot(), [](CommandContext<int>& context) -> std::vector<int> { return { 1, 2, 3 }; });
+
+            ExecuteResult result = subject.TryExecute("fail", source);
+            Assert::IsFalse(result.IsSuccess());
+            Assert::IsTrue(result.error == SyntaxError::DispatcherCommandFailed);
+            Assert::AreEqual(result.result, 0);
+            try {
+                subject.Execute("fail", source);
+                Assert::Fail();
+            }
+            catch (CommandSyntaxException& ex) {
+                Assert::IsTrue(ex.GetError() == SyntaxError::DispatcherCommandFailed);
+                Assert::AreEqual(ex.What(), std::string("Command failed"));
+            }
+
+            result = subject.TryExecute("throw", source);
+            Assert::IsFalse(result.IsSuccess());
+            Assert::IsTrue(result.error == SyntaxError::ReaderExpectedValue);
+
+            // forked commands fail one by one, the execution does not
+            result = subject.TryExecute("fork source", source);
+            Assert::IsTrue(result.IsSuccess());
+            Assert::AreEqual(result.successes, 2);
+            Assert::AreEqual(result.failures, 1);
+            Assert::AreEqual(result.result, 2);
+            Assert::IsTrue(result.error == SyntaxError::DispatcherCommandFailed);
+            Assert::AreEqual(subject.Execute("fork source", source), 2);
+
+            // failures of the dispatcher are recorded without creating exceptions
+            size_t allocations = GetAllocationCount();
+            result = subject.TryExecute("fail", source);
+            Assert::IsTrue(result.error == SyntaxError::DispatcherCommandFailed);
+            Assert::AreEqual(result.cursor, -1);
+            result = subject.TryExecute("fail now", source);
+            Assert::IsTrue(result.error == SyntaxError::DispatcherUnknownArgument);
+            Assert::AreEqual(result.cursor, 5);
+            Assert::AreEqual(GetAllocationCount() - allocations, size_t(0));
+        }
+
+        TEST_METHOD(testTryExecuteParseLimit) {
+            CommandDispatcher<int> subject;
+            subject.Register("actual").Executes(command);
+            subject.Register("run").Redirect(subject.GetRoot());
+
+            ParseOptions options;
+            options.maxRedirectDepth = 1;
+            subject.SetParseOptions(options);
+            ExecuteResult result = subject.TryExecute("run run actual", source);
+            Assert::IsFalse(result.IsSuccess());
+            Assert::IsTrue(result.error == SyntaxError::DispatcherParseBudgetExceeded);
+            Assert::AreEqual(result.cursor, 8);
+        }
+
+        TEST_METHOD(testParseErrorsExpandedLazily) {
+            CommandDispatcher<int> subject;
+            subject.Register<Argument, Integer>("value").Executes(command);
+            subject.Register<Argument, Bool>("flag").Executes(command);
+            subject.Register("num").Then<Argument, Integer>("value").Executes(command);
+
+            auto parse = subject.Parse("x", source);
+            subject.ParseInto(parse, "x", source);
+
+            // failed candidates are recorded without creating messages or map entries
+            size_t allocations = GetAllocationCount();
+            subject.ParseInto(parse, "x", source);
+            Assert::AreEqual(GetAllocationCount() - allocations, size_t(0));
+
+            auto& exceptions = parse.GetExceptions();
+            Assert::AreEqual(exceptions.size(), size_t(2));
+            CommandSyntaxException value = exceptions.at(subject.FindNode({ "value" }));
+            CommandSyntaxException flag = exceptions.at(subject.FindNode({ "flag" }));
+            Assert::AreEqual(value.What(), std::string("Expected value at position 0: x<--[HERE]"));
+            Assert::AreEqual(flag.What(), std::string("Invalid value 'x' at position 0: x<--[HERE]"));
+
+            try {
+                subject.Execute("num 1 2", source);
+                Assert::Fail();
+            }
+            catch (CommandSyntaxException& ex) {
+                Assert::IsTrue(ex.GetError() == SyntaxError::DispatcherUnknownArgument);
+                Assert::AreEqual(ex.What(), std::string("Incorrect argument for command at position 6: num 1 2<--[HERE]"));
+            }
+        }
+
+        TEST_METHOD(testParseErrorsExpandedConcurrently) {
+            CommandDispatcher<int> subject;
+            subject.Register<Argument, Integer>("value").Executes(command);
+            subject.Register<Argument, Bool>("flag").Executes(command);
+
+            // a cached parse may be inspected by several threads, the first call creates the map
+            auto parse = subject.Parse("x", source);
+            std::vector<std::thread> threads;
+            for (int i = 0; i < 4; ++i) {
+                threads.emplace_back([&] {
+                    auto& exceptions = parse.GetExceptions();
+                    Assert::AreEqual(exceptions.size(), size_t(2));
+                    Assert::IsTrue(exceptions.at(subject.FindNode({ "value" })).GetError() == SyntaxError::ReaderExpectedValue);
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+
+            // custom exceptions keep their message
+            CommandSyntaxException custom(StringReader("abc"), "Custom");
+            ExceptionRecord record(custom);
+            CommandSyntaxException copy(record, custom.GetInput());
+            Assert::AreEqual(copy.What(), custom.What());
+            Assert::AreEqual(copy.GetCursor(), 0);
+        }
+
         TEST_METHOD(testExecuteUnknownCommand) {
             CommandDispatcher<int> subject;
             subject.Register("bar");
@@ -60,6 +645,618 @@ namespace brigadier
             }
         }
 
+        TEST_METHOD(testExecutePermissions) {
+            CommandDispatcher<int> subject;
+            subject.SetPermissionProvider([](int const& src) { return GrantLevel(src); });
+            subject.Register("foo").RequiresPermissions(RequireLevel(2)).Executes(command);
+
+            Assert::AreEqual(subject.Execute("foo", 2), 42);
+            try {
+                subject.Execute("foo", 1);
+                Assert::Fail();
+            }
+            catch (CommandSyntaxException const& ex) {
+                Assert::AreEqual(ex.GetCursor(), 0);
+            }
+        }
+
+        TEST_METHOD(testSubtreePermissions) {
+            CommandDispatcher<int> subject;
+            auto foo = subject.Register("foo");
+            foo.RequiresPermissions(RequireLevel(1));
+            foo.Then<Literal>("bar").RequiresPermissions(RequireLevel(3)).Executes(command);
+            subject.Register("baz").Executes(command);
+
+            Assert::AreEqual(subject.GetRoot()->GetSubtreePermissions(), RequireLevel(1) | RequireLevel(3));
+            Assert::AreEqual(foo.GetNode()->GetSubtreePermissions(), RequireLevel(1) | RequireLevel(3));
+            Assert::AreEqual(subject.GetRoot()->GetChild("baz")->GetSubtreePermissions(), PermissionMask(0));
+            Assert::IsTrue(subject.GetRoot()->CanUseSubtree(GrantLevel(3)));
+            Assert::IsTrue(!subject.GetRoot()->CanUseSubtree(GrantLevel(2)));
+
+            foo.Then<Literal>("qux").RequiresPermissions(RequireLevel(4));
+            Assert::AreEqual(subject.GetRoot()->GetSubtreePermissions(), RequireLevel(1) | RequireLevel(3) | RequireLevel(4));
+        }
+
+        TEST_METHOD(testSubtreePermissionsUpdated) {
+            CommandDispatcher<int> subject;
+            auto foo = subject.Register("foo");
+            auto multi = foo.ThenOptional<Literal>("bar");
+            multi.Then<Literal>("baz").RequiresPermissions(RequireLevel(2));
+            std::shared_ptr<const CommandNode<int>> root = subject.GetRoot();
+            std::shared_ptr<const CommandNode<int>> bar = foo.GetNode()->GetChild("bar");
+            Assert::AreEqual(root->GetSubtreePermissions(), RequireLevel(2));
+            Assert::AreEqual(bar->GetSubtreePermissions(), RequireLevel(2));
+
+            // both parents of the shared node see the change
+            GetBuilder(std::static_pointer_cast<LiteralCommandNode<int>>(foo.GetNode()->GetChild("baz"))).RequiresPermissions(RequireLevel(5));
+            Assert::AreEqual(bar->GetSubtreePermissions(), RequireLevel(5));
+            Assert::AreEqual(root->GetSubtreePermissions(), RequireLevel(5));
+            Assert::IsFalse(root->CanUseSubtree(GrantLevel(4)));
+
+            subject.Unregister({ "foo", "baz" });
+            Assert::AreEqual(root->GetSubtreePermissions(), RequireLevel(5));
+            subject.Unregister({ "foo", "bar", "baz" });
+            Assert::AreEqual(root->GetSubtreePermissions(), PermissionMask(0));
+            Assert::IsTrue(root->CanUseSubtree(0));
+        }
+
+        TEST_METHOD(testAllUsagePermissions) {
+            CommandDispatcher<int> subject;
+            subject.SetPermissionProvider([](int const& src) { return GrantLevel(src); });
+            subject.Register("a").Executes(command);
+            subject.Register("b").RequiresPermissions(RequireLevel(2)).Executes(command).Then<Literal>("c").Executes(command);
+
+            AssertArray(subject.GetAllUsage(subject.GetRoot().get(), 1, true), { "a" });
+            AssertArray(subject.GetAllUsage(subject.GetRoot().get(), 2, true), { "a", "b", "b c" });
+            AssertArray(subject.GetAllUsage(subject.GetRoot().get(), 0, false), { "a", "b", "b c" });
+        }
+
+        TEST_METHOD(testFilteredRoot) {
+            CommandDispatcher<int> subject;
+            auto foo = subject.Register("foo");
+            foo.Executes(command);
+            foo.Then<Literal>("bar").RequiresPermissions(RequireLevel(2)).Executes(command);
+            subject.Register("baz").Executes(command);
+            subject.Register("qux").RequiresPermissions(RequireLevel(3)).Executes(command);
+            subject.SetPermissionClass(0, GrantLevel(1));
+            subject.SetPermissionClass(1, GrantLevel(4));
+
+            auto user = subject.GetFilteredRoot(0);
+            AssertArray(subject.GetAllUsage(user.get(), source, false), { "baz", "foo" });
+            Assert::IsTrue(user->GetChild("baz") == subject.GetRoot()->GetChild("baz"));
+            Assert::IsTrue(user->GetChild("foo") != subject.GetRoot()->GetChild("foo"));
+            Assert::IsTrue(subject.GetFilteredRoot(0) == user);
+
+            auto admin = subject.GetFilteredRoot(1);
+            AssertArray(subject.GetAllUsage(admin.get(), source, false), { "baz", "foo", "foo bar", "qux" });
+            Assert::IsTrue(admin->GetChild("foo") == subject.GetRoot()->GetChild("foo"));
+            Assert::IsTrue(admin != subject.GetRoot());
+
+            Assert::IsTrue(subject.GetFilteredRoot(2) == nullptr);
+        }
+
+        TEST_METHOD(testFilteredRootInvalidation) {
+            CommandDispatcher<int> subject;
+            subject.Register("foo").Executes(command);
+            subject.SetPermissionClass(0, GrantLevel(1));
+            auto first = subject.GetFilteredRoot(0);
+
+            subject.Register("bar").RequiresPermissions(RequireLevel(1)).Executes(command);
+            auto second = subject.GetFilteredRoot(0);
+            Assert::IsTrue(first != second);
+            AssertArray(subject.GetAllUsage(second.get(), source, false), { "bar", "foo" });
+
+            subject.SetPermissionClass(0, GrantLevel(1));
+            Assert::IsTrue(subject.GetFilteredRoot(0) == second);
+
+            subject.SetPermissionClass(0, GrantLevel(0));
+            AssertArray(subject.GetAllUsage(subject.GetFilteredRoot(0).get(), source, false), { "foo" });
+
+            subject.RemovePermissionClass(0);
+            Assert::IsTrue(subject.GetFilteredRoot(0) == nullptr);
+        }
+
+        TEST_METHOD(testFilteredRootIsolated) {
+            CommandDispatcher<int> subject;
+            auto baz = subject.Register("baz");
+            baz.Executes(command);
+            subject.SetPermissionClass(0, GrantLevel(1));
+
+            auto user = subject.GetFilteredRoot(0);
+            Assert::IsTrue(user->GetChild("baz") == subject.GetRoot()->GetChild("baz"));
+            Assert::IsFalse(user->IsWritable());
+            try {
+                baz.Then<Literal>("secret");
+                Assert::Fail();
+            }
+            catch (std::runtime_error const&) {}
+
+            subject.Register("baz").Then<Literal>("secret").RequiresPermissions(RequireLevel(3)).Executes(command);
+            Assert::IsTrue(user->GetChild("baz")->GetChild("secret") == nullptr);
+            AssertArray(subject.GetAllUsage(user.get(), source, false), { "baz" });
+            AssertArray(subject.GetAllUsage(subject.GetFilteredRoot(0).get(), source, false), { "baz" });
+        }
+
+        TEST_METHOD(testFilteredRootRedirects) {
+            CommandDispatcher<int> subject;
+            subject.Register("foo").Executes(command);
+            subject.Register("secret").RequiresPermissions(RequireLevel(2)).Executes(command);
+            subject.Register("redirect").Redirect(subject.GetRoot());
+            subject.Register("alias").Redirect(subject.GetRoot()->GetChild("secret"));
+            subject.SetPermissionClass(0, GrantLevel(1));
+
+            auto filtered = subject.GetFilteredRoot(0);
+            Assert::IsTrue(filtered->GetChild("redirect")->GetRedirect() == filtered);
+            Assert::IsTrue(filtered->GetChild("alias")->GetRedirect() == nullptr);
+            Assert::IsTrue(filtered->GetChild("secret") == nullptr);
+        }
+
+        TEST_METHOD(testVersion) {
+            CommandDispatcher<int> subject;
+            size_t empty = subject.GetVersion();
+            auto foo = subject.Register("foo");
+            size_t registered = subject.GetVersion();
+            Assert::IsTrue(registered > empty);
+
+            foo.Executes(command);
+            Assert::IsTrue(subject.GetVersion() > registered);
+
+            size_t current = subject.GetVersion();
+            subject.Execute("foo", source);
+            Assert::AreEqual(subject.GetVersion(), current);
+        }
+
+        TEST_METHOD(testDelta) {
+            CommandDispatcher<int> subject;
+            auto foo = subject.Register("foo");
+            foo.Then<Literal>("bar").Executes(command);
+            subject.Register("baz").Executes(command);
+            size_t version = subject.GetVersion();
+            Assert::IsTrue(subject.GetDelta(version).IsEmpty());
+
+            auto all = subject.GetDelta(0);
+            Assert::AreEqual(all.GetEntries().size(), size_t(2));
+            Assert::IsTrue(all.GetEntries()[0].change == CommandTreeChange::Added);
+
+            foo.Then<Literal>("qux").Then<Literal>("quux").Executes(command);
+            subject.Register("baz").RequiresPermissions(RequireLevel(1));
+            subject.Register("new").Executes(command);
+
+            auto delta = subject.GetDelta(version);
+            Assert::AreEqual(delta.GetFrom(), version);
+            Assert::AreEqual(delta.GetTo(), subject.GetVersion());
+            auto& entries = delta.GetEntries();
+            Assert::AreEqual(entries.size(), size_t(3));
+            Assert::IsTrue(entries[0].change == CommandTreeChange::Changed);
+            AssertArray(entries[0].path, { "baz" });
+            Assert::IsTrue(entries[1].change == CommandTreeChange::Added);
+            AssertArray(entries[1].path, { "foo", "qux" });
+            Assert::IsTrue(entries[1].node == foo.GetNode()->GetChild("qux"));
+            Assert::IsTrue(entries[2].change == CommandTreeChange::Added);
+            AssertArray(entries[2].path, { "new" });
+        }
+
+        TEST_METHOD(testDeltaIsNet) {
+            CommandDispatcher<int> subject;
+            subject.Register("foo").Executes(command);
+            size_t version = subject.GetVersion();
+
+            for (int i = 0; i < 500; ++i) {
+                subject.Register("temp").Executes(command);
+                subject.Unregister({ "temp" });
+                subject.Unregister({ "foo" });
+                subject.Register("foo").Executes(command);
+            }
+            auto delta = subject.GetDelta(version);
+            Assert::AreEqual(delta.GetEntries().size(), size_t(1));
+            Assert::IsTrue(delta.GetEntries()[0].change == CommandTreeChange::Added);
+            AssertArray(delta.GetEntries()[0].path, { "foo" });
+
+            subject.Unregister({ "foo" });
+            delta = subject.GetDelta(version);
+            Assert::AreEqual(delta.GetEntries().size(), size_t(1));
+            Assert::IsTrue(delta.GetEntries()[0].change == CommandTreeChange::Removed);
+            AssertArray(delta.GetEntries()[0].path, { "foo" });
+        }
+
+        TEST_METHOD(testDeltaHistoryBounded) {
+            CommandDispatcher<int> subject;
+            for (int i = 0; i < 1000; ++i)
+                subject.Register("command" + std::to_string(i)).Executes(command);
+            size_t version = subject.GetVersion();
+            for (int i = 0; i < 1000; ++i)
+                subject.Unregister({ "command" + std::to_string(i) });
+
+            // the oldest removals are forgotten, so the whole tree is sent again
+            auto delta = subject.GetDelta(version);
+            Assert::AreEqual(delta.GetEntries().size(), size_t(1));
+            Assert::IsTrue(delta.GetEntries()[0].change == CommandTreeChange::Added);
+            Assert::IsTrue(delta.GetEntries()[0].path.empty());
+            Assert::IsTrue(delta.GetEntries()[0].node == subject.GetRoot());
+
+            // recent removals are still known
+            delta = subject.GetDelta(subject.GetVersion() - 10);
+            Assert::AreEqual(delta.GetEntries().size(), size_t(10));
+            for (auto& entry : delta.GetEntries())
+                Assert::IsTrue(entry.change == CommandTreeChange::Removed);
+        }
+
+        TEST_METHOD(testUnregister) {
+            CommandDispatcher<int> subject;
+            subject.Register("foo").Then<Literal>("bar").Executes(command);
+            subject.Register("foo").Then<Literal>("baz").Executes(command);
+            size_t version = subject.GetVersion();
+
+            Assert::IsNull(subject.Unregister({ "foo", "missing" }).get());
+            Assert::IsNull(subject.Unregister({ "missing", "bar" }).get());
+            Assert::IsNotNull(subject.Unregister({ "foo", "bar" }).get());
+            Assert::IsTrue(subject.GetVersion() > version);
+            AssertArray(subject.GetAllUsage(subject.GetRoot().get(), source, false), { "foo baz" });
+
+            auto delta = subject.GetDelta(version);
+            Assert::AreEqual(delta.GetEntries().size(), size_t(1));
+            Assert::IsTrue(delta.GetEntries()[0].change == CommandTreeChange::Removed);
+            AssertArray(delta.GetEntries()[0].path, { "foo", "bar" });
+
+            subject.PruneDeltaHistory(subject.GetVersion());
+            Assert::IsTrue(subject.GetDelta(version).IsEmpty());
+        }
+
+        TEST_METHOD(testUnregisterDanglingRedirects) {
+            CommandDispatcher<int> subject;
+            auto foo = subject.Register("foo");
+            foo.Then<Literal>("bar");
+            foo.Then<Literal>("loop").Redirect(foo.GetNode());
+            subject.Register("alias").Redirect(foo.GetNode()->GetChild("bar"));
+            subject.Register("self").Redirect(subject.GetRoot());
+
+            // filtered views and copies of the dispatcher have their own copies of the redirecting nodes
+            subject.SetPermissionClass(0, 0);
+            subject.GetFilteredRoot(0);
+            CommandDispatcher<int> copy(subject);
+            copy.Register("alias").Executes(command);
+
+            std::vector<CommandNode<int>*> dangling;
+            subject.Unregister({ "foo" }, &dangling);
+            Assert::AreEqual(dangling.size(), size_t(1));
+            Assert::IsTrue(dangling[0] == subject.GetRoot()->GetChild("alias").get());
+
+            dangling.clear();
+            subject.Unregister({ "self" }, &dangling);
+            Assert::IsTrue(dangling.empty());
+        }
+
+        TEST_METHOD(testUnregisterInvalidatesFilteredRoot) {
+            CommandDispatcher<int> subject;
+            subject.Register("foo").Executes(command);
+            subject.Register("bar").Executes(command);
+            subject.SetPermissionClass(0, 0);
+            AssertArray(subject.GetAllUsage(subject.GetFilteredRoot(0).get(), source, false), { "bar", "foo" });
+
+            subject.Unregister({ "bar" });
+            AssertArray(subject.GetAllUsage(subject.GetFilteredRoot(0).get(), source, false), { "foo" });
+        }
+
+        TEST_METHOD(testReplace) {
+            CommandDispatcher<int> subject;
+            subject.Register("foo").Then<Literal>("bar").Executes(command);
+            subject.Register("baz").Executes(command);
+            auto old_root = subject.GetRoot();
+            auto parse = subject.Parse("foo bar", source);
+
+            auto replaced = subject.Replace({ "foo", "bar" }, MakeLiteral<int>("bar").Executes(subcommand).GetNode());
+            Assert::IsTrue(replaced == old_root->GetChild("foo")->GetChild("bar"));
+            Assert::IsTrue(subject.GetRoot() != old_root);
+            Assert::IsTrue(subject.GetRoot()->GetChild("foo") != old_root->GetChild("foo"));
+            Assert::IsTrue(subject.GetRoot()->GetChild("baz") == old_root->GetChild("baz"));
+
+            Assert::AreEqual(subject.Execute("foo bar", source), 100);
+            Assert::AreEqual(subject.Execute(parse), 42);
+            Assert::IsTrue(old_root->GetChild("foo")->GetChild("bar") == replaced);
+
+            Assert::IsNull(subject.Replace({ "foo", "missing" }, nullptr).get());
+            Assert::IsNotNull(subject.Replace({ "baz" }, nullptr).get());
+            AssertArray(subject.GetAllUsage(subject.GetRoot().get(), source, false), { "foo bar" });
+
+            try {
+                subject.Replace({ "foo", "bar" }, MakeLiteral<int>("baz").GetNode());
+                Assert::Fail();
+            }
+            catch (std::runtime_error const&) {}
+            try {
+                subject.Replace({ "missing", "bar" }, nullptr);
+                Assert::Fail();
+            }
+            catch (std::runtime_error const&) {}
+        }
+
+        TEST_METHOD(testReplaceDelta) {
+            CommandDispatcher<int> subject;
+            subject.Register("foo").Then<Literal>("bar").Executes(command);
+            size_t version = subject.GetVersion();
+
+            subject.Replace({ "foo", "bar" }, MakeLiteral<int>("bar").Executes(subcommand).GetNode());
+            auto delta = subject.GetDelta(version);
+            Assert::AreEqual(delta.GetEntries().size(), size_t(1));
+            Assert::IsTrue(delta.GetEntries()[0].change == CommandTreeChange::Added);
+            AssertArray(delta.GetEntries()[0].path, { "foo", "bar" });
+        }
+
+        TEST_METHOD(testReplaceRedirects) {
+            CommandDispatcher<int> subject;
+            subject.Register("foo").Executes(command);
+            subject.Register("run").Then<Literal>("as").Redirect(subject.GetRoot());
+            auto old_root = subject.GetRoot();
+
+            subject.Replace({ "foo" }, MakeLiteral<int>("foo").Executes(subcommand).GetNode());
+            auto root = subject.GetRoot();
+            Assert::IsTrue(root->GetChild("run")->GetChild("as")->GetRedirect() == root);
+            Assert::IsTrue(old_root->GetChild("run")->GetChild("as")->GetRedirect() == old_root);
+            Assert::AreEqual(subject.Execute("run as foo", source), 100);
+
+            // new subtrees may redirect to the current root as well
+            auto alias = MakeLiteral<int>("alias");
+            alias.Redirect(subject.GetRoot());
+            subject.Replace({ "alias" }, alias.GetNode());
+            Assert::IsTrue(subject.GetRoot()->GetChild("alias")->GetRedirect() == subject.GetRoot());
+            Assert::AreEqual(subject.Execute("alias run as foo", source), 100);
+        }
+
+        TEST_METHOD(testReplaceReleasesOldVersion) {
+            CommandDispatcher<int> subject;
+            subject.Register("foo").Executes(command);
+            subject.Register("run").Then<Literal>("as").Redirect(subject.GetRoot());
+            {
+                auto execute = subject.Register("execute");
+                execute.Then<Literal>("as").Then<Argument, Word>("name").Redirect(execute);
+                execute.Then<Literal>("run").Executes(command);
+            }
+            std::weak_ptr<RootCommandNode<int>> old_root = subject.GetRoot();
+            std::weak_ptr<CommandNode<int>> old_foo = subject.GetRoot()->GetChild("foo");
+            std::weak_ptr<CommandNode<int>> old_run = subject.GetRoot()->GetChild("run");
+            std::weak_ptr<CommandNode<int>> old_execute = subject.GetRoot()->GetChild("execute");
+
+            subject.Replace({ "foo" }, MakeLiteral<int>("foo").Executes(subcommand).GetNode());
+            Assert::IsTrue(old_root.expired());
+            Assert::IsTrue(old_foo.expired());
+            Assert::IsTrue(old_run.expired());
+            Assert::IsFalse(old_execute.expired());
+            Assert::AreEqual(subject.Execute("run as foo", source), 100);
+
+            subject.Replace({ "execute", "run" }, MakeLiteral<int>("run").Executes(subcommand).GetNode());
+            Assert::IsTrue(old_execute.expired());
+            Assert::AreEqual(subject.Execute("execute as a as b run", source), 100);
+
+            // a parse keeps its version alive until it is dropped
+            {
+                auto parse = subject.Parse("run as foo", source);
+                old_root = subject.GetRoot();
+                subject.Replace({ "foo" }, MakeLiteral<int>("foo").Executes(command).GetNode());
+                Assert::IsFalse(old_root.expired());
+                Assert::AreEqual(subject.Execute(parse), 100);
+            }
+            Assert::IsTrue(old_root.expired());
+            Assert::AreEqual(subject.Execute("run as foo", source), 42);
+        }
+
+        TEST_METHOD(testRedirectAboveSharedNode) {
+            CommandDispatcher<int> subject;
+            {
+                auto a = subject.Register("a");
+                a.Then<Literal>("y").Executes(command);
+                a.Then<Literal>("x").Redirect(subject.GetRoot()->GetChild("a"));
+            }
+            subject.Register("b");
+            std::weak_ptr<CommandNode<int>> weak_a = subject.GetRoot()->GetChild("a");
+
+            // once reachable from b, x is no longer only below a, so it has to keep a alive
+            auto x = subject.GetRoot()->GetChild("a")->GetChild("x");
+            subject.GetRoot()->GetChild("b")->AddChild(x);
+            x = nullptr;
+
+            std::vector<CommandNode<int>*> dangling;
+            subject.Unregister({ "a" }, &dangling);
+            Assert::AreEqual(dangling.size(), size_t(1));
+            Assert::IsFalse(weak_a.expired());
+            Assert::AreEqual(subject.Execute("b x x y", source), 42);
+
+            subject.Unregister({ "b" });
+            Assert::IsTrue(weak_a.expired());
+        }
+
+        TEST_METHOD(testRedirectToOtherRoot) {
+            CommandDispatcher<int> subject;
+            std::weak_ptr<RootCommandNode<int>> other_root;
+            {
+                CommandDispatcher<int> other;
+                other.Register("foo").Executes(command);
+                subject.Register("other").Redirect(other.GetRoot());
+                other_root = other.GetRoot();
+            }
+            Assert::IsFalse(other_root.expired());
+            Assert::AreEqual(subject.Execute("other foo", source), 42);
+
+            // redirects to the root of a copied tree are moved to the copy of the root
+            auto original = std::make_unique<CommandDispatcher<int>>();
+            original->Register("foo").Executes(command);
+            original->Register("run").Redirect(original->GetRoot());
+            CommandDispatcher<int> copy(original->GetRoot().get());
+            copy.Register("bar").Executes(subcommand);
+            original = nullptr;
+            Assert::AreEqual(copy.Execute("run bar", source), 100);
+            Assert::AreEqual(copy.Execute("run run foo", source), 42);
+        }
+
+        TEST_METHOD(testRedirectOutlivedBySharedNode) {
+            auto original = std::make_unique<CommandDispatcher<int>>();
+            {
+                auto execute = original->Register("execute");
+                execute.Then<Literal>("as").Then<Argument, Word>("name").Redirect(execute);
+                execute.Then<Literal>("run").Executes(command);
+            }
+            CommandDispatcher<int> subject(*original);
+            subject.Register("execute").Then<Literal>("say").Executes(subcommand);
+            Assert::AreEqual(subject.Execute("execute as a run", source), 42);
+
+            // the redirect of the shared node does not follow the copy of its target, and must not use it once freed
+            original = nullptr;
+            Assert::AreEqual(subject.Execute("execute say", source), 100);
+            auto parse = subject.Parse("execute as a run", source);
+            Assert::IsTrue(parse.GetReader().CanRead());
+        }
+
+        TEST_METHOD(testReplaceWhileExecuting) {
+            CommandDispatcher<int> subject;
+            subject.Register("foo").Then<Literal>("bar").Executes(command);
+            subject.Register("run").Redirect(subject.GetRoot());
+
+            std::atomic<bool> done = false;
+            std::thread reader([&] {
+                while (!done) {
+                    int result = subject.Execute("run foo bar", source);
+                    Assert::IsTrue(result == 42 || result == 100);
+                }
+            });
+            for (int i = 0; i < 1000; ++i) {
+                subject.Replace({ "foo", "bar" }, MakeLiteral<int>("bar").Executes(i % 2 ? command : subcommand).GetNode());
+            }
+            done = true;
+            reader.join();
+        }
+
+        TEST_METHOD(testCopy) {
+            CommandDispatcher<int> subject;
+            subject.Register("foo").Then<Literal>("bar").Executes(command);
+            subject.Register("baz").Executes(command);
+
+            CommandDispatcher<int> copy(subject);
+            Assert::IsTrue(copy.GetRoot() == subject.GetRoot());
+
+            copy.Register("foo").Then<Literal>("bar").Executes(subcommand);
+            copy.Register("qux").Executes(command);
+            Assert::IsTrue(copy.GetRoot()->GetChild("baz") == subject.GetRoot()->GetChild("baz"));
+            Assert::IsTrue(copy.GetRoot()->GetChild("foo") != subject.GetRoot()->GetChild("foo"));
+            Assert::AreEqual(copy.Execute("foo bar", source), 100);
+            Assert::AreEqual(subject.Execute("foo bar", source), 42);
+            AssertArray(subject.GetAllUsage(subject.GetRoot().get(), source, false), { "baz", "foo bar" });
+
+            subject.Register("foo").Then<Literal>("bar").Executes(wrongcommand);
+            subject.Unregister({ "baz" });
+            Assert::AreEqual(copy.Execute("foo bar", source), 100);
+            AssertArray(copy.GetAllUsage(copy.GetRoot().get(), source, false), { "baz", "foo bar", "qux" });
+        }
+
+        TEST_METHOD(testCopyFromRoot) {
+            CommandDispatcher<int> subject;
+            subject.Register("foo").Then<Literal>("bar").Executes(command);
+
+            CommandDispatcher<int> copy(subject.GetRoot().get());
+            copy.Register("foo").Then<Literal>("bar").Executes(subcommand);
+            subject.Register("foo").Then<Literal>("baz").Executes(command);
+            Assert::AreEqual(subject.Execute("foo bar", source), 42);
+            Assert::AreEqual(copy.Execute("foo bar", source), 100);
+            AssertArray(copy.GetAllUsage(copy.GetRoot().get(), source, false), { "foo bar" });
+        }
+
+        TEST_METHOD(testCopyBuilders) {
+            CommandDispatcher<int> subject;
+            auto foo = subject.Register("foo");
+            auto bar = foo.Then<Literal>("bar");
+            bar.Executes(command);
+            auto root = subject.GetRoot();
+
+            CommandDispatcher<int> copy(root.get());
+            Assert::IsTrue(subject.GetRoot() == root);
+            Assert::IsFalse(bar.GetNode()->IsWritable());
+            try {
+                bar.Executes(wrongcommand);
+                Assert::Fail();
+            }
+            catch (std::runtime_error const&) {}
+            try {
+                foo.Then<Literal>("baz");
+                Assert::Fail();
+            }
+            catch (std::runtime_error const&) {}
+
+            subject.Register("foo").Then<Literal>("bar").Executes(subcommand);
+            Assert::AreEqual(subject.Execute("foo bar", source), 100);
+            Assert::AreEqual(copy.Execute("foo bar", source), 42);
+
+            CommandDispatcher<int> other(subject);
+            auto qux = subject.Register("qux");
+            Assert::IsTrue(qux.GetNode()->IsWritable());
+            qux.Executes(command);
+            Assert::IsTrue(other.GetRoot()->GetChild("qux") == nullptr);
+        }
+
+        TEST_METHOD(testCopyRedirects) {
+            CommandDispatcher<int> subject;
+            subject.Register("foo").Executes(command);
+            subject.Register("run").Then<Literal>("as").Redirect(subject.GetRoot());
+
+            CommandDispatcher<int> copy(subject);
+            copy.Register("foo").Executes(subcommand);
+            Assert::IsTrue(copy.GetRoot()->GetChild("run")->GetChild("as")->GetRedirect() == copy.GetRoot());
+            Assert::AreEqual(copy.Execute("run as foo", source), 100);
+
+            subject.Register("bar").Executes(command);
+            Assert::IsTrue(subject.GetRoot()->GetChild("run")->GetChild("as")->GetRedirect() == subject.GetRoot());
+            Assert::AreEqual(subject.Execute("run as foo", source), 42);
+            Assert::AreEqual(subject.Execute("run as bar", source), 42);
+        }
+
+        TEST_METHOD(testDeduplicate) {
+            CommandDispatcher<int> subject;
+            for (auto name : { "foo", "bar", "baz" }) {
+                subject.Register(name).Then<Argument, Integer>("x", 0, 10).Then<Argument, Integer>("y").Executes(command);
+            }
+            subject.Register("qux").Then<Argument, Integer>("x", 0, 5).Then<Argument, Integer>("y").Executes(command);
+            auto root = subject.GetRoot();
+
+            size_t saved = subject.Deduplicate();
+            Assert::IsTrue(saved > 0);
+            Assert::IsTrue(root->GetChild("foo")->GetChild("x") == root->GetChild("bar")->GetChild("x"));
+            Assert::IsTrue(root->GetChild("foo")->GetChild("x") == root->GetChild("baz")->GetChild("x"));
+            Assert::IsTrue(root->GetChild("foo")->GetChild("x") != root->GetChild("qux")->GetChild("x"));
+            Assert::IsTrue(root->GetChild("foo")->GetChild("x")->GetChild("y") == root->GetChild("qux")->GetChild("x")->GetChild("y"));
+            Assert::AreEqual(subject.Execute("bar 1 2", source), 42);
+            Assert::AreEqual(subject.Deduplicate(), size_t(0));
+
+            // merged nodes are copied before modification
+            subject.Register("bar").Then<Argument, Integer>("x", 0, 10).Then<Argument, Integer>("y").Executes(subcommand);
+            Assert::AreEqual(subject.Execute("bar 1 2", source), 100);
+            Assert::AreEqual(subject.Execute("foo 1 2", source), 42);
+            Assert::AreEqual(subject.Execute("qux 1 2", source), 42);
+        }
+
+        TEST_METHOD(testMemoryStats) {
+            CommandDispatcher<int> subject;
+            for (auto name : { "foo", "bar", "baz" }) {
+                subject.Register(name).Then<Argument, Integer>("x").Then<Argument, Integer>("y").Executes(command);
+            }
+            subject.Register("foo").Then<Literal>("a_literal_too_long_to_be_stored_inline").Executes(command);
+
+            auto stats = subject.MemoryStats(2);
+            Assert::AreEqual(stats.rootNodes, size_t(1));
+            Assert::AreEqual(stats.literalNodes, size_t(4));
+            Assert::AreEqual(stats.argumentNodes, size_t(6));
+            Assert::AreEqual(stats.GetNodeCount(), size_t(11));
+            Assert::IsTrue(stats.stringBytes > 0);
+            Assert::IsTrue(stats.containerBytes > 0);
+            Assert::IsTrue(stats.controlBlockBytes > 0);
+            Assert::AreEqual(stats.largestFanOut.size(), size_t(2));
+            Assert::IsTrue(stats.largestFanOut[0].path.empty());
+            Assert::AreEqual(stats.largestFanOut[0].children, size_t(3));
+            AssertArray(stats.largestFanOut[1].path, { "foo" });
+            Assert::AreEqual(stats.largestFanOut[1].children, size_t(2));
+
+            size_t saved = subject.Deduplicate();
+            auto deduplicated = subject.MemoryStats();
+            Assert::AreEqual(deduplicated.argumentNodes, size_t(2));
+            Assert::AreEqual(deduplicated.GetTotalBytes(), stats.GetTotalBytes() - saved);
+        }
+
         TEST_METHOD(testExecuteEmptyCommand) {
             CommandDispatcher<int> subject;
             subject.Register("");
@@ -475,6 +1672,20 @@ namespace brigadier
         }
 
 
+        TEST_METHOD(getCompletionSuggestions_rootCommands_permissions) {
+            CommandDispatcher<int> subject;
+            subject.SetPermissionProvider([](int const& src) { return GrantLevel(src); });
+            subject.Register<Literal>("foo");
+            subject.Register<Literal>("bar").RequiresPermissions(RequireLevel(1));
+            subject.Register<Literal>("baz");
+
+            Suggestions result = subject.GetCompletionSuggestions(subject.Parse("", 0)).get();
+
+            AssertRange(result.GetRange(), StringRange::At(0));
+            AssertSet(result.GetList(), { Suggestion(StringRange::At(0), "baz"), Suggestion(StringRange::At(0), "foo") });
+        }
+
+
         TEST_METHOD(getCompletionSuggestions_rootCommands_withInputOffset) {
             CommandDispatcher<int> subject;
             subject.Register<Literal>("foo");
@@ -3,4 +3,22 @@
 
 namespace brigadier
 {
+    TEST_CLASS(CommandContextTest)
+    {
+        TEST_METHOD(testMoveKeepsChildLinked)
+        {
+            CommandDispatcher<int> subject;
+            subject.Register("actual").Executes([](CommandContext<int>& ctx) -> int { return 42; });
+            subject.Register("redirected").Redirect(subject.GetRoot());
+
+            auto parse = subject.Parse("redirected actual", 0);
+            Assert::IsNotNull(parse.GetContext().GetChild());
+
+            auto moved = std::move(parse);
+            auto* child = moved.GetContext().GetChild();
+            Assert::IsNotNull(child);
+            Assert::IsTrue(child->GetParent() == &moved.GetContext());
+            Assert::AreEqual(subject.Execute(moved), 42);
+        }
+    };
 }
\ No newline at end of file
@@ -20,5 +20,43 @@ namespace brigadier
 
             Assert::AreEqual(hashes.size(), {9});
         }
+
+        TEST_METHOD(StableTypeIdTest)
+        {
+            static_assert(GetArgumentTypeId<Integer>() == (ArgumentTypeHash("Integer") & 0x7FFFFFFF));
+            static_assert(GetArgumentTypeId<Number<short>>() == (((ArgumentTypeHash("Number") ^ ArgumentTypeHash("short")) * 16777619u) & 0x7FFFFFFF));
+            static_assert(GetArgumentTypeId<Number<short>>() != GetArgumentTypeId<Number<unsigned short>>());
+            static_assert(GetArgumentTypeName<Word>() == "Word");
+
+            Assert::AreEqual(TypeInfo::Create<Integer>(), size_t(GetArgumentTypeId<Integer>()));
+            Assert::AreEqual(TypeInfo::Create<Number<int>>(), TypeInfo::Create<Integer>());
+        }
+
+        TEST_METHOD(MakeReuseTest)
+        {
+            const IParsedArgument<int>* first = nullptr;
+            {
+                auto argument = ParsedArgument<int, Integer>::Make(0, 1, 5);
+                first = argument.get();
+
+                // still held, so another one is made
+                auto other = ParsedArgument<int, Integer>::Make(2, 3, 6);
+                Assert::IsTrue(other.get() != first);
+                Assert::AreEqual(argument->GetResult(), 5);
+            }
+
+            size_t allocations = GetAllocationCount();
+            auto reused = ParsedArgument<int, Integer>::Make(4, 5, 7);
+            Assert::AreEqual(GetAllocationCount() - allocations, size_t(0));
+            Assert::IsTrue(reused.get() == first);
+            Assert::AreEqual(reused->GetResult(), 7);
+            Assert::AreEqual(reused->GetRange().GetStart(), 4);
+
+            // results owning memory are never kept
+            auto word = ParsedArgument<int, String>::Make(0, 3, "foo");
+            auto copy = word;
+            word = nullptr;
+            Assert::AreEqual(copy.use_count(), long(1));
+        }
     };
 }
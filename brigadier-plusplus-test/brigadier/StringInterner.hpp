@@ -0,0 +1,66 @@
+#pragma once
+#include "CommonTest.hpp"
+
+namespace brigadier
+{
+    TEST_CLASS(StringInternerTest)
+    {
+        TEST_METHOD(testIntern)
+        {
+            std::string text = "interned";
+            auto interned = StringInterner::Intern(text);
+            Assert::IsTrue(interned.GetView() == "interned");
+            Assert::IsTrue(interned.data() != text.data());
+            Assert::IsTrue(StringInterner::Intern("interned").data() == interned.data());
+            Assert::IsTrue(StringInterner::Intern("Interned").data() != interned.data());
+            Assert::IsTrue(StringInterner::Intern("").empty());
+        }
+
+        TEST_METHOD(testLongString)
+        {
+            std::string text(10000, 'x');
+            auto interned = StringInterner::Intern(text);
+            Assert::IsTrue(interned.GetView() == text);
+            Assert::IsTrue(StringInterner::Intern(text).data() == interned.data());
+        }
+
+        TEST_METHOD(testRelease)
+        {
+            std::string text(10000, 'r');
+            size_t before = StringInterner::GetMemoryUsage();
+            {
+                auto interned = StringInterner::Intern(text);
+                auto copy = interned;
+                Assert::IsTrue(StringInterner::GetMemoryUsage() >= before + text.size());
+            }
+            Assert::IsTrue(StringInterner::GetMemoryUsage() < before + text.size());
+        }
+
+        TEST_METHOD(testReleaseNodeNames)
+        {
+            std::string name(10000, 'n');
+            size_t before = StringInterner::GetMemoryUsage();
+            {
+                CommandDispatcher<int> subject;
+                subject.Register(name);
+                auto copy = subject;
+                subject.Unregister({ name });
+                Assert::IsTrue(StringInterner::GetMemoryUsage() >= before + name.size());
+            }
+            Assert::IsTrue(StringInterner::GetMemoryUsage() < before + name.size());
+        }
+
+        TEST_METHOD(testNodeNames)
+        {
+            CommandDispatcher<int> first, second;
+            first.Register("shared").Then<Argument, Integer>("value");
+            second.Register("shared").Then<Argument, Integer>("value");
+
+            auto a = first.GetRoot()->GetChild("shared");
+            auto b = second.GetRoot()->GetChild("shared");
+            Assert::IsTrue(a->GetName().data() == b->GetName().data());
+            Assert::IsTrue(first.GetRoot()->GetChildren().begin()->first.data() == a->GetName().data());
+            Assert::IsTrue(a->GetChild("value")->GetName().data() == b->GetChild("value")->GetName().data());
+        }
+    };
+}
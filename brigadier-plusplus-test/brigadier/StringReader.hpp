@@ -239,6 +239,19 @@ namespace brigadier
             }
         }
 
+        TEST_METHOD(ReadStringView_tokens) {
+            std::string input = "\"hello world\" \"a\\\"b\" rest";
+            StringTokens tokens(input);
+            StringReader reader(input);
+            reader.SetTokens(&tokens);
+            std::string unescaped;
+            Assert::AreEqual(reader.ReadStringView(unescaped), { "hello world" });
+            Assert::AreEqual(reader.GetCursor(), 13);
+            reader.Skip();
+            Assert::AreEqual(reader.ReadStringView(unescaped), { "a\"b" });
+            Assert::AreEqual(reader.GetRemaining(), { " rest" });
+        }
+
         TEST_METHOD(ReadString_noQuotes) {
             StringReader reader("hello world");
             Assert::AreEqual(reader.ReadString(), {"hello"});
@@ -513,5 +526,23 @@ namespace brigadier
                 Assert::AreEqual(ex.GetCursor(), {0});
             }
         }
+
+        TEST_METHOD(ExceptionMessage) {
+            std::string input = "hello world \"unclosed";
+            StringReader reader(input);
+            reader.SetCursor(12);
+            try {
+                reader.ReadValue<int>();
+                Assert::Fail();
+            }
+            catch (CommandSyntaxException& ex) {
+                Assert::IsTrue(ex.GetError() == SyntaxError::ReaderExpectedValue);
+                input.assign(input.size(), '-'); // the message must not depend on the input after the exception was created
+                Assert::AreEqual(ex.What(), std::string("Expected value at position 12: ...llo world <--[HERE]"));
+            }
+
+            auto ex = CommandSyntaxException::BuiltInExceptions::ValueTooLow(StringReader("5"), 0.5f, 2);
+            Assert::AreEqual(ex.What(), std::string("Value must not be less than 2, found 0.5 at position 0: 5<--[HERE]"));
+        }
     };
 }
@@ -0,0 +1,73 @@
+#pragma once
+#include "CommonTest.hpp"
+
+namespace brigadier
+{
+    TEST_CLASS(StringTokensTest)
+    {
+        TEST_METHOD(GetWord) {
+            StringTokens tokens("foo bar  baz");
+            Assert::AreEqual(tokens.GetCount(), size_t(4));
+            Assert::IsTrue(tokens.GetWord(0) == "foo");
+            Assert::IsTrue(tokens.GetWord(4) == "bar");
+            Assert::IsTrue(tokens.GetWord(8) == "");
+            Assert::IsTrue(tokens.GetWord(9) == "baz");
+            Assert::IsTrue(tokens.GetWord(12) == "");
+        }
+
+        TEST_METHOD(GetWord_middle) {
+            StringTokens tokens("foo bar");
+            Assert::IsTrue(tokens.GetWord(1) == "oo");
+            Assert::IsTrue(tokens.GetWord(5) == "ar");
+        }
+
+        TEST_METHOD(Tokenize_overflow) {
+            std::string input;
+            for (int i = 0; i < 40; ++i) {
+                input += "w" + std::to_string(i) + " ";
+            }
+            StringTokens tokens;
+            tokens.Tokenize(input);
+            Assert::AreEqual(tokens.GetCount(), size_t(41));
+            Assert::IsTrue(tokens.GetWord(0) == "w0");
+            Assert::IsTrue(tokens.GetWord(int(input.find("w39"))) == "w39");
+
+            tokens.Tokenize("short input");
+            Assert::AreEqual(tokens.GetCount(), size_t(2));
+            Assert::IsTrue(tokens.GetWord(6) == "input");
+
+            // storage of the longer input is reused
+            size_t allocations = GetAllocationCount();
+            tokens.Tokenize(input);
+            Assert::AreEqual(GetAllocationCount() - allocations, size_t(0));
+            Assert::AreEqual(tokens.GetCount(), size_t(41));
+        }
+
+        TEST_METHOD(Tokenize_quoted) {
+            StringTokens tokens("say \"hello world\" 'a b' next");
+            Assert::AreEqual(tokens.GetCount(), size_t(4));
+            Assert::IsTrue(tokens.GetWord(4) == "\"hello world\"");
+            Assert::AreEqual(tokens.GetQuoteEnd(4), 16);
+            Assert::IsTrue(tokens.GetWord(18) == "'a b'");
+            Assert::AreEqual(tokens.GetQuoteEnd(18), 22);
+            Assert::IsTrue(tokens.GetWord(24) == "next");
+            Assert::AreEqual(tokens.GetQuoteEnd(24), -1);
+        }
+
+        TEST_METHOD(Tokenize_quotedNotPlain) {
+            StringTokens escaped("\"a \\\" b\" c");
+            Assert::AreEqual(escaped.GetCount(), size_t(2));
+            Assert::IsTrue(escaped.GetWord(0) == "\"a \\\" b\"");
+            Assert::AreEqual(escaped.GetQuoteEnd(0), -1);
+
+            StringTokens unclosed("\"a b");
+            Assert::AreEqual(unclosed.GetCount(), size_t(2));
+            Assert::IsTrue(unclosed.GetWord(0) == "\"a");
+            Assert::AreEqual(unclosed.GetQuoteEnd(0), -1);
+
+            StringTokens joined("\"a b\"c d");
+            Assert::IsTrue(joined.GetWord(0) == "\"a b\"c");
+            Assert::AreEqual(joined.GetQuoteEnd(0), -1);
+        }
+    };
+}
@@ -3,4 +3,30 @@
 
 namespace brigadier
 {
+    TEST_CLASS(CommandNodeTest)
+    {
+        TEST_METHOD(testRemoveChild)
+        {
+            CommandDispatcher<int> subject;
+            auto root = subject.GetRoot();
+            subject.Register("foo").Then<Argument, Integer>("bar");
+            subject.Register("baz").Executes([](CommandContext<int>& ctx) -> int { return 0; });
+            subject.Register<Argument, Integer>("qux");
+
+            auto foo = root->RemoveChild("foo");
+            Assert::IsNotNull(foo.get());
+            Assert::IsNull(root->GetChild("foo").get());
+            Assert::IsNotNull(foo->GetChild("bar").get());
+            Assert::IsNull(root->RemoveChild("foo").get());
+
+            root->RemoveChild("qux");
+            Assert::AreEqual(root->GetChildren().size(), size_t(1));
+            AssertArray(subject.GetAllUsage(root.get(), 0, false), { "baz" });
+            try {
+                subject.Execute("foo 1", 0);
+                Assert::Fail();
+            }
+            catch (CommandSyntaxException const&) {}
+        }
+    };
 }
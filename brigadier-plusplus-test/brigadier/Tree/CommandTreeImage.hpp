@@ -0,0 +1,122 @@
+#pragma once
+#include "CommonTest.hpp"
+
+namespace brigadier
+{
+    TEST_CLASS(CommandTreeImageTest)
+    {
+        static int Command1(CommandContext<int>& ctx) { return ctx.GetArgument<Integer>("value"); }
+        static int Command2(CommandContext<int>& ctx) { return 2; }
+        static bool Requirement(int& source) { return source > 0; }
+        static std::future<Suggestions> Provider(CommandContext<int>& context, SuggestionsBuilder& builder) { return Suggestions::Empty(); }
+
+        static CommandTreeBinder<int> MakeBinder()
+        {
+            CommandTreeBinder<int> binder;
+            binder.BindCommand(1, Command1);
+            binder.BindCommand(2, Command2);
+            binder.BindRequirement(1, Requirement);
+            binder.BindSuggestions(1, Provider);
+            binder.BindArgumentType<Integer>(1);
+            binder.BindArgumentType<Word>();
+            return binder;
+        }
+
+        static std::vector<uint64_t> Aligned(std::string const& bytes)
+        {
+            std::vector<uint64_t> buffer((bytes.size() + 7) / 8);
+            std::memcpy(buffer.data(), bytes.data(), bytes.size());
+            return buffer;
+        }
+
+        TEST_METHOD(testRoundTrip)
+        {
+            CommandDispatcher<int> subject;
+            auto foo = subject.Register("foo");
+            foo.Then<Argument, Integer>("value", 0, 10).Suggests(Provider).Executes(Command1);
+            foo.Then<Literal>("bar").Requires(Requirement).RequiresPermissions(RequireLevel(2)).Executes(Command2);
+            subject.Register<Argument, Word>("name").Executes(Command2);
+            subject.Register("redirect").Redirect(subject.GetRoot());
+
+            auto binder = MakeBinder();
+            std::string bytes = binder.WriteImage(subject.GetRoot().get());
+            auto buffer = Aligned(bytes);
+            CommandTreeImage image(buffer.data(), bytes.size());
+            Assert::AreEqual(image.GetNodeCount(), uint32_t(6));
+
+            CommandDispatcher<int> loaded(binder.ReadImage(image));
+            loaded.SetPermissionProvider([](int const& src) { return GrantLevel(src); });
+            AssertArray(loaded.GetAllUsage(loaded.GetRoot().get(), 0, false), subject.GetAllUsage(subject.GetRoot().get(), 0, false));
+            Assert::AreEqual(loaded.Execute("foo 7", 0), 7);
+            Assert::AreEqual(loaded.Execute("redirect foo 3", 0), 3);
+            Assert::AreEqual(loaded.Execute("foo bar", 2), 2);
+            Assert::AreEqual(loaded.Execute("anything", 0), 2);
+
+            auto foo_loaded = loaded.GetRoot()->GetChild("foo");
+            auto value = std::static_pointer_cast<ArgumentCommandNode<int, Integer>>(foo_loaded->GetChild("value"));
+            auto type = value->GetType();
+            Assert::AreEqual(type.GetMaximum(), 10);
+            Assert::IsTrue(value->GetCustomSuggestions() == Provider);
+            Assert::IsTrue(foo_loaded->GetChild("bar")->GetRequirement() == Requirement);
+            Assert::AreEqual(foo_loaded->GetChild("bar")->GetPermissions(), RequireLevel(2));
+            Assert::IsTrue(loaded.GetRoot()->GetChild("redirect")->GetRedirect() == loaded.GetRoot());
+
+            try {
+                loaded.Execute("foo 11", 0);
+                Assert::Fail();
+            }
+            catch (CommandSyntaxException const&) {}
+        }
+
+        TEST_METHOD(testUnboundCallback)
+        {
+            CommandDispatcher<int> subject;
+            subject.Register("foo").Executes([](CommandContext<int>& ctx) -> int { return 0; });
+
+            try {
+                MakeBinder().WriteImage(subject.GetRoot().get());
+                Assert::Fail();
+            }
+            catch (std::runtime_error const&) {}
+        }
+
+        TEST_METHOD(testInvalidImage)
+        {
+            CommandDispatcher<int> subject;
+            subject.Register("foo").Executes(Command2);
+            std::string bytes = MakeBinder().WriteImage(subject.GetRoot().get());
+
+            auto buffer = Aligned(bytes);
+            try {
+                CommandTreeImage image(buffer.data(), bytes.size() - 1);
+                Assert::Fail();
+            }
+            catch (std::runtime_error const&) {}
+
+            reinterpret_cast<CommandTreeImage::Header*>(buffer.data())->version = CommandTreeImage::VERSION + 1;
+            try {
+                CommandTreeImage image(buffer.data(), bytes.size());
+                Assert::Fail();
+            }
+            catch (std::runtime_error const&) {}
+        }
+
+        TEST_METHOD(testCyclicImage)
+        {
+            CommandDispatcher<int> subject;
+            subject.Register("foo").Then<Literal>("bar").Then<Literal>("baz").Executes(Command2);
+            std::string bytes = MakeBinder().WriteImage(subject.GetRoot().get());
+
+            auto buffer = Aligned(bytes);
+            CommandTreeImage image(buffer.data(), bytes.size());
+            uint32_t foo = image.GetChildren(image.GetNode(0))[0];
+            uint32_t bar = image.GetChildren(image.GetNode(foo))[0];
+            const_cast<uint32_t*>(image.GetChildren(image.GetNode(bar)))[0] = foo;
+            try {
+                CommandTreeImage cyclic(buffer.data(), bytes.size());
+                Assert::Fail();
+            }
+            catch (std::runtime_error const&) {}
+        }
+    };
+}
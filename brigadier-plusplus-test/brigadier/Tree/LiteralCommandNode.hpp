@@ -3,4 +3,40 @@
 
 namespace brigadier
 {
+    TEST_CLASS(LiteralCommandNodeTest)
+    {
+        TEST_METHOD(testLowerCase)
+        {
+            SuggestionsBuilder builder("Fo", "fo", 0);
+            CommandContext<int> context(0, nullptr, 0);
+
+            LiteralCommandNode<int> lower("foo");
+            Assert::AreEqual(lower.ListSuggestions(context, builder).get().GetList().size(), size_t(1));
+
+            LiteralCommandNode<int> mixed("FOO");
+            Assert::IsTrue(mixed.GetName() == "FOO");
+            Assert::IsTrue(mixed.GetUsageText() == "FOO");
+            Assert::IsTrue(mixed.ListSuggestions(context, builder).get().GetList().size() == 1);
+        }
+
+        TEST_METHOD(testParse)
+        {
+            CommandContext<int> context(0, nullptr, 0);
+            LiteralCommandNode<int> node("foo");
+            Assert::IsTrue(node.GetNodeType() == CommandNodeType::LiteralCommandNode);
+            Assert::IsTrue(node.Clone()->GetNodeType() == CommandNodeType::LiteralCommandNode);
+
+            StringReader reader("foo bar");
+            node.ParseLiteral(reader, context);
+            Assert::AreEqual(reader.GetCursor(), 3);
+
+            StringReader partial("foobar");
+            try {
+                node.ParseLiteral(partial, context);
+                Assert::Fail();
+            }
+            catch (CommandSyntaxException const&) {}
+            Assert::AreEqual(partial.GetCursor(), 0);
+        }
+    };
 }
@@ -0,0 +1,175 @@
+#pragma once
+#include "CommonTest.hpp"
+
+namespace brigadier
+{
+    constexpr auto staticTeleport = MakeStaticLiteral<int>("tp",
+        MakeStaticLiteral<int>("here").Executes([](CommandContext<int>& ctx) -> int { return 1; }),
+        MakeStaticArgument<int, Integer>("x",
+            MakeStaticArgument<int, Integer>("y").WithType(Integer(0, 100)).Executes([](CommandContext<int>& ctx) -> int {
+                return ctx.GetArgument<Integer>("x") * 1000 + ctx.GetArgument<Integer>("y");
+            })),
+        MakeStaticArgument<int, Word>("target").Executes([](CommandContext<int>& ctx) -> int { return 2; }));
+
+    static_assert(decltype(staticTeleport)::height == 3);
+    static_assert(decltype(staticTeleport)::literalCount == 1);
+    static_assert(decltype(staticTeleport)::argumentCount == 2);
+
+    TEST_CLASS(StaticCommandNodeTest)
+    {
+        TEST_METHOD(testExecute)
+        {
+            CommandDispatcher<int> subject;
+            subject.RegisterStatic(staticTeleport);
+            subject.Register("plugin").Then<Argument, Integer>("value").Executes([](CommandContext<int>& ctx) -> int { return ctx.GetArgument<Integer>("value"); });
+
+            Assert::AreEqual(subject.Execute("tp here", 0), 1);
+            Assert::AreEqual(subject.Execute("tp 12 34", 0), 12034);
+            Assert::AreEqual(subject.Execute("tp steve", 0), 2);
+            Assert::AreEqual(subject.Execute("plugin 5", 0), 5);
+            AssertArray(subject.GetAllUsage(subject.GetRoot().get(), 0, false), { "plugin <int: value>", "tp here", "tp <word: target>", "tp <int: x> <int: y>" });
+        }
+
+        TEST_METHOD(testSameAsDynamic)
+        {
+            CommandDispatcher<int> expected;
+            auto tp = expected.Register("tp");
+            tp.Then<Literal>("here").Executes([](CommandContext<int>& ctx) -> int { return 1; });
+            tp.Then<Argument, Integer>("x").Then<Argument, Integer>("y", 0, 100).Executes([](CommandContext<int>& ctx) -> int { return 0; });
+            tp.Then<Argument, Word>("target").Executes([](CommandContext<int>& ctx) -> int { return 2; });
+
+            CommandDispatcher<int> subject;
+            subject.RegisterStatic(staticTeleport);
+
+            for (std::string_view input : { "tp here", "tp 12 34", "tp steve", "tp 12 345", "tp 12", "tp 12 ", "tp 1 2 3", "tp", "tp here now" }) {
+                auto a = expected.Parse(input, 0);
+                auto b = subject.Parse(input, 0);
+                Assert::AreEqual(a.GetReader().GetCursor(), b.GetReader().GetCursor());
+                Assert::AreEqual(a.GetExceptions().size(), b.GetExceptions().size());
+                Assert::AreEqual(a.GetContext().GetCommand() != nullptr, b.GetContext().GetCommand() != nullptr);
+                AssertRange(a.GetContext().GetRange(), b.GetContext().GetRange());
+
+                auto& nodesA = a.GetContext().GetNodes();
+                auto& nodesB = b.GetContext().GetNodes();
+                Assert::AreEqual(nodesA.size(), nodesB.size());
+                for (size_t i = 0; i < nodesA.size(); ++i) {
+                    Assert::IsTrue(nodesA[i].GetNode()->GetName() == nodesB[i].GetNode()->GetName());
+                    AssertRange(nodesA[i].GetRange(), nodesB[i].GetRange());
+                }
+            }
+        }
+
+        TEST_METHOD(testParseCompiled)
+        {
+            CommandDispatcher<int> subject;
+            subject.RegisterStatic(staticTeleport);
+            auto root = subject.GetRoot();
+            auto tp = root->GetChild("tp");
+
+            StringReader reader("tp 12 34");
+            reader.SetCursor(3);
+            CommandContext<int> context(0, root.get(), 0);
+            Assert::IsTrue(tp->ParseCompiled(reader, context, 0));
+            Assert::IsFalse(reader.CanRead());
+            Assert::AreEqual(context.GetNodes().size(), size_t(2));
+            Assert::AreEqual(context.GetArgument<Integer>("y"), 34);
+
+            StringReader incomplete("tp 12 ");
+            incomplete.SetCursor(3);
+            CommandContext<int> other(0, root.get(), 0);
+            Assert::IsFalse(tp->ParseCompiled(incomplete, other, 0));
+            Assert::AreEqual(incomplete.GetCursor(), 3);
+            Assert::IsFalse(other.HasNodes());
+        }
+
+        TEST_METHOD(testVisitLimit)
+        {
+            CommandDispatcher<int> subject;
+            subject.RegisterStatic(staticTeleport);
+            auto root = subject.GetRoot();
+            auto tp = root->GetChild("tp");
+
+            StringReader reader("tp 12 34");
+            reader.SetCursor(3);
+            CommandContext<int> context(0, root.get(), 0);
+            ParseBudget budget;
+            Assert::IsTrue(tp->ParseCompiled(reader, context, 0, budget));
+            Assert::IsTrue(budget.visits >= 2); // x, y
+
+            StringReader limited("tp 12 34");
+            limited.SetCursor(3);
+            CommandContext<int> other(0, root.get(), 0);
+            ParseBudget small;
+            small.maxVisits = 1;
+            try {
+                tp->ParseCompiled(limited, other, 0, small);
+                Assert::Fail();
+            }
+            catch (CommandSyntaxException const&) {}
+
+            ParseOptions options;
+            options.maxNodeVisits = 2;
+            subject.SetParseOptions(options);
+            try {
+                subject.Parse("tp 12 34", 0);
+                Assert::Fail();
+            }
+            catch (CommandSyntaxException const&) {}
+        }
+
+        TEST_METHOD(testArgumentsReused)
+        {
+            CommandDispatcher<int> subject;
+            subject.RegisterStatic(staticTeleport);
+            subject.Execute("tp 12 34", 0);
+
+            // arguments of kept parses cannot be reused, and enough are kept to use up the reused ones
+            std::vector<ParseResults<int>> kept;
+            for (int i = 0; i < 8; ++i)
+                kept.push_back(subject.Parse("tp 12 34", 0));
+            size_t allocations = GetAllocationCount();
+            subject.Parse("tp 56 78", 0);
+            size_t separate = GetAllocationCount() - allocations;
+            CommandContext<int> context = kept.back().GetContext();
+            Assert::AreEqual(context.GetArgument<Integer>("y"), 34);
+
+            kept.clear();
+            allocations = GetAllocationCount();
+            auto parse = subject.Parse("tp 56 78", 0);
+            size_t reused = GetAllocationCount() - allocations;
+            Assert::AreEqual(separate - reused, size_t(2)); // x, y
+            Assert::AreEqual(subject.Execute(parse), 56078);
+        }
+
+        TEST_METHOD(testModifiedTree)
+        {
+            CommandDispatcher<int> subject;
+            subject.RegisterStatic(staticTeleport).Then<Literal>("spawn").Executes([](CommandContext<int>& ctx) -> int { return 3; });
+
+            // children no longer match the declaration, so the usual parser is used
+            StringReader reader("tp 12 34");
+            reader.SetCursor(3);
+            CommandContext<int> context(0, subject.GetRoot().get(), 0);
+            Assert::IsFalse(subject.GetRoot()->GetChild("tp")->ParseCompiled(reader, context, 0));
+
+            Assert::AreEqual(subject.Execute("tp spawn", 0), 3);
+            Assert::AreEqual(subject.Execute("tp 12 34", 0), 12034);
+        }
+
+        TEST_METHOD(testRequirement)
+        {
+            constexpr auto tree = MakeStaticLiteral<int>("kick",
+                MakeStaticArgument<int, Word>("player").Requires([](int& source) { return source > 0; }).Executes([](CommandContext<int>& ctx) -> int { return 1; }));
+
+            CommandDispatcher<int> subject;
+            subject.RegisterStatic(tree);
+
+            Assert::AreEqual(subject.Execute("kick steve", 1), 1);
+            try {
+                subject.Execute("kick steve", 0);
+                Assert::Fail();
+            }
+            catch (CommandSyntaxException const&) {}
+        }
+    };
+}
@@ -1,22 +1,142 @@
 #pragma once
 
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
 // Following code makes that you don't have to specify command source type inside arguments.
 // Command source type is automatically distributed from dispatcher.
+//
+// Registration also assigns a stable numeric ID to the argument type, derived from the registered name
+// (and IDs of template parameters for templated registrations). See GetArgumentTypeId<T>().
 
 // Default registration for arguments with or without template, without specialization
 #define REGISTER_ARGTYPE(type, name)                                      \
+constexpr ::brigadier::ArgumentTypeKey RegisteredArgumentType(::brigadier::ArgumentTypeTag<type>) \
+{ return ::brigadier::MakeArgumentTypeKey(#name); }                      \
 using name = type
 
 // Registration for arguments with template parameters
 #define REGISTER_ARGTYPE_TEMPL(type, name)                                \
 template<typename... Args>                                                \
+constexpr auto RegisteredArgumentType(::brigadier::ArgumentTypeTag<type<Args...>>) \
+-> std::enable_if_t<::brigadier::HasArgumentTypeParamIds<Args...>, ::brigadier::ArgumentTypeKey> \
+{ return ::brigadier::MakeArgumentTypeKey<Args...>(#name); }             \
+template<typename... Args>                                                \
 using name = type<Args...>
 
 // Registration for arguments with specialized templates
 #define REGISTER_ARGTYPE_SPEC(type, name, ...)                            \
+constexpr ::brigadier::ArgumentTypeKey RegisteredArgumentType(::brigadier::ArgumentTypeTag<type<__VA_ARGS__>>) \
+{ return ::brigadier::MakeArgumentTypeKey(#name); }                      \
 using name = type<__VA_ARGS__>
 
 // Registration for arguments with specialized templates and template parameters
 #define REGISTER_ARGTYPE_SPEC_TEMPL(type, name, ...)                      \
 template<typename... Args>                                                \
+constexpr auto RegisteredArgumentType(::brigadier::ArgumentTypeTag<type<__VA_ARGS__, Args...>>) \
+-> std::enable_if_t<::brigadier::HasArgumentTypeParamIds<Args...>, ::brigadier::ArgumentTypeKey> \
+{ return ::brigadier::MakeArgumentTypeKey<Args...>(#name); }             \
+template<typename... Args>                                                \
 using name = type<__VA_ARGS__, Args...>
+
+namespace brigadier
+{
+    template<typename T>
+    struct ArgumentTypeTag {};
+
+    struct ArgumentTypeKey
+    {
+        uint32_t id;
+        std::string_view name;
+    };
+
+    // FNV-1a
+    constexpr uint32_t ArgumentTypeHash(std::string_view text, uint32_t hash = 2166136261u)
+    {
+        for (char c : text) {
+            hash ^= uint8_t(c);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    template<typename T>
+    constexpr std::string_view FundamentalTypeName()
+    {
+        /**/ if constexpr (std::is_same_v<T, bool>)               return "bool";
+        else if constexpr (std::is_same_v<T, char>)               return "char";
+        else if constexpr (std::is_same_v<T, signed char>)        return "signed char";
+        else if constexpr (std::is_same_v<T, unsigned char>)      return "unsigned char";
+        else if constexpr (std::is_same_v<T, wchar_t>)            return "wchar_t";
+        else if constexpr (std::is_same_v<T, char16_t>)           return "char16_t";
+        else if constexpr (std::is_same_v<T, char32_t>)           return "char32_t";
+        else if constexpr (std::is_same_v<T, short>)              return "short";
+        else if constexpr (std::is_same_v<T, unsigned short>)     return "unsigned short";
+        else if constexpr (std::is_same_v<T, int>)                return "int";
+        else if constexpr (std::is_same_v<T, unsigned>)           return "unsigned";
+        else if constexpr (std::is_same_v<T, long>)               return "long";
+        else if constexpr (std::is_same_v<T, unsigned long>)      return "unsigned long";
+        else if constexpr (std::is_same_v<T, long long>)          return "long long";
+        else if constexpr (std::is_same_v<T, unsigned long long>) return "unsigned long long";
+        else if constexpr (std::is_same_v<T, float>)              return "float";
+        else if constexpr (std::is_same_v<T, double>)             return "double";
+        else                                                      return "long double";
+    }
+
+    // Checks if T was registered with one of REGISTER_ARGTYPE* macros.
+    template<typename T, typename = void>
+    struct HasArgumentTypeId : std::false_type {};
+    template<typename T>
+    struct HasArgumentTypeId<T, std::void_t<decltype(RegisteredArgumentType(ArgumentTypeTag<T>{}))>> : std::true_type {};
+
+    // Stable ID of a template parameter of a registered argument type. Arithmetic types and registered argument types have one,
+    // other types (e.g. enums) may get one by specializing this template.
+    template<typename T, typename = void>
+    struct ArgumentTypeParamId {};
+    template<typename T>
+    struct ArgumentTypeParamId<T, std::enable_if_t<std::is_arithmetic_v<T>>>
+    {
+        static constexpr uint32_t value = ArgumentTypeHash(FundamentalTypeName<T>());
+    };
+    template<typename T>
+    struct ArgumentTypeParamId<T, std::enable_if_t<HasArgumentTypeId<T>::value>>
+    {
+        static constexpr uint32_t value = RegisteredArgumentType(ArgumentTypeTag<T>{}).id;
+    };
+
+    template<typename T, typename = void>
+    struct HasArgumentTypeParamId : std::false_type {};
+    template<typename T>
+    struct HasArgumentTypeParamId<T, std::void_t<decltype(ArgumentTypeParamId<T>::value)>> : std::true_type {};
+
+    template<typename... Args>
+    constexpr bool HasArgumentTypeParamIds = (HasArgumentTypeParamId<Args>::value && ...);
+
+    // IDs are 31 bit wide, TypeInfo of unregistered types has the highest bit set.
+    template<typename... Args>
+    constexpr ArgumentTypeKey MakeArgumentTypeKey(std::string_view name)
+    {
+        uint32_t hash = ArgumentTypeHash(name);
+        ((hash = (hash ^ ArgumentTypeParamId<Args>::value) * 16777619u), ...);
+        return { hash & 0x7FFFFFFFu, name };
+    }
+
+    /**
+    Stable ID of an argument type registered with one of REGISTER_ARGTYPE* macros.
+    It depends only on the registered name and template parameters, so it is the same in every build.
+    */
+    template<typename T>
+    constexpr uint32_t GetArgumentTypeId()
+    {
+        static_assert(HasArgumentTypeId<T>::value, "Argument type is not registered");
+        return RegisteredArgumentType(ArgumentTypeTag<T>{}).id;
+    }
+
+    template<typename T>
+    constexpr std::string_view GetArgumentTypeName()
+    {
+        static_assert(HasArgumentTypeId<T>::value, "Argument type is not registered");
+        return RegisteredArgumentType(ArgumentTypeTag<T>{}).name;
+    }
+}
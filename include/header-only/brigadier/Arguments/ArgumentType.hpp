@@ -39,6 +39,16 @@ namespace brigadier
             return reader.ReadValue<T>();
         }
 
+        /**
+        Same as Parse, but returns false with the failure in `error` instead of throwing it, so the dispatcher can try
+        candidates without exceptions. The dispatcher calls it only if it is declared by the same class as Parse
+        (see HasTryParse), other argument types are parsed with Parse.
+        */
+        bool TryParse(StringReader& reader, T& result, ExceptionRecord& error)
+        {
+            return reader.TryReadValue<T>(result, error);
+        }
+
         template<typename S>
         std::future<Suggestions> ListSuggestions(CommandContext<S>& context, SuggestionsBuilder& builder)
         {
@@ -58,40 +68,120 @@ namespace brigadier
         {
             return {};
         }
+
+        /**
+        Characters that input accepted by Parse can start with. The dispatcher does not call Parse on input starting
+        with any other character, so the set must contain every character for which Parse may succeed.
+        The end of input is always passed to Parse.
+        */
+        static constexpr CharacterSet GetFirstCharacters()
+        {
+            return CharacterSet::All();
+        }
     };
     REGISTER_ARGTYPE_TEMPL(ArgumentType, Type);
 
+    template<typename M>
+    struct MemberClass;
+    template<typename C, typename M>
+    struct MemberClass<M C::*> { using type = C; };
+
+    /**
+    Checks if the argument type can be parsed without exceptions, see ArgumentType::TryParse. A type that replaces
+    the Parse function of its base class is parsed with its own Parse, not with the TryParse it inherits.
+    */
+    template<typename T, typename = void>
+    struct HasTryParse : std::false_type {};
+    template<typename T>
+    struct HasTryParse<T, std::void_t<decltype(&T::Parse), decltype(&T::TryParse)>>
+        : std::is_same<typename MemberClass<decltype(&T::Parse)>::type, typename MemberClass<decltype(&T::TryParse)>::type> {};
+
     enum class StringArgType {
         SINGLE_WORD,
         QUOTABLE_PHRASE,
         GREEDY_PHRASE
     };
 
-    template<StringArgType strType>
-    class StringArgumentType : public ArgumentType<std::string>
+    /**
+    Result of the string argument types parsing without copies (WordView, StringView, GreedyStringView).
+    Refers to the parsed input, so it is valid only as long as the input string. Quoted strings with escape
+    sequences are the exception, they are unescaped into storage owned by the result.
+    */
+    class StringArgumentView
+    {
+    public:
+        StringArgumentView() = default;
+        explicit StringArgumentView(std::string_view view) : view(view) {}
+        explicit StringArgumentView(std::string unescaped) : unescaped(std::move(unescaped)), owned(true) {}
+
+        inline std::string_view Get()     const { return owned ? std::string_view(unescaped) : view; }
+        inline bool             IsOwned() const { return owned; }
+        inline operator std::string_view() const { return Get(); }
+        inline bool operator==(std::string_view other) const { return Get() == other; }
+        inline bool operator!=(std::string_view other) const { return Get() != other; }
+    private:
+        std::string_view view;
+        std::string unescaped;
+        bool owned = false;
+    };
+
+    inline std::ostream& operator<<(std::ostream& os, StringArgumentView const& value)
+    {
+        return os << value.Get();
+    }
+
+    template<StringArgType strType, bool borrowed = false>
+    class StringArgumentType : public ArgumentType<std::conditional_t<borrowed, StringArgumentView, std::string>>
     {
     public:
-        StringArgumentType() {};
+        using type = std::conditional_t<borrowed, StringArgumentView, std::string>;
+    public:
+        constexpr StringArgumentType() {};
 
         StringArgType GetType()
         {
             return strType;
         }
 
-        std::string Parse(StringReader& reader) {
-            if (strType == StringArgType::GREEDY_PHRASE)
+        type Parse(StringReader& reader) {
+            type result;
+            ExceptionRecord error;
+            if (!TryParse(reader, result, error)) {
+                throw CommandSyntaxException(error, reader.GetString());
+            }
+            return result;
+        }
+
+        bool TryParse(StringReader& reader, type& result, ExceptionRecord& error) {
+            if constexpr (borrowed)
             {
-                std::string text(reader.GetRemaining());
+                return TryParseView(reader, result, error);
+            }
+            else if (strType == StringArgType::GREEDY_PHRASE)
+            {
+                result = reader.GetRemaining();
                 reader.SetCursor(reader.GetTotalLength());
-                return text;
+                return true;
             }
             else if (strType == StringArgType::SINGLE_WORD)
             {
-                return std::string(reader.ReadUnquotedString());
+                result = reader.ReadUnquotedString();
+                return true;
             }
             else
             {
-                return reader.ReadString();
+                std::string unescaped;
+                std::string_view text;
+                if (!reader.TryReadStringView(unescaped, text, error)) {
+                    return false;
+                }
+                if (text.data() == unescaped.data()) {
+                    result = std::move(unescaped);
+                }
+                else {
+                    result = text;
+                }
+                return true;
             }
         }
 
@@ -127,6 +217,24 @@ namespace brigadier
             }
         }
 
+        static constexpr CharacterSet GetFirstCharacters()
+        {
+            // unquoted strings may be empty, so a separator right away is accepted too
+            constexpr auto unquoted = CharacterSet::Matching(StringReader::IsAllowedInUnquotedString) | CharacterSet::Of(" ");
+            if constexpr (strType == StringArgType::GREEDY_PHRASE)
+            {
+                return CharacterSet::All();
+            }
+            else if constexpr (strType == StringArgType::SINGLE_WORD)
+            {
+                return unquoted;
+            }
+            else
+            {
+                return unquoted | CharacterSet::Matching(StringReader::IsQuotedStringStart);
+            }
+        }
+
         static std::string EscapeIfRequired(std::string_view input) {
             for (auto c : input) {
                 if (!StringReader::IsAllowedInUnquotedString(c)) {
@@ -149,10 +257,42 @@ namespace brigadier
             result += '\"';
             return result;
         }
+    private:
+        static bool TryParseView(StringReader& reader, StringArgumentView& result, ExceptionRecord& error)
+        {
+            if constexpr (strType == StringArgType::GREEDY_PHRASE)
+            {
+                std::string_view text = reader.GetRemaining();
+                reader.SetCursor(reader.GetTotalLength());
+                result = StringArgumentView(text);
+            }
+            else if constexpr (strType == StringArgType::SINGLE_WORD)
+            {
+                result = StringArgumentView(reader.ReadUnquotedString());
+            }
+            else
+            {
+                std::string unescaped;
+                std::string_view text;
+                if (!reader.TryReadStringView(unescaped, text, error)) {
+                    return false;
+                }
+                if (text.data() == unescaped.data()) {
+                    result = StringArgumentView(std::move(unescaped));
+                }
+                else {
+                    result = StringArgumentView(text);
+                }
+            }
+            return true;
+        }
     };
     REGISTER_ARGTYPE_SPEC(StringArgumentType, Word, StringArgType::SINGLE_WORD);
     REGISTER_ARGTYPE_SPEC(StringArgumentType, String, StringArgType::QUOTABLE_PHRASE);
     REGISTER_ARGTYPE_SPEC(StringArgumentType, GreedyString, StringArgType::GREEDY_PHRASE);
+    REGISTER_ARGTYPE_SPEC(StringArgumentType, WordView, StringArgType::SINGLE_WORD, true);
+    REGISTER_ARGTYPE_SPEC(StringArgumentType, StringView, StringArgType::QUOTABLE_PHRASE, true);
+    REGISTER_ARGTYPE_SPEC(StringArgumentType, GreedyStringView, StringArgType::GREEDY_PHRASE, true);
 
     class BoolArgumentType : public ArgumentType<bool>
     {
@@ -171,6 +311,10 @@ namespace brigadier
         {
             return { "true", "false" };
         }
+        static constexpr CharacterSet GetFirstCharacters()
+        {
+            return CharacterSet::Of("tf") | CharacterSet::Matching(StringReader::IsQuotedStringStart);
+        }
     };
     REGISTER_ARGTYPE(BoolArgumentType, Bool);
 
@@ -184,6 +328,16 @@ namespace brigadier
             else throw CommandSyntaxException::BuiltInExceptions::ReaderExpectedValue(reader);
         }
 
+        bool TryParse(StringReader& reader, char& result, ExceptionRecord& error)
+        {
+            if (reader.CanRead()) {
+                result = reader.Read();
+                return true;
+            }
+            error = ExceptionRecord(reader, SyntaxError::ReaderExpectedValue);
+            return false;
+        }
+
         static constexpr std::string_view GetTypeName()
         {
             return "char";
@@ -201,7 +355,7 @@ namespace brigadier
     {
         static_assert(std::is_arithmetic_v<T>, "T must be a number");
     public:
-        ArithmeticArgumentType(T minimum = std::numeric_limits<T>::lowest(), T maximum = std::numeric_limits<T>::max()) : minimum(minimum), maximum(maximum) {}
+        constexpr ArithmeticArgumentType(T minimum = std::numeric_limits<T>::lowest(), T maximum = std::numeric_limits<T>::max()) : minimum(minimum), maximum(maximum) {}
 
         T GetMinimum() {
             return minimum;
@@ -211,18 +365,32 @@ namespace brigadier
         }
 
         T Parse(StringReader& reader)
+        {
+            T result{};
+            ExceptionRecord error;
+            if (!TryParse(reader, result, error)) {
+                throw CommandSyntaxException(error, reader.GetString());
+            }
+            return result;
+        }
+
+        bool TryParse(StringReader& reader, T& result, ExceptionRecord& error)
         {
             int start = reader.GetCursor();
-            T result = reader.ReadValue<T>();
+            if (!reader.TryReadValue<T>(result, error)) {
+                return false;
+            }
             if (result < minimum) {
                 reader.SetCursor(start);
-                throw CommandSyntaxException::BuiltInExceptions::ValueTooLow(reader, result, minimum);
+                error = ExceptionRecord(reader, SyntaxError::ValueTooLow, result, minimum);
+                return false;
             }
             if (result > maximum) {
                 reader.SetCursor(start);
-                throw CommandSyntaxException::BuiltInExceptions::ValueTooHigh(reader, result, maximum);
+                error = ExceptionRecord(reader, SyntaxError::ValueTooHigh, result, maximum);
+                return false;
             }
-            return result;
+            return true;
         }
 
         static constexpr std::string_view GetTypeName()
@@ -252,6 +420,11 @@ namespace brigadier
             }
             else return {};
         }
+
+        static constexpr CharacterSet GetFirstCharacters()
+        {
+            return CharacterSet::Matching(StringReader::IsAllowedNumber<std::is_floating_point_v<T>, std::is_signed_v<T>>);
+        }
     private:
         T minimum;
         T maximum;
@@ -263,6 +436,12 @@ namespace brigadier
     REGISTER_ARGTYPE_TEMPL(ArithmeticArgumentType, Number);
 
 #ifdef HAS_MAGICENUM
+    template<typename T>
+    struct ArgumentTypeParamId<T, std::enable_if_t<std::is_enum_v<T>>>
+    {
+        static constexpr uint32_t value = ArgumentTypeHash(magic_enum::enum_type_name<T>());
+    };
+
     template<typename T>
     class EnumArgumentType : public ArgumentType<T>
     {
@@ -270,14 +449,28 @@ namespace brigadier
     public:
         T Parse(StringReader& reader)
         {
-            int start = reader.GetCursor();
-            auto str = reader.ReadString();
-            auto result = magic_enum::enum_cast<T>(str);
-            if (!result.has_value())
+            T result{};
+            ExceptionRecord error;
+            if (!TryParse(reader, result, error)) {
+                throw CommandSyntaxException(error, reader.GetString());
+            }
+            return result;
+        }
+
+        bool TryParse(StringReader& reader, T& result, ExceptionRecord& error)
+        {
+            std::string str;
+            if (!reader.TryReadString(str, error)) {
+                return false;
+            }
+            auto value = magic_enum::enum_cast<T>(str);
+            if (!value.has_value())
             {
-                throw CommandSyntaxException::BuiltInExceptions::ReaderInvalidValue(reader, str);
+                error = ExceptionRecord(reader, SyntaxError::ReaderInvalidValue, str);
+                return false;
             }
-            return result.value();
+            result = value.value();
+            return true;
         }
 
         template<typename S>
@@ -298,6 +491,11 @@ namespace brigadier
             static constexpr auto names = magic_enum::enum_names<T>();
             return std::vector<std::string_view>(names.begin(), names.end());
         }
+
+        static constexpr CharacterSet GetFirstCharacters()
+        {
+            return CharacterSet::Matching(StringReader::IsAllowedInUnquotedString) | CharacterSet::Matching(StringReader::IsQuotedStringStart);
+        }
     };
     REGISTER_ARGTYPE_TEMPL(EnumArgumentType, Enum);
 #endif
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <cstring>
+#include <stdexcept>
+
+#include "ArgumentRegister.hpp"
+
+namespace brigadier
+{
+    /**
+    Codec of argument type parameters (e.g. bounds of numbers) stored in a CommandTreeImage.
+
+    Trivially copyable argument types are stored as they are. Other types have to provide
+    `void WriteParameters(std::string& out) const` and `static T ReadParameters(std::string_view in)`.
+    */
+    template<typename T, typename = void>
+    struct ArgumentParameters
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Argument type has to be trivially copyable or provide WriteParameters and ReadParameters");
+
+        static void Write(T const& type, std::string& out)
+        {
+            out.append(reinterpret_cast<const char*>(&type), sizeof(T));
+        }
+
+        static T Read(std::string_view in)
+        {
+            if (in.size() != sizeof(T))
+                throw std::runtime_error("Invalid argument type parameters");
+            T type;
+            std::memcpy(static_cast<void*>(&type), in.data(), sizeof(T));
+            return type;
+        }
+    };
+
+    template<typename T>
+    struct ArgumentParameters<T, std::void_t<decltype(&T::WriteParameters), decltype(&T::ReadParameters)>>
+    {
+        static void Write(T const& type, std::string& out)
+        {
+            type.WriteParameters(out);
+        }
+
+        static T Read(std::string_view in)
+        {
+            return T::ReadParameters(in);
+        }
+    };
+
+    // Checks if ArgumentParameters can be used with T.
+    template<typename T, typename = void>
+    struct HasArgumentParameters : std::is_trivially_copyable<T> {};
+    template<typename T>
+    struct HasArgumentParameters<T, std::void_t<decltype(&T::WriteParameters), decltype(&T::ReadParameters)>> : std::true_type {};
+
+    /**
+    Process-wide registry of argument types with stable IDs (see GetArgumentTypeId()).
+    Maps an ID to the registered name and to a codec of type parameters, e.g. to export argument types of a command tree.
+
+    Types are added when the first ArgumentCommandNode of the type is created, or explicitly with Register().
+    Registering two different types with the same ID throws std::runtime_error.
+    */
+    class ArgumentTypeRegistry
+    {
+    public:
+        struct Entry
+        {
+            uint32_t id;
+            std::string_view name;
+            void(*writeParameters)(void const* type, std::string& out); // type points to an object of the registered type
+            void(*readParameters)(std::string_view in, void* type);
+        };
+
+        template<typename T>
+        static uint32_t Register()
+        {
+            static const uint32_t id = Add({ GetArgumentTypeId<T>(), GetArgumentTypeName<T>(), &WriteParameters<T>, &ReadParameters<T> });
+            return id;
+        }
+
+        static Entry const* Find(uint32_t id)
+        {
+            std::lock_guard<std::mutex> lock(GetMutex());
+            auto& entries = GetEntries();
+            auto found = entries.find(id);
+            return found != entries.end() ? &found->second : nullptr;
+        }
+    private:
+        static uint32_t Add(Entry entry)
+        {
+            std::lock_guard<std::mutex> lock(GetMutex());
+            auto [found, added] = GetEntries().emplace(entry.id, entry);
+            if (!added && found->second.writeParameters != entry.writeParameters)
+                throw std::runtime_error("Argument types '" + std::string(found->second.name) + "' and '" + std::string(entry.name) + "' have the same ID");
+            return entry.id;
+        }
+
+        template<typename T>
+        static void WriteParameters(void const* type, std::string& out)
+        {
+            ArgumentParameters<T>::Write(*static_cast<T const*>(type), out);
+        }
+
+        template<typename T>
+        static void ReadParameters(std::string_view in, void* type)
+        {
+            *static_cast<T*>(type) = ArgumentParameters<T>::Read(in);
+        }
+
+        static std::map<uint32_t, Entry>& GetEntries()
+        {
+            static std::map<uint32_t, Entry> entries;
+            return entries;
+        }
+
+        static std::mutex& GetMutex()
+        {
+            static std::mutex mutex;
+            return mutex;
+        }
+    };
+}
@@ -27,6 +27,7 @@ namespace brigadier
         template<template<typename...> typename Next, typename Type = void, typename... Args>
         auto Then(Args&&... args)
         {
+            node->CheckWritable();
             if (node->redirect != nullptr) {
                 throw std::runtime_error("Cannot add children to a redirected node");
             }
@@ -34,7 +35,7 @@ namespace brigadier
             if constexpr (std::is_same_v<Type, void>) {
                 using next_node = typename Next<S>::node_type;
                 next_node node_builder(std::forward<Args>(args)...);
-                auto& name = node_builder.GetName();
+                auto name = node_builder.GetName();
                 auto arg = node->children.find(name);
                 if (arg == node->children.end()) {
                     auto new_node = std::make_shared<next_node>(std::move(node_builder));
@@ -48,14 +49,14 @@ namespace brigadier
                             throw std::runtime_error("Node type (literal/argument) mismatch!");
                         }
                     }
-                    return Next<S>(std::static_pointer_cast<next_node>(arg_ptr));
+                    return Next<S>(std::static_pointer_cast<next_node>(node->GetOwnedChild(name)));
                 }
             }
             else
             {
                 using next_node = typename Next<S, Type>::node_type;
                 next_node node_builder(std::forward<Args>(args)...);
-                auto& name = node_builder.GetName();
+                auto name = node_builder.GetName();
                 auto arg = node->children.find(name);
                 if (arg == node->children.end()) {
                     auto new_node = std::make_shared<next_node>(std::move(node_builder));
@@ -69,7 +70,7 @@ namespace brigadier
                             throw std::runtime_error("Node type (literal/argument) mismatch!");
                         }
                     }
-                    return Next<S, Type>(std::static_pointer_cast<next_node>(arg_ptr));
+                    return Next<S, Type>(std::static_pointer_cast<next_node>(node->GetOwnedChild(name)));
                 }
             }
         }
@@ -83,6 +84,7 @@ namespace brigadier
 
         auto Then(std::shared_ptr<LiteralCommandNode<S>> argument)
         {
+            node->CheckWritable();
             if (node->redirect != nullptr) {
                 throw std::runtime_error("Cannot add children to a redirected node");
             }
@@ -95,6 +97,7 @@ namespace brigadier
         template<typename T>
         auto Then(std::shared_ptr<ArgumentCommandNode<S, T>> argument)
         {
+            node->CheckWritable();
             if (node->redirect != nullptr) {
                 throw std::runtime_error("Cannot add children to a redirected node");
             }
@@ -106,13 +109,25 @@ namespace brigadier
 
         B& Executes(Command<S> command)
         {
+            node->CheckWritable();
             node->command = command;
+            node->Modified();
             return *GetThis();
         }
 
         B& Requires(Predicate<S&> requirement)
         {
+            node->CheckWritable();
             node->requirement = requirement;
+            node->Modified();
+            return *GetThis();
+        }
+
+        B& RequiresPermissions(PermissionMask permissions)
+        {
+            node->CheckWritable();
+            node->permissions = permissions;
+            node->Modified();
             return *GetThis();
         }
 
@@ -140,13 +155,15 @@ namespace brigadier
 
         void Forward(std::shared_ptr<CommandNode<S>> target, RedirectModifier<S> modifier, bool fork)
         {
+            node->CheckWritable();
             if (node->GetChildren().size() > 0)
             {
                 throw std::runtime_error("Cannot forward a node with children");
             }
-            node->redirect = std::move(target);
+            node->SetRedirect(std::move(target));
             node->modifier = modifier;
             node->forks = fork;
+            node->Modified();
         }
     protected:
         template<typename _S, typename _B>
@@ -22,6 +22,7 @@ namespace brigadier
         auto Then(Args&&... args)
         {
             for (auto& node : nodes) {
+                node->CheckWritable();
                 if (node->redirect != nullptr) {
                     throw std::runtime_error("Cannot add children to a redirected node");
                 }
@@ -50,6 +51,7 @@ namespace brigadier
         auto Then(std::shared_ptr<LiteralCommandNode<S>> argument)
         {
             for (auto& node : nodes) {
+                node->CheckWritable();
                 if (node->redirect != nullptr) {
                     throw std::runtime_error("Cannot add children to a redirected node");
                 }
@@ -66,6 +68,7 @@ namespace brigadier
         auto Then(std::shared_ptr<ArgumentCommandNode<S, T>> argument)
         {
             for (auto& node : nodes) {
+                node->CheckWritable();
                 if (node->redirect != nullptr) {
                     throw std::runtime_error("Cannot add children to a redirected node");
                 }
@@ -83,7 +86,9 @@ namespace brigadier
             for (size_t i = 0; i < nodes.size(); ++i) {
                 if (master == -1 || master == i || !only_master) {
                     auto& node = nodes[i];
+                    node->CheckWritable();
                     node->command = command;
+                    node->Modified();
                 }
             }
             return *GetThis();
@@ -94,7 +99,22 @@ namespace brigadier
             for (size_t i = 0; i < nodes.size(); ++i) {
                 if (master == -1 || master == i || !only_master) {
                     auto& node = nodes[i];
+                    node->CheckWritable();
                     node->requirement = requirement;
+                    node->Modified();
+                }
+            }
+            return *GetThis();
+        }
+
+        B& RequiresPermissions(PermissionMask permissions, bool only_master = true)
+        {
+            for (size_t i = 0; i < nodes.size(); ++i) {
+                if (master == -1 || master == i || !only_master) {
+                    auto& node = nodes[i];
+                    node->CheckWritable();
+                    node->permissions = permissions;
+                    node->Modified();
                 }
             }
             return *GetThis();
@@ -127,6 +147,7 @@ namespace brigadier
             for (size_t i = 0; i < nodes.size(); ++i) {
                 if (master == -1 || master == i || !only_master) {
                     auto& node = nodes[i];
+                    node->CheckWritable();
                     if (node->GetChildren().size() > 0)
                     {
                         throw std::runtime_error("Cannot forward a node with children");
@@ -136,9 +157,10 @@ namespace brigadier
             for (size_t i = 0; i < nodes.size(); ++i) {
                 if (master == -1 || master == i || !only_master) {
                     auto& node = nodes[i];
-                    node->redirect = std::move(target);
+                    node->SetRedirect(target);
                     node->modifier = modifier;
                     node->forks = fork;
+                    node->Modified();
                 }
             }
         }
@@ -12,7 +12,7 @@ namespace brigadier
 
         RequiredArgumentBuilder<S, T>& Suggests(SuggestionProvider<S> provider)
         {
-            this->node->suggestionsProvider = provider;
+            this->node->customSuggestions = provider;
             return *this;
         }
     };
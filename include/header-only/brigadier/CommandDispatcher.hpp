@@ -1,10 +1,18 @@
 #pragma once
 
 #include "Tree/RootCommandNode.hpp"
+#include "Tree/CommandTreeImage.hpp"
 #include "Builder/LiteralArgumentBuilder.hpp"
 #include "Builder/RequiredArgumentBuilder.hpp"
+#include "Tree/StaticCommandNode.hpp"
 #include "ParseResults.hpp"
+#include "ExecuteResult.hpp"
+#include "StringTokens.hpp"
+#include "CommandTreeDelta.hpp"
+#include "CommandTreeMemory.hpp"
 #include <set>
+#include <deque>
+#include <unordered_map>
 
 namespace brigadier
 {
@@ -37,15 +45,90 @@ namespace brigadier
         Create a new CommandDispatcher with the specified root node.
         
         This is often useful to copy existing or pre-defined command trees.
+        Only the root is copied, the rest of the tree is shared until either tree modifies it,
+        the same way as by CommandDispatcher(CommandDispatcher const&). Redirects to the existing root are moved to the copy,
+        which also copies the paths to them.
         
         \param root the existing RootCommandNode to use as the basis for this tree
         */
-        CommandDispatcher(RootCommandNode<S>* root) : root(std::make_shared<RootCommandNode<S>>(*root)) {}
+        CommandDispatcher(RootCommandNode<S>* root) : root(std::make_shared<RootCommandNode<S>>(*root)), owner(std::make_shared<CommandTreeOwner>())
+        {
+            if (root->owner != nullptr)
+                root->owner->Seal();
+            this->root->owner = owner;
+
+            ReloadState state{ owner };
+            state.copies.emplace(root, this->root);
+            state.owned.insert(this->root.get());
+            RelinkRedirects(this->root, state);
+        }
+
+        /**
+        Create a new CommandDispatcher that takes over an existing command tree, e.g. one loaded by CommandTreeBinder::ReadImage(CommandTreeImage).
+
+        Unlike CommandDispatcher(RootCommandNode), the root is not copied, so redirects to it stay valid.
+        If the tree is used by another dispatcher as well, it is shared the same way as by CommandDispatcher(CommandDispatcher const&).
+
+        \param root the RootCommandNode of the tree
+        */
+        CommandDispatcher(std::shared_ptr<RootCommandNode<S>> root) : root(root ? std::move(root) : std::make_shared<RootCommandNode<S>>())
+        {
+            if (this->root->owner != nullptr) {
+                this->root->owner->Seal();
+            }
+            else {
+                owner = std::make_shared<CommandTreeOwner>();
+                this->root->Adopt(owner);
+            }
+        }
 
         /**
         Creates a new CommandDispatcher with an empty command tree.
         */
-        CommandDispatcher() : root(std::make_shared<RootCommandNode<S>>()) {}
+        CommandDispatcher() : root(std::make_shared<RootCommandNode<S>>()), owner(std::make_shared<CommandTreeOwner>())
+        {
+            root->owner = owner;
+        }
+
+        /**
+        Creates a copy of a dispatcher in constant time.
+
+        Both dispatchers share the command tree until one of them modifies it. Then only the nodes on the path
+        from the root to the modified node are copied (copy-on-write), together with the paths to nodes redirecting to the root.
+        Builders obtained from either dispatcher before the copy throw std::runtime_error when used to modify the tree,
+        get new ones from the dispatcher instead.
+
+        \param other the dispatcher to copy
+        */
+        CommandDispatcher(CommandDispatcher const& other)
+            : root(other.GetRoot())
+            , consumer(other.consumer)
+            , permissionProvider(other.permissionProvider)
+            , permissionClasses(other.permissionClasses)
+            , parseOptions(other.parseOptions)
+        {
+            // neither dispatcher may modify the shared nodes in place any more
+            if (root->owner != nullptr)
+                root->owner->Seal();
+        }
+
+        CommandDispatcher& operator=(CommandDispatcher const& other)
+        {
+            if (this != &other) {
+                root = other.GetRoot();
+                owner = nullptr;
+                if (root->owner != nullptr)
+                    root->owner->Seal();
+                consumer = other.consumer;
+                permissionProvider = other.permissionProvider;
+                permissionClasses = other.permissionClasses;
+                parseOptions = other.parseOptions;
+            }
+            return *this;
+        }
+
+        CommandDispatcher(CommandDispatcher&&) = default;
+        CommandDispatcher& operator=(CommandDispatcher&&) = default;
 
         /**
         Utility method for registering new commands.
@@ -59,11 +142,12 @@ namespace brigadier
             if constexpr (std::is_same_v<Type, void>) {
                 using next_node = typename Next<S>::node_type;
                 next_node node_builder(std::forward<Args>(args)...);
-                auto& name = node_builder.GetName();
-                auto arg = root->children.find(name);
-                if (arg == root->children.end()) {
+                auto name = node_builder.GetName();
+                auto parent = OwnRoot();
+                auto arg = parent->children.find(name);
+                if (arg == parent->children.end()) {
                     auto new_node = std::make_shared<next_node>(std::move(node_builder));
-                    root->AddChild(new_node);
+                    parent->AddChild(new_node);
                     return Next<S>(std::move(new_node));
                 }
                 else {
@@ -73,17 +157,18 @@ namespace brigadier
                             throw std::runtime_error("Node type (literal/argument) mismatch!");
                         }
                     }
-                    return Next<S>(std::static_pointer_cast<next_node>(arg_ptr));
+                    return Next<S>(std::static_pointer_cast<next_node>(parent->GetOwnedChild(name)));
                 }
             }
             else {
                 using next_node = typename Next<S, Type>::node_type;
                 next_node node_builder(std::forward<Args>(args)...);
-                auto& name = node_builder.GetName();
-                auto arg = root->children.find(name);
-                if (arg == root->children.end()) {
+                auto name = node_builder.GetName();
+                auto parent = OwnRoot();
+                auto arg = parent->children.find(name);
+                if (arg == parent->children.end()) {
                     auto new_node = std::make_shared<next_node>(std::move(node_builder));
-                    root->AddChild(new_node);
+                    parent->AddChild(new_node);
                     return Next<S, Type>(std::move(new_node));
                 }
                 else {
@@ -93,11 +178,114 @@ namespace brigadier
                             throw std::runtime_error("Node type (literal/argument) mismatch!");
                         }
                     }
-                    return Next<S, Type>(std::static_pointer_cast<next_node>(arg_ptr));
+                    return Next<S, Type>(std::static_pointer_cast<next_node>(parent->GetOwnedChild(name)));
                 }
             }
         }
 
+        /**
+        Registers a command declared at compile time, see StaticCommandNode.
+
+        Like every registration this is an append operation. If a command of the same name already exists,
+        the declared nodes are merged into it and parsed the usual way.
+
+        \param tree the declared command
+        \return the builder of the registered node
+        */
+        template<typename... Children>
+        LiteralArgumentBuilder<S> RegisterStatic(StaticLiteral<S, Children...> const& tree)
+        {
+            auto parent = OwnRoot();
+            parent->AddChild(MakeStaticNode(tree));
+            return LiteralArgumentBuilder<S>(std::static_pointer_cast<LiteralCommandNode<S>>(parent->GetOwnedChild(tree.name)));
+        }
+
+        /**
+        Removes a node, usually a command, together with its subtree.
+
+        Redirects pointing into the removed subtree are not changed. They can be found through `dangling`,
+        which receives every node left in this tree that redirects into it. Finding them visits the removed subtree
+        and the parts of the tree that contain redirects, otherwise the cost does not depend on the size of the tree.
+
+        \param path path to the node, see GetPath(CommandNode)
+        \param dangling optional list to append the redirecting nodes to
+        \return the removed node, or nullptr if there is no node at the given path
+        */
+        std::shared_ptr<CommandNode<S>> Unregister(std::vector<std::string> const& path, std::vector<CommandNode<S>*>* dangling = nullptr)
+        {
+            if (path.empty())
+                return nullptr;
+
+            CommandNode<S>* parent = OwnRoot();
+            for (size_t i = 0; i + 1 < path.size(); ++i) {
+                parent = parent->GetOwnedChild(path[i]).get();
+                if (parent == nullptr)
+                    return nullptr;
+            }
+            auto removed = parent->RemoveChild(path.back());
+            if (removed != nullptr && dangling != nullptr) {
+                std::set<CommandNode<S>*> nodes;
+                CollectSubtree(removed.get(), nodes);
+                std::set<CommandNode<S>*> visited;
+                ForEachRedirect(root.get(), visited, [&](CommandNode<S>* source) {
+                    if (nodes.count(source->redirect.get()) != 0)
+                        dangling->push_back(source);
+                });
+            }
+            return removed;
+        }
+
+        /**
+        Replaces a node, usually a command, together with its subtree, without pausing Parse or Execute.
+
+        The new subtree can be built in advance on any thread, e.g. with MakeLiteral(). Nodes on the path from the root
+        to the replaced node are copied, the rest of the tree is shared with the previous version. The new version
+        is then published atomically: Parse and Execute calls in progress, as well as ParseResults created before,
+        keep using the previous version until they finish.
+        Redirects to the copied nodes (e.g. to the root) are moved to the copies, which also copies the path to them.
+        Redirects into the replaced subtree are not changed.
+        The previous version is not modified any more, so builders obtained before throw std::runtime_error when used to modify the tree.
+
+        Calls of Replace must not overlap each other or any other change of the tree. Only Parse and Execute may run concurrently.
+
+        \param path path to the node, see GetPath(CommandNode). The last element has to be the name of `node`
+        \param node the new subtree, or nullptr to remove the node
+        \return the replaced node, or nullptr if there was no node at the given path
+        */
+        std::shared_ptr<CommandNode<S>> Replace(std::vector<std::string> const& path, std::shared_ptr<CommandNode<S>> node)
+        {
+            if (path.empty())
+                throw std::runtime_error("Cannot replace the root node");
+            if (node != nullptr && node->GetName() != path.back())
+                throw std::runtime_error("Node name does not match the path");
+
+            auto current = GetRoot();
+            ReloadState state{ std::make_shared<CommandTreeOwner>() };
+            auto copy = CopyNode(current, state);
+            CommandNode<S>* parent = copy.get();
+            for (size_t i = 0; i + 1 < path.size(); ++i) {
+                auto child = parent->GetChild(path[i]);
+                if (child == nullptr)
+                    throw std::runtime_error("Path does not exist");
+                if (child->redirect != nullptr)
+                    throw std::runtime_error("Cannot add children to a redirected node");
+                auto child_copy = CopyNode(child, state);
+                parent->ReplaceChild(child_copy);
+                parent = child_copy.get();
+            }
+
+            auto replaced = parent->RemoveChild(path.back());
+            parent->AddChild(std::move(node));
+
+            RelinkRedirects(copy, state);
+
+            if (owner != nullptr)
+                owner->Seal();
+            owner = state.owner;
+            std::atomic_store(&root, std::static_pointer_cast<RootCommandNode<S>>(std::move(copy)));
+            return replaced;
+        }
+
         /**
         Sets a callback to be informed of the result of every command.
 
@@ -108,6 +296,48 @@ namespace brigadier
             this->consumer = consumer;
         }
 
+        /**
+        Sets a callback that reports permissions granted to a source.
+
+        It is called once per parse, usage or suggestion request and the result is checked against
+        permissions required by nodes (see ArgumentBuilder::RequiresPermissions(PermissionMask)) without any further calls.
+        Without a provider, sources are granted no permissions.
+
+        \param provider the new permission provider
+        */
+        void SetPermissionProvider(PermissionProvider<S> provider)
+        {
+            this->permissionProvider = provider;
+        }
+
+        /**
+        Changes how commands are parsed, see ParseOptions.
+
+        \param options the new options
+        */
+        void SetParseOptions(ParseOptions options)
+        {
+            this->parseOptions = options;
+        }
+
+        inline ParseOptions const& GetParseOptions() const
+        {
+            return parseOptions;
+        }
+
+        /**
+        Gets permissions granted to a given source by the permission provider.
+
+        \param source a custom "source" object, usually representing the originator of this command
+        \return permission mask of the source
+        */
+        PermissionMask GetPermissions(S const& source) const
+        {
+            if (permissionProvider)
+                return permissionProvider(source);
+            else return 0;
+        }
+
         /**
         Gets the root of this command tree.
 
@@ -119,7 +349,7 @@ namespace brigadier
         */
         std::shared_ptr<RootCommandNode<S>> GetRoot() const
         {
-            return root;
+            return std::atomic_load(&root);
         }
 
         /**
@@ -190,8 +420,11 @@ namespace brigadier
         */
         int Execute(StringReader& input, S source)
         {
-            auto parse = Parse(input, std::move(source));
-            return Execute(parse);
+            typename ExecuteBuffers::Lease buffers;
+            auto tree = GetRoot();
+            auto& parse = Prepare(buffers->parse, source, tree.get(), StringRange::At(input.GetCursor()), input);
+            Parse(std::move(tree), parse);
+            return Execute<true>(parse, *buffers).result;
         }
 
         /**
@@ -222,15 +455,137 @@ namespace brigadier
         */
         int Execute(ParseResults<S>& parse)
         {
+            typename ExecuteBuffers::Lease buffers;
+            return Execute<true>(parse, *buffers).result;
+        }
+
+        /**
+        Parses and executes a given command, reporting failures in the result instead of throwing.
+
+        Failures that Execute(String, Object) would throw as a CommandSyntaxException, including ones thrown by commands, redirect modifiers
+        and the limits of ParseOptions, are returned as ExecuteResult::error and ExecuteResult::cursor.
+        Commands can fail without throwing with CommandContext::Fail(). Other exceptions, such as std::runtime_error, are not caught.
+
+        \param input a command string to parse and execute
+        \param source a custom "source" object, usually representing the originator of this command
+        \return the outcome of the command
+        \see Execute(String, Object)
+        \see TryExecute(ParseResults)
+        */
+        ExecuteResult TryExecute(std::string_view input, S source)
+        {
+            StringReader reader = StringReader(input);
+            return TryExecute(reader, std::move(source));
+        }
+
+        /**
+        Parses and executes a given command, reporting failures in the result instead of throwing.
+
+        Failures that Execute(StringReader, Object) would throw as a CommandSyntaxException, including ones thrown by commands, redirect modifiers
+        and the limits of ParseOptions, are returned as ExecuteResult::error and ExecuteResult::cursor.
+        Commands can fail without throwing with CommandContext::Fail(). Other exceptions, such as std::runtime_error, are not caught.
+
+        \param input a command string to parse and execute
+        \param source a custom "source" object, usually representing the originator of this command
+        \return the outcome of the command
+        \see Execute(StringReader, Object)
+        \see TryExecute(ParseResults)
+        */
+        ExecuteResult TryExecute(StringReader& input, S source)
+        {
+            typename ExecuteBuffers::Lease buffers;
+            auto tree = GetRoot();
+            auto& parse = Prepare(buffers->parse, source, tree.get(), StringRange::At(input.GetCursor()), input);
+            try {
+                Parse(std::move(tree), parse);
+            }
+            catch (CommandSyntaxException const& ex) {
+                ExecuteResult status;
+                return Abort<false>(status, ex);
+            }
+            return Execute<false>(parse, *buffers);
+        }
+
+        /**
+        Executes a given pre-parsed command, reporting failures in the result instead of throwing.
+
+        Failures that Execute(ParseResults) would throw as a CommandSyntaxException, including ones thrown by commands and redirect modifiers,
+        are returned as ExecuteResult::error and ExecuteResult::cursor. Commands can fail without throwing with CommandContext::Fail().
+        Other exceptions, such as std::runtime_error, are not caught.
+
+        \param parse the result of a Parse(StringReader, Object)
+        \return the outcome of the command
+        \see Execute(ParseResults)
+        */
+        ExecuteResult TryExecute(ParseResults<S>& parse)
+        {
+            typename ExecuteBuffers::Lease buffers;
+            return Execute<false>(parse, *buffers);
+        }
+
+    private:
+        // Memory reused by the Execute calls of a thread
+        struct ExecuteBuffers
+        {
+            std::optional<ParseResults<S>> parse; // for Execute(StringReader, Object)
+            std::vector<CommandContext<S>> contexts;
+            std::vector<CommandContext<S>> next;
+
+            // Takes buffers for one call and gives them back afterwards. A command may call Execute again, so each call gets its own.
+            class Lease
+            {
+            public:
+                Lease()
+                {
+                    auto& pool = GetPool();
+                    if (!pool.empty()) {
+                        buffers = std::move(pool.back());
+                        pool.pop_back();
+                    }
+                }
+                ~Lease()
+                {
+                    buffers.contexts.clear();
+                    buffers.next.clear();
+                    Recycle(buffers.parse);
+                    auto& pool = GetPool();
+                    if (pool.size() < CACHED_BUFFERS) {
+                        pool.reserve(CACHED_BUFFERS);
+                        pool.push_back(std::move(buffers));
+                    }
+                }
+                Lease(Lease const&) = delete;
+                Lease& operator=(Lease const&) = delete;
+
+                inline ExecuteBuffers& operator*() { return buffers; }
+                inline ExecuteBuffers* operator->() { return &buffers; }
+            private:
+                static std::vector<ExecuteBuffers>& GetPool()
+                {
+                    static thread_local std::vector<ExecuteBuffers> pool;
+                    return pool;
+                }
+
+                ExecuteBuffers buffers;
+            };
+
+            static constexpr size_t CACHED_BUFFERS = 4; // per thread, enough for a few nested calls
+        };
+
+        // Runs a parsed command. A failure that ends the execution is thrown if `Throws`, otherwise it is returned.
+        template<bool Throws>
+        ExecuteResult Execute(ParseResults<S>& parse, ExecuteBuffers& buffers)
+        {
+            ExecuteResult status;
             if (parse.GetReader().CanRead()) {
-                if (parse.GetExceptions().size() == 1) {
-                    throw *parse.GetExceptions().begin();
+                if (auto error = GetSingleException(parse)) {
+                    return Abort<Throws>(status, *error, parse.GetReader().GetString());
                 }
                 else if (parse.GetContext().GetRange().IsEmpty()) {
-                    throw CommandSyntaxException::BuiltInExceptions::DispatcherUnknownCommand(parse.GetReader());
+                    return Abort<Throws>(status, SyntaxError::DispatcherUnknownCommand, parse.GetReader());
                 }
                 else {
-                    throw CommandSyntaxException::BuiltInExceptions::DispatcherUnknownArgument(parse.GetReader());
+                    return Abort<Throws>(status, SyntaxError::DispatcherUnknownArgument, parse.GetReader());
                 }
             }
 
@@ -241,8 +596,9 @@ namespace brigadier
             auto command = parse.GetReader().GetString();
             auto original = parse.GetContext();
             original.WithInput(command);
-            std::vector<CommandContext<S>> contexts = { original };
-            std::vector<CommandContext<S>> next;
+            std::vector<CommandContext<S>>& contexts = buffers.contexts;
+            std::vector<CommandContext<S>>& next = buffers.next;
+            contexts.push_back(original);
 
             while (!contexts.empty()) {
                 for (auto& context : contexts) {
@@ -266,8 +622,9 @@ namespace brigadier
                                 catch (CommandSyntaxException const& ex) {
                                     consumer(context, false, 0);
                                     if (!forked) {
-                                        throw ex;
+                                        return Abort<Throws>(status, ex);
                                     }
+                                    Record(status, ex);
                                 }
                             }
                         }
@@ -275,30 +632,118 @@ namespace brigadier
                         foundCommand = true;
                         try {
                             int value = context.GetCommand()(context);
-                            result += value;
-                            consumer(context, true, value);
-                            successfulForks++;
+                            if (!context.HasFailed()) {
+                                result += value;
+                                consumer(context, true, value);
+                                successfulForks++;
+                                continue;
+                            }
                         }
                         catch (CommandSyntaxException const& ex) {
                             consumer(context, false, 0);
                             if (!forked) {
-                                throw ex;
+                                return Abort<Throws>(status, ex);
                             }
+                            Record(status, ex);
+                            continue;
+                        }
+                        // failed with CommandContext::Fail()
+                        consumer(context, false, 0);
+                        if (!forked) {
+                            return Abort<Throws>(status, SyntaxError::DispatcherCommandFailed, nullptr);
                         }
+                        Record(status, SyntaxError::DispatcherCommandFailed, -1);
                     }
                 }
 
-                contexts = std::move(next);
+                contexts.swap(next);
+                next.clear();
             }
 
             if (!foundCommand) {
                 consumer(original, false, 0);
-                throw CommandSyntaxException::BuiltInExceptions::DispatcherUnknownCommand(parse.GetReader());
+                return Abort<Throws>(status, SyntaxError::DispatcherUnknownCommand, parse.GetReader());
             }
 
-            return forked ? successfulForks : result;
+            status.result = forked ? successfulForks : result;
+            status.successes = successfulForks;
+            return status;
         }
 
+        // Record of GetExceptions().begin()->second if there is exactly one exception, without creating the map
+        static ExceptionRecord const* GetSingleException(ParseResults<S> const& parse)
+        {
+            if (parse.errors.empty())
+                return nullptr;
+            for (auto& [node, record] : parse.errors) {
+                if (node != parse.errors.front().node)
+                    return nullptr;
+            }
+            return &parse.errors.front().record;
+        }
+
+        template<bool Throws>
+        static ExecuteResult Abort(ExecuteResult& status, CommandSyntaxException const& ex)
+        {
+            if constexpr (Throws) {
+                throw ex;
+            }
+            else {
+                Record(status, ex);
+                status.result = 0;
+                status.failed = true;
+                return status;
+            }
+        }
+
+        // Same as Abort() with the exception of a record, which is created only if it is thrown
+        template<bool Throws>
+        static ExecuteResult Abort(ExecuteResult& status, ExceptionRecord const& record, std::string_view input)
+        {
+            if constexpr (Throws) {
+                throw CommandSyntaxException(record, input);
+            }
+            else {
+                Record(status, record.GetError(), record.GetCursor());
+                status.result = 0;
+                status.failed = true;
+                return status;
+            }
+        }
+
+        // Same as Abort() with a built-in exception of the dispatcher, which is created only if it is thrown
+        template<bool Throws>
+        static ExecuteResult Abort(ExecuteResult& status, SyntaxError error, ExceptionContext ctx)
+        {
+            if constexpr (Throws) {
+                switch (error) {
+                case SyntaxError::DispatcherUnknownCommand:  throw CommandSyntaxException::BuiltInExceptions::DispatcherUnknownCommand(ctx);
+                case SyntaxError::DispatcherUnknownArgument: throw CommandSyntaxException::BuiltInExceptions::DispatcherUnknownArgument(ctx);
+                default:                                     throw CommandSyntaxException::BuiltInExceptions::DispatcherCommandFailed(ctx);
+                }
+            }
+            else {
+                Record(status, error, ctx.cursor);
+                status.result = 0;
+                status.failed = true;
+                return status;
+            }
+        }
+
+        static void Record(ExecuteResult& status, CommandSyntaxException const& ex)
+        {
+            Record(status, ex.GetError(), ex.GetCursor());
+        }
+
+        static void Record(ExecuteResult& status, SyntaxError error, int cursor)
+        {
+            if (status.failures++ == 0) {
+                status.error = error;
+                status.cursor = cursor;
+            }
+        }
+
+    public:
         /**
         Parses a given command.
 
@@ -348,6 +793,7 @@ namespace brigadier
         You may inspect ParseResults::GetExceptions() if you know the parse failed, as it will explain why it could
         not find any valid commands. It may contain multiple exceptions, one for each "potential node" that it could have visited,
         explaining why it did not go down that node.
+        The only exception is a parse exceeding the limits set in ParseOptions, which throws a CommandSyntaxException.
 
         When you eventually call Execute(ParseResults) with the result of this method, the above error checking
         will occur. You only need to inspect it yourself if you wish to handle that yourself.
@@ -361,97 +807,474 @@ namespace brigadier
         */
         ParseResults<S> Parse(StringReader& command, S source)
         {
-            ParseResults<S> result(CommandContext<S>(std::move(source), root.get(), command.GetCursor()), command);
-            ParseNodes(root.get(), result);
+            auto tree = GetRoot();
+            ParseResults<S> result(CommandContext<S>(std::move(source), tree.get(), command.GetCursor()), command);
+            Parse(std::move(tree), result);
             return result;
         }
 
+        /**
+        Parses a given command into the results of an earlier parse.
+
+        This is the same as Parse(String, Object), but the memory of `result` is reused instead of allocating new results.
+        Callers parsing many commands can keep one ParseResults, e.g. per thread, and parse every command into it.
+        If the context of `result` is still shared, e.g. with a copy made by a command, `result` gets a new context instead.
+
+        \param result results to overwrite, from an earlier call to Parse(String, Object) or this method
+        \param command a command string to parse
+        \param source a custom "source" object, usually representing the originator of this command
+        \see Parse(String, Object)
+        \see Execute(ParseResults)
+        */
+        void ParseInto(ParseResults<S>& result, std::string_view command, S source)
+        {
+            StringReader reader = StringReader(command);
+            ParseInto(result, reader, std::move(source));
+        }
+
+        /**
+        Parses a given command into the results of an earlier parse.
+
+        This is the same as Parse(StringReader, Object), but the memory of `result` is reused instead of allocating new results.
+        Callers parsing many commands can keep one ParseResults, e.g. per thread, and parse every command into it.
+        If the context of `result` is still shared, e.g. with a copy made by a command, `result` gets a new context instead.
+
+        \param result results to overwrite, from an earlier call to Parse(StringReader, Object) or this method
+        \param command a command string to parse
+        \param source a custom "source" object, usually representing the originator of this command
+        \see Parse(StringReader, Object)
+        \see Execute(ParseResults)
+        */
+        void ParseInto(ParseResults<S>& result, StringReader& command, S source)
+        {
+            auto tree = GetRoot();
+            if (IsReusable(result))
+                result.Reset(std::move(source), tree.get(), command.GetCursor(), command);
+            else
+                result = ParseResults<S>(CommandContext<S>(std::move(source), tree.get(), command.GetCursor()), command);
+            Parse(std::move(tree), result);
+        }
+
     private:
-        void ParseNodes(CommandNode<S>* node, ParseResults<S>& result)
+        void Parse(std::shared_ptr<RootCommandNode<S>> tree, ParseResults<S>& result)
         {
-            if (!node)
+            // tokens are pooled like the frames, nested parses use the next ones
+            ParseStack& stack = GetParseStack();
+            if (stack.parses == stack.tokens.size())
+                stack.tokens.emplace_back();
+            StringTokens& tokens = stack.tokens[stack.parses++];
+            struct Release
+            {
+                ParseStack& stack;
+                StringTokens& tokens;
+                StringReader& reader;
+                ~Release()
+                {
+                    reader.SetTokens(nullptr);
+                    tokens.Trim(ParseStack::CACHED_WORDS);
+                    --stack.parses;
+                }
+            } release{ stack, tokens, result.reader };
+
+            tokens.Tokenize(result.reader.GetString());
+            result.reader.SetTokens(&tokens);
+            ParseState state{ tokens, GetPermissions(result.context.GetSource()) };
+            state.budget.maxVisits = parseOptions.maxNodeVisits;
+            if (parseOptions.maxTime > std::chrono::microseconds::zero()) {
+                state.budget.timed = true;
+                state.budget.deadline = std::chrono::steady_clock::now() + parseOptions.maxTime;
+            }
+            ParseNodes(tree.get(), result, state);
+            result.tree = std::move(tree);
+        }
+
+        // Result of parsing below a node at a position, see ParseOptions::memoize
+        struct ParseMemo
+        {
+            bool matched = false; // the context contains the best potential, otherwise only exceptions are reported
+            int cursor = 0;
+            CommandContext<S> context;
+            typename ParseResults<S>::Errors exceptions;
+        };
+
+        // Data shared by all levels of one Parse call. The source does not change while parsing, so neither do its permissions.
+        struct ParseState
+        {
+            StringTokens const& tokens;
+            PermissionMask permissions = 0;
+            std::map<std::pair<CommandNode<S>*, int>, ParseMemo> memo;
+            ParseBudget budget;
+            size_t redirectDepth = 0;
+        };
+
+        // Branches on the node kind so that literals are matched inline and arguments call the parse function of their type directly.
+        // Literals and built-in argument types report failures in `error`, other nodes throw them.
+        static inline bool ParseChild(CommandNode<S>* child, StringReader& reader, CommandContext<S>& context, ExceptionRecord& error)
+        {
+            switch (child->GetNodeType()) {
+            case CommandNodeType::LiteralCommandNode:
+                return static_cast<LiteralCommandNode<S>*>(child)->TryParseLiteral(reader, context, error);
+            case CommandNodeType::ArgumentCommandNode:
+                return static_cast<IArgumentCommandNode<S>*>(child)->TryParseArgument(reader, context, error);
+            default:
+                child->Parse(reader, context);
+                return true;
+            }
+        }
+
+        // Parses a child and checks that it ends before a separator. Returns false with the failure in `error`,
+        // exceptions of custom argument types are caught here, so the candidates of built-in types are tried without any.
+        static inline bool ParseCandidate(CommandNode<S>* child, StringReader& reader, CommandContext<S>& context, ExceptionRecord& error)
+        {
+            try {
+                if (!ParseChild(child, reader, context, error))
+                    return false;
+            }
+            catch (CommandSyntaxException const& ex) {
+                error = ExceptionRecord(ex);
+                return false;
+            }
+            catch (std::runtime_error const& ex) {
+                error = ExceptionRecord(reader, SyntaxError::DispatcherParseException, ex.what());
+                return false;
+            }
+            if (reader.CanRead() && reader.Peek() != ARGUMENT_SEPARATOR_CHAR) {
+                error = ExceptionRecord(reader, SyntaxError::DispatcherExpectedArgumentSeparator);
+                return false;
+            }
+            return true;
+        }
+
+        // Checks if the child is an argument whose type cannot parse input starting with `next` (-1 at the end of input)
+        static inline bool IsInadmissible(CommandNode<S>* child, int next)
+        {
+            return next >= 0 && child->GetNodeType() == CommandNodeType::ArgumentCommandNode
+                && !static_cast<IArgumentCommandNode<S>*>(child)->CanStartWith(char(next));
+        }
+
+        enum class ParseStep
+        {
+            Candidates, // trying children of the node
+            Child, // waiting for the subtree of the current candidate
+            Redirect // waiting for the redirect target of the current candidate, which ends this level
+        };
+
+        // One level of ParseNodes, kept on an explicit stack instead of the call stack
+        struct ParseFrame
+        {
+            CommandNode<S>* node = nullptr;
+            ParseResults<S>* result = nullptr; // receives the outcome of this level
+            ParseResults<S>* target = nullptr; // with memoization `result` points to `scratch`, and the stored outcome is applied to `target`
+            std::optional<ParseResults<S>> scratch;
+            std::optional<ParseResults<S>> best_potential;
+            bool has_best_potential = false; // best_potential may hold recycled storage only
+            std::optional<ParseResults<S>> current_result_ctx;
+            std::optional<ParseResults<S>> redirect_result;
+            std::shared_ptr<CommandNode<S>>* relevant_nodes = nullptr;
+            size_t relevant_node_count = 0;
+            size_t index = 0; // of the current candidate in relevant_nodes
+            size_t redirect_scan = 0; // in fast mode, candidates before it have been checked for redirects, see IsFinished()
+            int cursor = 0;
+            int next = -1;
+            bool skipped = false;
+            ParseStep step = ParseStep::Candidates;
+        };
+
+        // Frames of all parses on a thread. Nested parses (e.g. from a requirement) continue above the frames of the outer one.
+        struct ParseStack
+        {
+            static constexpr size_t CACHED_FRAMES = 64; // kept allocated between parses
+            static constexpr size_t CACHED_WORDS = 1024; // same for the words of long inputs
+
+            std::deque<ParseFrame> frames; // references stay valid when frames are added
+            size_t size = 0;
+            std::deque<StringTokens> tokens; // one per parse in progress
+            size_t parses = 0;
+        };
+
+        static ParseStack& GetParseStack()
+        {
+            static thread_local ParseStack stack;
+            return stack;
+        }
+
+        void ParseNodes(CommandNode<S>* node, ParseResults<S>& result, ParseState& state)
+        {
+            ParseStack& stack = GetParseStack();
+            size_t base = stack.size;
+            struct Unwind
+            {
+                ParseStack& stack;
+                size_t base;
+                ~Unwind()
+                {
+                    while (stack.size > base) {
+                        RecycleFrame(stack.frames[--stack.size]);
+                    }
+                    if (base == 0 && stack.frames.size() > ParseStack::CACHED_FRAMES) {
+                        stack.frames.resize(ParseStack::CACHED_FRAMES);
+                    }
+                }
+            } unwind{ stack, base };
+
+            if (!PushFrame(stack, node, result, state))
                 return;
 
-            S& source = result.context.GetSource();
+            while (stack.size > base) {
+                ParseFrame& frame = stack.frames[stack.size - 1];
+                ParseResults<S>& level = *frame.result;
+
+                if (frame.step == ParseStep::Redirect) {
+                    --state.redirectDepth;
+                    level.context.Merge(std::move(frame.current_result_ctx->context));
+                    level.context.WithChildContext(std::move(frame.redirect_result->context));
+                    level.SetExceptions(std::move(frame.redirect_result->errors));
+                    level.reader = std::move(frame.redirect_result->reader);
+                    PopFrame(stack, state);
+                    continue;
+                }
+                if (frame.step == ParseStep::Child) {
+                    frame.step = ParseStep::Candidates;
+                    KeepBest(frame);
+                    ++frame.index;
+                }
+                if (ParseCandidates(frame, stack, state))
+                    continue;
 
-            std::optional<ParseResults<S>> best_potential = {};
-            std::optional<ParseResults<S>> current_result_ctx = {}; // delay initialization
+                if (frame.has_best_potential) {
+                    level.ClearExceptions();
+                    level.reader = std::move(frame.best_potential->reader);
+                    level.context.Merge(std::move(frame.best_potential->context));
+                }
+                else if (frame.skipped && !parseOptions.fastMode) {
+                    ReportSkipped(frame, state);
+                }
+                PopFrame(stack, state);
+            }
+        }
+
+        // Starts parsing below a node. Returns false if the outcome is already known, so no frame was added.
+        bool PushFrame(ParseStack& stack, CommandNode<S>* node, ParseResults<S>& result, ParseState& state)
+        {
+            if (!node)
+                return false;
 
             int cursor = result.reader.GetCursor();
+            if (parseOptions.memoize) {
+                auto memo = state.memo.find(std::make_pair(node, cursor));
+                if (memo != state.memo.end()) {
+                    ApplyMemo(memo->second, result);
+                    return false;
+                }
+            }
 
-            auto [relevant_nodes, relevant_node_count] = node->GetRelevantNodes(result.reader);
+            if (stack.size == stack.frames.size())
+                stack.frames.emplace_back();
+            ParseFrame& frame = stack.frames[stack.size++];
+            frame.node = node;
+            frame.target = &result;
+            if (parseOptions.memoize) {
+                frame.scratch.emplace(CommandContext<S>(result.context.GetSource(), result.context.GetRootNode(), cursor), result.reader);
+                frame.result = &*frame.scratch;
+            }
+            else frame.result = &result;
+
+            auto [relevant_nodes, relevant_node_count] = node->GetRelevantNodes(state.tokens.GetWord(cursor));
+            frame.relevant_nodes = relevant_nodes;
+            frame.relevant_node_count = relevant_node_count;
+            frame.index = 0;
+            frame.redirect_scan = 0;
+            frame.cursor = cursor;
+            frame.next = result.reader.CanRead() ? static_cast<unsigned char>(result.reader.Peek()) : -1;
+            frame.skipped = false;
+            frame.has_best_potential = false;
+            frame.step = ParseStep::Candidates;
+            return true;
+        }
 
-            for (size_t i = 0; i < relevant_node_count; ++i) {
-                auto& child = relevant_nodes[i];
+        // Finishes the top frame, storing its outcome if memoization is enabled
+        void PopFrame(ParseStack& stack, ParseState& state)
+        {
+            ParseFrame& frame = stack.frames[stack.size - 1];
+            if (frame.scratch.has_value()) {
+                ParseResults<S>& scratch = *frame.scratch;
+                bool matched = scratch.context.HasNodes();
+                int cursor = scratch.reader.GetCursor();
+                auto memo = state.memo.emplace(std::make_pair(frame.node, frame.cursor), ParseMemo{ matched, cursor, std::move(scratch.context), std::move(scratch.errors) }).first;
+                ApplyMemo(memo->second, *frame.target);
+            }
+            RecycleFrame(frame);
+            --stack.size;
+        }
 
-                if (!child->CanUse(source)) {
-                    continue;
+        // Frames keep the storage of their candidates for the next node parsed at the same depth, on this or a later parse.
+        // Parsed data and the source are released right away, so a pooled frame does not keep e.g. a player handle alive.
+        static void RecycleFrame(ParseFrame& frame)
+        {
+            frame.scratch.reset();
+            Recycle(frame.best_potential);
+            Recycle(frame.current_result_ctx);
+            Recycle(frame.redirect_result);
+        }
+
+        static void Recycle(std::optional<ParseResults<S>>& slot)
+        {
+            if (!slot.has_value())
+                return;
+            if (!IsReusable(*slot)) {
+                // the context was handed over, e.g. as the child context of a redirect
+                slot.reset();
+                return;
+            }
+            if constexpr (!std::is_default_constructible_v<S>) {
+                // the source cannot be released without the context holding it
+                slot.reset();
+                return;
+            }
+            else {
+                slot->ClearExceptions();
+                slot->tree = nullptr;
+                slot->context.Reset();
+                slot->context.source = S();
+            }
+        }
+
+        static bool IsReusable(ParseResults<S> const& results)
+        {
+            return results.context.context && results.context.context.use_count() == 1;
+        }
+
+        // Resets a candidate to the state of the parent, reusing its storage if there is any
+        static ParseResults<S>& Prepare(std::optional<ParseResults<S>>& slot, S const& source, CommandNode<S>* root, StringRange range, StringReader const& reader)
+        {
+            if (slot.has_value() && IsReusable(*slot))
+                slot->Reset(source, root, range, reader);
+            else
+                slot.emplace(CommandContext<S>(source, root, range), reader);
+            return *slot;
+        }
+
+        static void ApplyMemo(ParseMemo const& memo, ParseResults<S>& result)
+        {
+            if (memo.matched) {
+                result.SetExceptions(memo.exceptions);
+                result.reader.SetCursor(memo.cursor);
+                result.context.Merge(memo.context.Clone());
+            }
+            else {
+                for (auto& [child, ex] : memo.exceptions) {
+                    result.AddException(child, ex);
                 }
+            }
+        }
+
+        static void KeepBest(ParseFrame& frame)
+        {
+            // swapped rather than moved, because a moved-from context still shares its data with the new owner,
+            // and resetting it for the next candidate would clear the best potential
+            if (!frame.has_best_potential || frame.current_result_ctx->IsBetterThan(*frame.best_potential)) {
+                std::swap(frame.best_potential, frame.current_result_ctx);
+                frame.has_best_potential = true;
+            }
+        }
 
-                // initialize current context
-                if (current_result_ctx.has_value()) {
-                    // context already exists so we have to reset it (avoid memory reallocation)
-                    current_result_ctx->Reset(source, result.context.GetRootNode(), result.GetContext().GetRange(), result.GetReader());
+        // In fast mode, a candidate that parsed the rest of the input without errors ends the frame, because ParseResults::IsBetterThan
+        // would not prefer any later sibling over it. A later sibling with a redirect is not compared though, it takes over the level
+        // once parsed (see ParseNodes()), so the frame goes on while any remaining candidate has one.
+        inline bool IsFinished(ParseFrame& frame) const
+        {
+            if (!parseOptions.fastMode || !frame.has_best_potential || frame.best_potential->reader.CanRead() || frame.best_potential->HasExceptions())
+                return false;
+            // each candidate is checked once, the scan stops at the next redirect until the candidates reach it
+            for (; frame.redirect_scan < frame.relevant_node_count; ++frame.redirect_scan) {
+                if (frame.redirect_scan >= frame.index && frame.relevant_nodes[frame.redirect_scan]->redirect != nullptr)
+                    return false;
+            }
+            return true;
+        }
+
+        // Tries the remaining candidates of a frame. Returns true when it has to wait for a subtree or a redirect target first.
+        bool ParseCandidates(ParseFrame& frame, ParseStack& stack, ParseState& state)
+        {
+            ParseResults<S>& result = *frame.result;
+            S& source = result.context.GetSource();
+
+            for (; frame.index < frame.relevant_node_count; ++frame.index) {
+                if (IsFinished(frame)) {
+                    frame.index = frame.relevant_node_count;
+                    break;
                 }
-                else {
-                    // create context
-                    current_result_ctx = ParseResults<S>(CommandContext<S>(source, result.GetContext().GetRootNode(), result.GetContext().GetRange()), result.GetReader());
+                auto& child = frame.relevant_nodes[frame.index];
+
+                if (IsInadmissible(child.get(), frame.next)) {
+                    frame.skipped = true;
+                    continue;
                 }
 
-                auto& current_result = current_result_ctx.value();
+                if (!child->CanUse(source, state.permissions)) {
+                    continue;
+                }
+
+                state.budget.Visit(result.reader);
+
+                // the current and the best candidate swap their storage, so no sibling allocates a new context
+                auto& current_result = Prepare(frame.current_result_ctx, source, result.context.GetRootNode(), result.GetContext().GetRange(), result.GetReader());
 
                 StringReader& reader = current_result.reader;
                 CommandContext<S>& context = current_result.context;
 
-                try {
-                    try {
-                        child->Parse(reader, context);
-                    }
-                    catch (std::runtime_error const& ex) {
-                        throw CommandSyntaxException::BuiltInExceptions::DispatcherParseException(reader, ex.what());
-                    }
-                    if (reader.CanRead() && reader.Peek() != ARGUMENT_SEPARATOR_CHAR) {
-                        throw CommandSyntaxException::BuiltInExceptions::DispatcherExpectedArgumentSeparator(reader);
-                    }
-                }
-                catch (CommandSyntaxException ex) {
-                    result.exceptions.emplace(child.get(), std::move(ex));
-                    reader.SetCursor(cursor);
+                ExceptionRecord error;
+                if (!ParseCandidate(child.get(), reader, context, error)) {
+                    if (!parseOptions.fastMode)
+                        result.AddException(child.get(), std::move(error));
+                    reader.SetCursor(frame.cursor);
                     continue;
                 }
 
                 context.WithCommand(child->GetCommand());
 
-                if (reader.CanRead(child->GetRedirect() == nullptr ? 2 : 1)) {
+                // most nodes have no redirect, so the target is only looked up for the ones that have
+                CommandNode<S>* redirect = child->redirect == nullptr ? nullptr : child->GetRedirect().get();
+                if (reader.CanRead(redirect == nullptr ? 2 : 1)) {
                     reader.Skip();
-                    if (child->GetRedirect() != nullptr) {
-                        ParseResults<S> child_result(CommandContext<S>(source, child->GetRedirect().get(), reader.GetCursor()), reader);
-                        ParseNodes(child->GetRedirect().get(), child_result);
-                        result.context.Merge(std::move(context));
-                        result.context.WithChildContext(std::move(child_result.context));
-                        result.exceptions = std::move(child_result.exceptions);
-                        result.reader = std::move(child_result.reader);
-                        return;
+                    if (redirect != nullptr) {
+                        if (parseOptions.maxRedirectDepth > 0 && state.redirectDepth >= parseOptions.maxRedirectDepth) {
+                            throw CommandSyntaxException::BuiltInExceptions::DispatcherParseBudgetExceeded(reader, "redirect limit");
+                        }
+                        Prepare(frame.redirect_result, source, redirect, StringRange::At(reader.GetCursor()), reader);
+                        ++state.redirectDepth;
+                        frame.step = ParseStep::Redirect;
+                        PushFrame(stack, redirect, *frame.redirect_result, state);
+                        return true;
                     }
-                    else {
-                        ParseNodes(child.get(), current_result);
+                    else if (!child->ParseCompiled(reader, context, state.permissions, state.budget)) {
+                        frame.step = ParseStep::Child;
+                        PushFrame(stack, child.get(), current_result, state);
+                        return true;
                     }
                 }
 
-                if (best_potential.has_value()) {
-                    if (current_result.IsBetterThan(*best_potential)) {
-                        best_potential = std::move(current_result_ctx);
-                    }
-                }
-                else {
-                    best_potential = std::move(current_result_ctx);
-                }
+                KeepBest(frame);
             }
+            return false;
+        }
 
-            if (best_potential.has_value()) {
-                result.exceptions.clear();
-                result.reader = std::move(best_potential->reader);
-                result.context.Merge(std::move(best_potential->context));
+        // Nothing matched, so the skipped arguments are parsed after all to explain why they failed
+        void ReportSkipped(ParseFrame& frame, ParseState& state)
+        {
+            ParseResults<S>& result = *frame.result;
+            S& source = result.context.GetSource();
+            for (size_t i = 0; i < frame.relevant_node_count; ++i) {
+                auto& child = frame.relevant_nodes[i];
+                if (!IsInadmissible(child.get(), frame.next) || !child->CanUse(source, state.permissions)) {
+                    continue;
+                }
+
+                auto& candidate = Prepare(frame.current_result_ctx, source, result.context.GetRootNode(), result.GetContext().GetRange(), result.GetReader());
+                ExceptionRecord error;
+                if (!ParseCandidate(child.get(), candidate.reader, candidate.context, error)) {
+                    result.AddException(child.get(), std::move(error));
+                }
             }
         }
 
@@ -478,18 +1301,24 @@ namespace brigadier
         std::vector<std::string> GetAllUsage(CommandNode<S>* node, S source, bool restricted)
         {
             std::vector<std::string> result;
-            GetAllUsage(node, std::move(source), result, {}, restricted);
+            PermissionMask permissions = GetPermissions(source);
+            GetAllUsage(node, std::move(source), permissions, result, {}, restricted);
             return result;
         }
 
     private:
-        void GetAllUsage(CommandNode<S>* node, S source, std::vector<std::string>& result, std::string prefix, bool restricted)
+        void GetAllUsage(CommandNode<S>* node, S source, PermissionMask permissions, std::vector<std::string>& result, std::string prefix, bool restricted)
         {
             if (!node)
                 return;
 
-            if (restricted && !node->CanUse(source))
-                return;
+            if (restricted) {
+                if (!node->CanUse(source, permissions))
+                    return;
+                // whole subtree is usable, no need to check nodes below
+                if (node->CanUseSubtree(permissions))
+                    restricted = false;
+            }
 
             if (node->GetCommand())
                 result.push_back(prefix);
@@ -516,7 +1345,7 @@ namespace brigadier
                         next_prefix += ARGUMENT_SEPARATOR;
                     }
                     next_prefix += child->GetUsageText();
-                    GetAllUsage(child.get(), std::move(source), result, std::move(next_prefix), restricted);
+                    GetAllUsage(child.get(), source, permissions, result, std::move(next_prefix), restricted);
                 }
             }
         }
@@ -544,9 +1373,10 @@ namespace brigadier
         std::map<CommandNode<S>*, std::string> GetSmartUsage(CommandNode<S>* node, S source)
         {
             std::map<CommandNode<S>*, std::string> result;
+            PermissionMask permissions = GetPermissions(source);
 
             for (auto const& [name, child] : node->GetChildren()) {
-                std::string usage = GetSmartUsage(child.get(), std::move(source), node->GetCommand() != nullptr, false);
+                std::string usage = GetSmartUsage(child.get(), source, permissions, node->GetCommand() != nullptr, false);
                 if (!usage.empty()) {
                     result[child.get()] = std::move(usage);
                 }
@@ -555,12 +1385,12 @@ namespace brigadier
         }
 
     private:
-        std::string GetSmartUsage(CommandNode<S>* node, S source, bool optional, bool deep)
+        std::string GetSmartUsage(CommandNode<S>* node, S source, PermissionMask permissions, bool optional, bool deep)
         {
             if (!node)
                 return {};
 
-            if (!node->CanUse(source))
+            if (!node->CanUse(source, permissions))
                 return {};
 
             std::string self;
@@ -591,12 +1421,12 @@ namespace brigadier
                 else {
                     std::vector<CommandNode<S>*> children;
                     for (auto const& [name, child] : node->GetChildren()) {
-                        if (child->CanUse(source)) {
+                        if (child->CanUse(source, permissions)) {
                             children.push_back(child.get());
                         }
                     }
                     if (children.size() == 1) {
-                        std::string usage = GetSmartUsage(children[0], source, childOptional, childOptional);
+                        std::string usage = GetSmartUsage(children[0], source, permissions, childOptional, childOptional);
                         if (!usage.empty()) {
                             self += ARGUMENT_SEPARATOR;
                             self += std::move(usage);
@@ -606,7 +1436,7 @@ namespace brigadier
                     else if (children.size() > 1) {
                         std::set<std::string> childUsage;
                         for (auto child : children) {
-                            std::string usage = GetSmartUsage(child, source, childOptional, true);
+                            std::string usage = GetSmartUsage(child, source, permissions, childOptional, true);
                             if (!usage.empty()) {
                                 childUsage.insert(usage);
                             }
@@ -686,7 +1516,8 @@ namespace brigadier
         */
         std::future<Suggestions> GetCompletionSuggestions(ParseResults<S>& parse, int cursor, bool* cancel = nullptr)
         {
-            return std::async(std::launch::async, [](ParseResults<S>* parse, int cursor, bool* cancel) {
+            PermissionMask permissions = GetPermissions(parse.GetContext().GetSource());
+            return std::async(std::launch::async, [](ParseResults<S>* parse, int cursor, PermissionMask permissions, bool* cancel) {
                 auto context = parse->GetContext();
 
                 SuggestionContext<S> nodeBeforeCursor = context.FindSuggestionContext(cursor);
@@ -706,6 +1537,8 @@ namespace brigadier
                 futures.reserve(max_size);
                 builders.reserve(max_size);
                 for (auto const& [name, node] : parent->GetChildren()) {
+                    if (!node->HasPermissions(permissions))
+                        continue;
                     try {
                         builders.emplace_back(truncatedInput, truncatedInputLowerCase, start, cancel);
                         futures.push_back(node->ListSuggestions(context, builders.back()));
@@ -719,7 +1552,7 @@ namespace brigadier
                     suggestions.emplace_back(future.get());
                 }
                 return Suggestions::Merge(fullInput, suggestions);
-            }, &parse, cursor, cancel);
+            }, &parse, cursor, permissions, cancel);
         }
 
         /**
@@ -747,7 +1580,7 @@ namespace brigadier
                     result.reserve(list.size());
                     for (auto node : list) {
                         if (node != root.get()) {
-                            result.push_back(node->GetName());
+                            result.emplace_back(node->GetName());
                         }
                     }
                     return result;
@@ -771,7 +1604,7 @@ namespace brigadier
         CommandNode<S>* FindNode(std::vector<std::string> const& path) {
             CommandNode<S>* node = root.get();
             for (auto& name : path) {
-                node = node->GetChild(name);
+                node = node->GetChild(name).get();
                 if (node == nullptr) {
                     return nullptr;
                 }
@@ -795,6 +1628,522 @@ namespace brigadier
             root->FindAmbiguities(consumer);
         }
 
+    public:
+        /**
+        Defines a permission class: a group of sources that are granted the same permissions, such as an operator level.
+
+        Sources of the same class share one filtered view of the command tree (see GetFilteredRoot(size_t)),
+        instead of filtering the whole tree for each of them. Redefining a class with different permissions invalidates its view.
+
+        \param id identifier of the class
+        \param permissions permissions granted to sources of this class
+        */
+        void SetPermissionClass(size_t id, PermissionMask permissions)
+        {
+            auto& permissionClass = permissionClasses[id];
+            if (permissionClass.root != nullptr && permissionClass.permissions == permissions)
+                return;
+            permissionClass.permissions = permissions;
+            permissionClass.root = nullptr;
+        }
+
+        /**
+        Removes a permission class together with its cached view.
+
+        \param id identifier of the class
+        */
+        void RemovePermissionClass(size_t id)
+        {
+            permissionClasses.erase(id);
+        }
+
+        /**
+        Gets a read-only view of the command tree, containing only the nodes usable with permissions of a given permission class.
+
+        The view is built on first use and cached until either the command tree or the class changes.
+        Subtrees fully usable by the class are shared with the command tree, the remaining nodes are copies.
+        Shared subtrees are copied before the command tree modifies them, the same way as nodes shared with a copy of the dispatcher,
+        so builders obtained before cannot modify them any more (see CommandDispatcher(CommandDispatcher const&)).
+        Predicate requirements (ArgumentBuilder::Requires(Predicate)) cannot be checked without a source, so nodes having them are kept.
+        Redirects point to nodes of the view, or nowhere if their target is not a part of it.
+
+        The view cannot be modified.
+
+        \param id identifier of the class
+        \return root of the filtered tree, or nullptr if the class is not defined
+        */
+        std::shared_ptr<RootCommandNode<S>> GetFilteredRoot(size_t id)
+        {
+            auto found = permissionClasses.find(id);
+            if (found == permissionClasses.end())
+                return nullptr;
+
+            auto& permissionClass = found->second;
+            auto current = GetRoot();
+            size_t revision = current->GetSubtreeRevision();
+            if (permissionClass.root == nullptr || permissionClass.revision != revision) {
+                permissionClass.root = FilterTree(current, permissionClass.permissions);
+                permissionClass.revision = revision;
+            }
+            return permissionClass.root;
+        }
+
+    public:
+        /**
+        Gets the current version of the command tree.
+
+        The version grows with every change of the tree: added or removed nodes and changed commands, requirements or redirects.
+        Pass it to GetDelta(size_t) later to find out what changed since.
+
+        \return version of the command tree
+        */
+        size_t GetVersion()
+        {
+            return root->GetSubtreeRevision();
+        }
+
+        /**
+        Computes changes made to the command tree since a given version.
+
+        Only subtrees that changed since that version are visited, so the result is proportional to the number of changes.
+        Added and removed nodes are reported once for their whole subtree. The delta is net: a node added and removed again
+        since that version is not reported, and a node removed and added again is reported as added, which replaces it.
+        Version 0 reports every command as added.
+
+        Each node remembers about as many removed children as it has children, plus a fixed number. If older removals were
+        forgotten, the node is reported as added instead, with an empty path for the root.
+
+        \param since a version previously returned by GetVersion()
+        \return changes between the given and the current version
+        */
+        CommandTreeDelta<S> GetDelta(size_t since)
+        {
+            CommandTreeDelta<S> delta(since, GetVersion());
+            std::vector<std::string> path;
+            if (root->removedHorizon > since)
+                delta.entries.push_back({ CommandTreeChange::Added, path, root });
+            else
+                CollectDelta(root.get(), since, path, delta);
+            return delta;
+        }
+
+        /**
+        Forgets removals made before a given version.
+
+        Removed nodes are remembered by their parents, so that GetDelta(size_t) can report them. Their number is bounded,
+        see GetDelta(size_t), so calling this is optional. Call it once no one will ask for a delta since an older version. Visits the whole tree.
+
+        \param version the oldest version deltas will be computed from
+        */
+        void PruneDeltaHistory(size_t version)
+        {
+            PruneDeltaHistory(root.get(), version);
+        }
+
+    public:
+        /**
+        Merges structurally identical subtrees of the command tree, e.g. the same argument chains registered under many literals.
+
+        Nodes are identical if they have the same name, type, argument type parameters, custom suggestions, command,
+        requirements and redirect, and their children are identical. Merged nodes have several parents, so they are copied
+        before being modified through any of them, the same way as nodes shared by copies of a dispatcher.
+        Nodes of argument types that cannot be compared (see ArgumentParameters) and redirect targets are kept as they are.
+
+        Visits the whole tree once. It is best called after the tree is built, before the dispatcher is copied.
+
+        \return estimated number of bytes freed, counted the same way as by MemoryStats(size_t)
+        */
+        size_t Deduplicate()
+        {
+            OwnRoot();
+            DeduplicationState state{ { owner } };
+            std::set<CommandNode<S>*> visited;
+            ForEachRedirect(root.get(), visited, [&state](CommandNode<S>* source) { state.targets.insert(source->redirect.get()); });
+            DeduplicateNode(root, state);
+            RelinkRedirects(root, state.reload);
+            return state.saved;
+        }
+
+    public:
+        /**
+        Walks the command tree and estimates how much memory it uses.
+
+        \param fanOutCount number of nodes with the most children to report
+        \return memory used by nodes of each type, their strings, containers and control blocks
+        */
+        CommandTreeMemoryStats MemoryStats(size_t fanOutCount = 10)
+        {
+            CommandTreeMemoryStats stats;
+            std::set<CommandNode<S>*> visited;
+            std::set<std::string_view> names;
+            std::vector<std::string> path;
+            CountMemory(GetRoot().get(), stats, fanOutCount, visited, names, path);
+            for (auto name : names) {
+                stats.stringBytes += StringInterner::GetMemoryUsage(name);
+            }
+            return stats;
+        }
+
+    private:
+        // Names are collected in a set, so a name used by several nodes is counted once
+        void CountMemory(CommandNode<S>* node, CommandTreeMemoryStats& stats, size_t fanOutCount, std::set<CommandNode<S>*>& visited, std::set<std::string_view>& names, std::vector<std::string>& path)
+        {
+            if (!visited.insert(node).second)
+                return;
+
+            CountNodeMemory(node, stats);
+            names.insert(node->name);
+            for (auto& [name, removed] : node->removedChildren) {
+                names.insert(name);
+            }
+            switch (node->GetNodeType()) {
+            case CommandNodeType::RootCommandNode:     ++stats.rootNodes;     break;
+            case CommandNodeType::LiteralCommandNode:  ++stats.literalNodes;  names.insert(static_cast<LiteralCommandNode<S>*>(node)->lowerCase); break;
+            case CommandNodeType::ArgumentCommandNode: ++stats.argumentNodes; break;
+            }
+
+            auto& fanOut = stats.largestFanOut;
+            size_t children = node->children.size();
+            if (children > 0 && (fanOut.size() < fanOutCount || children > fanOut.back().children)) {
+                auto position = std::upper_bound(fanOut.begin(), fanOut.end(), children, [](size_t count, auto const& entry) { return count > entry.children; });
+                fanOut.insert(position, { path, children });
+                if (fanOut.size() > fanOutCount)
+                    fanOut.pop_back();
+            }
+
+            for (auto& [name, child] : node->children) {
+                path.emplace_back(name);
+                CountMemory(child.get(), stats, fanOutCount, visited, names, path);
+                path.pop_back();
+            }
+        }
+
+        // Counts memory used by a node alone, without its children and names, see CommandTreeMemoryStats.
+        // Used by MemoryStats() and to estimate the memory freed by Deduplicate().
+        static void CountNodeMemory(CommandNode<S>* node, CommandTreeMemoryStats& stats)
+        {
+            // layouts of the standard library are not visible, these are the sizes used by the common implementations
+            constexpr size_t CONTROL_BLOCK_SIZE = sizeof(void*) + 2 * sizeof(long); // virtual table and both counters, allocated with the node by std::make_shared
+            constexpr size_t MAP_NODE_SIZE = 3 * sizeof(void*) + sizeof(void*) + sizeof(typename decltype(node->children)::value_type); // links, color and the entry
+            stats.objectBytes += node->GetObjectSize();
+            stats.controlBlockBytes += CONTROL_BLOCK_SIZE;
+            stats.containerBytes += node->children.size() * MAP_NODE_SIZE;
+            stats.containerBytes += node->literals.capacity() * sizeof(node->literals[0]);
+            stats.containerBytes += node->arguments.capacity() * sizeof(node->arguments[0]);
+            stats.containerBytes += node->removedChildren.size() * (4 * sizeof(void*) + sizeof(typename decltype(node->removedChildren)::value_type));
+            stats.containerBytes += node->parents.capacity() * sizeof(node->parents[0]);
+        }
+
+    private:
+        void PruneDeltaHistory(CommandNode<S>* node, size_t version)
+        {
+            auto& removed = node->removedChildren;
+            for (auto entry = removed.begin(); entry != removed.end();) {
+                if (entry->second.removed <= version)
+                    entry = removed.erase(entry);
+                else
+                    ++entry;
+            }
+            for (auto& [name, child] : node->children) {
+                PruneDeltaHistory(child.get(), version);
+            }
+        }
+
+        void CollectDelta(CommandNode<S>* node, size_t since, std::vector<std::string>& path, CommandTreeDelta<S>& delta)
+        {
+            for (auto& [name, removed] : node->removedChildren) {
+                // children added after `since` did not exist then, and children added again are reported as added below
+                if (removed.attached <= since && removed.removed > since && node->children.count(name) == 0) {
+                    path.emplace_back(name);
+                    delta.entries.push_back({ CommandTreeChange::Removed, path, nullptr });
+                    path.pop_back();
+                }
+            }
+            for (auto& [name, child] : node->children) {
+                if (child->GetSubtreeRevision() <= since)
+                    continue;
+
+                path.emplace_back(name);
+                if (child->attachRevision > since || child->removedHorizon > since) {
+                    delta.entries.push_back({ CommandTreeChange::Added, path, child });
+                }
+                else {
+                    if (child->revision > since) {
+                        delta.entries.push_back({ CommandTreeChange::Changed, path, child });
+                    }
+                    CollectDelta(child.get(), since, path, delta);
+                }
+                path.pop_back();
+            }
+        }
+
+    private:
+        static void CollectSubtree(CommandNode<S>* node, std::set<CommandNode<S>*>& nodes)
+        {
+            if (!nodes.insert(node).second)
+                return;
+            for (auto& [name, child] : node->children) {
+                CollectSubtree(child.get(), nodes);
+            }
+        }
+
+        // Calls `visit` for every node of the tree that has a redirect, skipping subtrees without any
+        template<typename F>
+        static void ForEachRedirect(CommandNode<S>* node, std::set<CommandNode<S>*>& visited, F&& visit)
+        {
+            if (!node->subtree.redirect || !visited.insert(node).second)
+                return;
+            if (node->redirect != nullptr)
+                visit(node);
+            for (auto& [name, child] : node->children) {
+                ForEachRedirect(child.get(), visited, visit);
+            }
+        }
+
+        // Gets the root for modification, copying it first if it is shared with another dispatcher
+        RootCommandNode<S>* OwnRoot()
+        {
+            if (owner == nullptr || owner->IsSealed() || root->owner != owner) {
+                owner = std::make_shared<CommandTreeOwner>();
+                ReloadState state{ owner };
+                auto copy = CopyNode(root, state);
+                RelinkRedirects(copy, state);
+                std::atomic_store(&root, std::static_pointer_cast<RootCommandNode<S>>(std::move(copy)));
+            }
+            return root.get();
+        }
+
+        struct ReloadState
+        {
+            std::shared_ptr<CommandTreeOwner> owner; // owner of the copies
+            std::map<CommandNode<S>*, std::shared_ptr<CommandNode<S>>> copies; // original -> copy
+            std::set<CommandNode<S>*> owned; // copies that are not published yet, so they can be modified
+        };
+
+        static std::shared_ptr<CommandNode<S>> CopyNode(std::shared_ptr<CommandNode<S>> const& node, ReloadState& state)
+        {
+            auto copy = node->Clone();
+            copy->owner = state.owner;
+            state.copies.emplace(node.get(), copy);
+            state.owned.insert(copy.get());
+            return copy;
+        }
+
+        // Moves redirects of the tree to copies of their targets
+        static void RelinkRedirects(std::shared_ptr<CommandNode<S>> const& root, ReloadState& state)
+        {
+            // copies of redirecting nodes may be redirect targets themselves, so repeat until nothing is copied
+            size_t copied;
+            do {
+                copied = state.copies.size();
+                std::map<CommandNode<S>*, std::shared_ptr<CommandNode<S>>> visited;
+                RelinkRedirects(root, state, visited);
+            } while (state.copies.size() != copied);
+        }
+
+        // Moves redirects below `node` to copies of their targets, copying shared nodes on the way. Returns the node to use in place of `node`.
+        // Subtrees without redirects are skipped.
+        static std::shared_ptr<CommandNode<S>> RelinkRedirects(std::shared_ptr<CommandNode<S>> const& node, ReloadState& state,
+            std::map<CommandNode<S>*, std::shared_ptr<CommandNode<S>>>& visited)
+        {
+            auto found = visited.find(node.get());
+            if (found != visited.end())
+                return found->second;
+
+            std::shared_ptr<CommandNode<S>> result = node;
+            auto own = [&] {
+                if (state.owned.count(result.get()) == 0)
+                    result = CopyNode(node, state);
+            };
+            if (node->redirect != nullptr) {
+                auto target = state.copies.find(node->redirect.get());
+                if (target != state.copies.end()) {
+                    own();
+                    result->RelinkRedirect(target->second);
+                }
+            }
+            for (auto& [name, child] : node->children) {
+                if (!child->subtree.redirect)
+                    continue;
+                auto relinked = RelinkRedirects(child, state, visited);
+                if (relinked != child) {
+                    own();
+                    result->ReplaceChild(std::move(relinked));
+                }
+            }
+            visited.emplace(node.get(), result);
+            return result;
+        }
+
+    private:
+        struct DeduplicationState
+        {
+            ReloadState reload;
+            std::unordered_map<std::string, std::shared_ptr<CommandNode<S>>> nodes; // structure -> first node with it
+            std::map<CommandNode<S>*, std::shared_ptr<CommandNode<S>>> visited; // node -> node to use in its place
+            std::set<CommandNode<S>*> shared;
+            std::set<CommandNode<S>*> targets; // redirect targets, which are never merged
+            size_t saved = 0;
+        };
+
+        // Returns the node identical to `node` that is used in its place
+        std::shared_ptr<CommandNode<S>> DeduplicateNode(std::shared_ptr<CommandNode<S>> const& node, DeduplicationState& state)
+        {
+            auto found = state.visited.find(node.get());
+            if (found != state.visited.end())
+                return found->second;
+
+            std::shared_ptr<CommandNode<S>> result = node;
+            for (auto& [name, child] : node->children) {
+                auto identical = DeduplicateNode(child, state);
+                if (identical != child) {
+                    if (result->owner != state.reload.owner)
+                        result = CopyNode(node, state.reload);
+                    result->ReplaceChild(std::move(identical));
+                }
+            }
+
+            std::string key;
+            if (node != root && WriteNodeKey(result.get(), key)) {
+                bool target = state.targets.count(node.get()) != 0;
+                auto [first, added] = state.nodes.emplace(std::move(key), result);
+                if (!added && !target) {
+                    CommandTreeMemoryStats stats;
+                    CountNodeMemory(result.get(), stats);
+                    state.saved += stats.GetTotalBytes();
+                    MarkShared(first->second.get(), state.shared);
+                    result = first->second;
+                }
+            }
+            state.visited.emplace(node.get(), result);
+            return result;
+        }
+
+        static bool WriteNodeKey(CommandNode<S>* node, std::string& key)
+        {
+            auto append = [&key](auto const& value) { key.append(reinterpret_cast<const char*>(&value), sizeof(value)); };
+            append(node->GetNodeType());
+            append(node->command);
+            append(node->requirement);
+            append(node->redirect.get());
+            append(node->modifier);
+            append(node->forks);
+            append(node->permissions);
+            append(node->GetName().size());
+            key += node->GetName();
+            if (node->GetNodeType() == CommandNodeType::ArgumentCommandNode) {
+                if (!static_cast<IArgumentCommandNode<S>*>(node)->WriteArgumentKey(key))
+                    return false;
+            }
+            // literals are looked up by name, but arguments are tried in order
+            for (auto& [name, child] : node->children) {
+                if (child->GetNodeType() == CommandNodeType::LiteralCommandNode)
+                    append(child.get());
+            }
+            for (auto& argument : node->arguments) {
+                append(static_cast<CommandNode<S>*>(argument.get()));
+            }
+            return true;
+        }
+
+        // Nodes with several parents cannot be modified in place by any of them, and neither can nodes below them.
+        // Nodes that are not writable already are left as they are, they may be read by other dispatchers.
+        static void MarkShared(CommandNode<S>* node, std::set<CommandNode<S>*>& shared)
+        {
+            if (!node->IsWritable() || !shared.insert(node).second)
+                return;
+            node->owner = CommandTreeOwner::Shared();
+            for (auto& [name, child] : node->children) {
+                MarkShared(child.get(), shared);
+            }
+        }
+
+    private:
+        static std::shared_ptr<RootCommandNode<S>> FilterTree(std::shared_ptr<RootCommandNode<S>> const& root, PermissionMask permissions)
+        {
+            std::map<CommandNode<S>*, std::shared_ptr<CommandNode<S>>> copies;
+            std::vector<CommandNode<S>*> shared;
+            auto filtered = std::static_pointer_cast<RootCommandNode<S>>(FilterNode(root, permissions, copies, shared));
+
+            // redirects into shared subtrees are kept, the others are resolved once all shared subtrees are known
+            std::set<CommandNode<S>*> targets;
+            for (auto& [original, copy] : copies) {
+                if (copy->redirect == nullptr)
+                    continue;
+                auto target = copies.find(copy->redirect.get());
+                if (target != copies.end())
+                    copy->RelinkRedirect(target->second);
+                else
+                    targets.insert(copy->redirect.get());
+            }
+            if (!targets.empty()) {
+                std::set<CommandNode<S>*> visited;
+                for (auto node : shared)
+                    FindTargets(node, targets, visited);
+                for (auto& [original, copy] : copies) {
+                    if (copy->redirect != nullptr && targets.count(copy->redirect.get()) != 0)
+                        copy->SetRedirect(nullptr);
+                }
+            }
+
+            // shared subtrees must not change in place under the view, and the copies are read-only
+            std::set<CommandNode<S>*> marked;
+            for (auto node : shared)
+                MarkShared(node, marked);
+            for (auto& [original, copy] : copies)
+                copy->owner = CommandTreeOwner::Shared();
+            return filtered;
+        }
+
+        static std::shared_ptr<CommandNode<S>> FilterNode(std::shared_ptr<CommandNode<S>> const& node, PermissionMask permissions,
+            std::map<CommandNode<S>*, std::shared_ptr<CommandNode<S>>>& copies, std::vector<CommandNode<S>*>& shared)
+        {
+            // nodes added by MultiArgumentBuilder may have several parents
+            auto found = copies.find(node.get());
+            if (found != copies.end())
+                return found->second;
+
+            if (node->GetNodeType() != CommandNodeType::RootCommandNode && !node->subtree.redirect && (node->subtree.permissions & ~permissions) == 0) {
+                shared.push_back(node.get());
+                return node;
+            }
+
+            auto copy = node->Clone();
+            copy->children.clear();
+            copy->literals.clear();
+            copy->arguments.clear();
+            copy->removedChildren.clear(); // deltas are computed for the dispatcher's tree only
+            copies.emplace(node.get(), copy);
+
+            for (auto& literal : node->literals) {
+                if (literal->HasPermissions(permissions)) {
+                    auto child = FilterNode(literal, permissions, copies, shared);
+                    copy->children.emplace(child->GetName(), child);
+                    copy->literals.emplace_back(std::static_pointer_cast<LiteralCommandNode<S>>(std::move(child)));
+                }
+            }
+            for (auto& argument : node->arguments) {
+                if (argument->HasPermissions(permissions)) {
+                    auto child = FilterNode(argument, permissions, copies, shared);
+                    copy->children.emplace(child->GetName(), child);
+                    copy->arguments.emplace_back(std::static_pointer_cast<IArgumentCommandNode<S>>(std::move(child)));
+                }
+            }
+            copy->UpdateSubtree();
+            return copy;
+        }
+
+        // Removes nodes found in the subtree from `targets`
+        static void FindTargets(CommandNode<S>* node, std::set<CommandNode<S>*>& targets, std::set<CommandNode<S>*>& visited)
+        {
+            if (targets.empty() || !visited.insert(node).second)
+                return;
+            targets.erase(node);
+            for (auto& [name, child] : node->children) {
+                FindTargets(child.get(), targets, visited);
+            }
+        }
+
     private:
         void AddPaths(CommandNode<S>* node, std::vector<std::vector<CommandNode<S>*>>& result, std::vector<CommandNode<S>*> parents) {
             parents.push_back(node);
@@ -807,6 +2156,17 @@ namespace brigadier
 
     private:
         std::shared_ptr<RootCommandNode<S>> root;
+        std::shared_ptr<CommandTreeOwner> owner; // allowed to modify the nodes of root in place, unless sealed
         ResultConsumer<S> consumer = [](CommandContext<S>& context, bool success, int result) {};
+        PermissionProvider<S> permissionProvider = nullptr;
+
+        struct PermissionClass
+        {
+            PermissionMask permissions = 0;
+            size_t revision = 0;
+            std::shared_ptr<RootCommandNode<S>> root;
+        };
+        std::map<size_t, PermissionClass> permissionClasses;
+        ParseOptions parseOptions;
     };
 }
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Tree/CommandNode.hpp"
+
+#include <vector>
+
+namespace brigadier
+{
+    enum class CommandTreeChange
+    {
+        Added,      // node (with its whole subtree) was added, replacing the node with the same path if there was one
+        Removed,    // node (with its whole subtree) was removed, only the path is reported
+        Changed     // command, requirements or redirect of the node were changed
+    };
+
+    /**
+    Changes made to a command tree between two versions, see CommandDispatcher::GetDelta(size_t).
+
+    \param <S> a custom "source" type, such as a user or originator of a command
+    */
+    template<typename S>
+    class CommandTreeDelta
+    {
+    public:
+        struct Entry
+        {
+            CommandTreeChange change;
+            std::vector<std::string> path;
+            std::shared_ptr<CommandNode<S>> node;
+        };
+    public:
+        CommandTreeDelta(size_t from, size_t to) : from(from), to(to) {}
+    public:
+        inline size_t GetFrom() const { return from; }
+        inline size_t GetTo()   const { return to;   }
+        inline std::vector<Entry> const& GetEntries() const { return entries; }
+        inline bool IsEmpty() const { return entries.empty(); }
+    private:
+        template<typename _S>
+        friend class CommandDispatcher;
+
+        size_t from;
+        size_t to;
+        std::vector<Entry> entries;
+    };
+}
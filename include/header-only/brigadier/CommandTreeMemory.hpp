@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace brigadier
+{
+    /**
+    Approximate memory used by a command tree, see CommandDispatcher::MemoryStats(size_t).
+
+    The figures are estimates. Objects and vectors are counted exactly from sizeof and capacity(), while nodes of
+    children maps and std::shared_ptr control blocks, whose layout is up to the standard library, are counted with
+    the sizes used by the common implementations. Allocator overhead is not included.
+    Nodes with several parents are counted once.
+    */
+    struct CommandTreeMemoryStats
+    {
+        struct FanOut
+        {
+            std::vector<std::string> path;
+            size_t children;
+        };
+
+        size_t rootNodes = 0;
+        size_t literalNodes = 0;
+        size_t argumentNodes = 0;
+
+        size_t objectBytes = 0;       // node objects
+        size_t stringBytes = 0;       // names of the nodes stored by StringInterner, each counted once
+        size_t containerBytes = 0;    // children maps and vectors
+        size_t controlBlockBytes = 0; // std::shared_ptr control blocks of nodes
+
+        std::vector<FanOut> largestFanOut; // nodes with the most children, largest first
+
+        inline size_t GetNodeCount() const { return rootNodes + literalNodes + argumentNodes; }
+        inline size_t GetTotalBytes() const { return objectBytes + stringBytes + containerBytes + controlBlockBytes; }
+    };
+}
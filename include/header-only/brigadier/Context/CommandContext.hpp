@@ -17,6 +17,8 @@ namespace brigadier
     class CommandNode;
     template<typename S, typename T>
     class ArgumentCommandNode;
+    template<typename S, typename Tree>
+    class StaticCommandNode;
     namespace detail
     {
         template<typename S>
@@ -27,8 +29,30 @@ namespace brigadier
     class CommandContext
     {
     public:
-        CommandContext(S source, CommandNode<S>* root, int start) : source(std::move(source)), context(std::make_unique<detail::CommandContextInternal<S>>(root, start)) {}
-        CommandContext(S source, CommandNode<S>* root, StringRange range) : source(std::move(source)), context(std::make_unique<detail::CommandContextInternal<S>>(root, range)) {}
+        CommandContext(S source, CommandNode<S>* root, int start) : source(std::move(source)), context(std::make_shared<detail::CommandContextInternal<S>>(root, start)) {}
+        CommandContext(S source, CommandNode<S>* root, StringRange range) : source(std::move(source)), context(std::make_shared<detail::CommandContextInternal<S>>(root, range)) {}
+        // Copies share the parsed data. Moves are cheaper, they do not touch the reference count while parsing.
+        CommandContext(CommandContext const&) = default;
+        CommandContext(CommandContext&& other)
+            : source(std::move(other.source))
+            , input(other.input)
+            , context(std::move(other.context))
+            , failed(other.failed)
+        {
+            if (context && context->child.has_value() && context->child->context)
+                context->child->context->parent = this;
+        }
+        CommandContext& operator=(CommandContext const&) = default;
+        CommandContext& operator=(CommandContext&& other)
+        {
+            source = std::move(other.source);
+            input = other.input;
+            context = std::move(other.context);
+            failed = other.failed;
+            if (context && context->child.has_value() && context->child->context)
+                context->child->context->parent = this;
+            return *this;
+        }
 
         inline CommandContext<S> GetFor(S source) const;
         inline CommandContext<S>* GetChild() const;
@@ -49,6 +73,14 @@ namespace brigadier
         inline bool HasNodes() const;
         inline bool IsForked() const;
 
+        /**
+        Reports that the command failed, without throwing an exception. The value returned by the command is ignored,
+        and CommandDispatcher::Execute handles the failure like a thrown CommandSyntaxException::BuiltInExceptions::DispatcherCommandFailed.
+        \return 0, so that a command can `return ctx.Fail();`
+        */
+        inline int Fail() { failed = true; return 0; }
+        inline bool HasFailed() const { return failed; }
+
         template<typename ArgType>
         typename ArgType::type GetArgument(std::string_view name);
         template<typename ArgType>
@@ -67,6 +99,7 @@ namespace brigadier
         {
             detail::CommandContextInternal<S>& ctx = *context;
             input = {};
+            failed = false;
             ctx.arguments.clear();
             ctx.command = nullptr;
             ctx.nodes.clear();
@@ -98,17 +131,23 @@ namespace brigadier
     protected:
         SuggestionContext<S> FindSuggestionContext(int cursor);
 
-        void Merge(CommandContext<S> other);
+        // Moves the parsed data of `other` to this context. `other` keeps its storage, so it can be reset and reused.
+        void Merge(CommandContext<S>&& other);
+        // Copies the parsed data and child contexts, unlike the copy constructor, which shares them
+        CommandContext<S> Clone() const;
     private:
         friend class CommandDispatcher<S>;
         friend class LiteralCommandNode<S>;
         friend class CommandNode<S>;
         template<typename _S, typename T>
         friend class ArgumentCommandNode;
+        template<typename _S, typename Tree>
+        friend class StaticCommandNode;
 
         S source;
         std::string_view input = {};
         std::shared_ptr<detail::CommandContextInternal<S>> context = nullptr;
+        bool failed = false; // see Fail()
     };
 
     namespace detail
@@ -122,7 +161,7 @@ namespace brigadier
         protected:
             friend class CommandContext<S>;
 
-            std::map<std::string, std::shared_ptr<IParsedArgument<S>>, std::less<>> arguments;
+            std::map<std::string_view, std::shared_ptr<IParsedArgument<S>>, std::less<>> arguments; // keys are interned node names
             Command<S> command = nullptr;
             CommandNode<S>* rootNode = nullptr;
             std::vector<ParsedCommandNode<S>> nodes;
@@ -283,10 +322,19 @@ namespace brigadier
     {
         if (context)
         {
-            if (context->child.has_value())
+            if (context->child.has_value() && context->child->context)
             {
                 context->child->context->parent = nullptr;
             }
+            // contexts of long redirect chains are released one by one instead of recursively
+            if (context.use_count() == 1)
+            {
+                std::optional<CommandContext<S>> next = std::move(context->child);
+                while (next.has_value() && next->context && next->context.use_count() == 1) {
+                    std::optional<CommandContext<S>> after = std::move(next->context->child);
+                    next = std::move(after);
+                }
+            }
         }
     }
 
@@ -375,7 +423,25 @@ namespace brigadier
     }
 
     template<typename S>
-    void CommandContext<S>::Merge(CommandContext<S> other)
+    CommandContext<S> CommandContext<S>::Clone() const
+    {
+        CommandContext<S> result(source, context->rootNode, context->range);
+        result.input = input;
+        detail::CommandContextInternal<S>& ctx = *result.context;
+        ctx.arguments = context->arguments;
+        ctx.command = context->command;
+        ctx.nodes = context->nodes;
+        ctx.modifier = context->modifier;
+        ctx.forks = context->forks;
+        if (context->child.has_value() && context->child->context) {
+            ctx.child = context->child->Clone();
+            ctx.child->context->parent = &result;
+        }
+        return result;
+    }
+
+    template<typename S>
+    void CommandContext<S>::Merge(CommandContext<S>&& other)
     {
         detail::CommandContextInternal<S>* ctx = other.GetInternalContext();
         for (auto& arg : ctx->arguments)
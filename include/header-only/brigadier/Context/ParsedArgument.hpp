@@ -1,14 +1,27 @@
 #pragma once
 
 #include "StringRange.hpp"
+#include "../Arguments/ArgumentRegister.hpp"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <type_traits>
 
 namespace brigadier
 {
     struct TypeInfo
     {
         TypeInfo(size_t hash) : hash(hash) {}
+        // Stable ID for types registered with REGISTER_ARGTYPE* macros. Other types are told apart by address of their name.
         template<typename ArgType>
-        static constexpr size_t Create() { return (((uintptr_t)((const char*)ArgType::GetTypeName().data())) + (sizeof(typename ArgType::type) << 24) + (sizeof(ArgType) << 8)); }
+        static constexpr size_t Create()
+        {
+            if constexpr (HasArgumentTypeId<ArgType>::value)
+                return GetArgumentTypeId<ArgType>();
+            else
+                return (((uintptr_t)((const char*)ArgType::GetTypeName().data())) + (sizeof(typename ArgType::type) << 24) + (sizeof(ArgType) << 8)) | (size_t(1) << (sizeof(size_t) * 8 - 1));
+        }
         inline bool operator==(TypeInfo const& other) { return hash == other.hash; }
         inline bool operator!=(TypeInfo const& other) { return hash != other.hash; }
         size_t hash = 0;
@@ -37,9 +50,36 @@ namespace brigadier
         ParsedArgument(const int start, const int end, T result) : IParsedArgument<S>(start, end, TypeInfo(TypeInfo::Create<ArgType>())), result(std::move(result)) {}
         virtual ~ParsedArgument() = default;
 
+        /**
+        Same as std::make_shared, but reuses an argument of this type made on this thread once no context holds it any more.
+        Only results that own no resources are reused, so an argument kept for reuse keeps nothing alive.
+        */
+        static std::shared_ptr<ParsedArgument> Make(int start, int end, T result)
+        {
+            if constexpr (std::is_trivially_destructible_v<T> && std::is_move_assignable_v<T>) {
+                static thread_local std::array<std::shared_ptr<ParsedArgument>, POOLED> pool;
+                for (auto& pooled : pool) {
+                    if (pooled == nullptr) {
+                        pooled = std::make_shared<ParsedArgument>(start, end, std::move(result));
+                        return pooled;
+                    }
+                    if (pooled.use_count() == 1) {
+                        // the last context may have released it on another thread
+                        std::atomic_thread_fence(std::memory_order_acquire);
+                        pooled->range = StringRange(start, end);
+                        pooled->result = std::move(result);
+                        return pooled;
+                    }
+                }
+            }
+            return std::make_shared<ParsedArgument>(start, end, std::move(result));
+        }
+
         inline T&       GetResult()       { return result; }
         inline T const& GetResult() const { return result; }
     private:
+        static constexpr size_t POOLED = 8; // arguments of one type kept per thread, enough for the arguments of a command and its siblings
+
         T result;
     };
 }
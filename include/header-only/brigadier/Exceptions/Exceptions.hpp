@@ -2,9 +2,14 @@
 
 #include "../StringReader.hpp"
 
+#include <variant>
+#include <algorithm>
+#include <type_traits>
+
 namespace brigadier
 {
     class BuiltInExceptionProvider;
+    class ExceptionRecord;
 
     struct ExceptionContext
     {
@@ -15,6 +20,75 @@ namespace brigadier
         int cursor = -1;
     };
 
+    /**
+    Kinds of CommandSyntaxException created by BuiltInExceptionProvider.
+    */
+    enum class SyntaxError : uint8_t
+    {
+        Custom, // created with a message, e.g. by an argument type
+        ValueTooLow,
+        ValueTooHigh,
+        LiteralIncorrect,
+        ReaderExpectedStartOfQuote,
+        ReaderExpectedEndOfQuote,
+        ReaderInvalidEscape,
+        ReaderInvalidValue,
+        ReaderExpectedValue,
+        ReaderExpectedSymbol,
+        ReaderExpectedOneOf,
+        DispatcherUnknownCommand,
+        DispatcherUnknownArgument,
+        DispatcherExpectedArgumentSeparator,
+        DispatcherParseException,
+        DispatcherParseBudgetExceeded,
+        DispatcherCommandFailed
+    };
+
+    /**
+    Value shown in the message of a built-in CommandSyntaxException, kept until the message is needed.
+    */
+    class ExceptionArgument
+    {
+    public:
+        ExceptionArgument() = default;
+        template<typename T>
+        explicit ExceptionArgument(T const& value)
+        {
+            using V = std::decay_t<T>;
+            if constexpr (std::is_same_v<V, char> || std::is_same_v<V, signed char> || std::is_same_v<V, unsigned char>)
+                this->value = char(value);
+            else if constexpr (std::is_integral_v<V> && std::is_signed_v<V>)
+                this->value = static_cast<long long>(value);
+            else if constexpr (std::is_integral_v<V>)
+                this->value = static_cast<unsigned long long>(value);
+            else if constexpr (std::is_floating_point_v<V> && sizeof(V) <= sizeof(double))
+                this->value = static_cast<double>(value);
+            else if constexpr (std::is_convertible_v<T const&, std::string_view>)
+                this->value = std::string(std::string_view(value));
+            else {
+                std::ostringstream s;
+                s << value;
+                this->value = s.str();
+            }
+        }
+
+        friend inline std::ostream& operator<<(std::ostream& stream, ExceptionArgument const& argument)
+        {
+            std::visit([&stream](auto const& value) {
+                if constexpr (!std::is_same_v<std::decay_t<decltype(value)>, std::monostate>)
+                    stream << value;
+            }, argument.value);
+            return stream;
+        }
+    private:
+        friend class CommandSyntaxException;
+        friend class ExceptionRecord;
+
+        // printed the same way as the original value, as the message used to be created right away.
+        // long double is printed right away, so that the variant needs no 16 byte alignment.
+        std::variant<std::monostate, char, long long, unsigned long long, double, std::string> value;
+    };
+
     class CommandSyntaxException
     {
     public:
@@ -22,8 +96,14 @@ namespace brigadier
         using BuiltInExceptions = BuiltInExceptionProvider;
         template<typename... Args>
         CommandSyntaxException(ExceptionContext ctx, Args&&... args) : ctx(ctx), msg(std::move(CreateMessageApplyContext(ctx, args...))) {}
-        std::string const& What() { return msg; }
+        inline std::string const& What();
+        inline SyntaxError GetError() const { return error; }
+
+        // Creates the exception of a record, `input` is the string it was created for
+        inline CommandSyntaxException(ExceptionRecord const& record, std::string_view input);
     private:
+        friend class ExceptionRecord;
+
         template<typename T>
         static inline void Add(std::ostringstream& stream, T&& value)
         {
@@ -44,9 +124,19 @@ namespace brigadier
         }
         template<typename... Args>
         static inline std::string CreateMessageApplyContext(ExceptionContext ctx, Args&&... args)
+        {
+            return CreateMessageApplyContext(ctx, GetExcerpt(ctx), args...);
+        }
+        template<typename... Args>
+        static inline std::string CreateMessageApplyContext(ExceptionContext ctx, std::string_view excerpt, Args&&... args)
         {
             if (ctx.cursor < 0) return CreateMessage(args...);
-            else return CreateMessage(args..., " at position ", ctx.cursor, ": ", ctx.cursor > context_amount ? "..." : "", ctx.input.substr((std::max)(0, ctx.cursor - context_amount), context_amount), "<--[HERE]");
+            else return CreateMessage(args..., " at position ", ctx.cursor, ": ", ctx.cursor > context_amount ? "..." : "", excerpt, "<--[HERE]");
+        }
+        static inline std::string_view GetExcerpt(ExceptionContext ctx)
+        {
+            if (ctx.cursor < 0) return {};
+            return ctx.input.substr((std::max)(0, ctx.cursor - context_amount), context_amount);
         }
     public:
         int GetCursor() const
@@ -60,24 +150,135 @@ namespace brigadier
     private:
         ExceptionContext ctx;
         std::string msg;
+        SyntaxError error = SyntaxError::Custom;
+        uint8_t excerptLength = 0;
+        char excerpt[context_amount] = {};
+        ExceptionArgument first;
+        ExceptionArgument second;
     };
 
     class BuiltInExceptionProvider
     {
     public:
-        template<typename T0, typename T1> static inline CommandSyntaxException ValueTooLow                        (ExceptionContext ctx, T0 found, T1 min)    { return CommandSyntaxException(ctx, "Value must not be less than ", min, ", found ", found); }
-        template<typename T0, typename T1> static inline CommandSyntaxException ValueTooHigh                       (ExceptionContext ctx, T0 found, T1 max)    { return CommandSyntaxException(ctx, "Value must not be more than ", max, ", found ", found); }
-        template<typename T0>              static inline CommandSyntaxException LiteralIncorrect                   (ExceptionContext ctx, T0 const& expected)  { return CommandSyntaxException(ctx, "Expected literal ", expected); }
-                                           static inline CommandSyntaxException ReaderExpectedStartOfQuote         (ExceptionContext ctx)                      { return CommandSyntaxException(ctx, "Expected quote to start a string"); }
-                                           static inline CommandSyntaxException ReaderExpectedEndOfQuote           (ExceptionContext ctx)                      { return CommandSyntaxException(ctx, "Unclosed quoted string"); }
-        template<typename T0>              static inline CommandSyntaxException ReaderInvalidEscape                (ExceptionContext ctx, T0 const& character) { return CommandSyntaxException(ctx, "Invalid escape sequence '", character, "' in quoted string"); }
-        template<typename T0>              static inline CommandSyntaxException ReaderInvalidValue                 (ExceptionContext ctx, T0 const& value)     { return CommandSyntaxException(ctx, "Invalid value '", value, "'"); }
-                                           static inline CommandSyntaxException ReaderExpectedValue                (ExceptionContext ctx)                      { return CommandSyntaxException(ctx, "Expected value"); }
-        template<typename T0>              static inline CommandSyntaxException ReaderExpectedSymbol               (ExceptionContext ctx, T0 const& symbol)    { return CommandSyntaxException(ctx, "Expected '", symbol, "'"); }
-        template<typename T0>              static inline CommandSyntaxException ReaderExpectedOneOf                (ExceptionContext ctx, T0 const& symbols)   { return CommandSyntaxException(ctx, "Expected one of `", symbols, "`"); }
-                                           static inline CommandSyntaxException DispatcherUnknownCommand           (ExceptionContext ctx)                      { return CommandSyntaxException(ctx, "Unknown command"); }
-                                           static inline CommandSyntaxException DispatcherUnknownArgument          (ExceptionContext ctx)                      { return CommandSyntaxException(ctx, "Incorrect argument for command"); }
-                                           static inline CommandSyntaxException DispatcherExpectedArgumentSeparator(ExceptionContext ctx)                      { return CommandSyntaxException(ctx, "Expected whitespace to end one argument, but found trailing data"); }
-        template<typename T0>              static inline CommandSyntaxException DispatcherParseException           (ExceptionContext ctx, T0 const& message)   { return CommandSyntaxException(ctx, "Could not parse command: ", message); }
+        template<typename T0, typename T1> static inline CommandSyntaxException ValueTooLow                        (ExceptionContext ctx, T0 found, T1 min)    { return Create(ctx, SyntaxError::ValueTooLow, found, min); }
+        template<typename T0, typename T1> static inline CommandSyntaxException ValueTooHigh                       (ExceptionContext ctx, T0 found, T1 max)    { return Create(ctx, SyntaxError::ValueTooHigh, found, max); }
+        template<typename T0>              static inline CommandSyntaxException LiteralIncorrect                   (ExceptionContext ctx, T0 const& expected)  { return Create(ctx, SyntaxError::LiteralIncorrect, expected); }
+                                           static inline CommandSyntaxException ReaderExpectedStartOfQuote         (ExceptionContext ctx)                      { return Create(ctx, SyntaxError::ReaderExpectedStartOfQuote); }
+                                           static inline CommandSyntaxException ReaderExpectedEndOfQuote           (ExceptionContext ctx)                      { return Create(ctx, SyntaxError::ReaderExpectedEndOfQuote); }
+        template<typename T0>              static inline CommandSyntaxException ReaderInvalidEscape                (ExceptionContext ctx, T0 const& character) { return Create(ctx, SyntaxError::ReaderInvalidEscape, character); }
+        template<typename T0>              static inline CommandSyntaxException ReaderInvalidValue                 (ExceptionContext ctx, T0 const& value)     { return Create(ctx, SyntaxError::ReaderInvalidValue, value); }
+                                           static inline CommandSyntaxException ReaderExpectedValue                (ExceptionContext ctx)                      { return Create(ctx, SyntaxError::ReaderExpectedValue); }
+        template<typename T0>              static inline CommandSyntaxException ReaderExpectedSymbol               (ExceptionContext ctx, T0 const& symbol)    { return Create(ctx, SyntaxError::ReaderExpectedSymbol, symbol); }
+        template<typename T0>              static inline CommandSyntaxException ReaderExpectedOneOf                (ExceptionContext ctx, T0 const& symbols)   { return Create(ctx, SyntaxError::ReaderExpectedOneOf, symbols); }
+                                           static inline CommandSyntaxException DispatcherUnknownCommand           (ExceptionContext ctx)                      { return Create(ctx, SyntaxError::DispatcherUnknownCommand); }
+                                           static inline CommandSyntaxException DispatcherUnknownArgument          (ExceptionContext ctx)                      { return Create(ctx, SyntaxError::DispatcherUnknownArgument); }
+                                           static inline CommandSyntaxException DispatcherExpectedArgumentSeparator(ExceptionContext ctx)                      { return Create(ctx, SyntaxError::DispatcherExpectedArgumentSeparator); }
+        template<typename T0>              static inline CommandSyntaxException DispatcherParseException           (ExceptionContext ctx, T0 const& message)   { return Create(ctx, SyntaxError::DispatcherParseException, message); }
+        template<typename T0>              static inline CommandSyntaxException DispatcherParseBudgetExceeded      (ExceptionContext ctx, T0 const& limit)     { return Create(ctx, SyntaxError::DispatcherParseBudgetExceeded, limit); }
+                                           static inline CommandSyntaxException DispatcherCommandFailed            (ExceptionContext ctx)                      { return Create(ctx, SyntaxError::DispatcherCommandFailed); }
+
+        // Message of a built-in exception, without the position in the input
+        static inline std::string GetMessage(SyntaxError error, ExceptionArgument const& first, ExceptionArgument const& second)
+        {
+            std::ostringstream s;
+            switch (error) {
+            case SyntaxError::ValueTooLow:                         s << "Value must not be less than " << second << ", found " << first; break;
+            case SyntaxError::ValueTooHigh:                        s << "Value must not be more than " << second << ", found " << first; break;
+            case SyntaxError::LiteralIncorrect:                    s << "Expected literal " << first; break;
+            case SyntaxError::ReaderExpectedStartOfQuote:          s << "Expected quote to start a string"; break;
+            case SyntaxError::ReaderExpectedEndOfQuote:            s << "Unclosed quoted string"; break;
+            case SyntaxError::ReaderInvalidEscape:                 s << "Invalid escape sequence '" << first << "' in quoted string"; break;
+            case SyntaxError::ReaderInvalidValue:                  s << "Invalid value '" << first << "'"; break;
+            case SyntaxError::ReaderExpectedValue:                 s << "Expected value"; break;
+            case SyntaxError::ReaderExpectedSymbol:                s << "Expected '" << first << "'"; break;
+            case SyntaxError::ReaderExpectedOneOf:                 s << "Expected one of `" << first << "`"; break;
+            case SyntaxError::DispatcherUnknownCommand:            s << "Unknown command"; break;
+            case SyntaxError::DispatcherUnknownArgument:           s << "Incorrect argument for command"; break;
+            case SyntaxError::DispatcherExpectedArgumentSeparator: s << "Expected whitespace to end one argument, but found trailing data"; break;
+            case SyntaxError::DispatcherParseException:            s << "Could not parse command: " << first; break;
+            case SyntaxError::DispatcherParseBudgetExceeded:       s << "Command is too complex to parse, exceeded " << first; break;
+            case SyntaxError::DispatcherCommandFailed:             s << "Command failed"; break;
+            default: break;
+            }
+            return s.str();
+        }
+    private:
+        template<typename... Args>
+        static inline CommandSyntaxException Create(ExceptionContext ctx, SyntaxError error, Args const&... args)
+        {
+            return CommandSyntaxException(ExceptionRecord(ctx, error, args...), ctx.input);
+        }
+    };
+
+    /**
+    Compact form of a CommandSyntaxException. Parsing functions that report failures without throwing (see ArgumentType::TryParse)
+    return one, and ParseResults keeps one for each node that failed, as the exceptions of most of them are never looked at.
+    A custom exception keeps its message in place of the arguments.
+    */
+    class ExceptionRecord
+    {
+    public:
+        ExceptionRecord() = default;
+        explicit inline ExceptionRecord(CommandSyntaxException const& ex);
+
+        // Failure reported by a built-in exception (see BuiltInExceptionProvider), whose message is created only when asked for.
+        // Only the part of the input shown in the message is copied, so it does not have to outlive the record.
+        template<typename... Args>
+        ExceptionRecord(ExceptionContext ctx, SyntaxError error, Args const&... args)
+            : cursor(ctx.cursor)
+            , error(error)
+        {
+            ExceptionArgument arguments[2] = { ExceptionArgument(args)... };
+            first = std::move(arguments[0]);
+            second = std::move(arguments[1]);
+            if (ctx.cursor >= 0)
+                excerptLength = static_cast<uint8_t>(CommandSyntaxException::GetExcerpt(ctx).copy(excerpt, CommandSyntaxException::context_amount));
+        }
+
+        inline SyntaxError GetError() const { return error; }
+        inline int GetCursor() const { return cursor; }
+    private:
+        friend class CommandSyntaxException;
+
+        ExceptionArgument first;
+        ExceptionArgument second;
+        int cursor = -1;
+        SyntaxError error = SyntaxError::Custom;
+        uint8_t excerptLength = 0;
+        char excerpt[CommandSyntaxException::context_amount] = {};
     };
+
+    inline ExceptionRecord::ExceptionRecord(CommandSyntaxException const& ex)
+        : second(ex.second)
+        , cursor(ex.ctx.cursor)
+        , error(ex.error)
+        , excerptLength(ex.excerptLength)
+    {
+        if (error == SyntaxError::Custom)
+            first.value = ex.msg;
+        else
+            first = ex.first;
+        std::copy(ex.excerpt, ex.excerpt + excerptLength, excerpt);
+    }
+
+    inline CommandSyntaxException::CommandSyntaxException(ExceptionRecord const& record, std::string_view input)
+        : error(record.error)
+        , excerptLength(record.excerptLength)
+        , second(record.second)
+    {
+        ctx.input = input;
+        ctx.cursor = record.cursor;
+        if (error == SyntaxError::Custom)
+            msg = std::get<std::string>(record.first.value);
+        else
+            first = record.first;
+        std::copy(record.excerpt, record.excerpt + excerptLength, excerpt);
+    }
+
+    inline std::string const& CommandSyntaxException::What()
+    {
+        if (msg.empty() && error != SyntaxError::Custom)
+            msg = CreateMessageApplyContext(ctx, std::string_view(excerpt, excerptLength), BuiltInExceptionProvider::GetMessage(error, first, second));
+        return msg;
+    }
 }
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Exceptions/Exceptions.hpp"
+
+namespace brigadier
+{
+    /**
+    Outcome of CommandDispatcher::TryExecute, which reports failures without throwing.
+    */
+    struct ExecuteResult
+    {
+        int result = 0; // the value CommandDispatcher::Execute would have returned, 0 if it would have thrown
+        int successes = 0; // commands that completed, one for each source of a fork
+        int failures = 0; // commands and redirect modifiers that failed, or 1 if the input could not be parsed
+        SyntaxError error = SyntaxError::Custom; // of the first failure
+        int cursor = -1; // of the first failure in the input, -1 if the failure has no position
+        bool failed = false; // CommandDispatcher::Execute would have thrown the first failure
+
+        inline bool IsSuccess() const { return !failed; }
+    };
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <cstdint>
 #include "Suggestion/SuggestionsBuilder.hpp"
 
 namespace brigadier
@@ -24,6 +25,10 @@ namespace brigadier
     using ResultConsumer = void(*)(CommandContext<S>& context, bool success, int result);
     template<typename S>
     using SuggestionProvider = std::future<Suggestions>(*)(CommandContext<S>& context, SuggestionsBuilder& builder);
+
+    using PermissionMask = uint64_t;
+    template<typename S>
+    using PermissionProvider = PermissionMask(*)(S const& source);
 }
 
 #define COMMAND(S, ...) [](brigadier::CommandContext<S>& ctx) -> int __VA_ARGS__
@@ -3,12 +3,48 @@
 #include "Context/CommandContext.hpp"
 
 #include <map>
+#include <vector>
+#include <chrono>
+#include <mutex>
+#include <atomic>
 
 namespace brigadier
 {
     template<typename S>
     class CommandDispatcher;
 
+    /**
+    Settings of CommandDispatcher::Parse, see CommandDispatcher::SetParseOptions(ParseOptions).
+    */
+    struct ParseOptions
+    {
+        /**
+        Remembers the result of parsing below each node at each position of the input, for the duration of one parse.
+        Trees where several arguments accept the same input and lead to shared nodes (see CommandDispatcher::Deduplicate())
+        are then parsed in polynomial instead of exponential time, at the cost of copying results on every level.
+        */
+        bool memoize = false;
+
+        /**
+        Limits of the work done by one parse, 0 for no limit. When a limit is reached, CommandDispatcher::Parse throws
+        CommandSyntaxException::BuiltInExceptions::DispatcherParseBudgetExceeded instead of returning partial results.
+        */
+        size_t maxNodeVisits = 0; // nodes tried against the input, across all branches
+        size_t maxRedirectDepth = 0; // redirects followed in a row, e.g. `execute ... run execute ... run ...`
+        std::chrono::microseconds maxTime = std::chrono::microseconds::zero(); // checked every few node visits
+
+        /**
+        Parses for execution only. Failures of nodes are not recorded, so ParseResults::GetExceptions() stays empty and
+        CommandDispatcher::Execute(ParseResults) reports only where the input stopped being valid. Once a node has parsed the rest
+        of the input, its siblings are not tried, as none of them could replace it as the best potential, unless a remaining sibling
+        has a redirect: a redirect takes over the level once parsed in both modes, so the siblings are tried up to the last one with a redirect.
+        For input that parses completely the resulting context is the same as in the diagnostic mode. For input that fails,
+        the diagnostic mode also ranks candidates by their exceptions (see ParseResults::IsBetterThan), so the fast mode
+        may stop in a different node and report a different position.
+        */
+        bool fastMode = false;
+    };
+
     template<typename S>
     class ParseResults
     {
@@ -16,8 +52,11 @@ namespace brigadier
         ParseResults(CommandContext<S> context, StringReader reader, std::map<CommandNode<S>*, CommandSyntaxException> exceptions)
             : context(std::move(context))
             , reader(std::move(reader))
-            , exceptions(std::move(exceptions))
-        {}
+        {
+            for (auto& [node, exception] : exceptions) {
+                errors.push_back({ node, ExceptionRecord(exception) });
+            }
+        }
         ParseResults(CommandContext<S> context, StringReader reader)
             : context(std::move(context))
             , reader(std::move(reader))
@@ -27,7 +66,27 @@ namespace brigadier
     public:
         inline CommandContext<S> const& GetContext() const { return context; }
         inline StringReader      const& GetReader()  const { return reader;  }
-        inline std::map<CommandNode<S>*, CommandSyntaxException> const& GetExceptions() const { return exceptions; }
+        inline bool HasExceptions() const { return !errors.empty(); }
+
+        /**
+        Gets the exceptions of the nodes that could not be parsed, one for each node.
+        They are created from the failures recorded while parsing on the first call, which may run concurrently with others.
+        Like GetReader(), the exceptions refer to the parsed input.
+        */
+        inline std::map<CommandNode<S>*, CommandSyntaxException> const& GetExceptions() const
+        {
+            if (!exceptions.expanded.load(std::memory_order_acquire)) {
+                std::lock_guard<std::mutex> lock(exceptions.mutex);
+                if (!exceptions.expanded.load(std::memory_order_relaxed)) {
+                    exceptions.map.clear();
+                    for (auto& [node, record] : errors) {
+                        exceptions.map.emplace(node, CommandSyntaxException(record, reader.GetString()));
+                    }
+                    exceptions.expanded.store(true, std::memory_order_release);
+                }
+            }
+            return exceptions.map;
+        }
 
         inline bool IsBetterThan(ParseResults<S> const& other) const
         {
@@ -37,10 +96,10 @@ namespace brigadier
             if (GetReader().CanRead() && !other.GetReader().CanRead()) {
                 return false;
             }
-            if (GetExceptions().empty() && !other.GetExceptions().empty()) {
+            if (!HasExceptions() && other.HasExceptions()) {
                 return true;
             }
-            if (!GetExceptions().empty() && other.GetExceptions().empty()) {
+            if (HasExceptions() && !other.HasExceptions()) {
                 return false;
             }
             return false;
@@ -48,7 +107,7 @@ namespace brigadier
 
         inline void Reset(StringReader new_reader)
         {
-            exceptions.clear();
+            ClearExceptions();
             reader = std::move(new_reader);
         }
         inline void Reset(S source, CommandNode<S>* root, int start, StringReader reader = {})
@@ -66,8 +125,57 @@ namespace brigadier
         template<typename _S>
         friend class CommandDispatcher;
 
+        struct Error
+        {
+            CommandNode<S>* node;
+            ExceptionRecord record;
+        };
+        using Errors = std::vector<Error>;
+
+        // The map of GetExceptions(), created once by whichever call comes first. Copies start without it.
+        struct ExpandedExceptions
+        {
+            ExpandedExceptions() = default;
+            ExpandedExceptions(ExpandedExceptions const&) {}
+            ExpandedExceptions& operator=(ExpandedExceptions const&) { Reset(); return *this; }
+
+            inline void Reset()
+            {
+                map.clear();
+                expanded.store(false, std::memory_order_relaxed);
+            }
+
+            std::map<CommandNode<S>*, CommandSyntaxException> map;
+            std::atomic<bool> expanded = false;
+            std::mutex mutex;
+        };
+
+        inline void AddException(CommandNode<S>* node, CommandSyntaxException const& exception)
+        {
+            AddException(node, ExceptionRecord(exception));
+        }
+        inline void AddException(CommandNode<S>* node, ExceptionRecord record)
+        {
+            errors.push_back({ node, std::move(record) });
+            exceptions.Reset();
+        }
+        inline void SetExceptions(Errors other)
+        {
+            errors = std::move(other);
+            exceptions.Reset();
+        }
+        inline void ClearExceptions()
+        {
+            errors.clear();
+            exceptions.Reset();
+        }
+
         CommandContext<S> context;
-        std::map<CommandNode<S>*, CommandSyntaxException> exceptions;
+        // Failures in the order they were found. A node may fail more than once, the first failure is reported.
+        // Exceptions are not created until needed, and the vector keeps its memory when the results are reused.
+        Errors errors;
+        mutable ExpandedExceptions exceptions; // see GetExceptions()
         StringReader reader;
+        std::shared_ptr<CommandNode<S>> tree; // keeps the parsed version of the command tree alive, see CommandDispatcher::Replace
     };
 }
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <cstring>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace brigadier
+{
+    class InternedString;
+
+    /**
+    Process-wide storage of node names.
+
+    Every distinct name is stored once, packed into large blocks, so nodes, children indexes and parsed arguments
+    can refer to names by std::string_view. Names are shared by all command trees, because nodes are shared between
+    dispatchers (see CommandDispatcher(CommandDispatcher const&)) and may be built without any.
+
+    Stored names are reference counted through InternedString. A name is dropped once no reference to it is left,
+    and a block is freed once none of its names are used, so loading and unloading commands does not grow the storage.
+    */
+    class StringInterner
+    {
+    public:
+        /**
+        Gets the stored copy of a string, storing it first if it is new.
+
+        \param text the string to store
+        \return reference to the stored string, which keeps it stored
+        */
+        static InternedString Intern(std::string_view text);
+
+        /**
+        Approximate memory used by stored strings and their index.
+        */
+        static size_t GetMemoryUsage()
+        {
+            auto& interner = Get();
+            std::lock_guard<std::mutex> lock(interner.mutex);
+            return interner.allocated + interner.strings.size() * INDEX_ENTRY_SIZE + interner.strings.bucket_count() * sizeof(void*);
+        }
+
+        /**
+        Approximate memory used by one stored string, including its share of the index.
+        */
+        static constexpr size_t GetMemoryUsage(std::string_view stored)
+        {
+            return stored.empty() ? 0 : sizeof(Header) + Align(stored.size()) + INDEX_ENTRY_SIZE;
+        }
+    private:
+        friend class InternedString;
+
+        struct Block;
+
+        // Stored in front of every string
+        struct Header
+        {
+            std::atomic<size_t> references;
+            Block* block;
+        };
+
+        struct Block
+        {
+            std::unique_ptr<char[]> data;
+            size_t size;
+            size_t used = 0; // bytes taken, freed only when the whole block is
+            size_t strings = 0; // strings of the block that are still stored
+        };
+
+        static constexpr size_t BLOCK_SIZE = 4096;
+        static constexpr size_t INDEX_ENTRY_SIZE = sizeof(std::string_view) + 2 * sizeof(void*); // node of the hash set, estimated
+
+        static constexpr size_t Align(size_t size)
+        {
+            return (size + alignof(Header) - 1) / alignof(Header) * alignof(Header);
+        }
+
+        static Header& GetHeader(std::string_view stored)
+        {
+            return *reinterpret_cast<Header*>(const_cast<char*>(stored.data()) - sizeof(Header));
+        }
+
+        // Another reference to a stored string, made from an existing one, so the string cannot be dropped meanwhile
+        static void Acquire(std::string_view stored)
+        {
+            if (!stored.empty())
+                GetHeader(stored).references.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        static void Release(std::string_view stored)
+        {
+            if (stored.empty())
+                return;
+
+            // only the last reference needs the lock, because Intern() can find the string again until it is dropped
+            Header& header = GetHeader(stored);
+            size_t references = header.references.load(std::memory_order_relaxed);
+            while (references > 1) {
+                if (header.references.compare_exchange_weak(references, references - 1, std::memory_order_acq_rel))
+                    return;
+            }
+
+            auto& interner = Get();
+            std::lock_guard<std::mutex> lock(interner.mutex);
+            if (header.references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                interner.Drop(stored);
+        }
+
+        std::string_view Store(std::string_view text)
+        {
+            size_t size = sizeof(Header) + Align(text.size());
+            Block* block;
+            if (size > BLOCK_SIZE / 4) {
+                // long strings get their own block, so that the current one is not wasted
+                block = AddBlock(size);
+            }
+            else {
+                if (current == nullptr || current->size - current->used < size) {
+                    current = AddBlock(BLOCK_SIZE);
+                }
+                block = current;
+            }
+            char* data = block->data.get() + block->used;
+            block->used += size;
+            ++block->strings;
+
+            new (data) Header{ { 1 }, block };
+            std::memcpy(data + sizeof(Header), text.data(), text.size());
+            return std::string_view(data + sizeof(Header), text.size());
+        }
+
+        void Drop(std::string_view stored)
+        {
+            strings.erase(stored);
+            Block* block = GetHeader(stored).block;
+            GetHeader(stored).~Header();
+            if (--block->strings > 0)
+                return;
+
+            if (block == current) {
+                // the current block is kept for new strings
+                block->used = 0;
+                return;
+            }
+            auto found = std::find_if(blocks.begin(), blocks.end(), [block](auto const& owned) { return owned.get() == block; });
+            allocated -= block->size;
+            blocks.erase(found);
+        }
+
+        Block* AddBlock(size_t size)
+        {
+            blocks.push_back(std::make_unique<Block>(Block{ std::unique_ptr<char[]>(new char[size]), size }));
+            allocated += size;
+            return blocks.back().get();
+        }
+
+        static StringInterner& Get()
+        {
+            // not destroyed at exit, so names held by static objects can still be released
+            static StringInterner* interner = new StringInterner();
+            return *interner;
+        }
+    private:
+        std::mutex mutex;
+        std::unordered_set<std::string_view> strings;
+        std::vector<std::unique_ptr<Block>> blocks;
+        Block* current = nullptr; // block receiving short strings
+        size_t allocated = 0;
+    };
+
+    /**
+    Reference to a string stored by StringInterner, usable as a std::string_view.
+
+    Copies refer to the same stored string. It stays stored as long as any reference to it exists.
+    */
+    class InternedString
+    {
+    public:
+        InternedString() = default;
+        InternedString(InternedString const& other) : text(other.text)
+        {
+            StringInterner::Acquire(text);
+        }
+        InternedString(InternedString&& other) noexcept : text(std::exchange(other.text, {})) {}
+        InternedString& operator=(InternedString other) noexcept
+        {
+            std::swap(text, other.text);
+            return *this;
+        }
+        ~InternedString()
+        {
+            StringInterner::Release(text);
+        }
+
+        inline operator std::string_view() const { return text; }
+        inline std::string_view GetView() const { return text; }
+        inline const char* data() const { return text.data(); }
+        inline size_t size() const { return text.size(); }
+        inline bool empty() const { return text.empty(); }
+    private:
+        friend class StringInterner;
+        explicit InternedString(std::string_view stored) : text(stored) {}
+
+        std::string_view text;
+    };
+
+    inline InternedString StringInterner::Intern(std::string_view text)
+    {
+        if (text.empty())
+            return {};
+
+        auto& interner = Get();
+        std::lock_guard<std::mutex> lock(interner.mutex);
+        auto found = interner.strings.find(text);
+        if (found != interner.strings.end()) {
+            GetHeader(*found).references.fetch_add(1, std::memory_order_relaxed);
+            return InternedString(*found);
+        }
+
+        std::string_view stored = interner.Store(text);
+        interner.strings.insert(stored);
+        return InternedString(stored);
+    }
+}
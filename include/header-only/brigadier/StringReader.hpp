@@ -3,9 +3,75 @@
 #include <string>
 #include <string_view>
 #include <sstream>
+#include <cstdint>
+
+#include "StringTokens.hpp"
 
 namespace brigadier
 {
+    /**
+    Set of characters as a 256-bit map, usable at compile time.
+    */
+    class CharacterSet
+    {
+    public:
+        constexpr CharacterSet() = default;
+
+        static constexpr CharacterSet All()
+        {
+            CharacterSet set;
+            for (auto& word : set.bits) {
+                word = ~uint64_t(0);
+            }
+            return set;
+        }
+
+        static constexpr CharacterSet Of(std::string_view chars)
+        {
+            CharacterSet set;
+            for (char c : chars) {
+                set.Add(c);
+            }
+            return set;
+        }
+
+        template<typename Predicate>
+        static constexpr CharacterSet Matching(Predicate predicate)
+        {
+            CharacterSet set;
+            for (int c = 0; c < 256; ++c) {
+                if (predicate(char(c)))
+                    set.Add(char(c));
+            }
+            return set;
+        }
+
+        constexpr bool Contains(char c) const
+        {
+            auto u = static_cast<unsigned char>(c);
+            return (bits[u >> 6] >> (u & 63)) & 1;
+        }
+
+        constexpr CharacterSet operator|(CharacterSet const& other) const
+        {
+            CharacterSet set;
+            for (int i = 0; i < 4; ++i) {
+                set.bits[i] = bits[i] | other.bits[i];
+            }
+            return set;
+        }
+    private:
+        constexpr void Add(char c)
+        {
+            auto u = static_cast<unsigned char>(c);
+            bits[u >> 6] |= uint64_t(1) << (u & 63);
+        }
+    private:
+        uint64_t bits[4] = {};
+    };
+
+    class ExceptionRecord;
+
     class StringReader
     {
     private:
@@ -31,7 +97,7 @@ namespace brigadier
         inline char             Read()                      { return string.at(cursor++); }
         inline void             Skip()                      { cursor++; }
 
-        inline static bool IsQuotedStringStart(char c)
+        inline static constexpr bool IsQuotedStringStart(char c)
         {
             return c == SYNTAX_DOUBLE_QUOTE || c == SYNTAX_SINGLE_QUOTE;
         }
@@ -50,7 +116,7 @@ namespace brigadier
         template<typename T>
         inline T ReadValueUntilOneOf(const char* terminators);
 
-        inline static bool IsAllowedInUnquotedString(char c)
+        inline static constexpr bool IsAllowedInUnquotedString(char c)
         {
             return (c >= '0' && c <= '9')
                 || (c >= 'A' && c <= 'Z')
@@ -60,7 +126,7 @@ namespace brigadier
         }
 
         template<bool allow_float = true, bool allow_negative = true>
-        inline static bool IsAllowedNumber(char c)
+        inline static constexpr bool IsAllowedNumber(char c)
         {
             return c >= '0' && c <= '9' || (allow_float && c == '.') || (allow_negative && c == '-');
         }
@@ -70,11 +136,23 @@ namespace brigadier
         inline std::string      ReadStringUntil(char terminator);
         inline std::string      ReadStringUntilOneOf(const char* terminators);
         inline std::string      ReadString();
+        inline std::string_view ReadStringView(std::string& unescaped); // view into the input, unless a quoted string has escapes
         inline void             Expect(char c);
 
+        // Same as the functions above, but return false with the failure in `error` instead of throwing it
+        template<typename T>
+        inline bool TryReadValue(T& value, ExceptionRecord& error);
+        inline bool TryReadStringUntil(char terminator, std::string& result, ExceptionRecord& error);
+        inline bool TryReadString(std::string& result, ExceptionRecord& error);
+        inline bool TryReadStringView(std::string& unescaped, std::string_view& result, ExceptionRecord& error);
+
+        // Words of the input found before parsing, used to skip over quoted strings. Copies of the reader share them.
+        inline void SetTokens(const StringTokens* tokens) { this->tokens = tokens; }
+
     private:
         std::string_view string;
         int cursor = 0;
+        const StringTokens* tokens = nullptr;
     };
 }
 
@@ -107,6 +185,16 @@ namespace brigadier
     std::string StringReader::ReadStringUntil(char terminator)
     {
         std::string result;
+        ExceptionRecord error;
+        if (!TryReadStringUntil(terminator, result, error)) {
+            throw CommandSyntaxException(error, string);
+        }
+        return result;
+    }
+
+    bool StringReader::TryReadStringUntil(char terminator, std::string& result, ExceptionRecord& error)
+    {
+        result.clear();
         result.reserve(GetRemainingLength());
 
         bool escaped = false;
@@ -119,21 +207,23 @@ namespace brigadier
                 }
                 else {
                     SetCursor(GetCursor() - 1);
-                    throw CommandSyntaxException::BuiltInExceptions::ReaderInvalidEscape(*this, c);
+                    error = ExceptionRecord(*this, SyntaxError::ReaderInvalidEscape, c);
+                    return false;
                 }
             }
             else if (c == SYNTAX_ESCAPE) {
                 escaped = true;
             }
             else if (c == terminator) {
-                return result;
+                return true;
             }
             else {
                 result += c;
             }
         }
 
-        throw CommandSyntaxException::BuiltInExceptions::ReaderExpectedEndOfQuote(*this);
+        error = ExceptionRecord(*this, SyntaxError::ReaderExpectedEndOfQuote);
+        return false;
     }
 
     std::string StringReader::ReadStringUntilOneOf(const char* terminators)
@@ -180,16 +270,75 @@ namespace brigadier
     }
 
     std::string StringReader::ReadString()
+    {
+        std::string result;
+        ExceptionRecord error;
+        if (!TryReadString(result, error)) {
+            throw CommandSyntaxException(error, string);
+        }
+        return result;
+    }
+
+    bool StringReader::TryReadString(std::string& result, ExceptionRecord& error)
     {
         if (!CanRead()) {
-            return {};
+            result.clear();
+            return true;
         }
         char next = Peek();
         if (IsQuotedStringStart(next)) {
             Skip();
-            return ReadStringUntil(next);
+            return TryReadStringUntil(next, result, error);
+        }
+        result = ReadUnquotedString();
+        return true;
+    }
+
+    std::string_view StringReader::ReadStringView(std::string& unescaped)
+    {
+        std::string_view result;
+        ExceptionRecord error;
+        if (!TryReadStringView(unescaped, result, error)) {
+            throw CommandSyntaxException(error, string);
+        }
+        return result;
+    }
+
+    bool StringReader::TryReadStringView(std::string& unescaped, std::string_view& result, ExceptionRecord& error)
+    {
+        if (!CanRead()) {
+            result = {};
+            return true;
+        }
+        char next = Peek();
+        if (!IsQuotedStringStart(next)) {
+            result = ReadUnquotedString();
+            return true;
+        }
+        if (tokens != nullptr && tokens->GetInput().data() == string.data() && tokens->GetInput().size() == string.size()) {
+            int end = tokens->GetQuoteEnd(cursor);
+            if (end >= 0) {
+                int start = cursor + 1;
+                cursor = end + 1;
+                result = string.substr(start, end - start);
+                return true;
+            }
+        }
+        for (size_t i = cursor + 1; i < string.length() && string[i] != SYNTAX_ESCAPE; ++i) {
+            if (string[i] == next) {
+                int start = cursor + 1;
+                cursor = int(i) + 1;
+                result = string.substr(start, i - start);
+                return true;
+            }
+        }
+        // escapes and missing end quotes are handled by the copying version
+        Skip();
+        if (!TryReadStringUntil(next, unescaped, error)) {
+            return false;
         }
-        return std::string(ReadUnquotedString());
+        result = unescaped;
+        return true;
     }
 
     void StringReader::Expect(char c)
@@ -202,6 +351,17 @@ namespace brigadier
 
     template<typename T>
     T StringReader::ReadValue()
+    {
+        T result{};
+        ExceptionRecord error;
+        if (!TryReadValue(result, error)) {
+            throw CommandSyntaxException(error, string);
+        }
+        return result;
+    }
+
+    template<typename T>
+    bool StringReader::TryReadValue(T& result, ExceptionRecord& error)
     {
         int start = cursor;
         std::string value;
@@ -212,26 +372,29 @@ namespace brigadier
             }
             value = string.substr(start, cursor - start);
         }
-        else
+        else if (!TryReadString(value, error))
         {
-            value = ReadString();
+            return false;
         }
 
         if (value.empty()) {
-            throw CommandSyntaxException::BuiltInExceptions::ReaderExpectedValue(*this);
+            error = ExceptionRecord(*this, SyntaxError::ReaderExpectedValue);
+            return false;
         }
 
         if constexpr (std::is_same_v<T, bool>)
         {
             /**/ if (value == "true")
-                return true;
+                result = true;
             else if (value == "false")
-                return false;
+                result = false;
             else
             {
                 cursor = start;
-                throw CommandSyntaxException::BuiltInExceptions::ReaderInvalidValue(*this, value);
+                error = ExceptionRecord(*this, SyntaxError::ReaderInvalidValue, value);
+                return false;
             }
+            return true;
         }
         else
         {
@@ -240,11 +403,15 @@ namespace brigadier
             s >> ret;
 
             if (s.eof() && !s.bad() && !s.fail())
-                return ret;
+            {
+                result = std::move(ret);
+                return true;
+            }
             else
             {
                 cursor = start;
-                throw CommandSyntaxException::BuiltInExceptions::ReaderInvalidValue(*this, value);
+                error = ExceptionRecord(*this, SyntaxError::ReaderInvalidValue, value);
+                return false;
             }
         }
     }
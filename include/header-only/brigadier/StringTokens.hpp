@@ -0,0 +1,146 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <string_view>
+#include <vector>
+
+namespace brigadier
+{
+    /**
+    Words of an input separated by spaces, found in a single pass before parsing.
+
+    The parser looks up literals by the word at the cursor on every level of the tree, and again for every candidate
+    tried at the same position. With the words recorded once, these lookups do not read the input again.
+    A word starting with a quote extends to the matching end quote, so quoted strings with spaces are a single word,
+    and string arguments tried at the same position skip to the recorded end quote instead of searching for it, see StringReader::ReadStringView().
+    */
+    class StringTokens
+    {
+    public:
+        StringTokens() = default;
+        explicit StringTokens(std::string_view input) { Tokenize(input); }
+
+        /**
+        Records the words of an input, replacing previous ones.
+        Memory is allocated only for inputs with more than INLINE_WORDS words, and is kept for the next input.
+        */
+        void Tokenize(std::string_view input)
+        {
+            this->input = input;
+            count = 0;
+            overflow.clear();
+
+            size_t start = 0;
+            while (true) {
+                Word word{ int(start) };
+                size_t end = start;
+                if (start < input.size() && (input[start] == '"' || input[start] == '\'')) {
+                    end = FindEndQuote(input, start, word.plain);
+                    if (end != std::string_view::npos)
+                        word.quoteEnd = int(end++);
+                    else
+                        end = start; // not closed, read as a plain word
+                }
+                end = input.find(' ', end);
+                if (end == std::string_view::npos)
+                    end = input.size();
+                word.end = int(end);
+                word.plain &= word.quoteEnd == int(end) - 1;
+                Add(word);
+                if (end == input.size())
+                    break;
+                start = end + 1;
+            }
+        }
+
+        /**
+        Gets the text from `cursor` up to the next space or the end of the input.
+        A quoted string starting at `cursor` is returned as a whole, including spaces within the quotes.
+        */
+        std::string_view GetWord(int cursor) const
+        {
+            if (const Word* found = Find(cursor))
+                return input.substr(cursor, found->end - cursor);
+
+            // parsing started in the middle of a word
+            size_t end = input.find(' ', cursor);
+            return input.substr(cursor, end == std::string_view::npos ? std::string_view::npos : end - cursor);
+        }
+
+        /**
+        Gets the position of the end quote of a quoted string starting at `cursor`, which is followed by a space or the end of the input.
+
+        \return position of the end quote, or -1 if no such string starts there, or it has escapes
+        */
+        int GetQuoteEnd(int cursor) const
+        {
+            const Word* found = Find(cursor);
+            return found != nullptr && found->plain ? found->quoteEnd : -1;
+        }
+
+        inline std::string_view GetInput() const { return input; }
+        inline size_t GetCount() const { return count; }
+
+        /**
+        Frees memory kept from earlier inputs beyond `words` words.
+        */
+        void Trim(size_t words)
+        {
+            if (overflow.capacity() > words)
+                std::vector<Word>().swap(overflow);
+        }
+    public:
+        static constexpr size_t INLINE_WORDS = 16;
+    private:
+        struct Word
+        {
+            int start = 0;
+            int end = 0;
+            int quoteEnd = -1; // of a quoted string starting the word
+            bool plain = true; // quoted string without escapes that makes up the whole word
+        };
+
+        // Same rules as StringReader::ReadStringUntil(), returns npos if the string is not closed
+        static size_t FindEndQuote(std::string_view input, size_t start, bool& plain)
+        {
+            char quote = input[start];
+            for (size_t i = start + 1; i < input.size(); ++i) {
+                if (input[i] == '\\') {
+                    plain = false;
+                    ++i;
+                }
+                else if (input[i] == quote) {
+                    return i;
+                }
+            }
+            return std::string_view::npos;
+        }
+
+        const Word* Find(int cursor) const
+        {
+            const Word* words = GetWords();
+            const Word* found = std::lower_bound(words, words + count, cursor, [](Word const& word, int cursor) { return word.start < cursor; });
+            return found != words + count && found->start == cursor ? found : nullptr;
+        }
+
+        void Add(Word word)
+        {
+            if (count < INLINE_WORDS) {
+                words[count++] = word;
+                return;
+            }
+            if (count == INLINE_WORDS)
+                overflow.assign(words.begin(), words.end());
+            overflow.push_back(word);
+            ++count;
+        }
+
+        inline const Word* GetWords() const { return count <= INLINE_WORDS ? words.data() : overflow.data(); }
+    private:
+        std::string_view input;
+        std::array<Word, INLINE_WORDS> words;
+        std::vector<Word> overflow; // all words, once there are more than INLINE_WORDS
+        size_t count = 0;
+    };
+}
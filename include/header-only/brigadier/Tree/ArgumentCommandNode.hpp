@@ -5,6 +5,7 @@
 
 #include "CommandNode.hpp"
 #include "../Arguments/ArgumentType.hpp"
+#include "../Arguments/ArgumentTypeRegistry.hpp"
 
 namespace brigadier
 {
@@ -14,20 +15,60 @@ namespace brigadier
     template<typename S>
     class IArgumentCommandNode : public CommandNode<S>
     {
+    public:
+        using ParseFunction = bool(*)(IArgumentCommandNode<S>& node, StringReader& reader, CommandContext<S>& contextBuilder, ExceptionRecord& error);
     protected:
-        IArgumentCommandNode(std::string_view name) : name(name) {}
+        IArgumentCommandNode(std::string_view name, ParseFunction parseFunction, CharacterSet const* firstCharacters)
+            : CommandNode<S>(CommandNodeType::ArgumentCommandNode, name)
+            , parseFunction(parseFunction)
+            , firstCharacters(firstCharacters)
+        {}
         virtual ~IArgumentCommandNode() = default;
     public:
-        virtual std::string const& GetName() {
-            return name;
+        /**
+        Same as Parse(StringReader&, CommandContext<S>&), but calls the parse function of the argument type directly
+        instead of going through the virtual table.
+        */
+        inline void ParseArgument(StringReader& reader, CommandContext<S>& contextBuilder) {
+            ExceptionRecord error;
+            if (!parseFunction(*this, reader, contextBuilder, error)) {
+                throw CommandSyntaxException(error, reader.GetString());
+            }
+        }
+
+        /**
+        Same as ParseArgument, but returns false with the failure in `error` instead of throwing it if the argument type
+        has ArgumentType::TryParse. Other argument types still throw.
+        */
+        inline bool TryParseArgument(StringReader& reader, CommandContext<S>& contextBuilder, ExceptionRecord& error) {
+            return parseFunction(*this, reader, contextBuilder, error);
+        }
+
+        inline ParseFunction GetParseFunction() const {
+            return parseFunction;
+        }
+
+        /**
+        Checks if input starting with `c` can be parsed by this argument. See ArgumentType::GetFirstCharacters().
+        */
+        inline bool CanStartWith(char c) const {
+            return firstCharacters->Contains(c);
         }
-        virtual CommandNodeType GetNodeType() { return CommandNodeType::ArgumentCommandNode; }
+
+        virtual TypeInfo GetTypeInfo() = 0;
+
+        /**
+        Appends the type, type parameters and custom suggestions of this argument to `out`. Arguments with equal keys parse the same way.
+        \return false if parameters of the argument type cannot be compared (see ArgumentParameters)
+        */
+        virtual bool WriteArgumentKey(std::string& out) = 0;
     protected:
         virtual std::string_view GetSortedKey() {
-            return name;
+            return this->name;
         }
-    protected:
-        std::string name;
+    private:
+        ParseFunction parseFunction; // ArgumentCommandNode<S, T>::ParseAs of the argument type
+        CharacterSet const* firstCharacters; // ArgumentCommandNode<S, T>::FIRST_CHARACTERS of the argument type
     };
 
     template<typename S, typename T>
@@ -36,12 +77,16 @@ namespace brigadier
     private:
         static constexpr std::string_view USAGE_ARGUMENT_OPEN = "<";
         static constexpr std::string_view USAGE_ARGUMENT_CLOSE = ">";
+        static constexpr CharacterSet FIRST_CHARACTERS = T::GetFirstCharacters();
     public:
         template<typename... Args>
         ArgumentCommandNode(std::string_view name, Args&&... args)
-            : IArgumentCommandNode<S>(name)
+            : IArgumentCommandNode<S>(name, &ArgumentCommandNode<S, T>::ParseAs, &FIRST_CHARACTERS)
             , type(std::forward<Args>(args)...)
-        {}
+        {
+            if constexpr (HasArgumentTypeId<T>::value)
+                ArgumentTypeRegistry::Register<T>();
+        }
         virtual ~ArgumentCommandNode() = default;
     public:
         inline SuggestionProvider<S> const& GetCustomSuggestions() const {
@@ -69,14 +114,11 @@ namespace brigadier
         virtual std::vector<std::string_view> GetExamples() {
             return type.GetExamples();
         }
+        virtual TypeInfo GetTypeInfo() {
+            return TypeInfo(TypeInfo::Create<T>());
+        }
         virtual void Parse(StringReader& reader, CommandContext<S>& contextBuilder) {
-            int start = reader.GetCursor();
-            using Type = typename T::type;
-            Type result = type.Parse(reader);
-            std::shared_ptr<ParsedArgument<S, T>> parsed = std::make_shared<ParsedArgument<S, T>>(start, reader.GetCursor(), std::move(result));
-
-            contextBuilder.WithArgument(this->name, parsed);
-            contextBuilder.WithNode(this, parsed->GetRange());
+            this->ParseArgument(reader, contextBuilder);
         }
         virtual std::future<Suggestions> ListSuggestions(CommandContext<S>& context, SuggestionsBuilder& builder)
         {
@@ -87,19 +129,65 @@ namespace brigadier
                 return customSuggestions(context, builder);
             }
         }
+        virtual bool WriteArgumentKey(std::string& out) {
+            if constexpr (HasArgumentParameters<T>::value) {
+                size_t typeId = TypeInfo::Create<T>();
+                out.append(reinterpret_cast<const char*>(&typeId), sizeof(typeId));
+                out.append(reinterpret_cast<const char*>(&customSuggestions), sizeof(customSuggestions));
+                ArgumentParameters<T>::Write(type, out);
+                return true;
+            }
+            else return false;
+        }
+        virtual std::shared_ptr<CommandNode<S>> Clone() { return std::make_shared<ArgumentCommandNode<S, T>>(*this); }
+        virtual size_t GetObjectSize() { return sizeof(*this); }
     protected:
         virtual bool IsValidInput(std::string_view input) {
-            try {
-                StringReader reader = StringReader(input);
-                type.Parse(reader);
-                return !reader.CanRead() || reader.Peek() == ' ';
+            StringReader reader = StringReader(input);
+            if constexpr (HasTryParse<T>::value) {
+                typename T::type result{};
+                ExceptionRecord error;
+                if (!type.TryParse(reader, result, error))
+                    return false;
+            }
+            else {
+                try {
+                    type.Parse(reader);
+                }
+                catch (CommandSyntaxException const&) {
+                    return false;
+                }
             }
-            catch (CommandSyntaxException const&) {
-                return false;
+            return !reader.CanRead() || reader.Peek() == ' ';
+        }
+    private:
+        static bool ParseAs(IArgumentCommandNode<S>& node, StringReader& reader, CommandContext<S>& contextBuilder, ExceptionRecord& error) {
+            auto& self = static_cast<ArgumentCommandNode<S, T>&>(node);
+            int start = reader.GetCursor();
+            using Type = typename T::type;
+            if constexpr (HasTryParse<T>::value) {
+                Type result{};
+                if (!self.type.TryParse(reader, result, error))
+                    return false;
+                self.AddArgument(contextBuilder, start, reader.GetCursor(), std::move(result));
             }
+            else {
+                Type result = self.type.Parse(reader);
+                self.AddArgument(contextBuilder, start, reader.GetCursor(), std::move(result));
+            }
+            return true;
+        }
+
+        inline void AddArgument(CommandContext<S>& contextBuilder, int start, int end, typename T::type&& result) {
+            StringRange range = StringRange::Between(start, end);
+            contextBuilder.WithArgument(this->name, ParsedArgument<S, T>::Make(range.GetStart(), range.GetEnd(), std::move(result)));
+            contextBuilder.WithNode(this, range);
         }
     private:
         friend class RequiredArgumentBuilder<S, T>;
+        friend class CommandTreeBinder<S>;
+        template<typename _S, typename Tree>
+        friend class StaticCommandNode;
         T type;
         SuggestionProvider<S> customSuggestions = nullptr;
     };
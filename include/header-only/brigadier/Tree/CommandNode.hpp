@@ -1,11 +1,16 @@
 #pragma once
 
+#include <algorithm>
 #include <map>
 #include <set>
+#include <atomic>
+#include <chrono>
 #include <string>
 #include <tuple>
+#include <vector>
 
 #include "../Functional.hpp"
+#include "../StringInterner.hpp"
 #include "../StringReader.hpp"
 #include "../Suggestion/SuggestionsBuilder.hpp"
 
@@ -21,6 +26,10 @@ namespace brigadier
     class RootCommandNode;
     template<typename S>
     class CommandDispatcher;
+    template<typename S>
+    class CommandTreeBinder;
+    template<typename S, typename Tree>
+    class StaticCommandNode;
 
     template<typename S, typename T, typename node_type>
     class ArgumentBuilder;
@@ -41,40 +50,182 @@ namespace brigadier
         ArgumentCommandNode
     };
 
+    /**
+    Permission mask required by a node that should only be usable with permission level of at least `level`.
+    Sources should report their level with GrantLevel(int).
+    */
+    constexpr PermissionMask RequireLevel(int level)
+    {
+        return level <= 0 ? 0 : level > 64 ? PermissionMask(1) << 63 : PermissionMask(1) << (level - 1);
+    }
+
+    /**
+    Permission mask of a source with permission level `level`. It satisfies RequireLevel(n) for every n <= level.
+    */
+    constexpr PermissionMask GrantLevel(int level)
+    {
+        return level <= 0 ? 0 : level >= 64 ? ~PermissionMask(0) : (PermissionMask(1) << level) - 1;
+    }
+
+    /**
+    Identifies the command tree allowed to modify its nodes in place, usually one per CommandDispatcher.
+
+    Once sealed, nodes marked with it may be shared with another tree (see CommandDispatcher(CommandDispatcher const&)),
+    so they are copied before being modified through a dispatcher and cannot be modified through builders obtained before.
+    */
+    class CommandTreeOwner
+    {
+    public:
+        inline bool IsSealed() const
+        {
+            return sealed.load(std::memory_order_acquire);
+        }
+
+        inline void Seal()
+        {
+            sealed.store(true, std::memory_order_release);
+        }
+
+        // Owner of nodes with several parents, which no tree may modify in place
+        static std::shared_ptr<CommandTreeOwner> const& Shared()
+        {
+            static const std::shared_ptr<CommandTreeOwner> shared = [] {
+                auto owner = std::make_shared<CommandTreeOwner>();
+                owner->Seal();
+                return owner;
+            }();
+            return shared;
+        }
+    private:
+        std::atomic<bool> sealed = false;
+    };
+
+    /**
+    Work done by one parse and its limits, see ParseOptions. Shared with parsers generated by StaticCommandNode,
+    so the nodes they try count as well.
+    */
+    struct ParseBudget
+    {
+        size_t visits = 0;
+        size_t maxVisits = 0; // 0 for no limit
+        bool timed = false;
+        std::chrono::steady_clock::time_point deadline;
+
+        // Counts a node tried at the reader position and aborts the parse once over the limits
+        inline void Visit(StringReader const& reader)
+        {
+            ++visits;
+            if (maxVisits > 0 && visits > maxVisits) {
+                throw CommandSyntaxException::BuiltInExceptions::DispatcherParseBudgetExceeded(reader, "node visit limit");
+            }
+            // reading the clock costs more than a node visit, so it is done only every few visits
+            if (timed && (visits & 31) == 0 && std::chrono::steady_clock::now() > deadline) {
+                throw CommandSyntaxException::BuiltInExceptions::DispatcherParseBudgetExceeded(reader, "time limit");
+            }
+        }
+    };
+
     template<typename S>
     class CommandNode
     {
     public:
-        CommandNode(Command<S> command, Predicate<S&> requirement, std::shared_ptr<CommandNode<S>> redirect, RedirectModifier<S> modifier, const bool forks)
-            : command(std::move(command))
+        CommandNode(CommandNodeType kind, std::string_view name, Command<S> command, Predicate<S&> requirement, std::shared_ptr<CommandNode<S>> redirect, RedirectModifier<S> modifier, const bool forks)
+            : kind(kind)
+            , name(StringInterner::Intern(name))
+            , command(std::move(command))
             , requirement(std::move(requirement))
-            , redirect(std::move(redirect))
             , modifier(std::move(modifier))
             , forks(std::move(forks))
+        {
+            SetRedirect(std::move(redirect));
+            subtree.requirement = this->requirement != nullptr;
+            subtree.redirect = this->redirect != nullptr;
+        }
+        CommandNode(CommandNodeType kind, std::string_view name)
+            : kind(kind)
+            , name(StringInterner::Intern(name))
         {}
-        CommandNode() {}
-        virtual ~CommandNode() = default;
+        CommandNode(CommandNode const& other)
+            : kind(other.kind)
+            , name(other.name)
+            , children(other.children)
+            , literals(other.literals)
+            , arguments(other.arguments)
+            , command(other.command)
+            , requirement(other.requirement)
+            , redirect(other.redirect)
+            , redirectTarget(other.redirectTarget)
+            , modifier(other.modifier)
+            , forks(other.forks)
+            , permissions(other.permissions)
+            , revision(other.revision)
+            , childrenRevision(other.childrenRevision)
+            , attachRevision(other.attachRevision)
+            , removedChildren(other.removedChildren)
+            , removedHorizon(other.removedHorizon)
+            , subtree(other.subtree)
+        {}
+        CommandNode& operator=(CommandNode const&) = delete;
+        virtual ~CommandNode()
+        {
+            if (IsWritable()) {
+                for (auto& [name, child] : children)
+                    Unlink(child.get());
+            }
+        }
     public:
+        inline CommandNodeType GetNodeType() const
+        {
+            return kind;
+        }
+
+        inline std::string_view GetName() const
+        {
+            return name;
+        }
+
+        /**
+        Parses the rest of the input below this node with a parser generated at compile time, see StaticCommandNode.
+
+        \param budget counts the nodes tried, throws CommandSyntaxException once over its limits
+        \return false if this node has no such parser or it could not parse a complete command, `reader` and `context` are not changed then
+        */
+        inline bool ParseCompiled(StringReader& reader, CommandContext<S>& context, PermissionMask permissions, ParseBudget& budget)
+        {
+            return compiledParse != nullptr && compiledParse(*this, reader, context, permissions, budget);
+        }
+
+        inline bool ParseCompiled(StringReader& reader, CommandContext<S>& context, PermissionMask permissions)
+        {
+            ParseBudget unlimited;
+            return ParseCompiled(reader, context, permissions, unlimited);
+        }
+
         inline Command<S> GetCommand() const
         {
             return command;
         }
 
-        inline std::map<std::string, std::shared_ptr<CommandNode<S>>, std::less<>> const& GetChildren() const
+        inline std::map<std::string_view, std::shared_ptr<CommandNode<S>>, std::less<>> const& GetChildren() const
         {
             return children;
         }
 
-        inline std::shared_ptr<CommandNode<S>> GetChild(std::string_view name) const
+        // Returned by reference, so that walking the tree does not change reference counts. Copy the pointer to keep the node alive.
+        inline std::shared_ptr<CommandNode<S>> const& GetChild(std::string_view name) const
         {
+            static const std::shared_ptr<CommandNode<S>> none;
             auto found = children.find(name);
             if (found != children.end())
                 return found->second;
-            return nullptr;
+            return none;
         }
 
+        // A redirect to a node above this one does not keep it alive (see SetRedirect()), then this is nullptr once that node is freed
         inline std::shared_ptr<CommandNode<S>> GetRedirect() const
         {
+            if (redirect != nullptr && redirect.use_count() == 0)
+                return redirectTarget.lock();
             return redirect;
         }
 
@@ -88,11 +239,50 @@ namespace brigadier
             return requirement;
         }
 
+        inline PermissionMask GetPermissions() const
+        {
+            return permissions;
+        }
+
+        /**
+        Union of permissions required by this node and every node below it. Redirects are not followed.
+        */
+        inline PermissionMask GetSubtreePermissions() const
+        {
+            return subtree.permissions;
+        }
+
+        /**
+        Revision of the last change made to this node's command, requirements or redirect.
+        Revisions come from a process-wide counter, so they are comparable between nodes.
+        */
+        inline size_t GetRevision() const
+        {
+            return revision;
+        }
+
+        /**
+        Highest revision found in this subtree. Changes whenever any node below (and including) this node is modified,
+        or a child is added anywhere in the subtree.
+        */
+        inline size_t GetSubtreeRevision() const
+        {
+            return subtree.revision;
+        }
+
         inline bool IsFork() const
         {
             return forks;
         }
 
+        /**
+        Checks if this node can be modified in place. Nodes that are not a part of any tree yet always can.
+        */
+        inline bool IsWritable() const
+        {
+            return owner == nullptr || !owner->IsSealed();
+        }
+
         inline bool CanUse(S& source)
         {
             if (requirement)
@@ -100,11 +290,31 @@ namespace brigadier
             else return true;
         }
 
+        inline bool CanUse(S& source, PermissionMask granted)
+        {
+            return HasPermissions(granted) && CanUse(source);
+        }
+
+        inline bool HasPermissions(PermissionMask granted) const
+        {
+            return (permissions & ~granted) == 0;
+        }
+
+        /**
+        Checks if a source with `granted` permissions can use every node of this subtree (including this node),
+        so that further checks below can be skipped. Always false if any node of the subtree has a Predicate requirement.
+        */
+        inline bool CanUseSubtree(PermissionMask granted) const
+        {
+            return !subtree.requirement && (subtree.permissions & ~granted) == 0;
+        }
+
         void AddChild(std::shared_ptr<CommandNode<S>> node)
         {
             if (node == nullptr)
                 return;
 
+            CheckWritable();
             if (node->GetNodeType() == CommandNodeType::RootCommandNode) {
                 throw std::runtime_error("Cannot add a RootCommandNode as a child to any other CommandNode");
             }
@@ -112,21 +322,30 @@ namespace brigadier
             auto child = children.find(node->GetName());
             if (child != children.end()) {
                 // We've found something to merge onto
-                auto child_node = child->second;
-
-                if (child_node->GetNodeType() != node->GetNodeType())
+                if (child->second->GetNodeType() != node->GetNodeType())
                     throw std::runtime_error("Node type (literal/argument) mismatch!");
 
+                auto child_node = GetOwnedChild(child->first);
+
                 auto node_command = node->GetCommand();
                 if (node_command != nullptr) {
                     child_node->command = node_command;
+                    child_node->Modified();
                 }
                 for (auto& [name, grandchild] : node->GetChildren()) {
                     child_node->AddChild(grandchild);
                 }
             }
             else {
+                if (!node->IsWritable())
+                    node = node->Clone(); // shared with another tree, so it cannot be marked as attached here
+                if (owner != nullptr)
+                    node->Adopt(owner);
+                childrenRevision = node->attachRevision = NextRevision();
+                Link(node.get());
                 children.emplace(node->GetName(), node);
+                node->MergeSubtree({ node->attachRevision });
+                MergeSubtree(node->subtree);
                 if (node->GetNodeType() == CommandNodeType::LiteralCommandNode) {
                     literals.emplace_back(std::move(std::static_pointer_cast<LiteralCommandNode<S>>(std::move(node))));
                 }
@@ -136,6 +355,41 @@ namespace brigadier
             }
         }
 
+        /**
+        Removes a child node together with its subtree.
+
+        Redirects pointing into the removed subtree are not changed, see CommandDispatcher::Unregister to find them.
+
+        \param name name of the child
+        \return the removed node, or nullptr if there is no such child
+        */
+        std::shared_ptr<CommandNode<S>> RemoveChild(std::string_view name)
+        {
+            CheckWritable();
+            auto found = children.find(name);
+            if (found == children.end())
+                return nullptr;
+
+            auto node = std::move(found->second);
+            children.erase(found);
+            if (node->GetNodeType() == CommandNodeType::LiteralCommandNode) {
+                auto literal = std::find(literals.begin(), literals.end(), node);
+                std::swap(*literal, literals.back());
+                literals.pop_back();
+            }
+            else {
+                arguments.erase(std::find(arguments.begin(), arguments.end(), node));
+            }
+            Unlink(node.get());
+            childrenRevision = NextRevision();
+            auto [removed, added] = removedChildren.try_emplace(node->GetName(), RemovedChild{ node->name, node->attachRevision });
+            removed->second.removed = childrenRevision;
+            if (removedChildren.size() > children.size() + REMOVED_CHILDREN_SLACK)
+                ForgetRemovedChildren();
+            UpdateSubtree();
+            return node;
+        }
+
         void FindAmbiguities(AmbiguityConsumer<S> consumer)
         {
             for (auto [child_name, child] : children) {
@@ -169,19 +423,27 @@ namespace brigadier
                 }
                 std::string_view text = input.GetString().substr(cursor, input.GetCursor() - cursor);
                 input.SetCursor(cursor);
-                auto literal = children.find(text);
-                if (literal != children.end() && literal->second->GetNodeType() == CommandNodeType::LiteralCommandNode) {
-                    return std::tuple<std::shared_ptr<CommandNode<S>>*, size_t>(&literal->second, 1);
-                }
-                else {
-                    return std::tuple<std::shared_ptr<CommandNode<S>>*, size_t>((std::shared_ptr<CommandNode<S>>*)arguments.data(), arguments.size());
-                }
+                return GetRelevantNodes(text);
             }
             else {
                 return std::tuple<std::shared_ptr<CommandNode<S>>*, size_t>((std::shared_ptr<CommandNode<S>>*)arguments.data(), arguments.size());
             }
         }
 
+        /**
+        Same as GetRelevantNodes(StringReader&), for a word already read from the input (see StringTokens).
+        */
+        std::tuple<std::shared_ptr<CommandNode<S>>*, size_t> GetRelevantNodes(std::string_view word)
+        {
+            if (literals.size() > 0) {
+                auto literal = children.find(word);
+                if (literal != children.end() && literal->second->GetNodeType() == CommandNodeType::LiteralCommandNode) {
+                    return std::tuple<std::shared_ptr<CommandNode<S>>*, size_t>(&literal->second, 1);
+                }
+            }
+            return std::tuple<std::shared_ptr<CommandNode<S>>*, size_t>((std::shared_ptr<CommandNode<S>>*)arguments.data(), arguments.size());
+        }
+
         bool HasCommand()
         {
             if (GetCommand() != nullptr) return true;
@@ -191,13 +453,16 @@ namespace brigadier
             return false;
         }
     public:
-        virtual std::string const& GetName() = 0;
         virtual std::string GetUsageText() = 0;
         virtual std::vector<std::string_view> GetExamples() = 0;
         virtual void Parse(StringReader& reader, CommandContext<S>& contextBuilder) = 0;
         virtual std::future<Suggestions> ListSuggestions(CommandContext<S>& context, SuggestionsBuilder& builder) = 0;
 
-        virtual CommandNodeType GetNodeType() = 0;
+        // Shallow copy of this node. The copy shares children with the original.
+        virtual std::shared_ptr<CommandNode<S>> Clone() = 0;
+
+        // Size of the node object, without memory owned by its members.
+        virtual size_t GetObjectSize() = 0;
     protected:
         template<typename _S, typename T, typename node_type>
         friend class ArgumentBuilder;
@@ -209,17 +474,289 @@ namespace brigadier
         friend class RequiredArgumentBuilder;
         template<typename _S>
         friend class LiteralArgumentBuilder;
+        template<typename _S>
+        friend class CommandTreeBinder;
+        template<typename _S, typename Tree>
+        friend class StaticCommandNode;
 
         virtual bool IsValidInput(std::string_view input) = 0;
         virtual std::string_view GetSortedKey() = 0;
+
+        // Stamps this node with a new revision and updates subtree data of this node and its ancestors.
+        // Has to be called on each change of command, requirements, permissions or redirect.
+        inline void Modified()
+        {
+            revision = NextRevision();
+            UpdateSubtree();
+        }
+
+        inline void CheckWritable() const
+        {
+            if (!IsWritable())
+                throw std::runtime_error("Cannot modify a node shared with another command tree, get a new builder from the dispatcher");
+        }
+
+        static inline size_t NextRevision()
+        {
+            return clock.fetch_add(1, std::memory_order_relaxed) + 1;
+        }
+
+        // A redirect does not keep its target alive while the target is above this node, i.e. every way up from this node passes it
+        // (including the root of its own tree). The tree keeps such a target alive, and owning it would make the tree keep itself alive
+        // and never be freed, e.g. the versions replaced by CommandDispatcher::Replace(). This is checked again whenever the parents
+        // above this node change, see Link(). Ways up through trees that share this node are not tracked, so the target is also
+        // referenced weakly and GetRedirect() returns nullptr instead of a freed node.
+        void SetRedirect(std::shared_ptr<CommandNode<S>> target)
+        {
+            redirectTarget = target;
+            redirect = std::move(target);
+            UpdateRedirectOwnership();
+        }
+
+        // Moves the redirect of a copy to the copy of its target, which is above the copy if the original target was above the original
+        void RelinkRedirect(std::shared_ptr<CommandNode<S>> target)
+        {
+            bool above = redirect != nullptr && redirect.use_count() == 0;
+            redirectTarget = target;
+            redirect = above ? std::shared_ptr<CommandNode<S>>(std::shared_ptr<void>(), target.get()) : std::move(target);
+        }
+
+        // Owns the redirect target only if it is not above this node, see SetRedirect().
+        // Returns the reference given up, so that the caller can release it once it no longer walks the tree.
+        std::shared_ptr<CommandNode<S>> UpdateRedirectOwnership()
+        {
+            if (redirect == nullptr)
+                return nullptr;
+            bool owning = redirect.use_count() != 0;
+            bool above = IsBelow(redirect.get());
+            if (above && owning) {
+                auto released = std::move(redirect);
+                redirect = std::shared_ptr<CommandNode<S>>(std::shared_ptr<void>(), released.get());
+                return released;
+            }
+            if (!above && !owning) {
+                // a target that is being freed, e.g. the parent unlinking this node in its destructor, stays expired
+                if (auto target = redirectTarget.lock())
+                    redirect = std::move(target);
+            }
+            return nullptr;
+        }
+
+        // Updates the redirects below `node` after the ways up from it changed, see SetRedirect().
+        // Only nodes of the same tree are visited, their parents are the ones tracked by Link().
+        static void UpdateRedirectsBelow(CommandNode<S>* node)
+        {
+            if (!node->subtree.redirect)
+                return;
+
+            std::vector<std::shared_ptr<CommandNode<S>>> released; // freed after the walk, as a freed node unlinks its children
+            std::vector<CommandNode<S>*> pending{ node };
+            std::set<CommandNode<S>*> visited{ node };
+            while (!pending.empty()) {
+                auto current = pending.back();
+                pending.pop_back();
+                if (auto previous = current->UpdateRedirectOwnership())
+                    released.push_back(std::move(previous));
+                for (auto& [name, child] : current->children) {
+                    if (child->subtree.redirect && child->owner == node->owner && visited.insert(child.get()).second)
+                        pending.push_back(child.get());
+                }
+            }
+        }
+
+        // Whether every way up from this node passes `ancestor`. Parents are only known between writable nodes, see Link().
+        bool IsBelow(CommandNode<S>* ancestor) const
+        {
+            std::vector<const CommandNode<S>*> pending{ this };
+            std::set<const CommandNode<S>*> visited{ this };
+            while (!pending.empty()) {
+                auto node = pending.back();
+                pending.pop_back();
+                if (node == ancestor)
+                    continue;
+                if (node->parents.empty())
+                    return false;
+                for (auto parent : node->parents) {
+                    if (visited.insert(parent).second)
+                        pending.push_back(parent);
+                }
+            }
+            return true;
+        }
+
+        // Gets a child that can be modified in place. A child shared with another tree is copied first, see CommandDispatcher(CommandDispatcher const&).
+        // This node has to be writable.
+        std::shared_ptr<CommandNode<S>> GetOwnedChild(std::string_view name)
+        {
+            auto found = children.find(name);
+            if (found == children.end())
+                return nullptr;
+            if (found->second->owner == owner)
+                return found->second;
+
+            auto copy = found->second->Clone();
+            copy->owner = owner;
+            ReplaceChild(copy);
+            return copy;
+        }
+
+        // Replaces the child of the same name with a copy, keeping its position. Revisions are not changed.
+        void ReplaceChild(std::shared_ptr<CommandNode<S>> node)
+        {
+            auto& child = children.find(node->GetName())->second;
+            Unlink(child.get());
+            Link(node.get());
+            MergeSubtree(node->subtree);
+            if (node->GetNodeType() == CommandNodeType::LiteralCommandNode) {
+                *std::find(literals.begin(), literals.end(), child) = std::static_pointer_cast<LiteralCommandNode<S>>(node);
+            }
+            else {
+                *std::find(arguments.begin(), arguments.end(), child) = std::static_pointer_cast<IArgumentCommandNode<S>>(node);
+            }
+            child = std::move(node);
+        }
     private:
-        std::map<std::string, std::shared_ptr<CommandNode<S>>, std::less<>> children;
+        // Marks nodes that are not a part of any tree yet, e.g. built with MakeLiteral(), as nodes of the tree
+        void Adopt(std::shared_ptr<CommandTreeOwner> const& tree)
+        {
+            if (owner != nullptr)
+                return;
+            owner = tree;
+            for (auto& [name, child] : children)
+                child->Adopt(tree);
+        }
+
+        // Summary of a subtree, kept up to date by every change so that reading it never writes
+        struct SubtreeData
+        {
+            size_t revision = 0;
+            PermissionMask permissions = 0;
+            bool requirement = false;
+            bool redirect = false;
+
+            inline void Merge(SubtreeData const& other)
+            {
+                revision = (std::max)(revision, other.revision);
+                permissions |= other.permissions;
+                requirement |= other.requirement;
+                redirect |= other.redirect;
+            }
+
+            inline bool operator==(SubtreeData const& other) const
+            {
+                return revision == other.revision && permissions == other.permissions && requirement == other.requirement && redirect == other.redirect;
+            }
+        };
+
+        // Parents are tracked only between writable nodes of the same tree, because other nodes do not change any more
+        // and may be shared with other trees, possibly released on another thread.
+        void Link(CommandNode<S>* child)
+        {
+            if (child->owner == owner && IsWritable()) {
+                child->parents.push_back(this);
+                UpdateRedirectsBelow(child);
+            }
+        }
+
+        void Unlink(CommandNode<S>* child)
+        {
+            if (child->owner != owner || !IsWritable())
+                return;
+            auto found = std::find(child->parents.begin(), child->parents.end(), this);
+            if (found != child->parents.end()) {
+                child->parents.erase(found);
+                UpdateRedirectsBelow(child);
+            }
+        }
+
+        // Forgets the older half of the removed children. Deltas since an older version re-send this node instead, see CommandDispatcher::GetDelta(size_t).
+        void ForgetRemovedChildren()
+        {
+            std::vector<size_t> revisions;
+            revisions.reserve(removedChildren.size());
+            for (auto& [name, removed] : removedChildren)
+                revisions.push_back(removed.removed);
+            auto middle = revisions.begin() + revisions.size() / 2;
+            std::nth_element(revisions.begin(), middle, revisions.end());
+            removedHorizon = (std::max)(removedHorizon, *middle);
+            for (auto entry = removedChildren.begin(); entry != removedChildren.end();) {
+                if (entry->second.removed <= removedHorizon)
+                    entry = removedChildren.erase(entry);
+                else
+                    ++entry;
+            }
+        }
+
+        // Recomputes subtree data after a change that may have removed something from it, e.g. a removed child
+        void UpdateSubtree()
+        {
+            SubtreeData data{ (std::max)({ revision, childrenRevision, attachRevision }), permissions, requirement != nullptr, redirect != nullptr };
+            for (auto& [name, child] : children)
+                data.Merge(child->subtree);
+            SetSubtree(data);
+        }
+
+        // Adds data of a changed descendant
+        void MergeSubtree(SubtreeData const& data)
+        {
+            SubtreeData merged = subtree;
+            merged.Merge(data);
+            SetSubtree(merged);
+        }
+
+        void SetSubtree(SubtreeData const& data)
+        {
+            if (data == subtree)
+                return;
+            SubtreeData previous = subtree;
+            subtree = data;
+            previous.Merge(data);
+            if (previous == data) {
+                // only grown, so ancestors can merge it instead of visiting all their children
+                for (auto parent : parents)
+                    parent->MergeSubtree(data);
+            }
+            else {
+                for (auto parent : parents)
+                    parent->UpdateSubtree();
+            }
+        }
+    protected:
+        // plain fields instead of virtual functions, because they are checked for every candidate node while parsing
+        CommandNodeType kind;
+        InternedString name; // see StringInterner
+        // set by StaticCommandNode only, so it is not copied by the copy constructor
+        bool(*compiledParse)(CommandNode<S>& node, StringReader& reader, CommandContext<S>& context, PermissionMask permissions, ParseBudget& budget) = nullptr;
+    private:
+        static inline std::atomic<size_t> clock{ 1 };
+        static constexpr size_t REMOVED_CHILDREN_SLACK = 64; // removed children remembered besides one per existing child
+
+        // Children removed with the same name are merged, so the entry covers the first time one was added until the last removal.
+        // A child added with the name again keeps the entry, which only matters once it is removed as well.
+        struct RemovedChild
+        {
+            InternedString name; // keeps the key of removedChildren
+            size_t attached;
+            size_t removed = 0;
+        };
+
+        std::map<std::string_view, std::shared_ptr<CommandNode<S>>, std::less<>> children; // keys are interned names of the children, see StringInterner
         std::vector<std::shared_ptr<LiteralCommandNode<S>>> literals;
         std::vector<std::shared_ptr<IArgumentCommandNode<S>>> arguments;
         Command<S> command = nullptr;
         Predicate<S&> requirement = nullptr;
-        std::shared_ptr<CommandNode<S>> redirect = nullptr;
+        std::shared_ptr<CommandNode<S>> redirect = nullptr; // does not own a target above this node, see SetRedirect()
+        std::weak_ptr<CommandNode<S>> redirectTarget;
         RedirectModifier<S> modifier = nullptr;
         bool forks = false;
+        PermissionMask permissions = 0;
+        size_t revision = 0;          // own properties, see Modified()
+        size_t childrenRevision = 0;  // last change of children
+        size_t attachRevision = 0;    // last time this node was added as a child
+        std::map<std::string_view, RemovedChild, std::less<>> removedChildren; // by name, see CommandDispatcher::GetDelta(size_t)
+        size_t removedHorizon = 0;    // removals up to this revision are forgotten
+        std::shared_ptr<CommandTreeOwner> owner; // tree allowed to modify this node in place, null if not a part of one yet
+        std::vector<CommandNode<S>*> parents; // writable parents, whose subtree data includes this node, see Link()
+        SubtreeData subtree;
     };
 }
@@ -0,0 +1,440 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "RootCommandNode.hpp"
+#include "LiteralCommandNode.hpp"
+#include "ArgumentCommandNode.hpp"
+#include "../Arguments/ArgumentTypeRegistry.hpp"
+
+namespace brigadier
+{
+    /**
+    Read-only view of a compiled command tree stored in a contiguous block of memory, e.g. a memory mapped file.
+
+    The image is laid out as a header, a table of fixed size node records, a table of child indices, a string pool
+    and a blob of argument type parameters. Nothing is copied; the constructor only validates that every offset and index is in bounds
+    and that children do not form a cycle.
+    Images are written and loaded by CommandTreeBinder, which also rebinds commands, requirements and suggestion providers by their IDs.
+    The dispatcher does not parse from the image: loading builds the full node graph, see CommandTreeBinder::ReadImage.
+
+    The memory has to stay valid and be aligned to at least 8 bytes for the lifetime of the view.
+    */
+    class CommandTreeImage
+    {
+    public:
+        static constexpr uint32_t MAGIC = 0x54524742; // "BGRT"
+        static constexpr uint32_t VERSION = 1;
+        static constexpr uint32_t NONE = ~uint32_t(0);
+
+        struct Header
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t nodeCount;
+            uint32_t childCount;
+            uint32_t stringsSize;
+            uint32_t parametersSize;
+            uint32_t reserved[2];
+        };
+
+        struct Node
+        {
+            PermissionMask permissions;
+            uint32_t name;
+            uint32_t nameLength;
+            uint32_t children;      // first entry in the child table
+            uint32_t childCount;
+            uint32_t redirect;      // node index or NONE
+            uint32_t command;       // IDs bound in CommandTreeBinder, 0 if not set
+            uint32_t requirement;
+            uint32_t modifier;
+            uint32_t suggestions;
+            uint32_t argumentType;
+            uint32_t parameters;
+            uint32_t parametersLength;
+            uint8_t type;           // CommandNodeType
+            uint8_t forks;
+            uint8_t reserved[6];
+        };
+        static_assert(sizeof(Header) == 32 && sizeof(Node) == 64, "Unexpected image record layout");
+    public:
+        CommandTreeImage(void const* data, size_t size) : data(static_cast<const char*>(data)), size(size)
+        {
+            if (size < sizeof(Header) || reinterpret_cast<uintptr_t>(data) % alignof(Node) != 0)
+                throw std::runtime_error("Invalid command tree image");
+            auto& header = GetHeader();
+            if (header.magic != MAGIC)
+                throw std::runtime_error("Invalid command tree image");
+            if (header.version != VERSION)
+                throw std::runtime_error("Unsupported command tree image version");
+
+            uint64_t expected = sizeof(Header) + uint64_t(header.nodeCount) * sizeof(Node) + uint64_t(header.childCount) * sizeof(uint32_t) + header.stringsSize + header.parametersSize;
+            if (expected != size || header.nodeCount == 0)
+                throw std::runtime_error("Invalid command tree image");
+
+            for (uint32_t i = 0; i < header.nodeCount; ++i) {
+                auto& node = GetNode(i);
+                bool valid = node.type <= uint8_t(CommandNodeType::ArgumentCommandNode)
+                    && (node.type == uint8_t(CommandNodeType::RootCommandNode)) == (i == 0)
+                    && uint64_t(node.name) + node.nameLength <= header.stringsSize
+                    && uint64_t(node.children) + node.childCount <= header.childCount
+                    && (node.redirect == NONE || node.redirect < header.nodeCount)
+                    && uint64_t(node.parameters) + node.parametersLength <= header.parametersSize;
+                if (!valid)
+                    throw std::runtime_error("Invalid command tree image");
+            }
+            for (uint32_t i = 0; i < header.childCount; ++i) {
+                if (GetChildIndices()[i] == 0 || GetChildIndices()[i] >= header.nodeCount)
+                    throw std::runtime_error("Invalid command tree image");
+            }
+            CheckAcyclic();
+        }
+    public:
+        inline Header const& GetHeader() const
+        {
+            return *reinterpret_cast<Header const*>(data);
+        }
+
+        inline uint32_t GetNodeCount() const
+        {
+            return GetHeader().nodeCount;
+        }
+
+        inline Node const& GetNode(uint32_t index) const
+        {
+            return reinterpret_cast<Node const*>(data + sizeof(Header))[index];
+        }
+
+        inline std::string_view GetName(Node const& node) const
+        {
+            return std::string_view(GetStrings() + node.name, node.nameLength);
+        }
+
+        inline std::string_view GetParameters(Node const& node) const
+        {
+            return std::string_view(GetStrings() + GetHeader().stringsSize + node.parameters, node.parametersLength);
+        }
+
+        inline uint32_t const* GetChildren(Node const& node) const
+        {
+            return GetChildIndices() + node.children;
+        }
+    private:
+        // Nodes may have several parents, but a node cannot be its own descendant. Redirects may point anywhere.
+        void CheckAcyclic() const
+        {
+            enum : uint8_t { Unvisited, Open, Closed };
+            std::vector<uint8_t> states(GetNodeCount(), Unvisited);
+            std::vector<std::pair<uint32_t, uint32_t>> stack; // node and its next child, explicit so that deep images cannot overflow the call stack
+            for (uint32_t start = 0; start < GetNodeCount(); ++start) {
+                if (states[start] != Unvisited)
+                    continue;
+                states[start] = Open;
+                stack.emplace_back(start, 0);
+                while (!stack.empty()) {
+                    auto& node = GetNode(stack.back().first);
+                    if (stack.back().second == node.childCount) {
+                        states[stack.back().first] = Closed;
+                        stack.pop_back();
+                        continue;
+                    }
+                    uint32_t child = GetChildren(node)[stack.back().second++];
+                    if (states[child] == Open)
+                        throw std::runtime_error("Invalid command tree image");
+                    if (states[child] == Unvisited) {
+                        states[child] = Open;
+                        stack.emplace_back(child, 0);
+                    }
+                }
+            }
+        }
+
+        inline uint32_t const* GetChildIndices() const
+        {
+            return reinterpret_cast<uint32_t const*>(data + sizeof(Header) + size_t(GetHeader().nodeCount) * sizeof(Node));
+        }
+
+        inline const char* GetStrings() const
+        {
+            return reinterpret_cast<const char*>(GetChildIndices() + GetHeader().childCount);
+        }
+    private:
+        const char* data;
+        size_t size;
+    };
+
+    /**
+    Assigns IDs to commands, requirements, redirect modifiers, suggestion providers and argument types,
+    so that a command tree can be written to a CommandTreeImage and loaded back without registering it again.
+
+    IDs have to be the same for the writer and the loader. ID 0 is reserved for "not set".
+
+    \param <S> a custom "source" type, such as a user or originator of a command
+    */
+    template<typename S>
+    class CommandTreeBinder
+    {
+    public:
+        void BindCommand(uint32_t id, Command<S> command)
+        {
+            Bind(commands, id, command);
+        }
+
+        void BindRequirement(uint32_t id, Predicate<S&> requirement)
+        {
+            Bind(requirements, id, requirement);
+        }
+
+        void BindRedirectModifier(uint32_t id, RedirectModifier<S> modifier)
+        {
+            Bind(modifiers, id, modifier);
+        }
+
+        void BindSuggestions(uint32_t id, SuggestionProvider<S> provider)
+        {
+            Bind(suggestions, id, provider);
+        }
+
+        // Binds an argument type registered with REGISTER_ARGTYPE* macros under its stable ID (see GetArgumentTypeId()).
+        template<typename T>
+        void BindArgumentType()
+        {
+            BindArgumentType<T>(GetArgumentTypeId<T>());
+        }
+
+        template<typename T>
+        void BindArgumentType(uint32_t id)
+        {
+            if (id == 0)
+                throw std::runtime_error("ID 0 is reserved");
+            argumentTypes.byId[id] = { &ReadArgument<T>, &WriteArgument<T> };
+            argumentTypes.ids[TypeInfo::Create<T>()] = id;
+        }
+
+        /**
+        Writes a command tree to a new image. Every command, requirement, redirect modifier, suggestion provider and argument type
+        found in the tree has to be bound, otherwise std::runtime_error is thrown.
+
+        \param root the root of the tree
+        \return bytes of the image, see CommandTreeImage
+        */
+        std::string WriteImage(RootCommandNode<S>* root) const
+        {
+            std::map<CommandNode<S>*, uint32_t> indices;
+            std::vector<CommandNode<S>*> nodes;
+            std::vector<CommandNode<S>*> pending = { root };
+            while (!pending.empty()) {
+                auto node = pending.back();
+                pending.pop_back();
+                if (!indices.emplace(node, uint32_t(nodes.size())).second)
+                    continue;
+                nodes.push_back(node);
+                if (auto target = node->GetRedirect())
+                    pending.push_back(target.get());
+                for (auto it = node->arguments.rbegin(); it != node->arguments.rend(); ++it)
+                    pending.push_back(it->get());
+                for (auto it = node->literals.rbegin(); it != node->literals.rend(); ++it)
+                    pending.push_back(it->get());
+            }
+            if (nodes[0]->GetNodeType() != CommandNodeType::RootCommandNode || std::any_of(nodes.begin() + 1, nodes.end(), [](CommandNode<S>* node) { return node->GetNodeType() == CommandNodeType::RootCommandNode; }))
+                throw std::runtime_error("Cannot write a tree redirecting to another root");
+
+            std::vector<CommandTreeImage::Node> records(nodes.size());
+            std::vector<uint32_t> children;
+            std::string strings;
+            std::string parameters;
+            for (size_t i = 0; i < nodes.size(); ++i) {
+                auto node = nodes[i];
+                auto& record = records[i];
+                record.permissions = node->permissions;
+                record.name = uint32_t(strings.size());
+                record.nameLength = uint32_t(node->GetName().size());
+                strings += node->GetName();
+                record.children = uint32_t(children.size());
+                record.childCount = uint32_t(node->literals.size() + node->arguments.size());
+                for (auto& literal : node->literals)
+                    children.push_back(indices[literal.get()]);
+                for (auto& argument : node->arguments)
+                    children.push_back(indices[argument.get()]);
+                auto target = node->GetRedirect();
+                record.redirect = target ? indices[target.get()] : CommandTreeImage::NONE;
+                record.command = Find(commands, node->command, "Command");
+                record.requirement = Find(requirements, node->requirement, "Requirement");
+                record.modifier = i == 0 ? 0 : Find(modifiers, node->modifier, "Redirect modifier");
+                record.type = uint8_t(node->GetNodeType());
+                record.forks = node->forks;
+                if (record.type == uint8_t(CommandNodeType::ArgumentCommandNode)) {
+                    auto argument = static_cast<IArgumentCommandNode<S>*>(node);
+                    auto type = argumentTypes.ids.find(argument->GetTypeInfo().hash);
+                    if (type == argumentTypes.ids.end())
+                        throw std::runtime_error("Argument type of '" + std::string(node->GetName()) + "' is not bound");
+                    record.argumentType = type->second;
+                    record.parameters = uint32_t(parameters.size());
+                    record.suggestions = argumentTypes.byId.at(type->second).write(argument, parameters, *this);
+                    record.parametersLength = uint32_t(parameters.size() - record.parameters);
+                }
+            }
+
+            CommandTreeImage::Header header = {};
+            header.magic = CommandTreeImage::MAGIC;
+            header.version = CommandTreeImage::VERSION;
+            header.nodeCount = uint32_t(records.size());
+            header.childCount = uint32_t(children.size());
+            header.stringsSize = uint32_t(strings.size());
+            header.parametersSize = uint32_t(parameters.size());
+
+            std::string image;
+            image.reserve(sizeof(header) + records.size() * sizeof(CommandTreeImage::Node) + children.size() * sizeof(uint32_t) + strings.size() + parameters.size());
+            image.append(reinterpret_cast<const char*>(&header), sizeof(header));
+            image.append(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(CommandTreeImage::Node));
+            image.append(reinterpret_cast<const char*>(children.data()), children.size() * sizeof(uint32_t));
+            image += strings;
+            image += parameters;
+            return image;
+        }
+
+        /**
+        Creates a command tree from an image. IDs stored in the image are resolved to the bound callbacks and argument types.
+        Every node of the image is allocated and every child is inserted into its parent, the same as when the tree is registered,
+        so the cost of loading grows with the size of the tree. The nodes do not refer to the image once it is loaded.
+
+        \param image the image to load
+        \return the root of a new command tree, e.g. to be passed to CommandDispatcher(std::shared_ptr<RootCommandNode>)
+        */
+        std::shared_ptr<RootCommandNode<S>> ReadImage(CommandTreeImage const& image) const
+        {
+            uint32_t count = image.GetNodeCount();
+            std::vector<std::shared_ptr<CommandNode<S>>> nodes(count);
+            auto root = std::make_shared<RootCommandNode<S>>();
+            nodes[0] = root;
+            for (uint32_t i = 1; i < count; ++i) {
+                auto& record = image.GetNode(i);
+                if (record.type == uint8_t(CommandNodeType::LiteralCommandNode)) {
+                    nodes[i] = std::make_shared<LiteralCommandNode<S>>(image.GetName(record));
+                }
+                else {
+                    auto type = argumentTypes.byId.find(record.argumentType);
+                    if (type == argumentTypes.byId.end()) {
+                        auto registered = ArgumentTypeRegistry::Find(record.argumentType);
+                        throw std::runtime_error("Argument type " + (registered ? std::string(registered->name) : std::to_string(record.argumentType)) + " is not bound");
+                    }
+                    nodes[i] = type->second.read(image.GetName(record), image.GetParameters(record), Get(suggestions, record.suggestions, "Suggestion provider"));
+                }
+            }
+
+            for (uint32_t i = 0; i < count; ++i) {
+                auto& record = image.GetNode(i);
+                auto& node = nodes[i];
+                node->permissions = record.permissions;
+                node->command = Get(commands, record.command, "Command");
+                node->requirement = Get(requirements, record.requirement, "Requirement");
+                if (i != 0)
+                    node->modifier = Get(modifiers, record.modifier, "Redirect modifier");
+                node->forks = record.forks != 0;
+
+                node->Modified();
+                node->childrenRevision = node->revision;
+                auto children = image.GetChildren(record);
+                for (uint32_t c = 0; c < record.childCount; ++c) {
+                    auto& child = nodes[children[c]];
+                    child->attachRevision = node->revision;
+                    if (!node->children.emplace(child->GetName(), child).second)
+                        throw std::runtime_error("Duplicate child '" + std::string(child->GetName()) + "' in command tree image");
+                    node->Link(child.get());
+                    if (child->GetNodeType() == CommandNodeType::LiteralCommandNode)
+                        node->literals.emplace_back(std::static_pointer_cast<LiteralCommandNode<S>>(child));
+                    else
+                        node->arguments.emplace_back(std::static_pointer_cast<IArgumentCommandNode<S>>(child));
+                }
+            }
+            // once all nodes are linked, so that redirects to nodes above do not keep them alive
+            for (uint32_t i = 0; i < count; ++i) {
+                auto& record = image.GetNode(i);
+                if (record.redirect != CommandTreeImage::NONE)
+                    nodes[i]->SetRedirect(nodes[record.redirect]);
+            }
+            // children are mostly written after their parents, so going backwards rarely updates a node twice
+            for (uint32_t i = count; i-- > 0;)
+                nodes[i]->UpdateSubtree();
+            return root;
+        }
+    private:
+        template<typename T>
+        static std::shared_ptr<CommandNode<S>> ReadArgument(std::string_view name, std::string_view parameters, SuggestionProvider<S> provider)
+        {
+            auto node = std::make_shared<ArgumentCommandNode<S, T>>(name, ArgumentParameters<T>::Read(parameters));
+            node->customSuggestions = provider;
+            return node;
+        }
+
+        template<typename T>
+        static uint32_t WriteArgument(IArgumentCommandNode<S>* argument, std::string& parameters, CommandTreeBinder<S> const& binder)
+        {
+            auto node = static_cast<ArgumentCommandNode<S, T>*>(argument);
+            ArgumentParameters<T>::Write(node->GetType(), parameters);
+            return binder.Find(binder.suggestions, node->customSuggestions, "Suggestion provider");
+        }
+
+        template<typename F>
+        struct Callbacks
+        {
+            std::map<uint32_t, F> byId;
+            std::map<F, uint32_t> ids;
+        };
+
+        template<typename F>
+        static void Bind(Callbacks<F>& callbacks, uint32_t id, F callback)
+        {
+            if (id == 0)
+                throw std::runtime_error("ID 0 is reserved");
+            if (callback == nullptr)
+                throw std::runtime_error("Cannot bind empty callback");
+            callbacks.byId[id] = callback;
+            callbacks.ids[callback] = id;
+        }
+
+        template<typename F>
+        static uint32_t Find(Callbacks<F> const& callbacks, F callback, const char* kind)
+        {
+            if (callback == nullptr)
+                return 0;
+            auto found = callbacks.ids.find(callback);
+            if (found == callbacks.ids.end())
+                throw std::runtime_error(std::string(kind) + " is not bound");
+            return found->second;
+        }
+
+        template<typename F>
+        static F Get(Callbacks<F> const& callbacks, uint32_t id, const char* kind)
+        {
+            if (id == 0)
+                return nullptr;
+            auto found = callbacks.byId.find(id);
+            if (found == callbacks.byId.end())
+                throw std::runtime_error(std::string(kind) + " " + std::to_string(id) + " is not bound");
+            return found->second;
+        }
+    private:
+        struct ArgumentCodec
+        {
+            std::shared_ptr<CommandNode<S>>(*read)(std::string_view name, std::string_view parameters, SuggestionProvider<S> provider);
+            uint32_t(*write)(IArgumentCommandNode<S>* argument, std::string& parameters, CommandTreeBinder<S> const& binder);
+        };
+        struct ArgumentTypes
+        {
+            std::map<uint32_t, ArgumentCodec> byId;
+            std::map<size_t, uint32_t> ids;
+        };
+
+        Callbacks<Command<S>> commands;
+        Callbacks<Predicate<S&>> requirements;
+        Callbacks<RedirectModifier<S>> modifiers;
+        Callbacks<SuggestionProvider<S>> suggestions;
+        ArgumentTypes argumentTypes;
+    };
+}
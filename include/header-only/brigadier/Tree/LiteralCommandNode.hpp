@@ -9,32 +9,49 @@ namespace brigadier
     {
     public:
         LiteralCommandNode(std::string_view literal, std::shared_ptr<Command<S>> command, Predicate<S&> requirement, std::shared_ptr<CommandNode<S>> redirect, RedirectModifier<S> modifier, const bool forks)
-            : CommandNode<S>(command, requirement, redirect, modifier, forks)
-            , literal(literal)
-            , literalLowerCase(literal)
-        {
-            std::transform(literalLowerCase.begin(), literalLowerCase.end(), literalLowerCase.begin(), [](char c) { return std::tolower(c); });
-        }
+            : CommandNode<S>(CommandNodeType::LiteralCommandNode, literal, command, requirement, redirect, modifier, forks)
+            , literal(this->name)
+            , lowerCase(LowerCase(this->literal))
+            , literalLowerCase(lowerCase.empty() ? this->literal : lowerCase.GetView())
+        {}
         LiteralCommandNode(std::string_view literal)
-            : literal(literal)
-            , literalLowerCase(literal)
-        {
-            std::transform(literalLowerCase.begin(), literalLowerCase.end(), literalLowerCase.begin(), [](char c) { return std::tolower(c); });
-        }
+            : CommandNode<S>(CommandNodeType::LiteralCommandNode, literal)
+            , literal(this->name)
+            , lowerCase(LowerCase(this->literal))
+            , literalLowerCase(lowerCase.empty() ? this->literal : lowerCase.GetView())
+        {}
         virtual ~LiteralCommandNode() = default;
-        virtual std::string const& GetName() { return literal; }
-        virtual std::string GetUsageText() { return literal; }
+        virtual std::string GetUsageText() { return std::string(literal); }
         virtual std::vector<std::string_view> GetExamples() { return { literal }; }
         virtual void Parse(StringReader& reader, CommandContext<S>& contextBuilder)
+        {
+            ParseLiteral(reader, contextBuilder);
+        }
+        /**
+        Same as Parse(StringReader&, CommandContext<S>&), but can be called without a virtual call
+        once the node is known to be a literal, see CommandNode::GetNodeType().
+        */
+        inline void ParseLiteral(StringReader& reader, CommandContext<S>& contextBuilder)
+        {
+            ExceptionRecord error;
+            if (!TryParseLiteral(reader, contextBuilder, error)) {
+                throw CommandSyntaxException(error, reader.GetString());
+            }
+        }
+        /**
+        Same as ParseLiteral, but returns false with the failure in `error` instead of throwing it.
+        */
+        inline bool TryParseLiteral(StringReader& reader, CommandContext<S>& contextBuilder, ExceptionRecord& error)
         {
             int start = reader.GetCursor();
             int end = Parse(reader);
             if (end > -1) {
                 contextBuilder.WithNode(this, StringRange::Between(start, end));
-                return;
+                return true;
             }
 
-            throw CommandSyntaxException::BuiltInExceptions::LiteralIncorrect(reader, literal);
+            error = ExceptionRecord(reader, SyntaxError::LiteralIncorrect, literal);
+            return false;
         }
         virtual std::future<Suggestions> ListSuggestions(CommandContext<S>& context, SuggestionsBuilder& builder)
         {
@@ -43,7 +60,8 @@ namespace brigadier
             else
                 return Suggestions::Empty();
         }
-        virtual CommandNodeType GetNodeType() { return CommandNodeType::LiteralCommandNode; }
+        virtual std::shared_ptr<CommandNode<S>> Clone() { return std::make_shared<LiteralCommandNode<S>>(*this); }
+        virtual size_t GetObjectSize() { return sizeof(*this); }
     protected:
         virtual bool IsValidInput(std::string_view input) {
             StringReader reader(input);
@@ -51,6 +69,17 @@ namespace brigadier
         }
         virtual std::string_view GetSortedKey() { return literal; }
     private:
+        // Lower case form is interned only if it differs from the literal
+        static InternedString LowerCase(std::string_view literal)
+        {
+            auto upper = std::find_if(literal.begin(), literal.end(), [](char c) { return std::tolower(c) != c; });
+            if (upper == literal.end())
+                return {};
+            std::string lower(literal);
+            std::transform(lower.begin(), lower.end(), lower.begin(), [](char c) { return std::tolower(c); });
+            return StringInterner::Intern(lower);
+        }
+
         int Parse(StringReader& reader)
         {
             int start = reader.GetCursor();
@@ -69,7 +98,11 @@ namespace brigadier
             return -1;
         }
     private:
-        std::string literal;
-        std::string literalLowerCase;
+        template<typename _S>
+        friend class CommandDispatcher;
+
+        std::string_view literal;          // name of the node
+        InternedString lowerCase;          // empty if the literal has no upper case characters
+        std::string_view literalLowerCase; // lowerCase or the literal
     };
 }
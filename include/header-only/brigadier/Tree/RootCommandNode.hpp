@@ -8,10 +8,9 @@ namespace brigadier
     class RootCommandNode : public CommandNode<S>
     {
     public:
-        RootCommandNode() : CommandNode<S>(nullptr, [](S&) { return true; }, nullptr, [](auto s)->std::vector<S> { return { s.GetSource() }; }, false) {}
+        RootCommandNode() : CommandNode<S>(CommandNodeType::RootCommandNode, {}, nullptr, nullptr, nullptr, [](auto s)->std::vector<S> { return { s.GetSource() }; }, false) {}
 
         virtual ~RootCommandNode() = default;
-        virtual std::string const& GetName() { static const std::string blank; return blank; }
         virtual std::string GetUsageText() { return {}; }
         virtual std::vector<std::string_view> GetExamples() { return {}; }
         virtual void Parse(StringReader& reader, CommandContext<S>& contextBuilder) {}
@@ -19,7 +18,8 @@ namespace brigadier
         {
             return Suggestions::Empty();
         }
-        virtual CommandNodeType GetNodeType() { return CommandNodeType::RootCommandNode; }
+        virtual std::shared_ptr<CommandNode<S>> Clone() { return std::make_shared<RootCommandNode<S>>(*this); }
+        virtual size_t GetObjectSize() { return sizeof(*this); }
     protected:
         virtual bool IsValidInput(std::string_view input) { return false; }
         virtual std::string_view GetSortedKey() { return {}; }
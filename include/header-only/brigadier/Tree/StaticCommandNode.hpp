@@ -0,0 +1,414 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <tuple>
+#include <utility>
+
+#include "LiteralCommandNode.hpp"
+#include "ArgumentCommandNode.hpp"
+
+namespace brigadier
+{
+    /**
+    Common part of nodes of a command tree declared at compile time, see StaticCommandNode.
+
+    Every modifier returns a modified copy, so whole trees can be declared as constexpr values.
+    */
+    template<typename S, typename B, typename... Children>
+    class StaticTreeNode
+    {
+    public:
+        static constexpr size_t height = 1 + (std::max)({ size_t(0), Children::height... });
+        static constexpr size_t literalCount = (size_t(Children::kind == CommandNodeType::LiteralCommandNode) + ... + 0);
+        static constexpr size_t argumentCount = sizeof...(Children) - literalCount;
+
+        constexpr StaticTreeNode(std::string_view name, Children... children) : name(name), children(std::move(children)...) {}
+
+        constexpr B Executes(Command<S> command) const
+        {
+            B copy = static_cast<B const&>(*this);
+            copy.command = command;
+            return copy;
+        }
+
+        constexpr B Requires(Predicate<S&> requirement) const
+        {
+            B copy = static_cast<B const&>(*this);
+            copy.requirement = requirement;
+            return copy;
+        }
+
+        constexpr B RequiresPermissions(PermissionMask permissions) const
+        {
+            B copy = static_cast<B const&>(*this);
+            copy.permissions = permissions;
+            return copy;
+        }
+
+        // Index of the I-th child in CommandNode::literals or CommandNode::arguments of the built node.
+        template<size_t I>
+        static constexpr size_t IndexOf()
+        {
+            constexpr CommandNodeType kinds[] = { Children::kind..., CommandNodeType::RootCommandNode };
+            size_t index = 0;
+            for (size_t i = 0; i < I; ++i) {
+                if (kinds[i] == kinds[I])
+                    ++index;
+            }
+            return index;
+        }
+    public:
+        std::string_view name;
+        std::tuple<Children...> children;
+        Command<S> command = nullptr;
+        Predicate<S&> requirement = nullptr;
+        PermissionMask permissions = 0;
+    };
+
+    template<typename S, typename... Children>
+    class StaticLiteral : public StaticTreeNode<S, StaticLiteral<S, Children...>, Children...>
+    {
+    public:
+        static constexpr CommandNodeType kind = CommandNodeType::LiteralCommandNode;
+
+        constexpr StaticLiteral(std::string_view literal, Children... children)
+            : StaticTreeNode<S, StaticLiteral<S, Children...>, Children...>(literal, std::move(children)...)
+        {}
+    };
+
+    template<typename S, typename T, typename... Children>
+    class StaticArgument : public StaticTreeNode<S, StaticArgument<S, T, Children...>, Children...>
+    {
+    public:
+        static constexpr CommandNodeType kind = CommandNodeType::ArgumentCommandNode;
+        using argument_type = T;
+
+        constexpr StaticArgument(std::string_view name, Children... children)
+            : StaticTreeNode<S, StaticArgument<S, T, Children...>, Children...>(name, std::move(children)...)
+        {}
+
+        // Sets parameters of the argument type, such as the range of a number.
+        constexpr StaticArgument WithType(T type) const
+        {
+            StaticArgument copy = *this;
+            copy.type = std::move(type);
+            return copy;
+        }
+    public:
+        T type{};
+    };
+
+    template<typename S, typename... Children>
+    constexpr StaticLiteral<S, Children...> MakeStaticLiteral(std::string_view literal, Children... children)
+    {
+        return StaticLiteral<S, Children...>(literal, std::move(children)...);
+    }
+
+    template<typename S, typename T, typename... Children>
+    constexpr StaticArgument<S, T, Children...> MakeStaticArgument(std::string_view name, Children... children)
+    {
+        return StaticArgument<S, T, Children...>(name, std::move(children)...);
+    }
+
+    /**
+    Literal node built from a command tree declared at compile time:
+
+        constexpr auto tp = MakeStaticLiteral<S>("tp",
+            MakeStaticArgument<S, Integer>("x",
+                MakeStaticArgument<S, Integer>("y").Executes(teleport)));
+
+    The tree below this node is made of ordinary nodes, so usage, suggestions and images work as usual.
+    Parsing below this node is done by code generated for the declared tree: literals are compared in place and
+    arguments are parsed by their types directly, without virtual calls or lookups in the children map.
+    Failed branches do not touch the context, it is filled once a complete command is found. Parsed values are kept
+    on the stack until then, so failed branches do not allocate. Every node tried counts towards ParseOptions::maxNodeVisits.
+
+    Commands, requirements and redirects are read from the nodes, so they can still be changed by builders.
+    If the children of a node no longer match the declared tree, or the input is not a complete command,
+    the generated parser gives up and the dispatcher parses it the usual way (see CommandNode::ParseCompiled()).
+    */
+    template<typename S, typename Tree>
+    class StaticCommandNode : public LiteralCommandNode<S>
+    {
+        static_assert(Tree::kind == CommandNodeType::LiteralCommandNode, "Static command tree must start with a literal");
+    public:
+        StaticCommandNode(Tree const& tree)
+            : LiteralCommandNode<S>(tree.name)
+            , tree(InternNames(tree, names))
+        {
+            this->compiledParse = &StaticCommandNode<S, Tree>::ParseChildren;
+            SetProperties(*this, tree);
+            AddChildren(*this, tree);
+        }
+        StaticCommandNode(StaticCommandNode const& other)
+            : LiteralCommandNode<S>(other)
+            , names(other.names)
+            , tree(other.tree)
+        {
+            this->compiledParse = &StaticCommandNode<S, Tree>::ParseChildren;
+        }
+        virtual ~StaticCommandNode() = default;
+
+        virtual std::shared_ptr<CommandNode<S>> Clone() { return std::make_shared<StaticCommandNode<S, Tree>>(*this); }
+        virtual size_t GetObjectSize() { return sizeof(*this); }
+    private:
+        enum class Match
+        {
+            Failed,     // no complete command below the node
+            Parsed,
+            Unsupported // the node does not match the declared tree
+        };
+
+        struct Step
+        {
+            CommandNode<S>* node = nullptr;
+            int start = 0;
+            int end = 0;
+        };
+
+        struct State
+        {
+            StringReader& reader;
+            CommandContext<S>& context;
+            PermissionMask permissions;
+            ParseBudget& budget;
+            Step* steps;
+            size_t length;
+        };
+
+        template<typename Node>
+        static Node InternNames(Node node, std::vector<InternedString>& names)
+        {
+            node.name = names.emplace_back(StringInterner::Intern(node.name));
+            std::apply([&names](auto&... children) { ((children = InternNames(children, names)), ...); }, node.children);
+            return node;
+        }
+
+        template<typename Node>
+        static void SetProperties(CommandNode<S>& node, Node const& desc)
+        {
+            node.command = desc.command;
+            node.requirement = desc.requirement;
+            node.permissions = desc.permissions;
+            node.Modified();
+        }
+
+        template<typename Node>
+        static void AddChildren(CommandNode<S>& node, Node const& desc)
+        {
+            std::apply([&node](auto const&... children) { (node.AddChild(MakeNode(children)), ...); }, desc.children);
+        }
+
+        template<typename Node>
+        static std::shared_ptr<CommandNode<S>> MakeNode(Node const& desc)
+        {
+            std::shared_ptr<CommandNode<S>> node;
+            if constexpr (Node::kind == CommandNodeType::LiteralCommandNode)
+                node = std::make_shared<LiteralCommandNode<S>>(desc.name);
+            else
+                node = std::make_shared<ArgumentCommandNode<S, typename Node::argument_type>>(desc.name, desc.type);
+            SetProperties(*node, desc);
+            AddChildren(*node, desc);
+            return node;
+        }
+
+        static bool ParseChildren(CommandNode<S>& node, StringReader& reader, CommandContext<S>& context, PermissionMask permissions, ParseBudget& budget)
+        {
+            auto& self = static_cast<StaticCommandNode<S, Tree>&>(node);
+            std::array<Step, Tree::height - 1> steps;
+            State state{ reader, context, permissions, budget, steps.data(), 0 };
+
+            int cursor = reader.GetCursor();
+            if (MatchChildren(node, self.tree, state, 0) != Match::Parsed) {
+                reader.SetCursor(cursor);
+                return false;
+            }
+
+            // arguments were added by MatchNode() on the way back
+            for (size_t i = 0; i < state.length; ++i) {
+                Step& step = steps[i];
+                context.WithNode(step.node, StringRange::Between(step.start, step.end));
+            }
+            context.WithCommand(steps[state.length - 1].node->GetCommand());
+            return true;
+        }
+
+        // Finds the child built from the I-th child of the declared node, checking that it was not replaced since.
+        template<size_t I, typename Node>
+        static CommandNode<S>* GetChild(CommandNode<S>& node, Node const& desc)
+        {
+            auto& child = std::get<I>(desc.children);
+            using Child = std::decay_t<decltype(child)>;
+            constexpr size_t index = Node::template IndexOf<I>();
+
+            if constexpr (Child::kind == CommandNodeType::LiteralCommandNode) {
+                CommandNode<S>* literal = node.literals[index].get();
+                return literal->GetName().data() == child.name.data() ? literal : nullptr;
+            }
+            else {
+                IArgumentCommandNode<S>* argument = node.arguments[index].get();
+                if (argument->GetName().data() != child.name.data() || argument->GetParseFunction() != &ArgumentCommandNode<S, typename Child::argument_type>::ParseAs)
+                    return nullptr;
+                return argument;
+            }
+        }
+
+        template<typename Node, size_t... I>
+        static bool GetChildren(CommandNode<S>& node, Node const& desc, CommandNode<S>** children, std::index_sequence<I...>)
+        {
+            if (node.literals.size() != Node::literalCount || node.arguments.size() != Node::argumentCount)
+                return false;
+            return ((children[I] = GetChild<I>(node, desc)) && ...);
+        }
+
+        // Same order of candidates as CommandNode::GetRelevantNodes(), the first one that parses the rest of the input wins.
+        template<typename Node>
+        static Match MatchChildren(CommandNode<S>& node, Node const& desc, State& state, size_t depth)
+        {
+            constexpr size_t count = std::tuple_size_v<decltype(desc.children)>;
+            if constexpr (count == 0) {
+                return node.children.empty() ? Match::Failed : Match::Unsupported;
+            }
+            else {
+                std::array<CommandNode<S>*, count> children;
+                if (!GetChildren(node, desc, children.data(), std::make_index_sequence<count>()))
+                    return Match::Unsupported;
+
+                if constexpr (Node::literalCount > 0) {
+                    std::string_view remaining = state.reader.GetRemaining();
+                    std::string_view word = remaining.substr(0, remaining.find(' '));
+                    bool found = false;
+                    Match match = MatchLiterals<0>(desc, children.data(), word, found, state, depth);
+                    if (found)
+                        return match;
+                }
+                if constexpr (Node::argumentCount > 0) {
+                    return MatchArguments<0>(desc, children.data(), state, depth);
+                }
+                return Match::Failed;
+            }
+        }
+
+        template<size_t I, typename Node>
+        static Match MatchLiterals(Node const& desc, CommandNode<S>** children, std::string_view word, bool& found, State& state, size_t depth)
+        {
+            if constexpr (I == std::tuple_size_v<decltype(desc.children)>) {
+                return Match::Failed;
+            }
+            else {
+                auto& child = std::get<I>(desc.children);
+                if constexpr (std::decay_t<decltype(child)>::kind == CommandNodeType::LiteralCommandNode) {
+                    if (word == child.name) {
+                        found = true;
+                        return MatchNode(*children[I], child, state, depth);
+                    }
+                }
+                return MatchLiterals<I + 1>(desc, children, word, found, state, depth);
+            }
+        }
+
+        template<size_t I, typename Node>
+        static Match MatchArguments(Node const& desc, CommandNode<S>** children, State& state, size_t depth)
+        {
+            if constexpr (I == std::tuple_size_v<decltype(desc.children)>) {
+                return Match::Failed;
+            }
+            else {
+                auto& child = std::get<I>(desc.children);
+                if constexpr (std::decay_t<decltype(child)>::kind == CommandNodeType::ArgumentCommandNode) {
+                    Match match = MatchNode(*children[I], child, state, depth);
+                    if (match != Match::Failed)
+                        return match;
+                }
+                return MatchArguments<I + 1>(desc, children, state, depth);
+            }
+        }
+
+        template<typename Node>
+        static Match MatchNode(CommandNode<S>& node, Node const& desc, State& state, size_t depth)
+        {
+            if (node.redirect != nullptr)
+                return Match::Unsupported;
+            if (!node.CanUse(state.context.GetSource(), state.permissions))
+                return Match::Failed;
+
+            StringReader& reader = state.reader;
+            state.budget.Visit(reader);
+            int start = reader.GetCursor();
+
+            if constexpr (Node::kind == CommandNodeType::LiteralCommandNode) {
+                reader.SetCursor(start + int(desc.name.size()));
+                return MatchRest(node, desc, state, depth, start);
+            }
+            else {
+                using T = typename Node::argument_type;
+                std::optional<typename T::type> result;
+                if constexpr (HasTryParse<T>::value) {
+                    ExceptionRecord error;
+                    if (!static_cast<ArgumentCommandNode<S, T>&>(node).type.TryParse(reader, result.emplace(), error)) {
+                        reader.SetCursor(start);
+                        return Match::Failed;
+                    }
+                }
+                else {
+                    try {
+                        result.emplace(static_cast<ArgumentCommandNode<S, T>&>(node).type.Parse(reader));
+                    }
+                    catch (CommandSyntaxException const&) {
+                        reader.SetCursor(start);
+                        return Match::Failed;
+                    }
+                    catch (std::runtime_error const&) {
+                        reader.SetCursor(start);
+                        return Match::Failed;
+                    }
+                }
+                if (reader.CanRead() && reader.Peek() != ' ') {
+                    reader.SetCursor(start);
+                    return Match::Failed;
+                }
+
+                int end = reader.GetCursor();
+                Match match = MatchRest(node, desc, state, depth, start);
+                if (match == Match::Parsed)
+                    state.context.WithArgument(node.GetName(), ParsedArgument<S, T>::Make(start, end, std::move(*result)));
+                return match;
+            }
+        }
+
+        // Records the node parsed from `start` up to the reader position and matches its children
+        template<typename Node>
+        static Match MatchRest(CommandNode<S>& node, Node const& desc, State& state, size_t depth, int start)
+        {
+            StringReader& reader = state.reader;
+            Step& step = state.steps[depth];
+            step.node = &node;
+            step.start = start;
+            step.end = reader.GetCursor();
+
+            if (reader.CanRead(2)) {
+                reader.Skip();
+                Match match = MatchChildren(node, desc, state, depth + 1);
+                if (match != Match::Failed)
+                    return match;
+            }
+            else if (!reader.CanRead()) {
+                state.length = depth + 1;
+                return Match::Parsed;
+            }
+            reader.SetCursor(start);
+            return Match::Failed;
+        }
+    private:
+        std::vector<InternedString> names; // keep the names of the declaration stored, even if its nodes are removed
+        Tree tree; // names are interned, so children can be compared with the declaration by address
+    };
+
+    template<typename S, typename... Children>
+    inline std::shared_ptr<StaticCommandNode<S, StaticLiteral<S, Children...>>> MakeStaticNode(StaticLiteral<S, Children...> const& tree)
+    {
+        return std::make_shared<StaticCommandNode<S, StaticLiteral<S, Children...>>>(tree);
+    }
+}
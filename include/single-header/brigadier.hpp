@@ -28,6 +28,7 @@ SOFTWARE.
 #include <string>
 #include <string_view>
 #include <cstring>
+#include <new>
 #include <sstream>
 #include <vector>
 #include <memory>
@@ -37,26 +38,54 @@ SOFTWARE.
 #include <algorithm>
 #include <limits>
 #include <optional>
+#include <variant>
+#include <deque>
+#include <chrono>
+#include <array>
+#include <utility>
+#include <unordered_set>
+#include <unordered_map>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <atomic>
+#include <cstdint>
+
 
 // Following code makes that you don't have to specify command source type inside arguments.
 // Command source type is automatically distributed from dispatcher.
+//
+// Registration also assigns a stable numeric ID to the argument type, derived from the registered name
+// (and IDs of template parameters for templated registrations). See GetArgumentTypeId<T>().
 
 // Default registration for arguments with or without template, without specialization
 #define REGISTER_ARGTYPE(type, name)                                      \
+constexpr ::brigadier::ArgumentTypeKey RegisteredArgumentType(::brigadier::ArgumentTypeTag<type>) \
+{ return ::brigadier::MakeArgumentTypeKey(#name); }                      \
 using name = type
 
 // Registration for arguments with template parameters
 #define REGISTER_ARGTYPE_TEMPL(type, name)                                \
 template<typename... Args>                                                \
+constexpr auto RegisteredArgumentType(::brigadier::ArgumentTypeTag<type<Args...>>) \
+-> std::enable_if_t<::brigadier::HasArgumentTypeParamIds<Args...>, ::brigadier::ArgumentTypeKey> \
+{ return ::brigadier::MakeArgumentTypeKey<Args...>(#name); }             \
+template<typename... Args>                                                \
 using name = type<Args...>
 
 // Registration for arguments with specialized templates
 #define REGISTER_ARGTYPE_SPEC(type, name, ...)                            \
+constexpr ::brigadier::ArgumentTypeKey RegisteredArgumentType(::brigadier::ArgumentTypeTag<type<__VA_ARGS__>>) \
+{ return ::brigadier::MakeArgumentTypeKey(#name); }                      \
 using name = type<__VA_ARGS__>
 
 // Registration for arguments with specialized templates and template parameters
 #define REGISTER_ARGTYPE_SPEC_TEMPL(type, name, ...)                      \
 template<typename... Args>                                                \
+constexpr auto RegisteredArgumentType(::brigadier::ArgumentTypeTag<type<__VA_ARGS__, Args...>>) \
+-> std::enable_if_t<::brigadier::HasArgumentTypeParamIds<Args...>, ::brigadier::ArgumentTypeKey> \
+{ return ::brigadier::MakeArgumentTypeKey<Args...>(#name); }             \
+template<typename... Args>                                                \
 using name = type<__VA_ARGS__, Args...>
 
 #ifdef __has_include
@@ -70,8 +99,107 @@ using name = type<__VA_ARGS__, Args...>
 #  endif
 #endif
 
+
 namespace brigadier
 {
+    template<typename T>
+    struct ArgumentTypeTag {};
+
+    struct ArgumentTypeKey
+    {
+        uint32_t id;
+        std::string_view name;
+    };
+
+    // FNV-1a
+    constexpr uint32_t ArgumentTypeHash(std::string_view text, uint32_t hash = 2166136261u)
+    {
+        for (char c : text) {
+            hash ^= uint8_t(c);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    template<typename T>
+    constexpr std::string_view FundamentalTypeName()
+    {
+        /**/ if constexpr (std::is_same_v<T, bool>)               return "bool";
+        else if constexpr (std::is_same_v<T, char>)               return "char";
+        else if constexpr (std::is_same_v<T, signed char>)        return "signed char";
+        else if constexpr (std::is_same_v<T, unsigned char>)      return "unsigned char";
+        else if constexpr (std::is_same_v<T, wchar_t>)            return "wchar_t";
+        else if constexpr (std::is_same_v<T, char16_t>)           return "char16_t";
+        else if constexpr (std::is_same_v<T, char32_t>)           return "char32_t";
+        else if constexpr (std::is_same_v<T, short>)              return "short";
+        else if constexpr (std::is_same_v<T, unsigned short>)     return "unsigned short";
+        else if constexpr (std::is_same_v<T, int>)                return "int";
+        else if constexpr (std::is_same_v<T, unsigned>)           return "unsigned";
+        else if constexpr (std::is_same_v<T, long>)               return "long";
+        else if constexpr (std::is_same_v<T, unsigned long>)      return "unsigned long";
+        else if constexpr (std::is_same_v<T, long long>)          return "long long";
+        else if constexpr (std::is_same_v<T, unsigned long long>) return "unsigned long long";
+        else if constexpr (std::is_same_v<T, float>)              return "float";
+        else if constexpr (std::is_same_v<T, double>)             return "double";
+        else                                                      return "long double";
+    }
+
+    // Checks if T was registered with one of REGISTER_ARGTYPE* macros.
+    template<typename T, typename = void>
+    struct HasArgumentTypeId : std::false_type {};
+    template<typename T>
+    struct HasArgumentTypeId<T, std::void_t<decltype(RegisteredArgumentType(ArgumentTypeTag<T>{}))>> : std::true_type {};
+
+    // Stable ID of a template parameter of a registered argument type. Arithmetic types and registered argument types have one,
+    // other types (e.g. enums) may get one by specializing this template.
+    template<typename T, typename = void>
+    struct ArgumentTypeParamId {};
+    template<typename T>
+    struct ArgumentTypeParamId<T, std::enable_if_t<std::is_arithmetic_v<T>>>
+    {
+        static constexpr uint32_t value = ArgumentTypeHash(FundamentalTypeName<T>());
+    };
+    template<typename T>
+    struct ArgumentTypeParamId<T, std::enable_if_t<HasArgumentTypeId<T>::value>>
+    {
+        static constexpr uint32_t value = RegisteredArgumentType(ArgumentTypeTag<T>{}).id;
+    };
+
+    template<typename T, typename = void>
+    struct HasArgumentTypeParamId : std::false_type {};
+    template<typename T>
+    struct HasArgumentTypeParamId<T, std::void_t<decltype(ArgumentTypeParamId<T>::value)>> : std::true_type {};
+
+    template<typename... Args>
+    constexpr bool HasArgumentTypeParamIds = (HasArgumentTypeParamId<Args>::value && ...);
+
+    // IDs are 31 bit wide, TypeInfo of unregistered types has the highest bit set.
+    template<typename... Args>
+    constexpr ArgumentTypeKey MakeArgumentTypeKey(std::string_view name)
+    {
+        uint32_t hash = ArgumentTypeHash(name);
+        ((hash = (hash ^ ArgumentTypeParamId<Args>::value) * 16777619u), ...);
+        return { hash & 0x7FFFFFFFu, name };
+    }
+
+    /**
+    Stable ID of an argument type registered with one of REGISTER_ARGTYPE* macros.
+    It depends only on the registered name and template parameters, so it is the same in every build.
+    */
+    template<typename T>
+    constexpr uint32_t GetArgumentTypeId()
+    {
+        static_assert(HasArgumentTypeId<T>::value, "Argument type is not registered");
+        return RegisteredArgumentType(ArgumentTypeTag<T>{}).id;
+    }
+
+    template<typename T>
+    constexpr std::string_view GetArgumentTypeName()
+    {
+        static_assert(HasArgumentTypeId<T>::value, "Argument type is not registered");
+        return RegisteredArgumentType(ArgumentTypeTag<T>{}).name;
+    }
+
     template<typename S>
     class CommandNode;
     template<typename S>
@@ -85,6 +213,10 @@ namespace brigadier
     class RootCommandNode;
     template<typename S>
     class CommandDispatcher;
+    template<typename S>
+    class CommandTreeBinder;
+    template<typename S, typename Tree>
+    class StaticCommandNode;
 
     template<typename S, typename T, typename node_type>
     class ArgumentBuilder;
@@ -96,6 +228,206 @@ namespace brigadier
     class RequiredArgumentBuilder;
 
 
+    /**
+    Words of an input separated by spaces, found in a single pass before parsing.
+
+    The parser looks up literals by the word at the cursor on every level of the tree, and again for every candidate
+    tried at the same position. With the words recorded once, these lookups do not read the input again.
+    A word starting with a quote extends to the matching end quote, so quoted strings with spaces are a single word,
+    and string arguments tried at the same position skip to the recorded end quote instead of searching for it, see StringReader::ReadStringView().
+    */
+    class StringTokens
+    {
+    public:
+        StringTokens() = default;
+        explicit StringTokens(std::string_view input) { Tokenize(input); }
+
+        /**
+        Records the words of an input, replacing previous ones.
+        Memory is allocated only for inputs with more than INLINE_WORDS words, and is kept for the next input.
+        */
+        void Tokenize(std::string_view input)
+        {
+            this->input = input;
+            count = 0;
+            overflow.clear();
+
+            size_t start = 0;
+            while (true) {
+                Word word{ int(start) };
+                size_t end = start;
+                if (start < input.size() && (input[start] == '"' || input[start] == '\'')) {
+                    end = FindEndQuote(input, start, word.plain);
+                    if (end != std::string_view::npos)
+                        word.quoteEnd = int(end++);
+                    else
+                        end = start; // not closed, read as a plain word
+                }
+                end = input.find(' ', end);
+                if (end == std::string_view::npos)
+                    end = input.size();
+                word.end = int(end);
+                word.plain &= word.quoteEnd == int(end) - 1;
+                Add(word);
+                if (end == input.size())
+                    break;
+                start = end + 1;
+            }
+        }
+
+        /**
+        Gets the text from `cursor` up to the next space or the end of the input.
+        A quoted string starting at `cursor` is returned as a whole, including spaces within the quotes.
+        */
+        std::string_view GetWord(int cursor) const
+        {
+            if (const Word* found = Find(cursor))
+                return input.substr(cursor, found->end - cursor);
+
+            // parsing started in the middle of a word
+            size_t end = input.find(' ', cursor);
+            return input.substr(cursor, end == std::string_view::npos ? std::string_view::npos : end - cursor);
+        }
+
+        /**
+        Gets the position of the end quote of a quoted string starting at `cursor`, which is followed by a space or the end of the input.
+
+        \return position of the end quote, or -1 if no such string starts there, or it has escapes
+        */
+        int GetQuoteEnd(int cursor) const
+        {
+            const Word* found = Find(cursor);
+            return found != nullptr && found->plain ? found->quoteEnd : -1;
+        }
+
+        inline std::string_view GetInput() const { return input; }
+        inline size_t GetCount() const { return count; }
+
+        /**
+        Frees memory kept from earlier inputs beyond `words` words.
+        */
+        void Trim(size_t words)
+        {
+            if (overflow.capacity() > words)
+                std::vector<Word>().swap(overflow);
+        }
+    public:
+        static constexpr size_t INLINE_WORDS = 16;
+    private:
+        struct Word
+        {
+            int start = 0;
+            int end = 0;
+            int quoteEnd = -1; // of a quoted string starting the word
+            bool plain = true; // quoted string without escapes that makes up the whole word
+        };
+
+        // Same rules as StringReader::ReadStringUntil(), returns npos if the string is not closed
+        static size_t FindEndQuote(std::string_view input, size_t start, bool& plain)
+        {
+            char quote = input[start];
+            for (size_t i = start + 1; i < input.size(); ++i) {
+                if (input[i] == '\\') {
+                    plain = false;
+                    ++i;
+                }
+                else if (input[i] == quote) {
+                    return i;
+                }
+            }
+            return std::string_view::npos;
+        }
+
+        const Word* Find(int cursor) const
+        {
+            const Word* words = GetWords();
+            const Word* found = std::lower_bound(words, words + count, cursor, [](Word const& word, int cursor) { return word.start < cursor; });
+            return found != words + count && found->start == cursor ? found : nullptr;
+        }
+
+        void Add(Word word)
+        {
+            if (count < INLINE_WORDS) {
+                words[count++] = word;
+                return;
+            }
+            if (count == INLINE_WORDS)
+                overflow.assign(words.begin(), words.end());
+            overflow.push_back(word);
+            ++count;
+        }
+
+        inline const Word* GetWords() const { return count <= INLINE_WORDS ? words.data() : overflow.data(); }
+    private:
+        std::string_view input;
+        std::array<Word, INLINE_WORDS> words;
+        std::vector<Word> overflow; // all words, once there are more than INLINE_WORDS
+        size_t count = 0;
+    };
+
+    /**
+    Set of characters as a 256-bit map, usable at compile time.
+    */
+    class CharacterSet
+    {
+    public:
+        constexpr CharacterSet() = default;
+
+        static constexpr CharacterSet All()
+        {
+            CharacterSet set;
+            for (auto& word : set.bits) {
+                word = ~uint64_t(0);
+            }
+            return set;
+        }
+
+        static constexpr CharacterSet Of(std::string_view chars)
+        {
+            CharacterSet set;
+            for (char c : chars) {
+                set.Add(c);
+            }
+            return set;
+        }
+
+        template<typename Predicate>
+        static constexpr CharacterSet Matching(Predicate predicate)
+        {
+            CharacterSet set;
+            for (int c = 0; c < 256; ++c) {
+                if (predicate(char(c)))
+                    set.Add(char(c));
+            }
+            return set;
+        }
+
+        constexpr bool Contains(char c) const
+        {
+            auto u = static_cast<unsigned char>(c);
+            return (bits[u >> 6] >> (u & 63)) & 1;
+        }
+
+        constexpr CharacterSet operator|(CharacterSet const& other) const
+        {
+            CharacterSet set;
+            for (int i = 0; i < 4; ++i) {
+                set.bits[i] = bits[i] | other.bits[i];
+            }
+            return set;
+        }
+    private:
+        constexpr void Add(char c)
+        {
+            auto u = static_cast<unsigned char>(c);
+            bits[u >> 6] |= uint64_t(1) << (u & 63);
+        }
+    private:
+        uint64_t bits[4] = {};
+    };
+
+    class ExceptionRecord;
+
     class StringReader
     {
     private:
@@ -121,7 +453,7 @@ namespace brigadier
         inline char             Read()                      { return string.at(cursor++); }
         inline void             Skip()                      { cursor++; }
 
-        inline static bool IsQuotedStringStart(char c)
+        inline static constexpr bool IsQuotedStringStart(char c)
         {
             return c == SYNTAX_DOUBLE_QUOTE || c == SYNTAX_SINGLE_QUOTE;
         }
@@ -136,7 +468,7 @@ namespace brigadier
         template<typename T>
         inline T ReadValue();
 
-        inline static bool IsAllowedInUnquotedString(char c)
+        inline static constexpr bool IsAllowedInUnquotedString(char c)
         {
             return (c >= '0' && c <= '9')
                 || (c >= 'A' && c <= 'Z')
@@ -146,7 +478,7 @@ namespace brigadier
         }
 
         template<bool allow_float = true, bool allow_negative = true>
-        inline static bool IsAllowedNumber(char c)
+        inline static constexpr bool IsAllowedNumber(char c)
         {
             return c >= '0' && c <= '9' || (allow_float && c == '.') || (allow_negative && c == '-');
         }
@@ -155,15 +487,28 @@ namespace brigadier
         inline std::string      ReadQuotedString();
         inline std::string      ReadStringUntil(char terminator);
         inline std::string      ReadString();
+        inline std::string_view ReadStringView(std::string& unescaped); // view into the input, unless a quoted string has escapes
         inline void             Expect(char c);
 
+        // Same as the functions above, but return false with the failure in `error` instead of throwing it
+        template<typename T>
+        inline bool TryReadValue(T& value, ExceptionRecord& error);
+        inline bool TryReadStringUntil(char terminator, std::string& result, ExceptionRecord& error);
+        inline bool TryReadString(std::string& result, ExceptionRecord& error);
+        inline bool TryReadStringView(std::string& unescaped, std::string_view& result, ExceptionRecord& error);
+
+        // Words of the input found before parsing, used to skip over quoted strings. Copies of the reader share them.
+        inline void SetTokens(const StringTokens* tokens) { this->tokens = tokens; }
+
     private:
         std::string_view string;
         int cursor = 0;
+        const StringTokens* tokens = nullptr;
     };
 
     
     class BuiltInExceptionProvider;
+    class ExceptionRecord;
 
     struct ExceptionContext
     {
@@ -174,6 +519,75 @@ namespace brigadier
         int cursor = -1;
     };
 
+    /**
+    Kinds of CommandSyntaxException created by BuiltInExceptionProvider.
+    */
+    enum class SyntaxError : uint8_t
+    {
+        Custom, // created with a message, e.g. by an argument type
+        ValueTooLow,
+        ValueTooHigh,
+        LiteralIncorrect,
+        ReaderExpectedStartOfQuote,
+        ReaderExpectedEndOfQuote,
+        ReaderInvalidEscape,
+        ReaderInvalidValue,
+        ReaderExpectedValue,
+        ReaderExpectedSymbol,
+        ReaderExpectedOneOf,
+        DispatcherUnknownCommand,
+        DispatcherUnknownArgument,
+        DispatcherExpectedArgumentSeparator,
+        DispatcherParseException,
+        DispatcherParseBudgetExceeded,
+        DispatcherCommandFailed
+    };
+
+    /**
+    Value shown in the message of a built-in CommandSyntaxException, kept until the message is needed.
+    */
+    class ExceptionArgument
+    {
+    public:
+        ExceptionArgument() = default;
+        template<typename T>
+        explicit ExceptionArgument(T const& value)
+        {
+            using V = std::decay_t<T>;
+            if constexpr (std::is_same_v<V, char> || std::is_same_v<V, signed char> || std::is_same_v<V, unsigned char>)
+                this->value = char(value);
+            else if constexpr (std::is_integral_v<V> && std::is_signed_v<V>)
+                this->value = static_cast<long long>(value);
+            else if constexpr (std::is_integral_v<V>)
+                this->value = static_cast<unsigned long long>(value);
+            else if constexpr (std::is_floating_point_v<V> && sizeof(V) <= sizeof(double))
+                this->value = static_cast<double>(value);
+            else if constexpr (std::is_convertible_v<T const&, std::string_view>)
+                this->value = std::string(std::string_view(value));
+            else {
+                std::ostringstream s;
+                s << value;
+                this->value = s.str();
+            }
+        }
+
+        friend inline std::ostream& operator<<(std::ostream& stream, ExceptionArgument const& argument)
+        {
+            std::visit([&stream](auto const& value) {
+                if constexpr (!std::is_same_v<std::decay_t<decltype(value)>, std::monostate>)
+                    stream << value;
+            }, argument.value);
+            return stream;
+        }
+    private:
+        friend class CommandSyntaxException;
+        friend class ExceptionRecord;
+
+        // printed the same way as the original value, as the message used to be created right away.
+        // long double is printed right away, so that the variant needs no 16 byte alignment.
+        std::variant<std::monostate, char, long long, unsigned long long, double, std::string> value;
+    };
+
     class CommandSyntaxException
     {
     public:
@@ -181,8 +595,14 @@ namespace brigadier
         using BuiltInExceptions = BuiltInExceptionProvider;
         template<typename... Args>
         CommandSyntaxException(ExceptionContext ctx, Args&&... args) : ctx(ctx), msg(std::move(CreateMessageApplyContext(ctx, args...))) {}
-        std::string const& What() { return msg; }
+        inline std::string const& What();
+        inline SyntaxError GetError() const { return error; }
+
+        // Creates the exception of a record, `input` is the string it was created for
+        inline CommandSyntaxException(ExceptionRecord const& record, std::string_view input);
     private:
+        friend class ExceptionRecord;
+
         template<typename T>
         static inline void Add(std::ostringstream& stream, T&& value)
         {
@@ -203,9 +623,19 @@ namespace brigadier
         }
         template<typename... Args>
         static inline std::string CreateMessageApplyContext(ExceptionContext ctx, Args&&... args)
+        {
+            return CreateMessageApplyContext(ctx, GetExcerpt(ctx), args...);
+        }
+        template<typename... Args>
+        static inline std::string CreateMessageApplyContext(ExceptionContext ctx, std::string_view excerpt, Args&&... args)
         {
             if (ctx.cursor < 0) return CreateMessage(args...);
-            else return CreateMessage(args..., " at position ", ctx.cursor, ": ", ctx.cursor > context_amount ? "..." : "", ctx.input.substr((std::max)(0, ctx.cursor - context_amount), context_amount), "<--[HERE]");
+            else return CreateMessage(args..., " at position ", ctx.cursor, ": ", ctx.cursor > context_amount ? "..." : "", excerpt, "<--[HERE]");
+        }
+        static inline std::string_view GetExcerpt(ExceptionContext ctx)
+        {
+            if (ctx.cursor < 0) return {};
+            return ctx.input.substr((std::max)(0, ctx.cursor - context_amount), context_amount);
         }
     public:
         int GetCursor() const
@@ -219,27 +649,138 @@ namespace brigadier
     private:
         ExceptionContext ctx;
         std::string msg;
+        SyntaxError error = SyntaxError::Custom;
+        uint8_t excerptLength = 0;
+        char excerpt[context_amount] = {};
+        ExceptionArgument first;
+        ExceptionArgument second;
     };
 
     class BuiltInExceptionProvider
     {
     public:
-        template<typename T0, typename T1> static inline CommandSyntaxException ValueTooLow                        (ExceptionContext ctx, T0 found, T1 min)    { return CommandSyntaxException(ctx, "Value must not be less than ", min, ", found ", found); }
-        template<typename T0, typename T1> static inline CommandSyntaxException ValueTooHigh                       (ExceptionContext ctx, T0 found, T1 max)    { return CommandSyntaxException(ctx, "Value must not be more than ", max, ", found ", found); }
-        template<typename T0>              static inline CommandSyntaxException LiteralIncorrect                   (ExceptionContext ctx, T0 const& expected)  { return CommandSyntaxException(ctx, "Expected literal ", expected); }
-                                           static inline CommandSyntaxException ReaderExpectedStartOfQuote         (ExceptionContext ctx)                      { return CommandSyntaxException(ctx, "Expected quote to start a string"); }
-                                           static inline CommandSyntaxException ReaderExpectedEndOfQuote           (ExceptionContext ctx)                      { return CommandSyntaxException(ctx, "Unclosed quoted string"); }
-        template<typename T0>              static inline CommandSyntaxException ReaderInvalidEscape                (ExceptionContext ctx, T0 const& character) { return CommandSyntaxException(ctx, "Invalid escape sequence '", character, "' in quoted string"); }
-        template<typename T0>              static inline CommandSyntaxException ReaderInvalidValue                 (ExceptionContext ctx, T0 const& value)     { return CommandSyntaxException(ctx, "Invalid value '", value, "'"); }
-                                           static inline CommandSyntaxException ReaderExpectedValue                (ExceptionContext ctx)                      { return CommandSyntaxException(ctx, "Expected value"); }
-        template<typename T0>              static inline CommandSyntaxException ReaderExpectedSymbol               (ExceptionContext ctx, T0 const& symbol)    { return CommandSyntaxException(ctx, "Expected '", symbol, "'"); }
-        template<typename T0>              static inline CommandSyntaxException ReaderExpectedOneOf                (ExceptionContext ctx, T0 const& symbols)   { return CommandSyntaxException(ctx, "Expected one of `", symbols, "`"); }
-                                           static inline CommandSyntaxException DispatcherUnknownCommand           (ExceptionContext ctx)                      { return CommandSyntaxException(ctx, "Unknown command"); }
-                                           static inline CommandSyntaxException DispatcherUnknownArgument          (ExceptionContext ctx)                      { return CommandSyntaxException(ctx, "Incorrect argument for command"); }
-                                           static inline CommandSyntaxException DispatcherExpectedArgumentSeparator(ExceptionContext ctx)                      { return CommandSyntaxException(ctx, "Expected whitespace to end one argument, but found trailing data"); }
-        template<typename T0>              static inline CommandSyntaxException DispatcherParseException           (ExceptionContext ctx, T0 const& message)   { return CommandSyntaxException(ctx, "Could not parse command: ", message); }
+        template<typename T0, typename T1> static inline CommandSyntaxException ValueTooLow                        (ExceptionContext ctx, T0 found, T1 min)    { return Create(ctx, SyntaxError::ValueTooLow, found, min); }
+        template<typename T0, typename T1> static inline CommandSyntaxException ValueTooHigh                       (ExceptionContext ctx, T0 found, T1 max)    { return Create(ctx, SyntaxError::ValueTooHigh, found, max); }
+        template<typename T0>              static inline CommandSyntaxException LiteralIncorrect                   (ExceptionContext ctx, T0 const& expected)  { return Create(ctx, SyntaxError::LiteralIncorrect, expected); }
+                                           static inline CommandSyntaxException ReaderExpectedStartOfQuote         (ExceptionContext ctx)                      { return Create(ctx, SyntaxError::ReaderExpectedStartOfQuote); }
+                                           static inline CommandSyntaxException ReaderExpectedEndOfQuote           (ExceptionContext ctx)                      { return Create(ctx, SyntaxError::ReaderExpectedEndOfQuote); }
+        template<typename T0>              static inline CommandSyntaxException ReaderInvalidEscape                (ExceptionContext ctx, T0 const& character) { return Create(ctx, SyntaxError::ReaderInvalidEscape, character); }
+        template<typename T0>              static inline CommandSyntaxException ReaderInvalidValue                 (ExceptionContext ctx, T0 const& value)     { return Create(ctx, SyntaxError::ReaderInvalidValue, value); }
+                                           static inline CommandSyntaxException ReaderExpectedValue                (ExceptionContext ctx)                      { return Create(ctx, SyntaxError::ReaderExpectedValue); }
+        template<typename T0>              static inline CommandSyntaxException ReaderExpectedSymbol               (ExceptionContext ctx, T0 const& symbol)    { return Create(ctx, SyntaxError::ReaderExpectedSymbol, symbol); }
+        template<typename T0>              static inline CommandSyntaxException ReaderExpectedOneOf                (ExceptionContext ctx, T0 const& symbols)   { return Create(ctx, SyntaxError::ReaderExpectedOneOf, symbols); }
+                                           static inline CommandSyntaxException DispatcherUnknownCommand           (ExceptionContext ctx)                      { return Create(ctx, SyntaxError::DispatcherUnknownCommand); }
+                                           static inline CommandSyntaxException DispatcherUnknownArgument          (ExceptionContext ctx)                      { return Create(ctx, SyntaxError::DispatcherUnknownArgument); }
+                                           static inline CommandSyntaxException DispatcherExpectedArgumentSeparator(ExceptionContext ctx)                      { return Create(ctx, SyntaxError::DispatcherExpectedArgumentSeparator); }
+        template<typename T0>              static inline CommandSyntaxException DispatcherParseException           (ExceptionContext ctx, T0 const& message)   { return Create(ctx, SyntaxError::DispatcherParseException, message); }
+        template<typename T0>              static inline CommandSyntaxException DispatcherParseBudgetExceeded      (ExceptionContext ctx, T0 const& limit)     { return Create(ctx, SyntaxError::DispatcherParseBudgetExceeded, limit); }
+                                           static inline CommandSyntaxException DispatcherCommandFailed            (ExceptionContext ctx)                      { return Create(ctx, SyntaxError::DispatcherCommandFailed); }
+
+        // Message of a built-in exception, without the position in the input
+        static inline std::string GetMessage(SyntaxError error, ExceptionArgument const& first, ExceptionArgument const& second)
+        {
+            std::ostringstream s;
+            switch (error) {
+            case SyntaxError::ValueTooLow:                         s << "Value must not be less than " << second << ", found " << first; break;
+            case SyntaxError::ValueTooHigh:                        s << "Value must not be more than " << second << ", found " << first; break;
+            case SyntaxError::LiteralIncorrect:                    s << "Expected literal " << first; break;
+            case SyntaxError::ReaderExpectedStartOfQuote:          s << "Expected quote to start a string"; break;
+            case SyntaxError::ReaderExpectedEndOfQuote:            s << "Unclosed quoted string"; break;
+            case SyntaxError::ReaderInvalidEscape:                 s << "Invalid escape sequence '" << first << "' in quoted string"; break;
+            case SyntaxError::ReaderInvalidValue:                  s << "Invalid value '" << first << "'"; break;
+            case SyntaxError::ReaderExpectedValue:                 s << "Expected value"; break;
+            case SyntaxError::ReaderExpectedSymbol:                s << "Expected '" << first << "'"; break;
+            case SyntaxError::ReaderExpectedOneOf:                 s << "Expected one of `" << first << "`"; break;
+            case SyntaxError::DispatcherUnknownCommand:            s << "Unknown command"; break;
+            case SyntaxError::DispatcherUnknownArgument:           s << "Incorrect argument for command"; break;
+            case SyntaxError::DispatcherExpectedArgumentSeparator: s << "Expected whitespace to end one argument, but found trailing data"; break;
+            case SyntaxError::DispatcherParseException:            s << "Could not parse command: " << first; break;
+            case SyntaxError::DispatcherParseBudgetExceeded:       s << "Command is too complex to parse, exceeded " << first; break;
+            case SyntaxError::DispatcherCommandFailed:             s << "Command failed"; break;
+            default: break;
+            }
+            return s.str();
+        }
+    private:
+        template<typename... Args>
+        static inline CommandSyntaxException Create(ExceptionContext ctx, SyntaxError error, Args const&... args)
+        {
+            return CommandSyntaxException(ExceptionRecord(ctx, error, args...), ctx.input);
+        }
+    };
+
+    /**
+    Compact form of a CommandSyntaxException. Parsing functions that report failures without throwing (see ArgumentType::TryParse)
+    return one, and ParseResults keeps one for each node that failed, as the exceptions of most of them are never looked at.
+    A custom exception keeps its message in place of the arguments.
+    */
+    class ExceptionRecord
+    {
+    public:
+        ExceptionRecord() = default;
+        explicit inline ExceptionRecord(CommandSyntaxException const& ex);
+
+        // Failure reported by a built-in exception (see BuiltInExceptionProvider), whose message is created only when asked for.
+        // Only the part of the input shown in the message is copied, so it does not have to outlive the record.
+        template<typename... Args>
+        ExceptionRecord(ExceptionContext ctx, SyntaxError error, Args const&... args)
+            : cursor(ctx.cursor)
+            , error(error)
+        {
+            ExceptionArgument arguments[2] = { ExceptionArgument(args)... };
+            first = std::move(arguments[0]);
+            second = std::move(arguments[1]);
+            if (ctx.cursor >= 0)
+                excerptLength = static_cast<uint8_t>(CommandSyntaxException::GetExcerpt(ctx).copy(excerpt, CommandSyntaxException::context_amount));
+        }
+
+        inline SyntaxError GetError() const { return error; }
+        inline int GetCursor() const { return cursor; }
+    private:
+        friend class CommandSyntaxException;
+
+        ExceptionArgument first;
+        ExceptionArgument second;
+        int cursor = -1;
+        SyntaxError error = SyntaxError::Custom;
+        uint8_t excerptLength = 0;
+        char excerpt[CommandSyntaxException::context_amount] = {};
     };
 
+    inline ExceptionRecord::ExceptionRecord(CommandSyntaxException const& ex)
+        : second(ex.second)
+        , cursor(ex.ctx.cursor)
+        , error(ex.error)
+        , excerptLength(ex.excerptLength)
+    {
+        if (error == SyntaxError::Custom)
+            first.value = ex.msg;
+        else
+            first = ex.first;
+        std::copy(ex.excerpt, ex.excerpt + excerptLength, excerpt);
+    }
+
+    inline CommandSyntaxException::CommandSyntaxException(ExceptionRecord const& record, std::string_view input)
+        : error(record.error)
+        , excerptLength(record.excerptLength)
+        , second(record.second)
+    {
+        ctx.input = input;
+        ctx.cursor = record.cursor;
+        if (error == SyntaxError::Custom)
+            msg = std::get<std::string>(record.first.value);
+        else
+            first = record.first;
+        std::copy(record.excerpt, record.excerpt + excerptLength, excerpt);
+    }
+
+    inline std::string const& CommandSyntaxException::What()
+    {
+        if (msg.empty() && error != SyntaxError::Custom)
+            msg = CreateMessageApplyContext(ctx, std::string_view(excerpt, excerptLength), BuiltInExceptionProvider::GetMessage(error, first, second));
+        return msg;
+    }
+
     std::string_view StringReader::ReadUnquotedString()
     {
         int start = cursor;
@@ -265,6 +806,16 @@ namespace brigadier
     std::string StringReader::ReadStringUntil(char terminator)
     {
         std::string result;
+        ExceptionRecord error;
+        if (!TryReadStringUntil(terminator, result, error)) {
+            throw CommandSyntaxException(error, string);
+        }
+        return result;
+    }
+
+    bool StringReader::TryReadStringUntil(char terminator, std::string& result, ExceptionRecord& error)
+    {
+        result.clear();
         result.reserve(GetRemainingLength());
 
         bool escaped = false;
@@ -277,34 +828,95 @@ namespace brigadier
                 }
                 else {
                     SetCursor(GetCursor() - 1);
-                    throw CommandSyntaxException::BuiltInExceptions::ReaderInvalidEscape(*this, c);
+                    error = ExceptionRecord(*this, SyntaxError::ReaderInvalidEscape, c);
+                    return false;
                 }
             }
             else if (c == SYNTAX_ESCAPE) {
                 escaped = true;
             }
             else if (c == terminator) {
-                return result;
+                return true;
             }
             else {
                 result += c;
             }
         }
 
-        throw CommandSyntaxException::BuiltInExceptions::ReaderExpectedEndOfQuote(*this);
+        error = ExceptionRecord(*this, SyntaxError::ReaderExpectedEndOfQuote);
+        return false;
     }
 
     std::string StringReader::ReadString()
+    {
+        std::string result;
+        ExceptionRecord error;
+        if (!TryReadString(result, error)) {
+            throw CommandSyntaxException(error, string);
+        }
+        return result;
+    }
+
+    bool StringReader::TryReadString(std::string& result, ExceptionRecord& error)
     {
         if (!CanRead()) {
-            return {};
+            result.clear();
+            return true;
         }
         char next = Peek();
         if (IsQuotedStringStart(next)) {
             Skip();
-            return ReadStringUntil(next);
+            return TryReadStringUntil(next, result, error);
+        }
+        result = ReadUnquotedString();
+        return true;
+    }
+
+    std::string_view StringReader::ReadStringView(std::string& unescaped)
+    {
+        std::string_view result;
+        ExceptionRecord error;
+        if (!TryReadStringView(unescaped, result, error)) {
+            throw CommandSyntaxException(error, string);
+        }
+        return result;
+    }
+
+    bool StringReader::TryReadStringView(std::string& unescaped, std::string_view& result, ExceptionRecord& error)
+    {
+        if (!CanRead()) {
+            result = {};
+            return true;
+        }
+        char next = Peek();
+        if (!IsQuotedStringStart(next)) {
+            result = ReadUnquotedString();
+            return true;
+        }
+        if (tokens != nullptr && tokens->GetInput().data() == string.data() && tokens->GetInput().size() == string.size()) {
+            int end = tokens->GetQuoteEnd(cursor);
+            if (end >= 0) {
+                int start = cursor + 1;
+                cursor = end + 1;
+                result = string.substr(start, end - start);
+                return true;
+            }
+        }
+        for (size_t i = cursor + 1; i < string.length() && string[i] != SYNTAX_ESCAPE; ++i) {
+            if (string[i] == next) {
+                int start = cursor + 1;
+                cursor = int(i) + 1;
+                result = string.substr(start, i - start);
+                return true;
+            }
         }
-        return std::string(ReadUnquotedString());
+        // escapes and missing end quotes are handled by the copying version
+        Skip();
+        if (!TryReadStringUntil(next, unescaped, error)) {
+            return false;
+        }
+        result = unescaped;
+        return true;
     }
 
     void StringReader::Expect(char c)
@@ -317,6 +929,17 @@ namespace brigadier
 
     template<typename T>
     T StringReader::ReadValue()
+    {
+        T result{};
+        ExceptionRecord error;
+        if (!TryReadValue(result, error)) {
+            throw CommandSyntaxException(error, string);
+        }
+        return result;
+    }
+
+    template<typename T>
+    bool StringReader::TryReadValue(T& result, ExceptionRecord& error)
     {
         int start = cursor;
         std::string value;
@@ -327,26 +950,29 @@ namespace brigadier
             }
             value = string.substr(start, cursor - start);
         }
-        else
+        else if (!TryReadString(value, error))
         {
-            value = ReadString();
+            return false;
         }
 
         if (value.empty()) {
-            throw CommandSyntaxException::BuiltInExceptions::ReaderExpectedValue(*this);
+            error = ExceptionRecord(*this, SyntaxError::ReaderExpectedValue);
+            return false;
         }
 
         if constexpr (std::is_same_v<T, bool>)
         {
             /**/ if (value == "true")
-                return true;
+                result = true;
             else if (value == "false")
-                return false;
+                result = false;
             else
             {
                 cursor = start;
-                throw CommandSyntaxException::BuiltInExceptions::ReaderInvalidValue(*this, value);
+                error = ExceptionRecord(*this, SyntaxError::ReaderInvalidValue, value);
+                return false;
             }
+            return true;
         }
         else
         {
@@ -355,11 +981,15 @@ namespace brigadier
             s >> ret;
 
             if (s.eof() && !s.bad() && !s.fail())
-                return ret;
+            {
+                result = std::move(ret);
+                return true;
+            }
             else
             {
                 cursor = start;
-                throw CommandSyntaxException::BuiltInExceptions::ReaderInvalidValue(*this, value);
+                error = ExceptionRecord(*this, SyntaxError::ReaderInvalidValue, value);
+                return false;
             }
         }
     }
@@ -675,47 +1305,408 @@ namespace brigadier
     template<typename S>
     using SuggestionProvider = std::future<Suggestions>(*)(CommandContext<S>& context, SuggestionsBuilder& builder);
 
-    enum class CommandNodeType
-    {
-        RootCommandNode,
-        LiteralCommandNode,
-        ArgumentCommandNode
-    };
-
+    using PermissionMask = uint64_t;
     template<typename S>
-    class CommandNode
-    {
-    public:
-        CommandNode(Command<S> command, Predicate<S&> requirement, std::shared_ptr<CommandNode<S>> redirect, RedirectModifier<S> modifier, const bool forks)
-            : command(std::move(command))
-            , requirement(std::move(requirement))
-            , redirect(std::move(redirect))
-            , modifier(std::move(modifier))
-            , forks(std::move(forks))
+    using PermissionProvider = PermissionMask(*)(S const& source);
+
+    class InternedString;
+
+    /**
+    Process-wide storage of node names.
+
+    Every distinct name is stored once, packed into large blocks, so nodes, children indexes and parsed arguments
+    can refer to names by std::string_view. Names are shared by all command trees, because nodes are shared between
+    dispatchers (see CommandDispatcher(CommandDispatcher const&)) and may be built without any.
+
+    Stored names are reference counted through InternedString. A name is dropped once no reference to it is left,
+    and a block is freed once none of its names are used, so loading and unloading commands does not grow the storage.
+    */
+    class StringInterner
+    {
+    public:
+        /**
+        Gets the stored copy of a string, storing it first if it is new.
+
+        \param text the string to store
+        \return reference to the stored string, which keeps it stored
+        */
+        static InternedString Intern(std::string_view text);
+
+        /**
+        Approximate memory used by stored strings and their index.
+        */
+        static size_t GetMemoryUsage()
+        {
+            auto& interner = Get();
+            std::lock_guard<std::mutex> lock(interner.mutex);
+            return interner.allocated + interner.strings.size() * INDEX_ENTRY_SIZE + interner.strings.bucket_count() * sizeof(void*);
+        }
+
+        /**
+        Approximate memory used by one stored string, including its share of the index.
+        */
+        static constexpr size_t GetMemoryUsage(std::string_view stored)
+        {
+            return stored.empty() ? 0 : sizeof(Header) + Align(stored.size()) + INDEX_ENTRY_SIZE;
+        }
+    private:
+        friend class InternedString;
+
+        struct Block;
+
+        // Stored in front of every string
+        struct Header
+        {
+            std::atomic<size_t> references;
+            Block* block;
+        };
+
+        struct Block
+        {
+            std::unique_ptr<char[]> data;
+            size_t size;
+            size_t used = 0; // bytes taken, freed only when the whole block is
+            size_t strings = 0; // strings of the block that are still stored
+        };
+
+        static constexpr size_t BLOCK_SIZE = 4096;
+        static constexpr size_t INDEX_ENTRY_SIZE = sizeof(std::string_view) + 2 * sizeof(void*); // node of the hash set, estimated
+
+        static constexpr size_t Align(size_t size)
+        {
+            return (size + alignof(Header) - 1) / alignof(Header) * alignof(Header);
+        }
+
+        static Header& GetHeader(std::string_view stored)
+        {
+            return *reinterpret_cast<Header*>(const_cast<char*>(stored.data()) - sizeof(Header));
+        }
+
+        // Another reference to a stored string, made from an existing one, so the string cannot be dropped meanwhile
+        static void Acquire(std::string_view stored)
+        {
+            if (!stored.empty())
+                GetHeader(stored).references.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        static void Release(std::string_view stored)
+        {
+            if (stored.empty())
+                return;
+
+            // only the last reference needs the lock, because Intern() can find the string again until it is dropped
+            Header& header = GetHeader(stored);
+            size_t references = header.references.load(std::memory_order_relaxed);
+            while (references > 1) {
+                if (header.references.compare_exchange_weak(references, references - 1, std::memory_order_acq_rel))
+                    return;
+            }
+
+            auto& interner = Get();
+            std::lock_guard<std::mutex> lock(interner.mutex);
+            if (header.references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                interner.Drop(stored);
+        }
+
+        std::string_view Store(std::string_view text)
+        {
+            size_t size = sizeof(Header) + Align(text.size());
+            Block* block;
+            if (size > BLOCK_SIZE / 4) {
+                // long strings get their own block, so that the current one is not wasted
+                block = AddBlock(size);
+            }
+            else {
+                if (current == nullptr || current->size - current->used < size) {
+                    current = AddBlock(BLOCK_SIZE);
+                }
+                block = current;
+            }
+            char* data = block->data.get() + block->used;
+            block->used += size;
+            ++block->strings;
+
+            new (data) Header{ { 1 }, block };
+            std::memcpy(data + sizeof(Header), text.data(), text.size());
+            return std::string_view(data + sizeof(Header), text.size());
+        }
+
+        void Drop(std::string_view stored)
+        {
+            strings.erase(stored);
+            Block* block = GetHeader(stored).block;
+            GetHeader(stored).~Header();
+            if (--block->strings > 0)
+                return;
+
+            if (block == current) {
+                // the current block is kept for new strings
+                block->used = 0;
+                return;
+            }
+            auto found = std::find_if(blocks.begin(), blocks.end(), [block](auto const& owned) { return owned.get() == block; });
+            allocated -= block->size;
+            blocks.erase(found);
+        }
+
+        Block* AddBlock(size_t size)
+        {
+            blocks.push_back(std::make_unique<Block>(Block{ std::unique_ptr<char[]>(new char[size]), size }));
+            allocated += size;
+            return blocks.back().get();
+        }
+
+        static StringInterner& Get()
+        {
+            // not destroyed at exit, so names held by static objects can still be released
+            static StringInterner* interner = new StringInterner();
+            return *interner;
+        }
+    private:
+        std::mutex mutex;
+        std::unordered_set<std::string_view> strings;
+        std::vector<std::unique_ptr<Block>> blocks;
+        Block* current = nullptr; // block receiving short strings
+        size_t allocated = 0;
+    };
+
+    /**
+    Reference to a string stored by StringInterner, usable as a std::string_view.
+
+    Copies refer to the same stored string. It stays stored as long as any reference to it exists.
+    */
+    class InternedString
+    {
+    public:
+        InternedString() = default;
+        InternedString(InternedString const& other) : text(other.text)
+        {
+            StringInterner::Acquire(text);
+        }
+        InternedString(InternedString&& other) noexcept : text(std::exchange(other.text, {})) {}
+        InternedString& operator=(InternedString other) noexcept
+        {
+            std::swap(text, other.text);
+            return *this;
+        }
+        ~InternedString()
+        {
+            StringInterner::Release(text);
+        }
+
+        inline operator std::string_view() const { return text; }
+        inline std::string_view GetView() const { return text; }
+        inline const char* data() const { return text.data(); }
+        inline size_t size() const { return text.size(); }
+        inline bool empty() const { return text.empty(); }
+    private:
+        friend class StringInterner;
+        explicit InternedString(std::string_view stored) : text(stored) {}
+
+        std::string_view text;
+    };
+
+    inline InternedString StringInterner::Intern(std::string_view text)
+    {
+        if (text.empty())
+            return {};
+
+        auto& interner = Get();
+        std::lock_guard<std::mutex> lock(interner.mutex);
+        auto found = interner.strings.find(text);
+        if (found != interner.strings.end()) {
+            GetHeader(*found).references.fetch_add(1, std::memory_order_relaxed);
+            return InternedString(*found);
+        }
+
+        std::string_view stored = interner.Store(text);
+        interner.strings.insert(stored);
+        return InternedString(stored);
+    }
+
+    enum class CommandNodeType
+    {
+        RootCommandNode,
+        LiteralCommandNode,
+        ArgumentCommandNode
+    };
+
+    /**
+    Permission mask required by a node that should only be usable with permission level of at least `level`.
+    Sources should report their level with GrantLevel(int).
+    */
+    constexpr PermissionMask RequireLevel(int level)
+    {
+        return level <= 0 ? 0 : level > 64 ? PermissionMask(1) << 63 : PermissionMask(1) << (level - 1);
+    }
+
+    /**
+    Permission mask of a source with permission level `level`. It satisfies RequireLevel(n) for every n <= level.
+    */
+    constexpr PermissionMask GrantLevel(int level)
+    {
+        return level <= 0 ? 0 : level >= 64 ? ~PermissionMask(0) : (PermissionMask(1) << level) - 1;
+    }
+
+    /**
+    Identifies the command tree allowed to modify its nodes in place, usually one per CommandDispatcher.
+
+    Once sealed, nodes marked with it may be shared with another tree (see CommandDispatcher(CommandDispatcher const&)),
+    so they are copied before being modified through a dispatcher and cannot be modified through builders obtained before.
+    */
+    class CommandTreeOwner
+    {
+    public:
+        inline bool IsSealed() const
+        {
+            return sealed.load(std::memory_order_acquire);
+        }
+
+        inline void Seal()
+        {
+            sealed.store(true, std::memory_order_release);
+        }
+
+        // Owner of nodes with several parents, which no tree may modify in place
+        static std::shared_ptr<CommandTreeOwner> const& Shared()
+        {
+            static const std::shared_ptr<CommandTreeOwner> shared = [] {
+                auto owner = std::make_shared<CommandTreeOwner>();
+                owner->Seal();
+                return owner;
+            }();
+            return shared;
+        }
+    private:
+        std::atomic<bool> sealed = false;
+    };
+
+    /**
+    Work done by one parse and its limits, see ParseOptions. Shared with parsers generated by StaticCommandNode,
+    so the nodes they try count as well.
+    */
+    struct ParseBudget
+    {
+        size_t visits = 0;
+        size_t maxVisits = 0; // 0 for no limit
+        bool timed = false;
+        std::chrono::steady_clock::time_point deadline;
+
+        // Counts a node tried at the reader position and aborts the parse once over the limits
+        inline void Visit(StringReader const& reader)
+        {
+            ++visits;
+            if (maxVisits > 0 && visits > maxVisits) {
+                throw CommandSyntaxException::BuiltInExceptions::DispatcherParseBudgetExceeded(reader, "node visit limit");
+            }
+            // reading the clock costs more than a node visit, so it is done only every few visits
+            if (timed && (visits & 31) == 0 && std::chrono::steady_clock::now() > deadline) {
+                throw CommandSyntaxException::BuiltInExceptions::DispatcherParseBudgetExceeded(reader, "time limit");
+            }
+        }
+    };
+
+    template<typename S>
+    class CommandNode
+    {
+    public:
+        CommandNode(CommandNodeType kind, std::string_view name, Command<S> command, Predicate<S&> requirement, std::shared_ptr<CommandNode<S>> redirect, RedirectModifier<S> modifier, const bool forks)
+            : kind(kind)
+            , name(StringInterner::Intern(name))
+            , command(std::move(command))
+            , requirement(std::move(requirement))
+            , modifier(std::move(modifier))
+            , forks(std::move(forks))
+        {
+            SetRedirect(std::move(redirect));
+            subtree.requirement = this->requirement != nullptr;
+            subtree.redirect = this->redirect != nullptr;
+        }
+        CommandNode(CommandNodeType kind, std::string_view name)
+            : kind(kind)
+            , name(StringInterner::Intern(name))
         {}
-        CommandNode() {}
-        virtual ~CommandNode() = default;
+        CommandNode(CommandNode const& other)
+            : kind(other.kind)
+            , name(other.name)
+            , children(other.children)
+            , literals(other.literals)
+            , arguments(other.arguments)
+            , command(other.command)
+            , requirement(other.requirement)
+            , redirect(other.redirect)
+            , redirectTarget(other.redirectTarget)
+            , modifier(other.modifier)
+            , forks(other.forks)
+            , permissions(other.permissions)
+            , revision(other.revision)
+            , childrenRevision(other.childrenRevision)
+            , attachRevision(other.attachRevision)
+            , removedChildren(other.removedChildren)
+            , removedHorizon(other.removedHorizon)
+            , subtree(other.subtree)
+        {}
+        CommandNode& operator=(CommandNode const&) = delete;
+        virtual ~CommandNode()
+        {
+            if (IsWritable()) {
+                for (auto& [name, child] : children)
+                    Unlink(child.get());
+            }
+        }
     public:
+        inline CommandNodeType GetNodeType() const
+        {
+            return kind;
+        }
+
+        inline std::string_view GetName() const
+        {
+            return name;
+        }
+
+        /**
+        Parses the rest of the input below this node with a parser generated at compile time, see StaticCommandNode.
+
+        \param budget counts the nodes tried, throws CommandSyntaxException once over its limits
+        \return false if this node has no such parser or it could not parse a complete command, `reader` and `context` are not changed then
+        */
+        inline bool ParseCompiled(StringReader& reader, CommandContext<S>& context, PermissionMask permissions, ParseBudget& budget)
+        {
+            return compiledParse != nullptr && compiledParse(*this, reader, context, permissions, budget);
+        }
+
+        inline bool ParseCompiled(StringReader& reader, CommandContext<S>& context, PermissionMask permissions)
+        {
+            ParseBudget unlimited;
+            return ParseCompiled(reader, context, permissions, unlimited);
+        }
+
         inline Command<S> GetCommand() const
         {
             return command;
         }
 
-        inline std::map<std::string, std::shared_ptr<CommandNode<S>>, std::less<>> const& GetChildren() const
+        inline std::map<std::string_view, std::shared_ptr<CommandNode<S>>, std::less<>> const& GetChildren() const
         {
             return children;
         }
 
-        inline std::shared_ptr<CommandNode<S>> GetChild(std::string_view name) const
+        // Returned by reference, so that walking the tree does not change reference counts. Copy the pointer to keep the node alive.
+        inline std::shared_ptr<CommandNode<S>> const& GetChild(std::string_view name) const
         {
+            static const std::shared_ptr<CommandNode<S>> none;
             auto found = children.find(name);
             if (found != children.end())
                 return found->second;
-            return nullptr;
+            return none;
         }
 
+        // A redirect to a node above this one does not keep it alive (see SetRedirect()), then this is nullptr once that node is freed
         inline std::shared_ptr<CommandNode<S>> GetRedirect() const
         {
+            if (redirect != nullptr && redirect.use_count() == 0)
+                return redirectTarget.lock();
             return redirect;
         }
 
@@ -729,11 +1720,50 @@ namespace brigadier
             return requirement;
         }
 
+        inline PermissionMask GetPermissions() const
+        {
+            return permissions;
+        }
+
+        /**
+        Union of permissions required by this node and every node below it. Redirects are not followed.
+        */
+        inline PermissionMask GetSubtreePermissions() const
+        {
+            return subtree.permissions;
+        }
+
+        /**
+        Revision of the last change made to this node's command, requirements or redirect.
+        Revisions come from a process-wide counter, so they are comparable between nodes.
+        */
+        inline size_t GetRevision() const
+        {
+            return revision;
+        }
+
+        /**
+        Highest revision found in this subtree. Changes whenever any node below (and including) this node is modified,
+        or a child is added anywhere in the subtree.
+        */
+        inline size_t GetSubtreeRevision() const
+        {
+            return subtree.revision;
+        }
+
         inline bool IsFork() const
         {
             return forks;
         }
 
+        /**
+        Checks if this node can be modified in place. Nodes that are not a part of any tree yet always can.
+        */
+        inline bool IsWritable() const
+        {
+            return owner == nullptr || !owner->IsSealed();
+        }
+
         inline bool CanUse(S& source)
         {
             if (requirement)
@@ -741,11 +1771,31 @@ namespace brigadier
             else return true;
         }
 
+        inline bool CanUse(S& source, PermissionMask granted)
+        {
+            return HasPermissions(granted) && CanUse(source);
+        }
+
+        inline bool HasPermissions(PermissionMask granted) const
+        {
+            return (permissions & ~granted) == 0;
+        }
+
+        /**
+        Checks if a source with `granted` permissions can use every node of this subtree (including this node),
+        so that further checks below can be skipped. Always false if any node of the subtree has a Predicate requirement.
+        */
+        inline bool CanUseSubtree(PermissionMask granted) const
+        {
+            return !subtree.requirement && (subtree.permissions & ~granted) == 0;
+        }
+
         void AddChild(std::shared_ptr<CommandNode<S>> node)
         {
             if (node == nullptr)
                 return;
 
+            CheckWritable();
             if (node->GetNodeType() == CommandNodeType::RootCommandNode) {
                 throw std::runtime_error("Cannot add a RootCommandNode as a child to any other CommandNode");
             }
@@ -753,21 +1803,30 @@ namespace brigadier
             auto child = children.find(node->GetName());
             if (child != children.end()) {
                 // We've found something to merge onto
-                auto child_node = child->second;
-
-                if (child_node->GetNodeType() != node->GetNodeType())
+                if (child->second->GetNodeType() != node->GetNodeType())
                     throw std::runtime_error("Node type (literal/argument) mismatch!");
 
+                auto child_node = GetOwnedChild(child->first);
+
                 auto node_command = node->GetCommand();
                 if (node_command != nullptr) {
                     child_node->command = node_command;
+                    child_node->Modified();
                 }
                 for (auto& [name, grandchild] : node->GetChildren()) {
                     child_node->AddChild(grandchild);
                 }
             }
             else {
+                if (!node->IsWritable())
+                    node = node->Clone(); // shared with another tree, so it cannot be marked as attached here
+                if (owner != nullptr)
+                    node->Adopt(owner);
+                childrenRevision = node->attachRevision = NextRevision();
+                Link(node.get());
                 children.emplace(node->GetName(), node);
+                node->MergeSubtree({ node->attachRevision });
+                MergeSubtree(node->subtree);
                 if (node->GetNodeType() == CommandNodeType::LiteralCommandNode) {
                     literals.emplace_back(std::move(std::static_pointer_cast<LiteralCommandNode<S>>(std::move(node))));
                 }
@@ -777,6 +1836,41 @@ namespace brigadier
             }
         }
 
+        /**
+        Removes a child node together with its subtree.
+
+        Redirects pointing into the removed subtree are not changed, see CommandDispatcher::Unregister to find them.
+
+        \param name name of the child
+        \return the removed node, or nullptr if there is no such child
+        */
+        std::shared_ptr<CommandNode<S>> RemoveChild(std::string_view name)
+        {
+            CheckWritable();
+            auto found = children.find(name);
+            if (found == children.end())
+                return nullptr;
+
+            auto node = std::move(found->second);
+            children.erase(found);
+            if (node->GetNodeType() == CommandNodeType::LiteralCommandNode) {
+                auto literal = std::find(literals.begin(), literals.end(), node);
+                std::swap(*literal, literals.back());
+                literals.pop_back();
+            }
+            else {
+                arguments.erase(std::find(arguments.begin(), arguments.end(), node));
+            }
+            Unlink(node.get());
+            childrenRevision = NextRevision();
+            auto [removed, added] = removedChildren.try_emplace(node->GetName(), RemovedChild{ node->name, node->attachRevision });
+            removed->second.removed = childrenRevision;
+            if (removedChildren.size() > children.size() + REMOVED_CHILDREN_SLACK)
+                ForgetRemovedChildren();
+            UpdateSubtree();
+            return node;
+        }
+
         void FindAmbiguities(AmbiguityConsumer<S> consumer)
         {
             for (auto [child_name, child] : children) {
@@ -810,19 +1904,27 @@ namespace brigadier
                 }
                 std::string_view text = input.GetString().substr(cursor, input.GetCursor() - cursor);
                 input.SetCursor(cursor);
-                auto literal = children.find(text);
-                if (literal != children.end() && literal->second->GetNodeType() == CommandNodeType::LiteralCommandNode) {
-                    return std::tuple<std::shared_ptr<CommandNode<S>>*, size_t>(&literal->second, 1);
-                }
-                else {
-                    return std::tuple<std::shared_ptr<CommandNode<S>>*, size_t>((std::shared_ptr<CommandNode<S>>*)arguments.data(), arguments.size());
-                }
+                return GetRelevantNodes(text);
             }
             else {
                 return std::tuple<std::shared_ptr<CommandNode<S>>*, size_t>((std::shared_ptr<CommandNode<S>>*)arguments.data(), arguments.size());
             }
         }
 
+        /**
+        Same as GetRelevantNodes(StringReader&), for a word already read from the input (see StringTokens).
+        */
+        std::tuple<std::shared_ptr<CommandNode<S>>*, size_t> GetRelevantNodes(std::string_view word)
+        {
+            if (literals.size() > 0) {
+                auto literal = children.find(word);
+                if (literal != children.end() && literal->second->GetNodeType() == CommandNodeType::LiteralCommandNode) {
+                    return std::tuple<std::shared_ptr<CommandNode<S>>*, size_t>(&literal->second, 1);
+                }
+            }
+            return std::tuple<std::shared_ptr<CommandNode<S>>*, size_t>((std::shared_ptr<CommandNode<S>>*)arguments.data(), arguments.size());
+        }
+
         bool HasCommand()
         {
             if (GetCommand() != nullptr) return true;
@@ -832,13 +1934,16 @@ namespace brigadier
             return false;
         }
     public:
-        virtual std::string const& GetName() = 0;
         virtual std::string GetUsageText() = 0;
         virtual std::vector<std::string_view> GetExamples() = 0;
         virtual void Parse(StringReader& reader, CommandContext<S>& contextBuilder) = 0;
         virtual std::future<Suggestions> ListSuggestions(CommandContext<S>& context, SuggestionsBuilder& builder) = 0;
 
-        virtual CommandNodeType GetNodeType() = 0;
+        // Shallow copy of this node. The copy shares children with the original.
+        virtual std::shared_ptr<CommandNode<S>> Clone() = 0;
+
+        // Size of the node object, without memory owned by its members.
+        virtual size_t GetObjectSize() = 0;
     protected:
         template<typename _S, typename T, typename node_type>
         friend class ArgumentBuilder;
@@ -850,72 +1955,361 @@ namespace brigadier
         friend class RequiredArgumentBuilder;
         template<typename _S>
         friend class LiteralArgumentBuilder;
+        template<typename _S>
+        friend class CommandTreeBinder;
+        template<typename _S, typename Tree>
+        friend class StaticCommandNode;
 
         virtual bool IsValidInput(std::string_view input) = 0;
         virtual std::string_view GetSortedKey() = 0;
-    private:
-        std::map<std::string, std::shared_ptr<CommandNode<S>>, std::less<>> children;
-        std::vector<std::shared_ptr<LiteralCommandNode<S>>> literals;
-        std::vector<std::shared_ptr<IArgumentCommandNode<S>>> arguments;
-        Command<S> command = nullptr;
-        Predicate<S&> requirement = nullptr;
-        std::shared_ptr<CommandNode<S>> redirect = nullptr;
-        RedirectModifier<S> modifier = nullptr;
-        bool forks = false;
-    };
 
-    template<typename S>
-    class RootCommandNode : public CommandNode<S>
-    {
-    public:
-        RootCommandNode() : CommandNode<S>(nullptr, [](S&) { return true; }, nullptr, [](auto s)->std::vector<S> { return { s.GetSource() }; }, false) {}
+        // Stamps this node with a new revision and updates subtree data of this node and its ancestors.
+        // Has to be called on each change of command, requirements, permissions or redirect.
+        inline void Modified()
+        {
+            revision = NextRevision();
+            UpdateSubtree();
+        }
 
-        virtual ~RootCommandNode() = default;
-        virtual std::string const& GetName() { static const std::string blank; return blank; }
-        virtual std::string GetUsageText() { return {}; }
-        virtual std::vector<std::string_view> GetExamples() { return {}; }
-        virtual void Parse(StringReader& reader, CommandContext<S>& contextBuilder) {}
-        virtual std::future<Suggestions> ListSuggestions(CommandContext<S>& context, SuggestionsBuilder& builder)
+        inline void CheckWritable() const
         {
-            return Suggestions::Empty();
+            if (!IsWritable())
+                throw std::runtime_error("Cannot modify a node shared with another command tree, get a new builder from the dispatcher");
         }
-        virtual CommandNodeType GetNodeType() { return CommandNodeType::RootCommandNode; }
-    protected:
-        virtual bool IsValidInput(std::string_view input) { return false; }
-        virtual std::string_view GetSortedKey() { return {}; }
-    };
+
+        static inline size_t NextRevision()
+        {
+            return clock.fetch_add(1, std::memory_order_relaxed) + 1;
+        }
+
+        // A redirect does not keep its target alive while the target is above this node, i.e. every way up from this node passes it
+        // (including the root of its own tree). The tree keeps such a target alive, and owning it would make the tree keep itself alive
+        // and never be freed, e.g. the versions replaced by CommandDispatcher::Replace(). This is checked again whenever the parents
+        // above this node change, see Link(). Ways up through trees that share this node are not tracked, so the target is also
+        // referenced weakly and GetRedirect() returns nullptr instead of a freed node.
+        void SetRedirect(std::shared_ptr<CommandNode<S>> target)
+        {
+            redirectTarget = target;
+            redirect = std::move(target);
+            UpdateRedirectOwnership();
+        }
+
+        // Moves the redirect of a copy to the copy of its target, which is above the copy if the original target was above the original
+        void RelinkRedirect(std::shared_ptr<CommandNode<S>> target)
+        {
+            bool above = redirect != nullptr && redirect.use_count() == 0;
+            redirectTarget = target;
+            redirect = above ? std::shared_ptr<CommandNode<S>>(std::shared_ptr<void>(), target.get()) : std::move(target);
+        }
+
+        // Owns the redirect target only if it is not above this node, see SetRedirect().
+        // Returns the reference given up, so that the caller can release it once it no longer walks the tree.
+        std::shared_ptr<CommandNode<S>> UpdateRedirectOwnership()
+        {
+            if (redirect == nullptr)
+                return nullptr;
+            bool owning = redirect.use_count() != 0;
+            bool above = IsBelow(redirect.get());
+            if (above && owning) {
+                auto released = std::move(redirect);
+                redirect = std::shared_ptr<CommandNode<S>>(std::shared_ptr<void>(), released.get());
+                return released;
+            }
+            if (!above && !owning) {
+                // a target that is being freed, e.g. the parent unlinking this node in its destructor, stays expired
+                if (auto target = redirectTarget.lock())
+                    redirect = std::move(target);
+            }
+            return nullptr;
+        }
+
+        // Updates the redirects below `node` after the ways up from it changed, see SetRedirect().
+        // Only nodes of the same tree are visited, their parents are the ones tracked by Link().
+        static void UpdateRedirectsBelow(CommandNode<S>* node)
+        {
+            if (!node->subtree.redirect)
+                return;
+
+            std::vector<std::shared_ptr<CommandNode<S>>> released; // freed after the walk, as a freed node unlinks its children
+            std::vector<CommandNode<S>*> pending{ node };
+            std::set<CommandNode<S>*> visited{ node };
+            while (!pending.empty()) {
+                auto current = pending.back();
+                pending.pop_back();
+                if (auto previous = current->UpdateRedirectOwnership())
+                    released.push_back(std::move(previous));
+                for (auto& [name, child] : current->children) {
+                    if (child->subtree.redirect && child->owner == node->owner && visited.insert(child.get()).second)
+                        pending.push_back(child.get());
+                }
+            }
+        }
+
+        // Whether every way up from this node passes `ancestor`. Parents are only known between writable nodes, see Link().
+        bool IsBelow(CommandNode<S>* ancestor) const
+        {
+            std::vector<const CommandNode<S>*> pending{ this };
+            std::set<const CommandNode<S>*> visited{ this };
+            while (!pending.empty()) {
+                auto node = pending.back();
+                pending.pop_back();
+                if (node == ancestor)
+                    continue;
+                if (node->parents.empty())
+                    return false;
+                for (auto parent : node->parents) {
+                    if (visited.insert(parent).second)
+                        pending.push_back(parent);
+                }
+            }
+            return true;
+        }
+
+        // Gets a child that can be modified in place. A child shared with another tree is copied first, see CommandDispatcher(CommandDispatcher const&).
+        // This node has to be writable.
+        std::shared_ptr<CommandNode<S>> GetOwnedChild(std::string_view name)
+        {
+            auto found = children.find(name);
+            if (found == children.end())
+                return nullptr;
+            if (found->second->owner == owner)
+                return found->second;
+
+            auto copy = found->second->Clone();
+            copy->owner = owner;
+            ReplaceChild(copy);
+            return copy;
+        }
+
+        // Replaces the child of the same name with a copy, keeping its position. Revisions are not changed.
+        void ReplaceChild(std::shared_ptr<CommandNode<S>> node)
+        {
+            auto& child = children.find(node->GetName())->second;
+            Unlink(child.get());
+            Link(node.get());
+            MergeSubtree(node->subtree);
+            if (node->GetNodeType() == CommandNodeType::LiteralCommandNode) {
+                *std::find(literals.begin(), literals.end(), child) = std::static_pointer_cast<LiteralCommandNode<S>>(node);
+            }
+            else {
+                *std::find(arguments.begin(), arguments.end(), child) = std::static_pointer_cast<IArgumentCommandNode<S>>(node);
+            }
+            child = std::move(node);
+        }
+    private:
+        // Marks nodes that are not a part of any tree yet, e.g. built with MakeLiteral(), as nodes of the tree
+        void Adopt(std::shared_ptr<CommandTreeOwner> const& tree)
+        {
+            if (owner != nullptr)
+                return;
+            owner = tree;
+            for (auto& [name, child] : children)
+                child->Adopt(tree);
+        }
+
+        // Summary of a subtree, kept up to date by every change so that reading it never writes
+        struct SubtreeData
+        {
+            size_t revision = 0;
+            PermissionMask permissions = 0;
+            bool requirement = false;
+            bool redirect = false;
+
+            inline void Merge(SubtreeData const& other)
+            {
+                revision = (std::max)(revision, other.revision);
+                permissions |= other.permissions;
+                requirement |= other.requirement;
+                redirect |= other.redirect;
+            }
+
+            inline bool operator==(SubtreeData const& other) const
+            {
+                return revision == other.revision && permissions == other.permissions && requirement == other.requirement && redirect == other.redirect;
+            }
+        };
+
+        // Parents are tracked only between writable nodes of the same tree, because other nodes do not change any more
+        // and may be shared with other trees, possibly released on another thread.
+        void Link(CommandNode<S>* child)
+        {
+            if (child->owner == owner && IsWritable()) {
+                child->parents.push_back(this);
+                UpdateRedirectsBelow(child);
+            }
+        }
+
+        void Unlink(CommandNode<S>* child)
+        {
+            if (child->owner != owner || !IsWritable())
+                return;
+            auto found = std::find(child->parents.begin(), child->parents.end(), this);
+            if (found != child->parents.end()) {
+                child->parents.erase(found);
+                UpdateRedirectsBelow(child);
+            }
+        }
+
+        // Forgets the older half of the removed children. Deltas since an older version re-send this node instead, see CommandDispatcher::GetDelta(size_t).
+        void ForgetRemovedChildren()
+        {
+            std::vector<size_t> revisions;
+            revisions.reserve(removedChildren.size());
+            for (auto& [name, removed] : removedChildren)
+                revisions.push_back(removed.removed);
+            auto middle = revisions.begin() + revisions.size() / 2;
+            std::nth_element(revisions.begin(), middle, revisions.end());
+            removedHorizon = (std::max)(removedHorizon, *middle);
+            for (auto entry = removedChildren.begin(); entry != removedChildren.end();) {
+                if (entry->second.removed <= removedHorizon)
+                    entry = removedChildren.erase(entry);
+                else
+                    ++entry;
+            }
+        }
+
+        // Recomputes subtree data after a change that may have removed something from it, e.g. a removed child
+        void UpdateSubtree()
+        {
+            SubtreeData data{ (std::max)({ revision, childrenRevision, attachRevision }), permissions, requirement != nullptr, redirect != nullptr };
+            for (auto& [name, child] : children)
+                data.Merge(child->subtree);
+            SetSubtree(data);
+        }
+
+        // Adds data of a changed descendant
+        void MergeSubtree(SubtreeData const& data)
+        {
+            SubtreeData merged = subtree;
+            merged.Merge(data);
+            SetSubtree(merged);
+        }
+
+        void SetSubtree(SubtreeData const& data)
+        {
+            if (data == subtree)
+                return;
+            SubtreeData previous = subtree;
+            subtree = data;
+            previous.Merge(data);
+            if (previous == data) {
+                // only grown, so ancestors can merge it instead of visiting all their children
+                for (auto parent : parents)
+                    parent->MergeSubtree(data);
+            }
+            else {
+                for (auto parent : parents)
+                    parent->UpdateSubtree();
+            }
+        }
+    protected:
+        // plain fields instead of virtual functions, because they are checked for every candidate node while parsing
+        CommandNodeType kind;
+        InternedString name; // see StringInterner
+        // set by StaticCommandNode only, so it is not copied by the copy constructor
+        bool(*compiledParse)(CommandNode<S>& node, StringReader& reader, CommandContext<S>& context, PermissionMask permissions, ParseBudget& budget) = nullptr;
+    private:
+        static inline std::atomic<size_t> clock{ 1 };
+        static constexpr size_t REMOVED_CHILDREN_SLACK = 64; // removed children remembered besides one per existing child
+
+        // Children removed with the same name are merged, so the entry covers the first time one was added until the last removal.
+        // A child added with the name again keeps the entry, which only matters once it is removed as well.
+        struct RemovedChild
+        {
+            InternedString name; // keeps the key of removedChildren
+            size_t attached;
+            size_t removed = 0;
+        };
+
+        std::map<std::string_view, std::shared_ptr<CommandNode<S>>, std::less<>> children; // keys are interned names of the children, see StringInterner
+        std::vector<std::shared_ptr<LiteralCommandNode<S>>> literals;
+        std::vector<std::shared_ptr<IArgumentCommandNode<S>>> arguments;
+        Command<S> command = nullptr;
+        Predicate<S&> requirement = nullptr;
+        std::shared_ptr<CommandNode<S>> redirect = nullptr; // does not own a target above this node, see SetRedirect()
+        std::weak_ptr<CommandNode<S>> redirectTarget;
+        RedirectModifier<S> modifier = nullptr;
+        bool forks = false;
+        PermissionMask permissions = 0;
+        size_t revision = 0;          // own properties, see Modified()
+        size_t childrenRevision = 0;  // last change of children
+        size_t attachRevision = 0;    // last time this node was added as a child
+        std::map<std::string_view, RemovedChild, std::less<>> removedChildren; // by name, see CommandDispatcher::GetDelta(size_t)
+        size_t removedHorizon = 0;    // removals up to this revision are forgotten
+        std::shared_ptr<CommandTreeOwner> owner; // tree allowed to modify this node in place, null if not a part of one yet
+        std::vector<CommandNode<S>*> parents; // writable parents, whose subtree data includes this node, see Link()
+        SubtreeData subtree;
+    };
 
     template<typename S>
-    class LiteralCommandNode : public CommandNode<S>
+    class RootCommandNode : public CommandNode<S>
     {
     public:
-        LiteralCommandNode(std::string_view literal, std::shared_ptr<Command<S>> command, Predicate<S&> requirement, std::shared_ptr<CommandNode<S>> redirect, RedirectModifier<S> modifier, const bool forks)
-            : CommandNode<S>(command, requirement, redirect, modifier, forks)
-            , literal(literal)
-            , literalLowerCase(literal)
+        RootCommandNode() : CommandNode<S>(CommandNodeType::RootCommandNode, {}, nullptr, nullptr, nullptr, [](auto s)->std::vector<S> { return { s.GetSource() }; }, false) {}
+
+        virtual ~RootCommandNode() = default;
+        virtual std::string GetUsageText() { return {}; }
+        virtual std::vector<std::string_view> GetExamples() { return {}; }
+        virtual void Parse(StringReader& reader, CommandContext<S>& contextBuilder) {}
+        virtual std::future<Suggestions> ListSuggestions(CommandContext<S>& context, SuggestionsBuilder& builder)
         {
-            std::transform(literalLowerCase.begin(), literalLowerCase.end(), literalLowerCase.begin(), [](char c) { return std::tolower(c); });
+            return Suggestions::Empty();
         }
+        virtual std::shared_ptr<CommandNode<S>> Clone() { return std::make_shared<RootCommandNode<S>>(*this); }
+        virtual size_t GetObjectSize() { return sizeof(*this); }
+    protected:
+        virtual bool IsValidInput(std::string_view input) { return false; }
+        virtual std::string_view GetSortedKey() { return {}; }
+    };
+
+    template<typename S>
+    class LiteralCommandNode : public CommandNode<S>
+    {
+    public:
+        LiteralCommandNode(std::string_view literal, std::shared_ptr<Command<S>> command, Predicate<S&> requirement, std::shared_ptr<CommandNode<S>> redirect, RedirectModifier<S> modifier, const bool forks)
+            : CommandNode<S>(CommandNodeType::LiteralCommandNode, literal, command, requirement, redirect, modifier, forks)
+            , literal(this->name)
+            , lowerCase(LowerCase(this->literal))
+            , literalLowerCase(lowerCase.empty() ? this->literal : lowerCase.GetView())
+        {}
         LiteralCommandNode(std::string_view literal)
-            : literal(literal)
-            , literalLowerCase(literal)
-        {
-            std::transform(literalLowerCase.begin(), literalLowerCase.end(), literalLowerCase.begin(), [](char c) { return std::tolower(c); });
-        }
+            : CommandNode<S>(CommandNodeType::LiteralCommandNode, literal)
+            , literal(this->name)
+            , lowerCase(LowerCase(this->literal))
+            , literalLowerCase(lowerCase.empty() ? this->literal : lowerCase.GetView())
+        {}
         virtual ~LiteralCommandNode() = default;
-        virtual std::string const& GetName() { return literal; }
-        virtual std::string GetUsageText() { return literal; }
+        virtual std::string GetUsageText() { return std::string(literal); }
         virtual std::vector<std::string_view> GetExamples() { return { literal }; }
         virtual void Parse(StringReader& reader, CommandContext<S>& contextBuilder)
+        {
+            ParseLiteral(reader, contextBuilder);
+        }
+        /**
+        Same as Parse(StringReader&, CommandContext<S>&), but can be called without a virtual call
+        once the node is known to be a literal, see CommandNode::GetNodeType().
+        */
+        inline void ParseLiteral(StringReader& reader, CommandContext<S>& contextBuilder)
+        {
+            ExceptionRecord error;
+            if (!TryParseLiteral(reader, contextBuilder, error)) {
+                throw CommandSyntaxException(error, reader.GetString());
+            }
+        }
+        /**
+        Same as ParseLiteral, but returns false with the failure in `error` instead of throwing it.
+        */
+        inline bool TryParseLiteral(StringReader& reader, CommandContext<S>& contextBuilder, ExceptionRecord& error)
         {
             int start = reader.GetCursor();
             int end = Parse(reader);
             if (end > -1) {
                 contextBuilder.WithNode(this, StringRange::Between(start, end));
-                return;
+                return true;
             }
 
-            throw CommandSyntaxException::BuiltInExceptions::LiteralIncorrect(reader, literal);
+            error = ExceptionRecord(reader, SyntaxError::LiteralIncorrect, literal);
+            return false;
         }
         virtual std::future<Suggestions> ListSuggestions(CommandContext<S>& context, SuggestionsBuilder& builder)
         {
@@ -924,7 +2318,8 @@ namespace brigadier
             else
                 return Suggestions::Empty();
         }
-        virtual CommandNodeType GetNodeType() { return CommandNodeType::LiteralCommandNode; }
+        virtual std::shared_ptr<CommandNode<S>> Clone() { return std::make_shared<LiteralCommandNode<S>>(*this); }
+        virtual size_t GetObjectSize() { return sizeof(*this); }
     protected:
         virtual bool IsValidInput(std::string_view input) {
             StringReader reader(input);
@@ -932,6 +2327,17 @@ namespace brigadier
         }
         virtual std::string_view GetSortedKey() { return literal; }
     private:
+        // Lower case form is interned only if it differs from the literal
+        static InternedString LowerCase(std::string_view literal)
+        {
+            auto upper = std::find_if(literal.begin(), literal.end(), [](char c) { return std::tolower(c) != c; });
+            if (upper == literal.end())
+                return {};
+            std::string lower(literal);
+            std::transform(lower.begin(), lower.end(), lower.begin(), [](char c) { return std::tolower(c); });
+            return StringInterner::Intern(lower);
+        }
+
         int Parse(StringReader& reader)
         {
             int start = reader.GetCursor();
@@ -950,8 +2356,12 @@ namespace brigadier
             return -1;
         }
     private:
-        std::string literal;
-        std::string literalLowerCase;
+        template<typename _S>
+        friend class CommandDispatcher;
+
+        std::string_view literal;          // name of the node
+        InternedString lowerCase;          // empty if the literal has no upper case characters
+        std::string_view literalLowerCase; // lowerCase or the literal
     };
     
 
@@ -972,6 +2382,16 @@ namespace brigadier
             return reader.ReadValue<T>();
         }
 
+        /**
+        Same as Parse, but returns false with the failure in `error` instead of throwing it, so the dispatcher can try
+        candidates without exceptions. The dispatcher calls it only if it is declared by the same class as Parse
+        (see HasTryParse), other argument types are parsed with Parse.
+        */
+        bool TryParse(StringReader& reader, T& result, ExceptionRecord& error)
+        {
+            return reader.TryReadValue<T>(result, error);
+        }
+
         template<typename S>
         std::future<Suggestions> ListSuggestions(CommandContext<S>& context, SuggestionsBuilder& builder)
         {
@@ -991,40 +2411,120 @@ namespace brigadier
         {
             return {};
         }
+
+        /**
+        Characters that input accepted by Parse can start with. The dispatcher does not call Parse on input starting
+        with any other character, so the set must contain every character for which Parse may succeed.
+        The end of input is always passed to Parse.
+        */
+        static constexpr CharacterSet GetFirstCharacters()
+        {
+            return CharacterSet::All();
+        }
     };
     REGISTER_ARGTYPE_TEMPL(ArgumentType, Type);
 
+    template<typename M>
+    struct MemberClass;
+    template<typename C, typename M>
+    struct MemberClass<M C::*> { using type = C; };
+
+    /**
+    Checks if the argument type can be parsed without exceptions, see ArgumentType::TryParse. A type that replaces
+    the Parse function of its base class is parsed with its own Parse, not with the TryParse it inherits.
+    */
+    template<typename T, typename = void>
+    struct HasTryParse : std::false_type {};
+    template<typename T>
+    struct HasTryParse<T, std::void_t<decltype(&T::Parse), decltype(&T::TryParse)>>
+        : std::is_same<typename MemberClass<decltype(&T::Parse)>::type, typename MemberClass<decltype(&T::TryParse)>::type> {};
+
     enum class StringArgType {
         SINGLE_WORD,
         QUOTABLE_PHRASE,
         GREEDY_PHRASE
     };
 
-    template<StringArgType strType>
-    class StringArgumentType : public ArgumentType<std::string>
+    /**
+    Result of the string argument types parsing without copies (WordView, StringView, GreedyStringView).
+    Refers to the parsed input, so it is valid only as long as the input string. Quoted strings with escape
+    sequences are the exception, they are unescaped into storage owned by the result.
+    */
+    class StringArgumentView
+    {
+    public:
+        StringArgumentView() = default;
+        explicit StringArgumentView(std::string_view view) : view(view) {}
+        explicit StringArgumentView(std::string unescaped) : unescaped(std::move(unescaped)), owned(true) {}
+
+        inline std::string_view Get()     const { return owned ? std::string_view(unescaped) : view; }
+        inline bool             IsOwned() const { return owned; }
+        inline operator std::string_view() const { return Get(); }
+        inline bool operator==(std::string_view other) const { return Get() == other; }
+        inline bool operator!=(std::string_view other) const { return Get() != other; }
+    private:
+        std::string_view view;
+        std::string unescaped;
+        bool owned = false;
+    };
+
+    inline std::ostream& operator<<(std::ostream& os, StringArgumentView const& value)
+    {
+        return os << value.Get();
+    }
+
+    template<StringArgType strType, bool borrowed = false>
+    class StringArgumentType : public ArgumentType<std::conditional_t<borrowed, StringArgumentView, std::string>>
     {
     public:
-        StringArgumentType() {};
+        using type = std::conditional_t<borrowed, StringArgumentView, std::string>;
+    public:
+        constexpr StringArgumentType() {};
 
         StringArgType GetType()
         {
             return strType;
         }
 
-        std::string Parse(StringReader& reader) {
-            if (strType == StringArgType::GREEDY_PHRASE)
+        type Parse(StringReader& reader) {
+            type result;
+            ExceptionRecord error;
+            if (!TryParse(reader, result, error)) {
+                throw CommandSyntaxException(error, reader.GetString());
+            }
+            return result;
+        }
+
+        bool TryParse(StringReader& reader, type& result, ExceptionRecord& error) {
+            if constexpr (borrowed)
+            {
+                return TryParseView(reader, result, error);
+            }
+            else if (strType == StringArgType::GREEDY_PHRASE)
             {
-                std::string text(reader.GetRemaining());
+                result = reader.GetRemaining();
                 reader.SetCursor(reader.GetTotalLength());
-                return text;
+                return true;
             }
             else if (strType == StringArgType::SINGLE_WORD)
             {
-                return std::string(reader.ReadUnquotedString());
+                result = reader.ReadUnquotedString();
+                return true;
             }
             else
             {
-                return reader.ReadString();
+                std::string unescaped;
+                std::string_view text;
+                if (!reader.TryReadStringView(unescaped, text, error)) {
+                    return false;
+                }
+                if (text.data() == unescaped.data()) {
+                    result = std::move(unescaped);
+                }
+                else {
+                    result = text;
+                }
+                return true;
             }
         }
 
@@ -1060,6 +2560,24 @@ namespace brigadier
             }
         }
 
+        static constexpr CharacterSet GetFirstCharacters()
+        {
+            // unquoted strings may be empty, so a separator right away is accepted too
+            constexpr auto unquoted = CharacterSet::Matching(StringReader::IsAllowedInUnquotedString) | CharacterSet::Of(" ");
+            if constexpr (strType == StringArgType::GREEDY_PHRASE)
+            {
+                return CharacterSet::All();
+            }
+            else if constexpr (strType == StringArgType::SINGLE_WORD)
+            {
+                return unquoted;
+            }
+            else
+            {
+                return unquoted | CharacterSet::Matching(StringReader::IsQuotedStringStart);
+            }
+        }
+
         static std::string EscapeIfRequired(std::string_view input) {
             for (auto c : input) {
                 if (!StringReader::IsAllowedInUnquotedString(c)) {
@@ -1082,10 +2600,42 @@ namespace brigadier
             result += '\"';
             return result;
         }
+    private:
+        static bool TryParseView(StringReader& reader, StringArgumentView& result, ExceptionRecord& error)
+        {
+            if constexpr (strType == StringArgType::GREEDY_PHRASE)
+            {
+                std::string_view text = reader.GetRemaining();
+                reader.SetCursor(reader.GetTotalLength());
+                result = StringArgumentView(text);
+            }
+            else if constexpr (strType == StringArgType::SINGLE_WORD)
+            {
+                result = StringArgumentView(reader.ReadUnquotedString());
+            }
+            else
+            {
+                std::string unescaped;
+                std::string_view text;
+                if (!reader.TryReadStringView(unescaped, text, error)) {
+                    return false;
+                }
+                if (text.data() == unescaped.data()) {
+                    result = StringArgumentView(std::move(unescaped));
+                }
+                else {
+                    result = StringArgumentView(text);
+                }
+            }
+            return true;
+        }
     };
     REGISTER_ARGTYPE_SPEC(StringArgumentType, Word, StringArgType::SINGLE_WORD);
     REGISTER_ARGTYPE_SPEC(StringArgumentType, String, StringArgType::QUOTABLE_PHRASE);
     REGISTER_ARGTYPE_SPEC(StringArgumentType, GreedyString, StringArgType::GREEDY_PHRASE);
+    REGISTER_ARGTYPE_SPEC(StringArgumentType, WordView, StringArgType::SINGLE_WORD, true);
+    REGISTER_ARGTYPE_SPEC(StringArgumentType, StringView, StringArgType::QUOTABLE_PHRASE, true);
+    REGISTER_ARGTYPE_SPEC(StringArgumentType, GreedyStringView, StringArgType::GREEDY_PHRASE, true);
 
     class BoolArgumentType : public ArgumentType<bool>
     {
@@ -1104,6 +2654,10 @@ namespace brigadier
         {
             return { "true", "false" };
         }
+        static constexpr CharacterSet GetFirstCharacters()
+        {
+            return CharacterSet::Of("tf") | CharacterSet::Matching(StringReader::IsQuotedStringStart);
+        }
     };
     REGISTER_ARGTYPE(BoolArgumentType, Bool);
 
@@ -1117,6 +2671,16 @@ namespace brigadier
             else throw CommandSyntaxException::BuiltInExceptions::ReaderExpectedValue(reader);
         }
 
+        bool TryParse(StringReader& reader, char& result, ExceptionRecord& error)
+        {
+            if (reader.CanRead()) {
+                result = reader.Read();
+                return true;
+            }
+            error = ExceptionRecord(reader, SyntaxError::ReaderExpectedValue);
+            return false;
+        }
+
         static constexpr std::string_view GetTypeName()
         {
             return "char";
@@ -1134,7 +2698,7 @@ namespace brigadier
     {
         static_assert(std::is_arithmetic_v<T>, "T must be a number");
     public:
-        ArithmeticArgumentType(T minimum = std::numeric_limits<T>::lowest(), T maximum = std::numeric_limits<T>::max()) : minimum(minimum), maximum(maximum) {}
+        constexpr ArithmeticArgumentType(T minimum = std::numeric_limits<T>::lowest(), T maximum = std::numeric_limits<T>::max()) : minimum(minimum), maximum(maximum) {}
 
         T GetMinimum() {
             return minimum;
@@ -1144,18 +2708,32 @@ namespace brigadier
         }
 
         T Parse(StringReader& reader)
+        {
+            T result{};
+            ExceptionRecord error;
+            if (!TryParse(reader, result, error)) {
+                throw CommandSyntaxException(error, reader.GetString());
+            }
+            return result;
+        }
+
+        bool TryParse(StringReader& reader, T& result, ExceptionRecord& error)
         {
             int start = reader.GetCursor();
-            T result = reader.ReadValue<T>();
+            if (!reader.TryReadValue<T>(result, error)) {
+                return false;
+            }
             if (result < minimum) {
                 reader.SetCursor(start);
-                throw CommandSyntaxException::BuiltInExceptions::ValueTooLow(reader, result, minimum);
+                error = ExceptionRecord(reader, SyntaxError::ValueTooLow, result, minimum);
+                return false;
             }
             if (result > maximum) {
                 reader.SetCursor(start);
-                throw CommandSyntaxException::BuiltInExceptions::ValueTooHigh(reader, result, maximum);
+                error = ExceptionRecord(reader, SyntaxError::ValueTooHigh, result, maximum);
+                return false;
             }
-            return result;
+            return true;
         }
 
         static constexpr std::string_view GetTypeName()
@@ -1185,6 +2763,11 @@ namespace brigadier
             }
             else return {};
         }
+
+        static constexpr CharacterSet GetFirstCharacters()
+        {
+            return CharacterSet::Matching(StringReader::IsAllowedNumber<std::is_floating_point_v<T>, std::is_signed_v<T>>);
+        }
     private:
         T minimum;
         T maximum;
@@ -1196,6 +2779,12 @@ namespace brigadier
     REGISTER_ARGTYPE_TEMPL(ArithmeticArgumentType, Number);
 
 #ifdef HAS_MAGICENUM
+    template<typename T>
+    struct ArgumentTypeParamId<T, std::enable_if_t<std::is_enum_v<T>>>
+    {
+        static constexpr uint32_t value = ArgumentTypeHash(magic_enum::enum_type_name<T>());
+    };
+
     template<typename T>
     class EnumArgumentType : public ArgumentType<T>
     {
@@ -1203,14 +2792,28 @@ namespace brigadier
     public:
         T Parse(StringReader& reader)
         {
-            int start = reader.GetCursor();
-            auto str = reader.ReadString();
-            auto result = magic_enum::enum_cast<T>(str);
-            if (!result.has_value())
+            T result{};
+            ExceptionRecord error;
+            if (!TryParse(reader, result, error)) {
+                throw CommandSyntaxException(error, reader.GetString());
+            }
+            return result;
+        }
+
+        bool TryParse(StringReader& reader, T& result, ExceptionRecord& error)
+        {
+            std::string str;
+            if (!reader.TryReadString(str, error)) {
+                return false;
+            }
+            auto value = magic_enum::enum_cast<T>(str);
+            if (!value.has_value())
             {
-                throw CommandSyntaxException::BuiltInExceptions::ReaderInvalidValue(reader, str);
+                error = ExceptionRecord(reader, SyntaxError::ReaderInvalidValue, str);
+                return false;
             }
-            return result.value();
+            result = value.value();
+            return true;
         }
 
         template<typename S>
@@ -1231,6 +2834,11 @@ namespace brigadier
             static constexpr auto names = magic_enum::enum_names<T>();
             return std::vector<std::string_view>(names.begin(), names.end());
         }
+
+        static constexpr CharacterSet GetFirstCharacters()
+        {
+            return CharacterSet::Matching(StringReader::IsAllowedInUnquotedString) | CharacterSet::Matching(StringReader::IsQuotedStringStart);
+        }
     };
     REGISTER_ARGTYPE_TEMPL(EnumArgumentType, Enum);
 #endif
@@ -1238,8 +2846,15 @@ namespace brigadier
     struct TypeInfo
     {
         TypeInfo(size_t hash) : hash(hash) {}
+        // Stable ID for types registered with REGISTER_ARGTYPE* macros. Other types are told apart by address of their name.
         template<typename ArgType>
-        static constexpr size_t Create() { return (((uintptr_t)(ArgType::GetTypeName().data())) + (sizeof(typename ArgType::type) << 24) + (sizeof(ArgType) << 8)); }
+        static constexpr size_t Create()
+        {
+            if constexpr (HasArgumentTypeId<ArgType>::value)
+                return GetArgumentTypeId<ArgType>();
+            else
+                return (((uintptr_t)(ArgType::GetTypeName().data())) + (sizeof(typename ArgType::type) << 24) + (sizeof(ArgType) << 8)) | (size_t(1) << (sizeof(size_t) * 8 - 1));
+        }
         inline bool operator==(TypeInfo const& other) { return hash == other.hash; }
         inline bool operator!=(TypeInfo const& other) { return hash != other.hash; }
         size_t hash = 0;
@@ -1268,9 +2883,36 @@ namespace brigadier
         ParsedArgument(const int start, const int end, T result) : IParsedArgument<S>(start, end, TypeInfo(TypeInfo::Create<ArgType>())), result(std::move(result)) {}
         virtual ~ParsedArgument() = default;
 
+        /**
+        Same as std::make_shared, but reuses an argument of this type made on this thread once no context holds it any more.
+        Only results that own no resources are reused, so an argument kept for reuse keeps nothing alive.
+        */
+        static std::shared_ptr<ParsedArgument> Make(int start, int end, T result)
+        {
+            if constexpr (std::is_trivially_destructible_v<T> && std::is_move_assignable_v<T>) {
+                static thread_local std::array<std::shared_ptr<ParsedArgument>, POOLED> pool;
+                for (auto& pooled : pool) {
+                    if (pooled == nullptr) {
+                        pooled = std::make_shared<ParsedArgument>(start, end, std::move(result));
+                        return pooled;
+                    }
+                    if (pooled.use_count() == 1) {
+                        // the last context may have released it on another thread
+                        std::atomic_thread_fence(std::memory_order_acquire);
+                        pooled->range = StringRange(start, end);
+                        pooled->result = std::move(result);
+                        return pooled;
+                    }
+                }
+            }
+            return std::make_shared<ParsedArgument>(start, end, std::move(result));
+        }
+
         inline T& GetResult() { return result; }
         inline T const& GetResult() const { return result; }
     private:
+        static constexpr size_t POOLED = 8; // arguments of one type kept per thread, enough for the arguments of a command and its siblings
+
         T result;
     };
 
@@ -1305,6 +2947,8 @@ namespace brigadier
     class CommandNode;
     template<typename S, typename T>
     class ArgumentCommandNode;
+    template<typename S, typename Tree>
+    class StaticCommandNode;
     namespace detail
     {
         template<typename S>
@@ -1315,9 +2959,31 @@ namespace brigadier
     class CommandContext
     {
     public:
-        CommandContext(S source, CommandNode<S>* root, int start) : source(std::move(source)), context(std::make_unique<detail::CommandContextInternal<S>>(root, start)) {}
-        CommandContext(S source, CommandNode<S>* root, StringRange range) : source(std::move(source)), context(std::make_unique<detail::CommandContextInternal<S>>(root, range)) {}
-
+        CommandContext(S source, CommandNode<S>* root, int start) : source(std::move(source)), context(std::make_shared<detail::CommandContextInternal<S>>(root, start)) {}
+        CommandContext(S source, CommandNode<S>* root, StringRange range) : source(std::move(source)), context(std::make_shared<detail::CommandContextInternal<S>>(root, range)) {}
+        // Copies share the parsed data. Moves are cheaper, they do not touch the reference count while parsing.
+        CommandContext(CommandContext const&) = default;
+        CommandContext(CommandContext&& other)
+            : source(std::move(other.source))
+            , input(other.input)
+            , context(std::move(other.context))
+            , failed(other.failed)
+        {
+            if (context && context->child.has_value() && context->child->context)
+                context->child->context->parent = this;
+        }
+        CommandContext& operator=(CommandContext const&) = default;
+        CommandContext& operator=(CommandContext&& other)
+        {
+            source = std::move(other.source);
+            input = other.input;
+            context = std::move(other.context);
+            failed = other.failed;
+            if (context && context->child.has_value() && context->child->context)
+                context->child->context->parent = this;
+            return *this;
+        }
+
         inline CommandContext<S> GetFor(S source) const;
         inline CommandContext<S>* GetChild() const;
         inline CommandContext<S>* GetLastChild() const;
@@ -1337,6 +3003,14 @@ namespace brigadier
         inline bool HasNodes() const;
         inline bool IsForked() const;
 
+        /**
+        Reports that the command failed, without throwing an exception. The value returned by the command is ignored,
+        and CommandDispatcher::Execute handles the failure like a thrown CommandSyntaxException::BuiltInExceptions::DispatcherCommandFailed.
+        \return 0, so that a command can `return ctx.Fail();`
+        */
+        inline int Fail() { failed = true; return 0; }
+        inline bool HasFailed() const { return failed; }
+
         template<typename ArgType>
         typename ArgType::type GetArgument(std::string_view name);
         template<typename ArgType>
@@ -1355,6 +3029,7 @@ namespace brigadier
         {
             detail::CommandContextInternal<S>& ctx = *context;
             input = {};
+            failed = false;
             ctx.arguments.clear();
             ctx.command = nullptr;
             ctx.nodes.clear();
@@ -1386,17 +3061,23 @@ namespace brigadier
     protected:
         SuggestionContext<S> FindSuggestionContext(int cursor);
 
-        void Merge(CommandContext<S> other);
+        // Moves the parsed data of `other` to this context. `other` keeps its storage, so it can be reset and reused.
+        void Merge(CommandContext<S>&& other);
+        // Copies the parsed data and child contexts, unlike the copy constructor, which shares them
+        CommandContext<S> Clone() const;
     private:
         friend class CommandDispatcher<S>;
         friend class LiteralCommandNode<S>;
         friend class CommandNode<S>;
         template<typename _S, typename T>
         friend class ArgumentCommandNode;
+        template<typename _S, typename Tree>
+        friend class StaticCommandNode;
 
         S source;
         std::string_view input = {};
         std::shared_ptr<detail::CommandContextInternal<S>> context = nullptr;
+        bool failed = false; // see Fail()
     };
 
     namespace detail
@@ -1410,7 +3091,7 @@ namespace brigadier
         protected:
             friend class CommandContext<S>;
 
-            std::map<std::string, std::shared_ptr<IParsedArgument<S>>, std::less<>> arguments;
+            std::map<std::string_view, std::shared_ptr<IParsedArgument<S>>, std::less<>> arguments; // keys are interned node names
             Command<S> command = nullptr;
             CommandNode<S>* rootNode = nullptr;
             std::vector<ParsedCommandNode<S>> nodes;
@@ -1570,10 +3251,19 @@ namespace brigadier
     {
         if (context)
         {
-            if (context->child.has_value())
+            if (context->child.has_value() && context->child->context)
             {
                 context->child->context->parent = nullptr;
             }
+            // contexts of long redirect chains are released one by one instead of recursively
+            if (context.use_count() == 1)
+            {
+                std::optional<CommandContext<S>> next = std::move(context->child);
+                while (next.has_value() && next->context && next->context.use_count() == 1) {
+                    std::optional<CommandContext<S>> after = std::move(next->context->child);
+                    next = std::move(after);
+                }
+            }
         }
     }
 
@@ -1662,7 +3352,25 @@ namespace brigadier
     }
 
     template<typename S>
-    void CommandContext<S>::Merge(CommandContext<S> other)
+    CommandContext<S> CommandContext<S>::Clone() const
+    {
+        CommandContext<S> result(source, context->rootNode, context->range);
+        result.input = input;
+        detail::CommandContextInternal<S>& ctx = *result.context;
+        ctx.arguments = context->arguments;
+        ctx.command = context->command;
+        ctx.nodes = context->nodes;
+        ctx.modifier = context->modifier;
+        ctx.forks = context->forks;
+        if (context->child.has_value() && context->child->context) {
+            ctx.child = context->child->Clone();
+            ctx.child->context->parent = &result;
+        }
+        return result;
+    }
+
+    template<typename S>
+    void CommandContext<S>::Merge(CommandContext<S>&& other)
     {
         detail::CommandContextInternal<S>* ctx = other.GetInternalContext();
         for (auto& arg : ctx->arguments)
@@ -1683,33 +3391,186 @@ namespace brigadier
             ctx->child->context->parent = this;
             if (context->child.has_value())
             {
-                context->child->Merge(*ctx->child);
+                context->child->Merge(std::move(*ctx->child));
                 ctx->child = {};
             }
             else context->child = std::move(ctx->child);
         }
     }
 
+    /**
+    Codec of argument type parameters (e.g. bounds of numbers) stored in a CommandTreeImage.
+
+    Trivially copyable argument types are stored as they are. Other types have to provide
+    `void WriteParameters(std::string& out) const` and `static T ReadParameters(std::string_view in)`.
+    */
+    template<typename T, typename = void>
+    struct ArgumentParameters
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Argument type has to be trivially copyable or provide WriteParameters and ReadParameters");
+
+        static void Write(T const& type, std::string& out)
+        {
+            out.append(reinterpret_cast<const char*>(&type), sizeof(T));
+        }
+
+        static T Read(std::string_view in)
+        {
+            if (in.size() != sizeof(T))
+                throw std::runtime_error("Invalid argument type parameters");
+            T type;
+            std::memcpy(static_cast<void*>(&type), in.data(), sizeof(T));
+            return type;
+        }
+    };
+
+    template<typename T>
+    struct ArgumentParameters<T, std::void_t<decltype(&T::WriteParameters), decltype(&T::ReadParameters)>>
+    {
+        static void Write(T const& type, std::string& out)
+        {
+            type.WriteParameters(out);
+        }
+
+        static T Read(std::string_view in)
+        {
+            return T::ReadParameters(in);
+        }
+    };
+
+    // Checks if ArgumentParameters can be used with T.
+    template<typename T, typename = void>
+    struct HasArgumentParameters : std::is_trivially_copyable<T> {};
+    template<typename T>
+    struct HasArgumentParameters<T, std::void_t<decltype(&T::WriteParameters), decltype(&T::ReadParameters)>> : std::true_type {};
+
+    /**
+    Process-wide registry of argument types with stable IDs (see GetArgumentTypeId()).
+    Maps an ID to the registered name and to a codec of type parameters, e.g. to export argument types of a command tree.
+
+    Types are added when the first ArgumentCommandNode of the type is created, or explicitly with Register().
+    Registering two different types with the same ID throws std::runtime_error.
+    */
+    class ArgumentTypeRegistry
+    {
+    public:
+        struct Entry
+        {
+            uint32_t id;
+            std::string_view name;
+            void(*writeParameters)(void const* type, std::string& out); // type points to an object of the registered type
+            void(*readParameters)(std::string_view in, void* type);
+        };
+
+        template<typename T>
+        static uint32_t Register()
+        {
+            static const uint32_t id = Add({ GetArgumentTypeId<T>(), GetArgumentTypeName<T>(), &WriteParameters<T>, &ReadParameters<T> });
+            return id;
+        }
+
+        static Entry const* Find(uint32_t id)
+        {
+            std::lock_guard<std::mutex> lock(GetMutex());
+            auto& entries = GetEntries();
+            auto found = entries.find(id);
+            return found != entries.end() ? &found->second : nullptr;
+        }
+    private:
+        static uint32_t Add(Entry entry)
+        {
+            std::lock_guard<std::mutex> lock(GetMutex());
+            auto [found, added] = GetEntries().emplace(entry.id, entry);
+            if (!added && found->second.writeParameters != entry.writeParameters)
+                throw std::runtime_error("Argument types '" + std::string(found->second.name) + "' and '" + std::string(entry.name) + "' have the same ID");
+            return entry.id;
+        }
+
+        template<typename T>
+        static void WriteParameters(void const* type, std::string& out)
+        {
+            ArgumentParameters<T>::Write(*static_cast<T const*>(type), out);
+        }
+
+        template<typename T>
+        static void ReadParameters(std::string_view in, void* type)
+        {
+            *static_cast<T*>(type) = ArgumentParameters<T>::Read(in);
+        }
+
+        static std::map<uint32_t, Entry>& GetEntries()
+        {
+            static std::map<uint32_t, Entry> entries;
+            return entries;
+        }
+
+        static std::mutex& GetMutex()
+        {
+            static std::mutex mutex;
+            return mutex;
+        }
+    };
+
     template<typename S, typename T>
     class RequiredArgumentBuilder;
 
     template<typename S>
     class IArgumentCommandNode : public CommandNode<S>
     {
+    public:
+        using ParseFunction = bool(*)(IArgumentCommandNode<S>& node, StringReader& reader, CommandContext<S>& contextBuilder, ExceptionRecord& error);
     protected:
-        IArgumentCommandNode(std::string_view name) : name(name) {}
+        IArgumentCommandNode(std::string_view name, ParseFunction parseFunction, CharacterSet const* firstCharacters)
+            : CommandNode<S>(CommandNodeType::ArgumentCommandNode, name)
+            , parseFunction(parseFunction)
+            , firstCharacters(firstCharacters)
+        {}
         virtual ~IArgumentCommandNode() = default;
     public:
-        virtual std::string const& GetName() {
-            return name;
+        /**
+        Same as Parse(StringReader&, CommandContext<S>&), but calls the parse function of the argument type directly
+        instead of going through the virtual table.
+        */
+        inline void ParseArgument(StringReader& reader, CommandContext<S>& contextBuilder) {
+            ExceptionRecord error;
+            if (!parseFunction(*this, reader, contextBuilder, error)) {
+                throw CommandSyntaxException(error, reader.GetString());
+            }
+        }
+
+        /**
+        Same as ParseArgument, but returns false with the failure in `error` instead of throwing it if the argument type
+        has ArgumentType::TryParse. Other argument types still throw.
+        */
+        inline bool TryParseArgument(StringReader& reader, CommandContext<S>& contextBuilder, ExceptionRecord& error) {
+            return parseFunction(*this, reader, contextBuilder, error);
+        }
+
+        inline ParseFunction GetParseFunction() const {
+            return parseFunction;
         }
-        virtual CommandNodeType GetNodeType() { return CommandNodeType::ArgumentCommandNode; }
+
+        /**
+        Checks if input starting with `c` can be parsed by this argument. See ArgumentType::GetFirstCharacters().
+        */
+        inline bool CanStartWith(char c) const {
+            return firstCharacters->Contains(c);
+        }
+
+        virtual TypeInfo GetTypeInfo() = 0;
+
+        /**
+        Appends the type, type parameters and custom suggestions of this argument to `out`. Arguments with equal keys parse the same way.
+        \return false if parameters of the argument type cannot be compared (see ArgumentParameters)
+        */
+        virtual bool WriteArgumentKey(std::string& out) = 0;
     protected:
         virtual std::string_view GetSortedKey() {
-            return name;
+            return this->name;
         }
-    protected:
-        std::string name;
+    private:
+        ParseFunction parseFunction; // ArgumentCommandNode<S, T>::ParseAs of the argument type
+        CharacterSet const* firstCharacters; // ArgumentCommandNode<S, T>::FIRST_CHARACTERS of the argument type
     };
 
     template<typename S, typename T>
@@ -1718,12 +3579,16 @@ namespace brigadier
     private:
         static constexpr std::string_view USAGE_ARGUMENT_OPEN = "<";
         static constexpr std::string_view USAGE_ARGUMENT_CLOSE = ">";
+        static constexpr CharacterSet FIRST_CHARACTERS = T::GetFirstCharacters();
     public:
         template<typename... Args>
         ArgumentCommandNode(std::string_view name, Args&&... args)
-            : IArgumentCommandNode<S>(name)
+            : IArgumentCommandNode<S>(name, &ArgumentCommandNode<S, T>::ParseAs, &FIRST_CHARACTERS)
             , type(std::forward<Args>(args)...)
-        {}
+        {
+            if constexpr (HasArgumentTypeId<T>::value)
+                ArgumentTypeRegistry::Register<T>();
+        }
         virtual ~ArgumentCommandNode() = default;
     public:
         inline SuggestionProvider<S> const& GetCustomSuggestions() const {
@@ -1751,14 +3616,11 @@ namespace brigadier
         virtual std::vector<std::string_view> GetExamples() {
             return type.GetExamples();
         }
+        virtual TypeInfo GetTypeInfo() {
+            return TypeInfo(TypeInfo::Create<T>());
+        }
         virtual void Parse(StringReader& reader, CommandContext<S>& contextBuilder) {
-            int start = reader.GetCursor();
-            using Type = typename T::type;
-            Type result = type.Parse(reader);
-            std::shared_ptr<ParsedArgument<S, T>> parsed = std::make_shared<ParsedArgument<S, T>>(start, reader.GetCursor(), std::move(result));
-
-            contextBuilder.WithArgument(this->name, parsed);
-            contextBuilder.WithNode(this, parsed->GetRange());
+            this->ParseArgument(reader, contextBuilder);
         }
         virtual std::future<Suggestions> ListSuggestions(CommandContext<S>& context, SuggestionsBuilder& builder)
         {
@@ -1769,169 +3631,662 @@ namespace brigadier
                 return customSuggestions(context, builder);
             }
         }
+        virtual bool WriteArgumentKey(std::string& out) {
+            if constexpr (HasArgumentParameters<T>::value) {
+                size_t typeId = TypeInfo::Create<T>();
+                out.append(reinterpret_cast<const char*>(&typeId), sizeof(typeId));
+                out.append(reinterpret_cast<const char*>(&customSuggestions), sizeof(customSuggestions));
+                ArgumentParameters<T>::Write(type, out);
+                return true;
+            }
+            else return false;
+        }
+        virtual std::shared_ptr<CommandNode<S>> Clone() { return std::make_shared<ArgumentCommandNode<S, T>>(*this); }
+        virtual size_t GetObjectSize() { return sizeof(*this); }
     protected:
         virtual bool IsValidInput(std::string_view input) {
-            try {
-                StringReader reader = StringReader(input);
-                type.Parse(reader);
-                return !reader.CanRead() || reader.Peek() == ' ';
+            StringReader reader = StringReader(input);
+            if constexpr (HasTryParse<T>::value) {
+                typename T::type result{};
+                ExceptionRecord error;
+                if (!type.TryParse(reader, result, error))
+                    return false;
             }
-            catch (CommandSyntaxException const&) {
-                return false;
+            else {
+                try {
+                    type.Parse(reader);
+                }
+                catch (CommandSyntaxException const&) {
+                    return false;
+                }
+            }
+            return !reader.CanRead() || reader.Peek() == ' ';
+        }
+    private:
+        static bool ParseAs(IArgumentCommandNode<S>& node, StringReader& reader, CommandContext<S>& contextBuilder, ExceptionRecord& error) {
+            auto& self = static_cast<ArgumentCommandNode<S, T>&>(node);
+            int start = reader.GetCursor();
+            using Type = typename T::type;
+            if constexpr (HasTryParse<T>::value) {
+                Type result{};
+                if (!self.type.TryParse(reader, result, error))
+                    return false;
+                self.AddArgument(contextBuilder, start, reader.GetCursor(), std::move(result));
+            }
+            else {
+                Type result = self.type.Parse(reader);
+                self.AddArgument(contextBuilder, start, reader.GetCursor(), std::move(result));
             }
+            return true;
+        }
+
+        inline void AddArgument(CommandContext<S>& contextBuilder, int start, int end, typename T::type&& result) {
+            StringRange range = StringRange::Between(start, end);
+            contextBuilder.WithArgument(this->name, ParsedArgument<S, T>::Make(range.GetStart(), range.GetEnd(), std::move(result)));
+            contextBuilder.WithNode(this, range);
         }
     private:
         friend class RequiredArgumentBuilder<S, T>;
+        friend class CommandTreeBinder<S>;
+        template<typename _S, typename Tree>
+        friend class StaticCommandNode;
         T type;
         SuggestionProvider<S> customSuggestions = nullptr;
     };
 
-    template<typename S>
-    class MultiArgumentBuilder
+    /**
+    Read-only view of a compiled command tree stored in a contiguous block of memory, e.g. a memory mapped file.
+
+    The image is laid out as a header, a table of fixed size node records, a table of child indices, a string pool
+    and a blob of argument type parameters. Nothing is copied; the constructor only validates that every offset and index is in bounds
+    and that children do not form a cycle.
+    Images are written and loaded by CommandTreeBinder, which also rebinds commands, requirements and suggestion providers by their IDs.
+    The dispatcher does not parse from the image: loading builds the full node graph, see CommandTreeBinder::ReadImage.
+
+    The memory has to stay valid and be aligned to at least 8 bytes for the lifetime of the view.
+    */
+    class CommandTreeImage
     {
     public:
-        using B = MultiArgumentBuilder<S>;
-    public:
-        MultiArgumentBuilder(std::vector<std::shared_ptr<CommandNode<S>>> nodes, int master = -1) : nodes(std::move(nodes)), master(master) {}
-        MultiArgumentBuilder(MultiArgumentBuilder const&) = delete; // no copying. Use reference or GetThis().
-
-        inline B* GetThis() { return this; }
+        static constexpr uint32_t MAGIC = 0x54524742; // "BGRT"
+        static constexpr uint32_t VERSION = 1;
+        static constexpr uint32_t NONE = ~uint32_t(0);
 
-        template<template<typename...> typename Next, typename Type = void, typename... Args>
-        auto Then(Args&&... args)
+        struct Header
         {
-            for (auto& node : nodes) {
-                if (node->redirect != nullptr) {
-                    throw std::runtime_error("Cannot add children to a redirected node");
-                }
-            }
+            uint32_t magic;
+            uint32_t version;
+            uint32_t nodeCount;
+            uint32_t childCount;
+            uint32_t stringsSize;
+            uint32_t parametersSize;
+            uint32_t reserved[2];
+        };
 
-            if constexpr (std::is_same_v<Type, void>) {
-                using next_node = typename Next<S>::node_type;
-                next_node node_builder(std::forward<Args>(args)...);
-                auto new_node = std::make_shared<next_node>(std::move(node_builder));
-                for (auto& node : nodes) {
-                    node->AddChild(new_node);
-                }
-                return Next<S>(std::move(new_node));
+        struct Node
+        {
+            PermissionMask permissions;
+            uint32_t name;
+            uint32_t nameLength;
+            uint32_t children;      // first entry in the child table
+            uint32_t childCount;
+            uint32_t redirect;      // node index or NONE
+            uint32_t command;       // IDs bound in CommandTreeBinder, 0 if not set
+            uint32_t requirement;
+            uint32_t modifier;
+            uint32_t suggestions;
+            uint32_t argumentType;
+            uint32_t parameters;
+            uint32_t parametersLength;
+            uint8_t type;           // CommandNodeType
+            uint8_t forks;
+            uint8_t reserved[6];
+        };
+        static_assert(sizeof(Header) == 32 && sizeof(Node) == 64, "Unexpected image record layout");
+    public:
+        CommandTreeImage(void const* data, size_t size) : data(static_cast<const char*>(data)), size(size)
+        {
+            if (size < sizeof(Header) || reinterpret_cast<uintptr_t>(data) % alignof(Node) != 0)
+                throw std::runtime_error("Invalid command tree image");
+            auto& header = GetHeader();
+            if (header.magic != MAGIC)
+                throw std::runtime_error("Invalid command tree image");
+            if (header.version != VERSION)
+                throw std::runtime_error("Unsupported command tree image version");
+
+            uint64_t expected = sizeof(Header) + uint64_t(header.nodeCount) * sizeof(Node) + uint64_t(header.childCount) * sizeof(uint32_t) + header.stringsSize + header.parametersSize;
+            if (expected != size || header.nodeCount == 0)
+                throw std::runtime_error("Invalid command tree image");
+
+            for (uint32_t i = 0; i < header.nodeCount; ++i) {
+                auto& node = GetNode(i);
+                bool valid = node.type <= uint8_t(CommandNodeType::ArgumentCommandNode)
+                    && (node.type == uint8_t(CommandNodeType::RootCommandNode)) == (i == 0)
+                    && uint64_t(node.name) + node.nameLength <= header.stringsSize
+                    && uint64_t(node.children) + node.childCount <= header.childCount
+                    && (node.redirect == NONE || node.redirect < header.nodeCount)
+                    && uint64_t(node.parameters) + node.parametersLength <= header.parametersSize;
+                if (!valid)
+                    throw std::runtime_error("Invalid command tree image");
             }
-            else {
-                using next_node = typename Next<S, Type>::node_type;
-                next_node node_builder(std::forward<Args>(args)...);
-                auto new_node = std::make_shared<next_node>(std::move(node_builder));
-                for (auto& node : nodes) {
-                    node->AddChild(new_node);
-                }
-                return Next<S, Type>(std::move(new_node));
+            for (uint32_t i = 0; i < header.childCount; ++i) {
+                if (GetChildIndices()[i] == 0 || GetChildIndices()[i] >= header.nodeCount)
+                    throw std::runtime_error("Invalid command tree image");
             }
+            CheckAcyclic();
         }
-
-        auto Then(std::shared_ptr<LiteralCommandNode<S>> argument)
+    public:
+        inline Header const& GetHeader() const
         {
-            for (auto& node : nodes) {
-                if (node->redirect != nullptr) {
-                    throw std::runtime_error("Cannot add children to a redirected node");
-                }
-            }
-            for (auto& node : nodes) {
-                if (argument != nullptr) {
-                    node->AddChild(argument);
-                }
-            }
-            return GetBuilder(std::move(argument));
+            return *reinterpret_cast<Header const*>(data);
         }
 
-        template<typename T>
-        auto Then(std::shared_ptr<ArgumentCommandNode<S, T>> argument)
+        inline uint32_t GetNodeCount() const
         {
-            for (auto& node : nodes) {
-                if (node->redirect != nullptr) {
-                    throw std::runtime_error("Cannot add children to a redirected node");
-                }
-            }
-            for (auto& node : nodes) {
-                if (argument != nullptr) {
-                    node->AddChild(argument);
-                }
-            }
-            return GetBuilder(std::move(argument));
+            return GetHeader().nodeCount;
         }
 
-        B& Executes(Command<S> command, bool only_master = true)
+        inline Node const& GetNode(uint32_t index) const
         {
-            for (size_t i = 0; i < nodes.size(); ++i) {
-                if (master == -1 || master == i || !only_master) {
-                    auto& node = nodes[i];
-                    node->command = command;
-                }
-            }
-            return *GetThis();
+            return reinterpret_cast<Node const*>(data + sizeof(Header))[index];
         }
 
-        B& Requires(Predicate<S&> requirement, bool only_master = true)
+        inline std::string_view GetName(Node const& node) const
         {
-            for (size_t i = 0; i < nodes.size(); ++i) {
-                if (master == -1 || master == i || !only_master) {
-                    auto& node = nodes[i];
-                    node->requirement = requirement;
-                }
-            }
-            return *GetThis();
+            return std::string_view(GetStrings() + node.name, node.nameLength);
         }
 
-        inline auto Redirect(std::shared_ptr<CommandNode<S>> target, bool only_master = true)
+        inline std::string_view GetParameters(Node const& node) const
         {
-            return Forward(std::move(target), nullptr, false, only_master);
+            return std::string_view(GetStrings() + GetHeader().stringsSize + node.parameters, node.parametersLength);
         }
 
-        inline auto Redirect(std::shared_ptr<CommandNode<S>> target, SingleRedirectModifier<S> modifier, bool only_master = true)
+        inline uint32_t const* GetChildren(Node const& node) const
         {
-            return Forward(std::move(target), modifier ? [modifier](CommandContext<S>& context) -> std::vector<S> {
-                return { modifier(context) }; } : nullptr, false, only_master);
+            return GetChildIndices() + node.children;
         }
-
-        inline auto Fork(std::shared_ptr<CommandNode<S>> target, SingleRedirectModifier<S> modifier, bool only_master = true)
+    private:
+        // Nodes may have several parents, but a node cannot be its own descendant. Redirects may point anywhere.
+        void CheckAcyclic() const
         {
-            return Forward(std::move(target), modifier ? [modifier](CommandContext<S>& context) -> std::vector<S> {
-                return { modifier(context) }; } : nullptr, true, only_master);
+            enum : uint8_t { Unvisited, Open, Closed };
+            std::vector<uint8_t> states(GetNodeCount(), Unvisited);
+            std::vector<std::pair<uint32_t, uint32_t>> stack; // node and its next child, explicit so that deep images cannot overflow the call stack
+            for (uint32_t start = 0; start < GetNodeCount(); ++start) {
+                if (states[start] != Unvisited)
+                    continue;
+                states[start] = Open;
+                stack.emplace_back(start, 0);
+                while (!stack.empty()) {
+                    auto& node = GetNode(stack.back().first);
+                    if (stack.back().second == node.childCount) {
+                        states[stack.back().first] = Closed;
+                        stack.pop_back();
+                        continue;
+                    }
+                    uint32_t child = GetChildren(node)[stack.back().second++];
+                    if (states[child] == Open)
+                        throw std::runtime_error("Invalid command tree image");
+                    if (states[child] == Unvisited) {
+                        states[child] = Open;
+                        stack.emplace_back(child, 0);
+                    }
+                }
+            }
         }
 
-        inline auto Fork(std::shared_ptr<CommandNode<S>> target, RedirectModifier<S> modifier, bool only_master = true)
+        inline uint32_t const* GetChildIndices() const
         {
-            return Forward(std::move(target), modifier, true, only_master);
+            return reinterpret_cast<uint32_t const*>(data + sizeof(Header) + size_t(GetHeader().nodeCount) * sizeof(Node));
         }
 
-        void Forward(std::shared_ptr<CommandNode<S>> target, RedirectModifier<S> modifier, bool fork, bool only_master = true)
+        inline const char* GetStrings() const
         {
-            for (size_t i = 0; i < nodes.size(); ++i) {
-                if (master == -1 || master == i || !only_master) {
-                    auto& node = nodes[i];
-                    if (node->GetChildren().size() > 0)
-                    {
-                        throw std::runtime_error("Cannot forward a node with children");
-                    }
-                }
-            }
-            for (size_t i = 0; i < nodes.size(); ++i) {
-                if (master == -1 || master == i || !only_master) {
-                    auto& node = nodes[i];
-                    node->redirect = std::move(target);
-                    node->modifier = modifier;
-                    node->forks = fork;
-                }
-            }
+            return reinterpret_cast<const char*>(GetChildIndices() + GetHeader().childCount);
         }
-    protected:
-        std::vector<std::shared_ptr<CommandNode<S>>> nodes;
-        int master = -1;
+    private:
+        const char* data;
+        size_t size;
     };
 
-    // multi builder
+    /**
+    Assigns IDs to commands, requirements, redirect modifiers, suggestion providers and argument types,
+    so that a command tree can be written to a CommandTreeImage and loaded back without registering it again.
+
+    IDs have to be the same for the writer and the loader. ID 0 is reserved for "not set".
+
+    \param <S> a custom "source" type, such as a user or originator of a command
+    */
     template<typename S>
-    inline MultiArgumentBuilder<S> GetBuilder(std::vector<std::shared_ptr<CommandNode<S>>> nodes, int master = -1)
+    class CommandTreeBinder
     {
-        return MultiArgumentBuilder<S>(std::move(nodes), master);
-    }
+    public:
+        void BindCommand(uint32_t id, Command<S> command)
+        {
+            Bind(commands, id, command);
+        }
+
+        void BindRequirement(uint32_t id, Predicate<S&> requirement)
+        {
+            Bind(requirements, id, requirement);
+        }
+
+        void BindRedirectModifier(uint32_t id, RedirectModifier<S> modifier)
+        {
+            Bind(modifiers, id, modifier);
+        }
+
+        void BindSuggestions(uint32_t id, SuggestionProvider<S> provider)
+        {
+            Bind(suggestions, id, provider);
+        }
+
+        // Binds an argument type registered with REGISTER_ARGTYPE* macros under its stable ID (see GetArgumentTypeId()).
+        template<typename T>
+        void BindArgumentType()
+        {
+            BindArgumentType<T>(GetArgumentTypeId<T>());
+        }
+
+        template<typename T>
+        void BindArgumentType(uint32_t id)
+        {
+            if (id == 0)
+                throw std::runtime_error("ID 0 is reserved");
+            argumentTypes.byId[id] = { &ReadArgument<T>, &WriteArgument<T> };
+            argumentTypes.ids[TypeInfo::Create<T>()] = id;
+        }
+
+        /**
+        Writes a command tree to a new image. Every command, requirement, redirect modifier, suggestion provider and argument type
+        found in the tree has to be bound, otherwise std::runtime_error is thrown.
+
+        \param root the root of the tree
+        \return bytes of the image, see CommandTreeImage
+        */
+        std::string WriteImage(RootCommandNode<S>* root) const
+        {
+            std::map<CommandNode<S>*, uint32_t> indices;
+            std::vector<CommandNode<S>*> nodes;
+            std::vector<CommandNode<S>*> pending = { root };
+            while (!pending.empty()) {
+                auto node = pending.back();
+                pending.pop_back();
+                if (!indices.emplace(node, uint32_t(nodes.size())).second)
+                    continue;
+                nodes.push_back(node);
+                if (auto target = node->GetRedirect())
+                    pending.push_back(target.get());
+                for (auto it = node->arguments.rbegin(); it != node->arguments.rend(); ++it)
+                    pending.push_back(it->get());
+                for (auto it = node->literals.rbegin(); it != node->literals.rend(); ++it)
+                    pending.push_back(it->get());
+            }
+            if (nodes[0]->GetNodeType() != CommandNodeType::RootCommandNode || std::any_of(nodes.begin() + 1, nodes.end(), [](CommandNode<S>* node) { return node->GetNodeType() == CommandNodeType::RootCommandNode; }))
+                throw std::runtime_error("Cannot write a tree redirecting to another root");
+
+            std::vector<CommandTreeImage::Node> records(nodes.size());
+            std::vector<uint32_t> children;
+            std::string strings;
+            std::string parameters;
+            for (size_t i = 0; i < nodes.size(); ++i) {
+                auto node = nodes[i];
+                auto& record = records[i];
+                record.permissions = node->permissions;
+                record.name = uint32_t(strings.size());
+                record.nameLength = uint32_t(node->GetName().size());
+                strings += node->GetName();
+                record.children = uint32_t(children.size());
+                record.childCount = uint32_t(node->literals.size() + node->arguments.size());
+                for (auto& literal : node->literals)
+                    children.push_back(indices[literal.get()]);
+                for (auto& argument : node->arguments)
+                    children.push_back(indices[argument.get()]);
+                auto target = node->GetRedirect();
+                record.redirect = target ? indices[target.get()] : CommandTreeImage::NONE;
+                record.command = Find(commands, node->command, "Command");
+                record.requirement = Find(requirements, node->requirement, "Requirement");
+                record.modifier = i == 0 ? 0 : Find(modifiers, node->modifier, "Redirect modifier");
+                record.type = uint8_t(node->GetNodeType());
+                record.forks = node->forks;
+                if (record.type == uint8_t(CommandNodeType::ArgumentCommandNode)) {
+                    auto argument = static_cast<IArgumentCommandNode<S>*>(node);
+                    auto type = argumentTypes.ids.find(argument->GetTypeInfo().hash);
+                    if (type == argumentTypes.ids.end())
+                        throw std::runtime_error("Argument type of '" + std::string(node->GetName()) + "' is not bound");
+                    record.argumentType = type->second;
+                    record.parameters = uint32_t(parameters.size());
+                    record.suggestions = argumentTypes.byId.at(type->second).write(argument, parameters, *this);
+                    record.parametersLength = uint32_t(parameters.size() - record.parameters);
+                }
+            }
+
+            CommandTreeImage::Header header = {};
+            header.magic = CommandTreeImage::MAGIC;
+            header.version = CommandTreeImage::VERSION;
+            header.nodeCount = uint32_t(records.size());
+            header.childCount = uint32_t(children.size());
+            header.stringsSize = uint32_t(strings.size());
+            header.parametersSize = uint32_t(parameters.size());
+
+            std::string image;
+            image.reserve(sizeof(header) + records.size() * sizeof(CommandTreeImage::Node) + children.size() * sizeof(uint32_t) + strings.size() + parameters.size());
+            image.append(reinterpret_cast<const char*>(&header), sizeof(header));
+            image.append(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(CommandTreeImage::Node));
+            image.append(reinterpret_cast<const char*>(children.data()), children.size() * sizeof(uint32_t));
+            image += strings;
+            image += parameters;
+            return image;
+        }
+
+        /**
+        Creates a command tree from an image. IDs stored in the image are resolved to the bound callbacks and argument types.
+        Every node of the image is allocated and every child is inserted into its parent, the same as when the tree is registered,
+        so the cost of loading grows with the size of the tree. The nodes do not refer to the image once it is loaded.
+
+        \param image the image to load
+        \return the root of a new command tree, e.g. to be passed to CommandDispatcher(std::shared_ptr<RootCommandNode>)
+        */
+        std::shared_ptr<RootCommandNode<S>> ReadImage(CommandTreeImage const& image) const
+        {
+            uint32_t count = image.GetNodeCount();
+            std::vector<std::shared_ptr<CommandNode<S>>> nodes(count);
+            auto root = std::make_shared<RootCommandNode<S>>();
+            nodes[0] = root;
+            for (uint32_t i = 1; i < count; ++i) {
+                auto& record = image.GetNode(i);
+                if (record.type == uint8_t(CommandNodeType::LiteralCommandNode)) {
+                    nodes[i] = std::make_shared<LiteralCommandNode<S>>(image.GetName(record));
+                }
+                else {
+                    auto type = argumentTypes.byId.find(record.argumentType);
+                    if (type == argumentTypes.byId.end()) {
+                        auto registered = ArgumentTypeRegistry::Find(record.argumentType);
+                        throw std::runtime_error("Argument type " + (registered ? std::string(registered->name) : std::to_string(record.argumentType)) + " is not bound");
+                    }
+                    nodes[i] = type->second.read(image.GetName(record), image.GetParameters(record), Get(suggestions, record.suggestions, "Suggestion provider"));
+                }
+            }
+
+            for (uint32_t i = 0; i < count; ++i) {
+                auto& record = image.GetNode(i);
+                auto& node = nodes[i];
+                node->permissions = record.permissions;
+                node->command = Get(commands, record.command, "Command");
+                node->requirement = Get(requirements, record.requirement, "Requirement");
+                if (i != 0)
+                    node->modifier = Get(modifiers, record.modifier, "Redirect modifier");
+                node->forks = record.forks != 0;
+
+                node->Modified();
+                node->childrenRevision = node->revision;
+                auto children = image.GetChildren(record);
+                for (uint32_t c = 0; c < record.childCount; ++c) {
+                    auto& child = nodes[children[c]];
+                    child->attachRevision = node->revision;
+                    if (!node->children.emplace(child->GetName(), child).second)
+                        throw std::runtime_error("Duplicate child '" + std::string(child->GetName()) + "' in command tree image");
+                    node->Link(child.get());
+                    if (child->GetNodeType() == CommandNodeType::LiteralCommandNode)
+                        node->literals.emplace_back(std::static_pointer_cast<LiteralCommandNode<S>>(child));
+                    else
+                        node->arguments.emplace_back(std::static_pointer_cast<IArgumentCommandNode<S>>(child));
+                }
+            }
+            // once all nodes are linked, so that redirects to nodes above do not keep them alive
+            for (uint32_t i = 0; i < count; ++i) {
+                auto& record = image.GetNode(i);
+                if (record.redirect != CommandTreeImage::NONE)
+                    nodes[i]->SetRedirect(nodes[record.redirect]);
+            }
+            // children are mostly written after their parents, so going backwards rarely updates a node twice
+            for (uint32_t i = count; i-- > 0;)
+                nodes[i]->UpdateSubtree();
+            return root;
+        }
+    private:
+        template<typename T>
+        static std::shared_ptr<CommandNode<S>> ReadArgument(std::string_view name, std::string_view parameters, SuggestionProvider<S> provider)
+        {
+            auto node = std::make_shared<ArgumentCommandNode<S, T>>(name, ArgumentParameters<T>::Read(parameters));
+            node->customSuggestions = provider;
+            return node;
+        }
+
+        template<typename T>
+        static uint32_t WriteArgument(IArgumentCommandNode<S>* argument, std::string& parameters, CommandTreeBinder<S> const& binder)
+        {
+            auto node = static_cast<ArgumentCommandNode<S, T>*>(argument);
+            ArgumentParameters<T>::Write(node->GetType(), parameters);
+            return binder.Find(binder.suggestions, node->customSuggestions, "Suggestion provider");
+        }
+
+        template<typename F>
+        struct Callbacks
+        {
+            std::map<uint32_t, F> byId;
+            std::map<F, uint32_t> ids;
+        };
+
+        template<typename F>
+        static void Bind(Callbacks<F>& callbacks, uint32_t id, F callback)
+        {
+            if (id == 0)
+                throw std::runtime_error("ID 0 is reserved");
+            if (callback == nullptr)
+                throw std::runtime_error("Cannot bind empty callback");
+            callbacks.byId[id] = callback;
+            callbacks.ids[callback] = id;
+        }
+
+        template<typename F>
+        static uint32_t Find(Callbacks<F> const& callbacks, F callback, const char* kind)
+        {
+            if (callback == nullptr)
+                return 0;
+            auto found = callbacks.ids.find(callback);
+            if (found == callbacks.ids.end())
+                throw std::runtime_error(std::string(kind) + " is not bound");
+            return found->second;
+        }
+
+        template<typename F>
+        static F Get(Callbacks<F> const& callbacks, uint32_t id, const char* kind)
+        {
+            if (id == 0)
+                return nullptr;
+            auto found = callbacks.byId.find(id);
+            if (found == callbacks.byId.end())
+                throw std::runtime_error(std::string(kind) + " " + std::to_string(id) + " is not bound");
+            return found->second;
+        }
+    private:
+        struct ArgumentCodec
+        {
+            std::shared_ptr<CommandNode<S>>(*read)(std::string_view name, std::string_view parameters, SuggestionProvider<S> provider);
+            uint32_t(*write)(IArgumentCommandNode<S>* argument, std::string& parameters, CommandTreeBinder<S> const& binder);
+        };
+        struct ArgumentTypes
+        {
+            std::map<uint32_t, ArgumentCodec> byId;
+            std::map<size_t, uint32_t> ids;
+        };
+
+        Callbacks<Command<S>> commands;
+        Callbacks<Predicate<S&>> requirements;
+        Callbacks<RedirectModifier<S>> modifiers;
+        Callbacks<SuggestionProvider<S>> suggestions;
+        ArgumentTypes argumentTypes;
+    };
+
+    template<typename S>
+    class MultiArgumentBuilder
+    {
+    public:
+        using B = MultiArgumentBuilder<S>;
+    public:
+        MultiArgumentBuilder(std::vector<std::shared_ptr<CommandNode<S>>> nodes, int master = -1) : nodes(std::move(nodes)), master(master) {}
+        MultiArgumentBuilder(MultiArgumentBuilder const&) = delete; // no copying. Use reference or GetThis().
+
+        inline B* GetThis() { return this; }
+
+        template<template<typename...> typename Next, typename Type = void, typename... Args>
+        auto Then(Args&&... args)
+        {
+            for (auto& node : nodes) {
+                node->CheckWritable();
+                if (node->redirect != nullptr) {
+                    throw std::runtime_error("Cannot add children to a redirected node");
+                }
+            }
+
+            if constexpr (std::is_same_v<Type, void>) {
+                using next_node = typename Next<S>::node_type;
+                next_node node_builder(std::forward<Args>(args)...);
+                auto new_node = std::make_shared<next_node>(std::move(node_builder));
+                for (auto& node : nodes) {
+                    node->AddChild(new_node);
+                }
+                return Next<S>(std::move(new_node));
+            }
+            else {
+                using next_node = typename Next<S, Type>::node_type;
+                next_node node_builder(std::forward<Args>(args)...);
+                auto new_node = std::make_shared<next_node>(std::move(node_builder));
+                for (auto& node : nodes) {
+                    node->AddChild(new_node);
+                }
+                return Next<S, Type>(std::move(new_node));
+            }
+        }
+
+        auto Then(std::shared_ptr<LiteralCommandNode<S>> argument)
+        {
+            for (auto& node : nodes) {
+                node->CheckWritable();
+                if (node->redirect != nullptr) {
+                    throw std::runtime_error("Cannot add children to a redirected node");
+                }
+            }
+            for (auto& node : nodes) {
+                if (argument != nullptr) {
+                    node->AddChild(argument);
+                }
+            }
+            return GetBuilder(std::move(argument));
+        }
+
+        template<typename T>
+        auto Then(std::shared_ptr<ArgumentCommandNode<S, T>> argument)
+        {
+            for (auto& node : nodes) {
+                node->CheckWritable();
+                if (node->redirect != nullptr) {
+                    throw std::runtime_error("Cannot add children to a redirected node");
+                }
+            }
+            for (auto& node : nodes) {
+                if (argument != nullptr) {
+                    node->AddChild(argument);
+                }
+            }
+            return GetBuilder(std::move(argument));
+        }
+
+        B& Executes(Command<S> command, bool only_master = true)
+        {
+            for (size_t i = 0; i < nodes.size(); ++i) {
+                if (master == -1 || master == i || !only_master) {
+                    auto& node = nodes[i];
+                    node->CheckWritable();
+                    node->command = command;
+                    node->Modified();
+                }
+            }
+            return *GetThis();
+        }
+
+        B& Requires(Predicate<S&> requirement, bool only_master = true)
+        {
+            for (size_t i = 0; i < nodes.size(); ++i) {
+                if (master == -1 || master == i || !only_master) {
+                    auto& node = nodes[i];
+                    node->CheckWritable();
+                    node->requirement = requirement;
+                    node->Modified();
+                }
+            }
+            return *GetThis();
+        }
+
+        B& RequiresPermissions(PermissionMask permissions, bool only_master = true)
+        {
+            for (size_t i = 0; i < nodes.size(); ++i) {
+                if (master == -1 || master == i || !only_master) {
+                    auto& node = nodes[i];
+                    node->CheckWritable();
+                    node->permissions = permissions;
+                    node->Modified();
+                }
+            }
+            return *GetThis();
+        }
+
+        inline auto Redirect(std::shared_ptr<CommandNode<S>> target, bool only_master = true)
+        {
+            return Forward(std::move(target), nullptr, false, only_master);
+        }
+
+        inline auto Redirect(std::shared_ptr<CommandNode<S>> target, SingleRedirectModifier<S> modifier, bool only_master = true)
+        {
+            return Forward(std::move(target), modifier ? [modifier](CommandContext<S>& context) -> std::vector<S> {
+                return { modifier(context) }; } : nullptr, false, only_master);
+        }
+
+        inline auto Fork(std::shared_ptr<CommandNode<S>> target, SingleRedirectModifier<S> modifier, bool only_master = true)
+        {
+            return Forward(std::move(target), modifier ? [modifier](CommandContext<S>& context) -> std::vector<S> {
+                return { modifier(context) }; } : nullptr, true, only_master);
+        }
+
+        inline auto Fork(std::shared_ptr<CommandNode<S>> target, RedirectModifier<S> modifier, bool only_master = true)
+        {
+            return Forward(std::move(target), modifier, true, only_master);
+        }
+
+        void Forward(std::shared_ptr<CommandNode<S>> target, RedirectModifier<S> modifier, bool fork, bool only_master = true)
+        {
+            for (size_t i = 0; i < nodes.size(); ++i) {
+                if (master == -1 || master == i || !only_master) {
+                    auto& node = nodes[i];
+                    node->CheckWritable();
+                    if (node->GetChildren().size() > 0)
+                    {
+                        throw std::runtime_error("Cannot forward a node with children");
+                    }
+                }
+            }
+            for (size_t i = 0; i < nodes.size(); ++i) {
+                if (master == -1 || master == i || !only_master) {
+                    auto& node = nodes[i];
+                    node->SetRedirect(target);
+                    node->modifier = modifier;
+                    node->forks = fork;
+                    node->Modified();
+                }
+            }
+        }
+    protected:
+        std::vector<std::shared_ptr<CommandNode<S>>> nodes;
+        int master = -1;
+    };
+
+    // multi builder
+    template<typename S>
+    inline MultiArgumentBuilder<S> GetBuilder(std::vector<std::shared_ptr<CommandNode<S>>> nodes, int master = -1)
+    {
+        return MultiArgumentBuilder<S>(std::move(nodes), master);
+    }
 
     template<typename S, typename B, typename NodeType>
     class ArgumentBuilder
@@ -1956,6 +4311,7 @@ namespace brigadier
         template<template<typename...> typename Next, typename Type = void, typename... Args>
         auto Then(Args&&... args)
         {
+            node->CheckWritable();
             if (node->redirect != nullptr) {
                 throw std::runtime_error("Cannot add children to a redirected node");
             }
@@ -1963,7 +4319,7 @@ namespace brigadier
             if constexpr (std::is_same_v<Type, void>) {
                 using next_node = typename Next<S>::node_type;
                 next_node node_builder(std::forward<Args>(args)...);
-                auto& name = node_builder.GetName();
+                auto name = node_builder.GetName();
                 auto arg = node->children.find(name);
                 if (arg == node->children.end()) {
                     auto new_node = std::make_shared<next_node>(std::move(node_builder));
@@ -1977,14 +4333,14 @@ namespace brigadier
                             throw std::runtime_error("Node type (literal/argument) mismatch!");
                         }
                     }
-                    return Next<S>(std::static_pointer_cast<next_node>(arg_ptr));
+                    return Next<S>(std::static_pointer_cast<next_node>(node->GetOwnedChild(name)));
                 }
             }
             else
             {
                 using next_node = typename Next<S, Type>::node_type;
                 next_node node_builder(std::forward<Args>(args)...);
-                auto& name = node_builder.GetName();
+                auto name = node_builder.GetName();
                 auto arg = node->children.find(name);
                 if (arg == node->children.end()) {
                     auto new_node = std::make_shared<next_node>(std::move(node_builder));
@@ -1998,7 +4354,7 @@ namespace brigadier
                             throw std::runtime_error("Node type (literal/argument) mismatch!");
                         }
                     }
-                    return Next<S, Type>(std::static_pointer_cast<next_node>(arg_ptr));
+                    return Next<S, Type>(std::static_pointer_cast<next_node>(node->GetOwnedChild(name)));
                 }
             }
         }
@@ -2012,6 +4368,7 @@ namespace brigadier
 
         auto Then(std::shared_ptr<LiteralCommandNode<S>> argument)
         {
+            node->CheckWritable();
             if (node->redirect != nullptr) {
                 throw std::runtime_error("Cannot add children to a redirected node");
             }
@@ -2024,6 +4381,7 @@ namespace brigadier
         template<typename T>
         auto Then(std::shared_ptr<ArgumentCommandNode<S, T>> argument)
         {
+            node->CheckWritable();
             if (node->redirect != nullptr) {
                 throw std::runtime_error("Cannot add children to a redirected node");
             }
@@ -2035,13 +4393,25 @@ namespace brigadier
 
         B& Executes(Command<S> command)
         {
+            node->CheckWritable();
             node->command = command;
+            node->Modified();
             return *GetThis();
         }
 
         B& Requires(Predicate<S&> requirement)
         {
+            node->CheckWritable();
             node->requirement = requirement;
+            node->Modified();
+            return *GetThis();
+        }
+
+        B& RequiresPermissions(PermissionMask permissions)
+        {
+            node->CheckWritable();
+            node->permissions = permissions;
+            node->Modified();
             return *GetThis();
         }
 
@@ -2069,13 +4439,15 @@ namespace brigadier
 
         void Forward(std::shared_ptr<CommandNode<S>> target, RedirectModifier<S> modifier, bool fork)
         {
+            node->CheckWritable();
             if (node->GetChildren().size() > 0)
             {
                 throw std::runtime_error("Cannot forward a node with children");
             }
-            node->redirect = std::move(target);
+            node->SetRedirect(std::move(target));
             node->modifier = modifier;
             node->forks = fork;
+            node->Modified();
         }
     protected:
         template<typename _S, typename _B>
@@ -2114,7 +4486,7 @@ namespace brigadier
 
         RequiredArgumentBuilder<S, T>& Suggests(SuggestionProvider<S> provider)
         {
-            this->node->suggestionsProvider = provider;
+            this->node->customSuggestions = provider;
             return *this;
         }
     };
@@ -2134,9 +4506,125 @@ namespace brigadier
         return RequiredArgumentBuilder<S, Spec<S, Type>>(std::make_shared<ArgumentCommandNode<S, Spec<S, Type>>>(std::forward<Args>(args)...));
     }
 
+    /**
+    Approximate memory used by a command tree, see CommandDispatcher::MemoryStats(size_t).
+
+    The figures are estimates. Objects and vectors are counted exactly from sizeof and capacity(), while nodes of
+    children maps and std::shared_ptr control blocks, whose layout is up to the standard library, are counted with
+    the sizes used by the common implementations. Allocator overhead is not included.
+    Nodes with several parents are counted once.
+    */
+    struct CommandTreeMemoryStats
+    {
+        struct FanOut
+        {
+            std::vector<std::string> path;
+            size_t children;
+        };
+
+        size_t rootNodes = 0;
+        size_t literalNodes = 0;
+        size_t argumentNodes = 0;
+
+        size_t objectBytes = 0;       // node objects
+        size_t stringBytes = 0;       // names of the nodes stored by StringInterner, each counted once
+        size_t containerBytes = 0;    // children maps and vectors
+        size_t controlBlockBytes = 0; // std::shared_ptr control blocks of nodes
+
+        std::vector<FanOut> largestFanOut; // nodes with the most children, largest first
+
+        inline size_t GetNodeCount() const { return rootNodes + literalNodes + argumentNodes; }
+        inline size_t GetTotalBytes() const { return objectBytes + stringBytes + containerBytes + controlBlockBytes; }
+    };
+
+    enum class CommandTreeChange
+    {
+        Added,      // node (with its whole subtree) was added, replacing the node with the same path if there was one
+        Removed,    // node (with its whole subtree) was removed, only the path is reported
+        Changed     // command, requirements or redirect of the node were changed
+    };
+
+    /**
+    Changes made to a command tree between two versions, see CommandDispatcher::GetDelta(size_t).
+
+    \param <S> a custom "source" type, such as a user or originator of a command
+    */
+    template<typename S>
+    class CommandTreeDelta
+    {
+    public:
+        struct Entry
+        {
+            CommandTreeChange change;
+            std::vector<std::string> path;
+            std::shared_ptr<CommandNode<S>> node;
+        };
+    public:
+        CommandTreeDelta(size_t from, size_t to) : from(from), to(to) {}
+    public:
+        inline size_t GetFrom() const { return from; }
+        inline size_t GetTo()   const { return to;   }
+        inline std::vector<Entry> const& GetEntries() const { return entries; }
+        inline bool IsEmpty() const { return entries.empty(); }
+    private:
+        template<typename _S>
+        friend class CommandDispatcher;
+
+        size_t from;
+        size_t to;
+        std::vector<Entry> entries;
+    };
+
     template<typename S>
     class CommandDispatcher;
 
+    /**
+    Outcome of CommandDispatcher::TryExecute, which reports failures without throwing.
+    */
+    struct ExecuteResult
+    {
+        int result = 0; // the value CommandDispatcher::Execute would have returned, 0 if it would have thrown
+        int successes = 0; // commands that completed, one for each source of a fork
+        int failures = 0; // commands and redirect modifiers that failed, or 1 if the input could not be parsed
+        SyntaxError error = SyntaxError::Custom; // of the first failure
+        int cursor = -1; // of the first failure in the input, -1 if the failure has no position
+        bool failed = false; // CommandDispatcher::Execute would have thrown the first failure
+
+        inline bool IsSuccess() const { return !failed; }
+    };
+
+    /**
+    Settings of CommandDispatcher::Parse, see CommandDispatcher::SetParseOptions(ParseOptions).
+    */
+    struct ParseOptions
+    {
+        /**
+        Remembers the result of parsing below each node at each position of the input, for the duration of one parse.
+        Trees where several arguments accept the same input and lead to shared nodes (see CommandDispatcher::Deduplicate())
+        are then parsed in polynomial instead of exponential time, at the cost of copying results on every level.
+        */
+        bool memoize = false;
+
+        /**
+        Limits of the work done by one parse, 0 for no limit. When a limit is reached, CommandDispatcher::Parse throws
+        CommandSyntaxException::BuiltInExceptions::DispatcherParseBudgetExceeded instead of returning partial results.
+        */
+        size_t maxNodeVisits = 0; // nodes tried against the input, across all branches
+        size_t maxRedirectDepth = 0; // redirects followed in a row, e.g. `execute ... run execute ... run ...`
+        std::chrono::microseconds maxTime = std::chrono::microseconds::zero(); // checked every few node visits
+
+        /**
+        Parses for execution only. Failures of nodes are not recorded, so ParseResults::GetExceptions() stays empty and
+        CommandDispatcher::Execute(ParseResults) reports only where the input stopped being valid. Once a node has parsed the rest
+        of the input, its siblings are not tried, as none of them could replace it as the best potential, unless a remaining sibling
+        has a redirect: a redirect takes over the level once parsed in both modes, so the siblings are tried up to the last one with a redirect.
+        For input that parses completely the resulting context is the same as in the diagnostic mode. For input that fails,
+        the diagnostic mode also ranks candidates by their exceptions (see ParseResults::IsBetterThan), so the fast mode
+        may stop in a different node and report a different position.
+        */
+        bool fastMode = false;
+    };
+
     template<typename S>
     class ParseResults
     {
@@ -2144,8 +4632,11 @@ namespace brigadier
         ParseResults(CommandContext<S> context, StringReader reader, std::map<CommandNode<S>*, CommandSyntaxException> exceptions)
             : context(std::move(context))
             , reader(std::move(reader))
-            , exceptions(std::move(exceptions))
-        {}
+        {
+            for (auto& [node, exception] : exceptions) {
+                errors.push_back({ node, ExceptionRecord(exception) });
+            }
+        }
         ParseResults(CommandContext<S> context, StringReader reader)
             : context(std::move(context))
             , reader(std::move(reader))
@@ -2155,7 +4646,27 @@ namespace brigadier
     public:
         inline CommandContext<S> const& GetContext() const { return context; }
         inline StringReader      const& GetReader()  const { return reader; }
-        inline std::map<CommandNode<S>*, CommandSyntaxException> const& GetExceptions() const { return exceptions; }
+        inline bool HasExceptions() const { return !errors.empty(); }
+
+        /**
+        Gets the exceptions of the nodes that could not be parsed, one for each node.
+        They are created from the failures recorded while parsing on the first call, which may run concurrently with others.
+        Like GetReader(), the exceptions refer to the parsed input.
+        */
+        inline std::map<CommandNode<S>*, CommandSyntaxException> const& GetExceptions() const
+        {
+            if (!exceptions.expanded.load(std::memory_order_acquire)) {
+                std::lock_guard<std::mutex> lock(exceptions.mutex);
+                if (!exceptions.expanded.load(std::memory_order_relaxed)) {
+                    exceptions.map.clear();
+                    for (auto& [node, record] : errors) {
+                        exceptions.map.emplace(node, CommandSyntaxException(record, reader.GetString()));
+                    }
+                    exceptions.expanded.store(true, std::memory_order_release);
+                }
+            }
+            return exceptions.map;
+        }
 
         inline bool IsBetterThan(ParseResults<S> const& other) const
         {
@@ -2165,10 +4676,10 @@ namespace brigadier
             if (GetReader().CanRead() && !other.GetReader().CanRead()) {
                 return false;
             }
-            if (GetExceptions().empty() && !other.GetExceptions().empty()) {
+            if (!HasExceptions() && other.HasExceptions()) {
                 return true;
             }
-            if (!GetExceptions().empty() && other.GetExceptions().empty()) {
+            if (HasExceptions() && !other.HasExceptions()) {
                 return false;
             }
             return false;
@@ -2176,7 +4687,7 @@ namespace brigadier
 
         inline void Reset(StringReader new_reader)
         {
-            exceptions.clear();
+            ClearExceptions();
             reader = std::move(new_reader);
         }
         inline void Reset(S source, CommandNode<S>* root, int start, StringReader reader = {})
@@ -2194,11 +4705,461 @@ namespace brigadier
         template<typename _S>
         friend class CommandDispatcher;
 
+        struct Error
+        {
+            CommandNode<S>* node;
+            ExceptionRecord record;
+        };
+        using Errors = std::vector<Error>;
+
+        // The map of GetExceptions(), created once by whichever call comes first. Copies start without it.
+        struct ExpandedExceptions
+        {
+            ExpandedExceptions() = default;
+            ExpandedExceptions(ExpandedExceptions const&) {}
+            ExpandedExceptions& operator=(ExpandedExceptions const&) { Reset(); return *this; }
+
+            inline void Reset()
+            {
+                map.clear();
+                expanded.store(false, std::memory_order_relaxed);
+            }
+
+            std::map<CommandNode<S>*, CommandSyntaxException> map;
+            std::atomic<bool> expanded = false;
+            std::mutex mutex;
+        };
+
+        inline void AddException(CommandNode<S>* node, CommandSyntaxException const& exception)
+        {
+            AddException(node, ExceptionRecord(exception));
+        }
+        inline void AddException(CommandNode<S>* node, ExceptionRecord record)
+        {
+            errors.push_back({ node, std::move(record) });
+            exceptions.Reset();
+        }
+        inline void SetExceptions(Errors other)
+        {
+            errors = std::move(other);
+            exceptions.Reset();
+        }
+        inline void ClearExceptions()
+        {
+            errors.clear();
+            exceptions.Reset();
+        }
+
         CommandContext<S> context;
-        std::map<CommandNode<S>*, CommandSyntaxException> exceptions;
+        // Failures in the order they were found. A node may fail more than once, the first failure is reported.
+        // Exceptions are not created until needed, and the vector keeps its memory when the results are reused.
+        Errors errors;
+        mutable ExpandedExceptions exceptions; // see GetExceptions()
         StringReader reader;
+        std::shared_ptr<CommandNode<S>> tree; // keeps the parsed version of the command tree alive, see CommandDispatcher::Replace
+    };
+
+    /**
+    Common part of nodes of a command tree declared at compile time, see StaticCommandNode.
+
+    Every modifier returns a modified copy, so whole trees can be declared as constexpr values.
+    */
+    template<typename S, typename B, typename... Children>
+    class StaticTreeNode
+    {
+    public:
+        static constexpr size_t height = 1 + (std::max)({ size_t(0), Children::height... });
+        static constexpr size_t literalCount = (size_t(Children::kind == CommandNodeType::LiteralCommandNode) + ... + 0);
+        static constexpr size_t argumentCount = sizeof...(Children) - literalCount;
+
+        constexpr StaticTreeNode(std::string_view name, Children... children) : name(name), children(std::move(children)...) {}
+
+        constexpr B Executes(Command<S> command) const
+        {
+            B copy = static_cast<B const&>(*this);
+            copy.command = command;
+            return copy;
+        }
+
+        constexpr B Requires(Predicate<S&> requirement) const
+        {
+            B copy = static_cast<B const&>(*this);
+            copy.requirement = requirement;
+            return copy;
+        }
+
+        constexpr B RequiresPermissions(PermissionMask permissions) const
+        {
+            B copy = static_cast<B const&>(*this);
+            copy.permissions = permissions;
+            return copy;
+        }
+
+        // Index of the I-th child in CommandNode::literals or CommandNode::arguments of the built node.
+        template<size_t I>
+        static constexpr size_t IndexOf()
+        {
+            constexpr CommandNodeType kinds[] = { Children::kind..., CommandNodeType::RootCommandNode };
+            size_t index = 0;
+            for (size_t i = 0; i < I; ++i) {
+                if (kinds[i] == kinds[I])
+                    ++index;
+            }
+            return index;
+        }
+    public:
+        std::string_view name;
+        std::tuple<Children...> children;
+        Command<S> command = nullptr;
+        Predicate<S&> requirement = nullptr;
+        PermissionMask permissions = 0;
+    };
+
+    template<typename S, typename... Children>
+    class StaticLiteral : public StaticTreeNode<S, StaticLiteral<S, Children...>, Children...>
+    {
+    public:
+        static constexpr CommandNodeType kind = CommandNodeType::LiteralCommandNode;
+
+        constexpr StaticLiteral(std::string_view literal, Children... children)
+            : StaticTreeNode<S, StaticLiteral<S, Children...>, Children...>(literal, std::move(children)...)
+        {}
+    };
+
+    template<typename S, typename T, typename... Children>
+    class StaticArgument : public StaticTreeNode<S, StaticArgument<S, T, Children...>, Children...>
+    {
+    public:
+        static constexpr CommandNodeType kind = CommandNodeType::ArgumentCommandNode;
+        using argument_type = T;
+
+        constexpr StaticArgument(std::string_view name, Children... children)
+            : StaticTreeNode<S, StaticArgument<S, T, Children...>, Children...>(name, std::move(children)...)
+        {}
+
+        // Sets parameters of the argument type, such as the range of a number.
+        constexpr StaticArgument WithType(T type) const
+        {
+            StaticArgument copy = *this;
+            copy.type = std::move(type);
+            return copy;
+        }
+    public:
+        T type{};
+    };
+
+    template<typename S, typename... Children>
+    constexpr StaticLiteral<S, Children...> MakeStaticLiteral(std::string_view literal, Children... children)
+    {
+        return StaticLiteral<S, Children...>(literal, std::move(children)...);
+    }
+
+    template<typename S, typename T, typename... Children>
+    constexpr StaticArgument<S, T, Children...> MakeStaticArgument(std::string_view name, Children... children)
+    {
+        return StaticArgument<S, T, Children...>(name, std::move(children)...);
+    }
+
+    /**
+    Literal node built from a command tree declared at compile time:
+
+        constexpr auto tp = MakeStaticLiteral<S>("tp",
+            MakeStaticArgument<S, Integer>("x",
+                MakeStaticArgument<S, Integer>("y").Executes(teleport)));
+
+    The tree below this node is made of ordinary nodes, so usage, suggestions and images work as usual.
+    Parsing below this node is done by code generated for the declared tree: literals are compared in place and
+    arguments are parsed by their types directly, without virtual calls or lookups in the children map.
+    Failed branches do not touch the context, it is filled once a complete command is found. Parsed values are kept
+    on the stack until then, so failed branches do not allocate. Every node tried counts towards ParseOptions::maxNodeVisits.
+
+    Commands, requirements and redirects are read from the nodes, so they can still be changed by builders.
+    If the children of a node no longer match the declared tree, or the input is not a complete command,
+    the generated parser gives up and the dispatcher parses it the usual way (see CommandNode::ParseCompiled()).
+    */
+    template<typename S, typename Tree>
+    class StaticCommandNode : public LiteralCommandNode<S>
+    {
+        static_assert(Tree::kind == CommandNodeType::LiteralCommandNode, "Static command tree must start with a literal");
+    public:
+        StaticCommandNode(Tree const& tree)
+            : LiteralCommandNode<S>(tree.name)
+            , tree(InternNames(tree, names))
+        {
+            this->compiledParse = &StaticCommandNode<S, Tree>::ParseChildren;
+            SetProperties(*this, tree);
+            AddChildren(*this, tree);
+        }
+        StaticCommandNode(StaticCommandNode const& other)
+            : LiteralCommandNode<S>(other)
+            , names(other.names)
+            , tree(other.tree)
+        {
+            this->compiledParse = &StaticCommandNode<S, Tree>::ParseChildren;
+        }
+        virtual ~StaticCommandNode() = default;
+
+        virtual std::shared_ptr<CommandNode<S>> Clone() { return std::make_shared<StaticCommandNode<S, Tree>>(*this); }
+        virtual size_t GetObjectSize() { return sizeof(*this); }
+    private:
+        enum class Match
+        {
+            Failed,     // no complete command below the node
+            Parsed,
+            Unsupported // the node does not match the declared tree
+        };
+
+        struct Step
+        {
+            CommandNode<S>* node = nullptr;
+            int start = 0;
+            int end = 0;
+        };
+
+        struct State
+        {
+            StringReader& reader;
+            CommandContext<S>& context;
+            PermissionMask permissions;
+            ParseBudget& budget;
+            Step* steps;
+            size_t length;
+        };
+
+        template<typename Node>
+        static Node InternNames(Node node, std::vector<InternedString>& names)
+        {
+            node.name = names.emplace_back(StringInterner::Intern(node.name));
+            std::apply([&names](auto&... children) { ((children = InternNames(children, names)), ...); }, node.children);
+            return node;
+        }
+
+        template<typename Node>
+        static void SetProperties(CommandNode<S>& node, Node const& desc)
+        {
+            node.command = desc.command;
+            node.requirement = desc.requirement;
+            node.permissions = desc.permissions;
+            node.Modified();
+        }
+
+        template<typename Node>
+        static void AddChildren(CommandNode<S>& node, Node const& desc)
+        {
+            std::apply([&node](auto const&... children) { (node.AddChild(MakeNode(children)), ...); }, desc.children);
+        }
+
+        template<typename Node>
+        static std::shared_ptr<CommandNode<S>> MakeNode(Node const& desc)
+        {
+            std::shared_ptr<CommandNode<S>> node;
+            if constexpr (Node::kind == CommandNodeType::LiteralCommandNode)
+                node = std::make_shared<LiteralCommandNode<S>>(desc.name);
+            else
+                node = std::make_shared<ArgumentCommandNode<S, typename Node::argument_type>>(desc.name, desc.type);
+            SetProperties(*node, desc);
+            AddChildren(*node, desc);
+            return node;
+        }
+
+        static bool ParseChildren(CommandNode<S>& node, StringReader& reader, CommandContext<S>& context, PermissionMask permissions, ParseBudget& budget)
+        {
+            auto& self = static_cast<StaticCommandNode<S, Tree>&>(node);
+            std::array<Step, Tree::height - 1> steps;
+            State state{ reader, context, permissions, budget, steps.data(), 0 };
+
+            int cursor = reader.GetCursor();
+            if (MatchChildren(node, self.tree, state, 0) != Match::Parsed) {
+                reader.SetCursor(cursor);
+                return false;
+            }
+
+            // arguments were added by MatchNode() on the way back
+            for (size_t i = 0; i < state.length; ++i) {
+                Step& step = steps[i];
+                context.WithNode(step.node, StringRange::Between(step.start, step.end));
+            }
+            context.WithCommand(steps[state.length - 1].node->GetCommand());
+            return true;
+        }
+
+        // Finds the child built from the I-th child of the declared node, checking that it was not replaced since.
+        template<size_t I, typename Node>
+        static CommandNode<S>* GetChild(CommandNode<S>& node, Node const& desc)
+        {
+            auto& child = std::get<I>(desc.children);
+            using Child = std::decay_t<decltype(child)>;
+            constexpr size_t index = Node::template IndexOf<I>();
+
+            if constexpr (Child::kind == CommandNodeType::LiteralCommandNode) {
+                CommandNode<S>* literal = node.literals[index].get();
+                return literal->GetName().data() == child.name.data() ? literal : nullptr;
+            }
+            else {
+                IArgumentCommandNode<S>* argument = node.arguments[index].get();
+                if (argument->GetName().data() != child.name.data() || argument->GetParseFunction() != &ArgumentCommandNode<S, typename Child::argument_type>::ParseAs)
+                    return nullptr;
+                return argument;
+            }
+        }
+
+        template<typename Node, size_t... I>
+        static bool GetChildren(CommandNode<S>& node, Node const& desc, CommandNode<S>** children, std::index_sequence<I...>)
+        {
+            if (node.literals.size() != Node::literalCount || node.arguments.size() != Node::argumentCount)
+                return false;
+            return ((children[I] = GetChild<I>(node, desc)) && ...);
+        }
+
+        // Same order of candidates as CommandNode::GetRelevantNodes(), the first one that parses the rest of the input wins.
+        template<typename Node>
+        static Match MatchChildren(CommandNode<S>& node, Node const& desc, State& state, size_t depth)
+        {
+            constexpr size_t count = std::tuple_size_v<decltype(desc.children)>;
+            if constexpr (count == 0) {
+                return node.children.empty() ? Match::Failed : Match::Unsupported;
+            }
+            else {
+                std::array<CommandNode<S>*, count> children;
+                if (!GetChildren(node, desc, children.data(), std::make_index_sequence<count>()))
+                    return Match::Unsupported;
+
+                if constexpr (Node::literalCount > 0) {
+                    std::string_view remaining = state.reader.GetRemaining();
+                    std::string_view word = remaining.substr(0, remaining.find(' '));
+                    bool found = false;
+                    Match match = MatchLiterals<0>(desc, children.data(), word, found, state, depth);
+                    if (found)
+                        return match;
+                }
+                if constexpr (Node::argumentCount > 0) {
+                    return MatchArguments<0>(desc, children.data(), state, depth);
+                }
+                return Match::Failed;
+            }
+        }
+
+        template<size_t I, typename Node>
+        static Match MatchLiterals(Node const& desc, CommandNode<S>** children, std::string_view word, bool& found, State& state, size_t depth)
+        {
+            if constexpr (I == std::tuple_size_v<decltype(desc.children)>) {
+                return Match::Failed;
+            }
+            else {
+                auto& child = std::get<I>(desc.children);
+                if constexpr (std::decay_t<decltype(child)>::kind == CommandNodeType::LiteralCommandNode) {
+                    if (word == child.name) {
+                        found = true;
+                        return MatchNode(*children[I], child, state, depth);
+                    }
+                }
+                return MatchLiterals<I + 1>(desc, children, word, found, state, depth);
+            }
+        }
+
+        template<size_t I, typename Node>
+        static Match MatchArguments(Node const& desc, CommandNode<S>** children, State& state, size_t depth)
+        {
+            if constexpr (I == std::tuple_size_v<decltype(desc.children)>) {
+                return Match::Failed;
+            }
+            else {
+                auto& child = std::get<I>(desc.children);
+                if constexpr (std::decay_t<decltype(child)>::kind == CommandNodeType::ArgumentCommandNode) {
+                    Match match = MatchNode(*children[I], child, state, depth);
+                    if (match != Match::Failed)
+                        return match;
+                }
+                return MatchArguments<I + 1>(desc, children, state, depth);
+            }
+        }
+
+        template<typename Node>
+        static Match MatchNode(CommandNode<S>& node, Node const& desc, State& state, size_t depth)
+        {
+            if (node.redirect != nullptr)
+                return Match::Unsupported;
+            if (!node.CanUse(state.context.GetSource(), state.permissions))
+                return Match::Failed;
+
+            StringReader& reader = state.reader;
+            state.budget.Visit(reader);
+            int start = reader.GetCursor();
+
+            if constexpr (Node::kind == CommandNodeType::LiteralCommandNode) {
+                reader.SetCursor(start + int(desc.name.size()));
+                return MatchRest(node, desc, state, depth, start);
+            }
+            else {
+                using T = typename Node::argument_type;
+                std::optional<typename T::type> result;
+                if constexpr (HasTryParse<T>::value) {
+                    ExceptionRecord error;
+                    if (!static_cast<ArgumentCommandNode<S, T>&>(node).type.TryParse(reader, result.emplace(), error)) {
+                        reader.SetCursor(start);
+                        return Match::Failed;
+                    }
+                }
+                else {
+                    try {
+                        result.emplace(static_cast<ArgumentCommandNode<S, T>&>(node).type.Parse(reader));
+                    }
+                    catch (CommandSyntaxException const&) {
+                        reader.SetCursor(start);
+                        return Match::Failed;
+                    }
+                    catch (std::runtime_error const&) {
+                        reader.SetCursor(start);
+                        return Match::Failed;
+                    }
+                }
+                if (reader.CanRead() && reader.Peek() != ' ') {
+                    reader.SetCursor(start);
+                    return Match::Failed;
+                }
+
+                int end = reader.GetCursor();
+                Match match = MatchRest(node, desc, state, depth, start);
+                if (match == Match::Parsed)
+                    state.context.WithArgument(node.GetName(), ParsedArgument<S, T>::Make(start, end, std::move(*result)));
+                return match;
+            }
+        }
+
+        // Records the node parsed from `start` up to the reader position and matches its children
+        template<typename Node>
+        static Match MatchRest(CommandNode<S>& node, Node const& desc, State& state, size_t depth, int start)
+        {
+            StringReader& reader = state.reader;
+            Step& step = state.steps[depth];
+            step.node = &node;
+            step.start = start;
+            step.end = reader.GetCursor();
+
+            if (reader.CanRead(2)) {
+                reader.Skip();
+                Match match = MatchChildren(node, desc, state, depth + 1);
+                if (match != Match::Failed)
+                    return match;
+            }
+            else if (!reader.CanRead()) {
+                state.length = depth + 1;
+                return Match::Parsed;
+            }
+            reader.SetCursor(start);
+            return Match::Failed;
+        }
+    private:
+        std::vector<InternedString> names; // keep the names of the declaration stored, even if its nodes are removed
+        Tree tree; // names are interned, so children can be compared with the declaration by address
     };
 
+    template<typename S, typename... Children>
+    inline std::shared_ptr<StaticCommandNode<S, StaticLiteral<S, Children...>>> MakeStaticNode(StaticLiteral<S, Children...> const& tree)
+    {
+        return std::make_shared<StaticCommandNode<S, StaticLiteral<S, Children...>>>(tree);
+    }
+
     /**
     The core command dispatcher, for registering, parsing, and executing commands.
 
@@ -2227,16 +5188,91 @@ namespace brigadier
         /**
         Create a new CommandDispatcher with the specified root node.
 
-        This is often useful to copy existing or pre-defined command trees.
+        This is often useful to copy existing or pre-defined command trees.
+
+        \param root the existing RootCommandNode to use as the basis for this tree
+        Only the root is copied, the rest of the tree is shared until either tree modifies it,
+        the same way as by CommandDispatcher(CommandDispatcher const&). Redirects to the existing root are moved to the copy,
+        which also copies the paths to them.
+        */
+        CommandDispatcher(RootCommandNode<S>* root) : root(std::make_shared<RootCommandNode<S>>(*root)), owner(std::make_shared<CommandTreeOwner>())
+        {
+            if (root->owner != nullptr)
+                root->owner->Seal();
+            this->root->owner = owner;
+
+            ReloadState state{ owner };
+            state.copies.emplace(root, this->root);
+            state.owned.insert(this->root.get());
+            RelinkRedirects(this->root, state);
+        }
+
+        /**
+        Create a new CommandDispatcher that takes over an existing command tree, e.g. one loaded by CommandTreeBinder::ReadImage(CommandTreeImage).
+
+        Unlike CommandDispatcher(RootCommandNode), the root is not copied, so redirects to it stay valid.
+        If the tree is used by another dispatcher as well, it is shared the same way as by CommandDispatcher(CommandDispatcher const&).
+
+        \param root the RootCommandNode of the tree
+        */
+        CommandDispatcher(std::shared_ptr<RootCommandNode<S>> root) : root(root ? std::move(root) : std::make_shared<RootCommandNode<S>>())
+        {
+            if (this->root->owner != nullptr) {
+                this->root->owner->Seal();
+            }
+            else {
+                owner = std::make_shared<CommandTreeOwner>();
+                this->root->Adopt(owner);
+            }
+        }
+
+        /**
+        Creates a new CommandDispatcher with an empty command tree.
+        */
+        CommandDispatcher() : root(std::make_shared<RootCommandNode<S>>()), owner(std::make_shared<CommandTreeOwner>())
+        {
+            root->owner = owner;
+        }
+
+        /**
+        Creates a copy of a dispatcher in constant time.
+
+        Both dispatchers share the command tree until one of them modifies it. Then only the nodes on the path
+        from the root to the modified node are copied (copy-on-write), together with the paths to nodes redirecting to the root.
+        Builders obtained from either dispatcher before the copy throw std::runtime_error when used to modify the tree,
+        get new ones from the dispatcher instead.
 
-        \param root the existing RootCommandNode to use as the basis for this tree
+        \param other the dispatcher to copy
         */
-        CommandDispatcher(RootCommandNode<S>* root) : root(std::make_shared<RootCommandNode<S>>(*root)) {}
+        CommandDispatcher(CommandDispatcher const& other)
+            : root(other.GetRoot())
+            , consumer(other.consumer)
+            , permissionProvider(other.permissionProvider)
+            , permissionClasses(other.permissionClasses)
+            , parseOptions(other.parseOptions)
+        {
+            // neither dispatcher may modify the shared nodes in place any more
+            if (root->owner != nullptr)
+                root->owner->Seal();
+        }
 
-        /**
-        Creates a new CommandDispatcher with an empty command tree.
-        */
-        CommandDispatcher() : root(std::make_shared<RootCommandNode<S>>()) {}
+        CommandDispatcher& operator=(CommandDispatcher const& other)
+        {
+            if (this != &other) {
+                root = other.GetRoot();
+                owner = nullptr;
+                if (root->owner != nullptr)
+                    root->owner->Seal();
+                consumer = other.consumer;
+                permissionProvider = other.permissionProvider;
+                permissionClasses = other.permissionClasses;
+                parseOptions = other.parseOptions;
+            }
+            return *this;
+        }
+
+        CommandDispatcher(CommandDispatcher&&) = default;
+        CommandDispatcher& operator=(CommandDispatcher&&) = default;
 
         /**
         Utility method for registering new commands.
@@ -2250,11 +5286,12 @@ namespace brigadier
             if constexpr (std::is_same_v<Type, void>) {
                 using next_node = typename Next<S>::node_type;
                 next_node node_builder(std::forward<Args>(args)...);
-                auto& name = node_builder.GetName();
-                auto arg = root->children.find(name);
-                if (arg == root->children.end()) {
+                auto name = node_builder.GetName();
+                auto parent = OwnRoot();
+                auto arg = parent->children.find(name);
+                if (arg == parent->children.end()) {
                     auto new_node = std::make_shared<next_node>(std::move(node_builder));
-                    root->AddChild(new_node);
+                    parent->AddChild(new_node);
                     return Next<S>(std::move(new_node));
                 }
                 else {
@@ -2264,17 +5301,18 @@ namespace brigadier
                             throw std::runtime_error("Node type (literal/argument) mismatch!");
                         }
                     }
-                    return Next<S>(std::static_pointer_cast<next_node>(arg_ptr));
+                    return Next<S>(std::static_pointer_cast<next_node>(parent->GetOwnedChild(name)));
                 }
             }
             else {
                 using next_node = typename Next<S, Type>::node_type;
                 next_node node_builder(std::forward<Args>(args)...);
-                auto& name = node_builder.GetName();
-                auto arg = root->children.find(name);
-                if (arg == root->children.end()) {
+                auto name = node_builder.GetName();
+                auto parent = OwnRoot();
+                auto arg = parent->children.find(name);
+                if (arg == parent->children.end()) {
                     auto new_node = std::make_shared<next_node>(std::move(node_builder));
-                    root->AddChild(new_node);
+                    parent->AddChild(new_node);
                     return Next<S, Type>(std::move(new_node));
                 }
                 else {
@@ -2284,11 +5322,114 @@ namespace brigadier
                             throw std::runtime_error("Node type (literal/argument) mismatch!");
                         }
                     }
-                    return Next<S, Type>(std::static_pointer_cast<next_node>(arg_ptr));
+                    return Next<S, Type>(std::static_pointer_cast<next_node>(parent->GetOwnedChild(name)));
                 }
             }
         }
 
+        /**
+        Registers a command declared at compile time, see StaticCommandNode.
+
+        Like every registration this is an append operation. If a command of the same name already exists,
+        the declared nodes are merged into it and parsed the usual way.
+
+        \param tree the declared command
+        \return the builder of the registered node
+        */
+        template<typename... Children>
+        LiteralArgumentBuilder<S> RegisterStatic(StaticLiteral<S, Children...> const& tree)
+        {
+            auto parent = OwnRoot();
+            parent->AddChild(MakeStaticNode(tree));
+            return LiteralArgumentBuilder<S>(std::static_pointer_cast<LiteralCommandNode<S>>(parent->GetOwnedChild(tree.name)));
+        }
+
+        /**
+        Removes a node, usually a command, together with its subtree.
+
+        Redirects pointing into the removed subtree are not changed. They can be found through `dangling`,
+        which receives every node left in this tree that redirects into it. Finding them visits the removed subtree
+        and the parts of the tree that contain redirects, otherwise the cost does not depend on the size of the tree.
+
+        \param path path to the node, see GetPath(CommandNode)
+        \param dangling optional list to append the redirecting nodes to
+        \return the removed node, or nullptr if there is no node at the given path
+        */
+        std::shared_ptr<CommandNode<S>> Unregister(std::vector<std::string> const& path, std::vector<CommandNode<S>*>* dangling = nullptr)
+        {
+            if (path.empty())
+                return nullptr;
+
+            CommandNode<S>* parent = OwnRoot();
+            for (size_t i = 0; i + 1 < path.size(); ++i) {
+                parent = parent->GetOwnedChild(path[i]).get();
+                if (parent == nullptr)
+                    return nullptr;
+            }
+            auto removed = parent->RemoveChild(path.back());
+            if (removed != nullptr && dangling != nullptr) {
+                std::set<CommandNode<S>*> nodes;
+                CollectSubtree(removed.get(), nodes);
+                std::set<CommandNode<S>*> visited;
+                ForEachRedirect(root.get(), visited, [&](CommandNode<S>* source) {
+                    if (nodes.count(source->redirect.get()) != 0)
+                        dangling->push_back(source);
+                });
+            }
+            return removed;
+        }
+
+        /**
+        Replaces a node, usually a command, together with its subtree, without pausing Parse or Execute.
+
+        The new subtree can be built in advance on any thread, e.g. with MakeLiteral(). Nodes on the path from the root
+        to the replaced node are copied, the rest of the tree is shared with the previous version. The new version
+        is then published atomically: Parse and Execute calls in progress, as well as ParseResults created before,
+        keep using the previous version until they finish.
+        Redirects to the copied nodes (e.g. to the root) are moved to the copies, which also copies the path to them.
+        Redirects into the replaced subtree are not changed.
+        The previous version is not modified any more, so builders obtained before throw std::runtime_error when used to modify the tree.
+
+        Calls of Replace must not overlap each other or any other change of the tree. Only Parse and Execute may run concurrently.
+
+        \param path path to the node, see GetPath(CommandNode). The last element has to be the name of `node`
+        \param node the new subtree, or nullptr to remove the node
+        \return the replaced node, or nullptr if there was no node at the given path
+        */
+        std::shared_ptr<CommandNode<S>> Replace(std::vector<std::string> const& path, std::shared_ptr<CommandNode<S>> node)
+        {
+            if (path.empty())
+                throw std::runtime_error("Cannot replace the root node");
+            if (node != nullptr && node->GetName() != path.back())
+                throw std::runtime_error("Node name does not match the path");
+
+            auto current = GetRoot();
+            ReloadState state{ std::make_shared<CommandTreeOwner>() };
+            auto copy = CopyNode(current, state);
+            CommandNode<S>* parent = copy.get();
+            for (size_t i = 0; i + 1 < path.size(); ++i) {
+                auto child = parent->GetChild(path[i]);
+                if (child == nullptr)
+                    throw std::runtime_error("Path does not exist");
+                if (child->redirect != nullptr)
+                    throw std::runtime_error("Cannot add children to a redirected node");
+                auto child_copy = CopyNode(child, state);
+                parent->ReplaceChild(child_copy);
+                parent = child_copy.get();
+            }
+
+            auto replaced = parent->RemoveChild(path.back());
+            parent->AddChild(std::move(node));
+
+            RelinkRedirects(copy, state);
+
+            if (owner != nullptr)
+                owner->Seal();
+            owner = state.owner;
+            std::atomic_store(&root, std::static_pointer_cast<RootCommandNode<S>>(std::move(copy)));
+            return replaced;
+        }
+
         /**
         Sets a callback to be informed of the result of every command.
 
@@ -2299,6 +5440,48 @@ namespace brigadier
             this->consumer = consumer;
         }
 
+        /**
+        Sets a callback that reports permissions granted to a source.
+
+        It is called once per parse, usage or suggestion request and the result is checked against
+        permissions required by nodes (see ArgumentBuilder::RequiresPermissions(PermissionMask)) without any further calls.
+        Without a provider, sources are granted no permissions.
+
+        \param provider the new permission provider
+        */
+        void SetPermissionProvider(PermissionProvider<S> provider)
+        {
+            this->permissionProvider = provider;
+        }
+
+        /**
+        Changes how commands are parsed, see ParseOptions.
+
+        \param options the new options
+        */
+        void SetParseOptions(ParseOptions options)
+        {
+            this->parseOptions = options;
+        }
+
+        inline ParseOptions const& GetParseOptions() const
+        {
+            return parseOptions;
+        }
+
+        /**
+        Gets permissions granted to a given source by the permission provider.
+
+        \param source a custom "source" object, usually representing the originator of this command
+        \return permission mask of the source
+        */
+        PermissionMask GetPermissions(S const& source) const
+        {
+            if (permissionProvider)
+                return permissionProvider(source);
+            else return 0;
+        }
+
         /**
         Gets the root of this command tree.
 
@@ -2310,7 +5493,7 @@ namespace brigadier
         */
         std::shared_ptr<RootCommandNode<S>> GetRoot() const
         {
-            return root;
+            return std::atomic_load(&root);
         }
 
         /**
@@ -2381,8 +5564,11 @@ namespace brigadier
         */
         int Execute(StringReader& input, S source)
         {
-            auto parse = Parse(input, std::move(source));
-            return Execute(parse);
+            typename ExecuteBuffers::Lease buffers;
+            auto tree = GetRoot();
+            auto& parse = Prepare(buffers->parse, source, tree.get(), StringRange::At(input.GetCursor()), input);
+            Parse(std::move(tree), parse);
+            return Execute<true>(parse, *buffers).result;
         }
 
         /**
@@ -2413,15 +5599,137 @@ namespace brigadier
         */
         int Execute(ParseResults<S>& parse)
         {
+            typename ExecuteBuffers::Lease buffers;
+            return Execute<true>(parse, *buffers).result;
+        }
+
+        /**
+        Parses and executes a given command, reporting failures in the result instead of throwing.
+
+        Failures that Execute(String, Object) would throw as a CommandSyntaxException, including ones thrown by commands, redirect modifiers
+        and the limits of ParseOptions, are returned as ExecuteResult::error and ExecuteResult::cursor.
+        Commands can fail without throwing with CommandContext::Fail(). Other exceptions, such as std::runtime_error, are not caught.
+
+        \param input a command string to parse and execute
+        \param source a custom "source" object, usually representing the originator of this command
+        \return the outcome of the command
+        \see Execute(String, Object)
+        \see TryExecute(ParseResults)
+        */
+        ExecuteResult TryExecute(std::string_view input, S source)
+        {
+            StringReader reader = StringReader(input);
+            return TryExecute(reader, std::move(source));
+        }
+
+        /**
+        Parses and executes a given command, reporting failures in the result instead of throwing.
+
+        Failures that Execute(StringReader, Object) would throw as a CommandSyntaxException, including ones thrown by commands, redirect modifiers
+        and the limits of ParseOptions, are returned as ExecuteResult::error and ExecuteResult::cursor.
+        Commands can fail without throwing with CommandContext::Fail(). Other exceptions, such as std::runtime_error, are not caught.
+
+        \param input a command string to parse and execute
+        \param source a custom "source" object, usually representing the originator of this command
+        \return the outcome of the command
+        \see Execute(StringReader, Object)
+        \see TryExecute(ParseResults)
+        */
+        ExecuteResult TryExecute(StringReader& input, S source)
+        {
+            typename ExecuteBuffers::Lease buffers;
+            auto tree = GetRoot();
+            auto& parse = Prepare(buffers->parse, source, tree.get(), StringRange::At(input.GetCursor()), input);
+            try {
+                Parse(std::move(tree), parse);
+            }
+            catch (CommandSyntaxException const& ex) {
+                ExecuteResult status;
+                return Abort<false>(status, ex);
+            }
+            return Execute<false>(parse, *buffers);
+        }
+
+        /**
+        Executes a given pre-parsed command, reporting failures in the result instead of throwing.
+
+        Failures that Execute(ParseResults) would throw as a CommandSyntaxException, including ones thrown by commands and redirect modifiers,
+        are returned as ExecuteResult::error and ExecuteResult::cursor. Commands can fail without throwing with CommandContext::Fail().
+        Other exceptions, such as std::runtime_error, are not caught.
+
+        \param parse the result of a Parse(StringReader, Object)
+        \return the outcome of the command
+        \see Execute(ParseResults)
+        */
+        ExecuteResult TryExecute(ParseResults<S>& parse)
+        {
+            typename ExecuteBuffers::Lease buffers;
+            return Execute<false>(parse, *buffers);
+        }
+
+    private:
+        // Memory reused by the Execute calls of a thread
+        struct ExecuteBuffers
+        {
+            std::optional<ParseResults<S>> parse; // for Execute(StringReader, Object)
+            std::vector<CommandContext<S>> contexts;
+            std::vector<CommandContext<S>> next;
+
+            // Takes buffers for one call and gives them back afterwards. A command may call Execute again, so each call gets its own.
+            class Lease
+            {
+            public:
+                Lease()
+                {
+                    auto& pool = GetPool();
+                    if (!pool.empty()) {
+                        buffers = std::move(pool.back());
+                        pool.pop_back();
+                    }
+                }
+                ~Lease()
+                {
+                    buffers.contexts.clear();
+                    buffers.next.clear();
+                    Recycle(buffers.parse);
+                    auto& pool = GetPool();
+                    if (pool.size() < CACHED_BUFFERS) {
+                        pool.reserve(CACHED_BUFFERS);
+                        pool.push_back(std::move(buffers));
+                    }
+                }
+                Lease(Lease const&) = delete;
+                Lease& operator=(Lease const&) = delete;
+
+                inline ExecuteBuffers& operator*() { return buffers; }
+                inline ExecuteBuffers* operator->() { return &buffers; }
+            private:
+                static std::vector<ExecuteBuffers>& GetPool()
+                {
+                    static thread_local std::vector<ExecuteBuffers> pool;
+                    return pool;
+                }
+
+                ExecuteBuffers buffers;
+            };
+
+            static constexpr size_t CACHED_BUFFERS = 4; // per thread, enough for a few nested calls
+        };
+
+        // Runs a parsed command. A failure that ends the execution is thrown if `Throws`, otherwise it is returned.
+        template<bool Throws>
+        ExecuteResult Execute(ParseResults<S>& parse, ExecuteBuffers& buffers)
+        {
+            ExecuteResult status;
             if (parse.GetReader().CanRead()) {
-                if (parse.GetExceptions().size() == 1) {
-                    throw* parse.GetExceptions().begin();
+                if (auto error = GetSingleException(parse)) {
+                    return Abort<Throws>(status, *error, parse.GetReader().GetString());
                 }
                 else if (parse.GetContext().GetRange().IsEmpty()) {
-                    throw CommandSyntaxException::BuiltInExceptions::DispatcherUnknownCommand(parse.GetReader());
+                    return Abort<Throws>(status, SyntaxError::DispatcherUnknownCommand, parse.GetReader());
                 }
                 else {
-                    throw CommandSyntaxException::BuiltInExceptions::DispatcherUnknownArgument(parse.GetReader());
+                    return Abort<Throws>(status, SyntaxError::DispatcherUnknownArgument, parse.GetReader());
                 }
             }
 
@@ -2432,8 +5740,9 @@ namespace brigadier
             auto command = parse.GetReader().GetString();
             auto original = parse.GetContext();
             original.WithInput(command);
-            std::vector<CommandContext<S>> contexts = { original };
-            std::vector<CommandContext<S>> next;
+            std::vector<CommandContext<S>>& contexts = buffers.contexts;
+            std::vector<CommandContext<S>>& next = buffers.next;
+            contexts.push_back(original);
 
             while (!contexts.empty()) {
                 for (auto& context : contexts) {
@@ -2458,8 +5767,9 @@ namespace brigadier
                                 catch (CommandSyntaxException const& ex) {
                                     consumer(context, false, 0);
                                     if (!forked) {
-                                        throw ex;
+                                        return Abort<Throws>(status, ex);
                                     }
+                                    Record(status, ex);
                                 }
                             }
                         }
@@ -2468,30 +5778,118 @@ namespace brigadier
                         foundCommand = true;
                         try {
                             int value = context.GetCommand()(context);
-                            result += value;
-                            consumer(context, true, value);
-                            successfulForks++;
+                            if (!context.HasFailed()) {
+                                result += value;
+                                consumer(context, true, value);
+                                successfulForks++;
+                                continue;
+                            }
                         }
                         catch (CommandSyntaxException const& ex) {
                             consumer(context, false, 0);
                             if (!forked) {
-                                throw ex;
+                                return Abort<Throws>(status, ex);
                             }
+                            Record(status, ex);
+                            continue;
+                        }
+                        // failed with CommandContext::Fail()
+                        consumer(context, false, 0);
+                        if (!forked) {
+                            return Abort<Throws>(status, SyntaxError::DispatcherCommandFailed, nullptr);
                         }
+                        Record(status, SyntaxError::DispatcherCommandFailed, -1);
                     }
                 }
 
-                contexts = std::move(next);
+                contexts.swap(next);
+                next.clear();
             }
 
             if (!foundCommand) {
                 consumer(original, false, 0);
-                throw CommandSyntaxException::BuiltInExceptions::DispatcherUnknownCommand(parse.GetReader());
+                return Abort<Throws>(status, SyntaxError::DispatcherUnknownCommand, parse.GetReader());
+            }
+
+            status.result = forked ? successfulForks : result;
+            status.successes = successfulForks;
+            return status;
+        }
+
+        // Record of GetExceptions().begin()->second if there is exactly one exception, without creating the map
+        static ExceptionRecord const* GetSingleException(ParseResults<S> const& parse)
+        {
+            if (parse.errors.empty())
+                return nullptr;
+            for (auto& [node, record] : parse.errors) {
+                if (node != parse.errors.front().node)
+                    return nullptr;
+            }
+            return &parse.errors.front().record;
+        }
+
+        template<bool Throws>
+        static ExecuteResult Abort(ExecuteResult& status, CommandSyntaxException const& ex)
+        {
+            if constexpr (Throws) {
+                throw ex;
+            }
+            else {
+                Record(status, ex);
+                status.result = 0;
+                status.failed = true;
+                return status;
+            }
+        }
+
+        // Same as Abort() with the exception of a record, which is created only if it is thrown
+        template<bool Throws>
+        static ExecuteResult Abort(ExecuteResult& status, ExceptionRecord const& record, std::string_view input)
+        {
+            if constexpr (Throws) {
+                throw CommandSyntaxException(record, input);
+            }
+            else {
+                Record(status, record.GetError(), record.GetCursor());
+                status.result = 0;
+                status.failed = true;
+                return status;
+            }
+        }
+
+        // Same as Abort() with a built-in exception of the dispatcher, which is created only if it is thrown
+        template<bool Throws>
+        static ExecuteResult Abort(ExecuteResult& status, SyntaxError error, ExceptionContext ctx)
+        {
+            if constexpr (Throws) {
+                switch (error) {
+                case SyntaxError::DispatcherUnknownCommand:  throw CommandSyntaxException::BuiltInExceptions::DispatcherUnknownCommand(ctx);
+                case SyntaxError::DispatcherUnknownArgument: throw CommandSyntaxException::BuiltInExceptions::DispatcherUnknownArgument(ctx);
+                default:                                     throw CommandSyntaxException::BuiltInExceptions::DispatcherCommandFailed(ctx);
+                }
+            }
+            else {
+                Record(status, error, ctx.cursor);
+                status.result = 0;
+                status.failed = true;
+                return status;
             }
+        }
+
+        static void Record(ExecuteResult& status, CommandSyntaxException const& ex)
+        {
+            Record(status, ex.GetError(), ex.GetCursor());
+        }
 
-            return forked ? successfulForks : result;
+        static void Record(ExecuteResult& status, SyntaxError error, int cursor)
+        {
+            if (status.failures++ == 0) {
+                status.error = error;
+                status.cursor = cursor;
+            }
         }
 
+    public:
         /**
         Parses a given command.
 
@@ -2541,6 +5939,7 @@ namespace brigadier
         You may inspect ParseResults::GetExceptions() if you know the parse failed, as it will explain why it could
         not find any valid commands. It may contain multiple exceptions, one for each "potential node" that it could have visited,
         explaining why it did not go down that node.
+        The only exception is a parse exceeding the limits set in ParseOptions, which throws a CommandSyntaxException.
 
         When you eventually call Execute(ParseResults) with the result of this method, the above error checking
         will occur. You only need to inspect it yourself if you wish to handle that yourself.
@@ -2554,97 +5953,474 @@ namespace brigadier
         */
         ParseResults<S> Parse(StringReader& command, S source)
         {
-            ParseResults<S> result(CommandContext<S>(std::move(source), root.get(), command.GetCursor()), command);
-            ParseNodes(root.get(), result);
-            return result;
+            auto tree = GetRoot();
+            ParseResults<S> result(CommandContext<S>(std::move(source), tree.get(), command.GetCursor()), command);
+            Parse(std::move(tree), result);
+            return result;
+        }
+
+        /**
+        Parses a given command into the results of an earlier parse.
+
+        This is the same as Parse(String, Object), but the memory of `result` is reused instead of allocating new results.
+        Callers parsing many commands can keep one ParseResults, e.g. per thread, and parse every command into it.
+        If the context of `result` is still shared, e.g. with a copy made by a command, `result` gets a new context instead.
+
+        \param result results to overwrite, from an earlier call to Parse(String, Object) or this method
+        \param command a command string to parse
+        \param source a custom "source" object, usually representing the originator of this command
+        \see Parse(String, Object)
+        \see Execute(ParseResults)
+        */
+        void ParseInto(ParseResults<S>& result, std::string_view command, S source)
+        {
+            StringReader reader = StringReader(command);
+            ParseInto(result, reader, std::move(source));
+        }
+
+        /**
+        Parses a given command into the results of an earlier parse.
+
+        This is the same as Parse(StringReader, Object), but the memory of `result` is reused instead of allocating new results.
+        Callers parsing many commands can keep one ParseResults, e.g. per thread, and parse every command into it.
+        If the context of `result` is still shared, e.g. with a copy made by a command, `result` gets a new context instead.
+
+        \param result results to overwrite, from an earlier call to Parse(StringReader, Object) or this method
+        \param command a command string to parse
+        \param source a custom "source" object, usually representing the originator of this command
+        \see Parse(StringReader, Object)
+        \see Execute(ParseResults)
+        */
+        void ParseInto(ParseResults<S>& result, StringReader& command, S source)
+        {
+            auto tree = GetRoot();
+            if (IsReusable(result))
+                result.Reset(std::move(source), tree.get(), command.GetCursor(), command);
+            else
+                result = ParseResults<S>(CommandContext<S>(std::move(source), tree.get(), command.GetCursor()), command);
+            Parse(std::move(tree), result);
+        }
+
+    private:
+        void Parse(std::shared_ptr<RootCommandNode<S>> tree, ParseResults<S>& result)
+        {
+            // tokens are pooled like the frames, nested parses use the next ones
+            ParseStack& stack = GetParseStack();
+            if (stack.parses == stack.tokens.size())
+                stack.tokens.emplace_back();
+            StringTokens& tokens = stack.tokens[stack.parses++];
+            struct Release
+            {
+                ParseStack& stack;
+                StringTokens& tokens;
+                StringReader& reader;
+                ~Release()
+                {
+                    reader.SetTokens(nullptr);
+                    tokens.Trim(ParseStack::CACHED_WORDS);
+                    --stack.parses;
+                }
+            } release{ stack, tokens, result.reader };
+
+            tokens.Tokenize(result.reader.GetString());
+            result.reader.SetTokens(&tokens);
+            ParseState state{ tokens, GetPermissions(result.context.GetSource()) };
+            state.budget.maxVisits = parseOptions.maxNodeVisits;
+            if (parseOptions.maxTime > std::chrono::microseconds::zero()) {
+                state.budget.timed = true;
+                state.budget.deadline = std::chrono::steady_clock::now() + parseOptions.maxTime;
+            }
+            ParseNodes(tree.get(), result, state);
+            result.tree = std::move(tree);
+        }
+
+        // Result of parsing below a node at a position, see ParseOptions::memoize
+        struct ParseMemo
+        {
+            bool matched = false; // the context contains the best potential, otherwise only exceptions are reported
+            int cursor = 0;
+            CommandContext<S> context;
+            typename ParseResults<S>::Errors exceptions;
+        };
+
+        // Data shared by all levels of one Parse call. The source does not change while parsing, so neither do its permissions.
+        struct ParseState
+        {
+            StringTokens const& tokens;
+            PermissionMask permissions = 0;
+            std::map<std::pair<CommandNode<S>*, int>, ParseMemo> memo;
+            ParseBudget budget;
+            size_t redirectDepth = 0;
+        };
+
+        // Branches on the node kind so that literals are matched inline and arguments call the parse function of their type directly.
+        // Literals and built-in argument types report failures in `error`, other nodes throw them.
+        static inline bool ParseChild(CommandNode<S>* child, StringReader& reader, CommandContext<S>& context, ExceptionRecord& error)
+        {
+            switch (child->GetNodeType()) {
+            case CommandNodeType::LiteralCommandNode:
+                return static_cast<LiteralCommandNode<S>*>(child)->TryParseLiteral(reader, context, error);
+            case CommandNodeType::ArgumentCommandNode:
+                return static_cast<IArgumentCommandNode<S>*>(child)->TryParseArgument(reader, context, error);
+            default:
+                child->Parse(reader, context);
+                return true;
+            }
+        }
+
+        // Parses a child and checks that it ends before a separator. Returns false with the failure in `error`,
+        // exceptions of custom argument types are caught here, so the candidates of built-in types are tried without any.
+        static inline bool ParseCandidate(CommandNode<S>* child, StringReader& reader, CommandContext<S>& context, ExceptionRecord& error)
+        {
+            try {
+                if (!ParseChild(child, reader, context, error))
+                    return false;
+            }
+            catch (CommandSyntaxException const& ex) {
+                error = ExceptionRecord(ex);
+                return false;
+            }
+            catch (std::runtime_error const& ex) {
+                error = ExceptionRecord(reader, SyntaxError::DispatcherParseException, ex.what());
+                return false;
+            }
+            if (reader.CanRead() && reader.Peek() != ARGUMENT_SEPARATOR_CHAR) {
+                error = ExceptionRecord(reader, SyntaxError::DispatcherExpectedArgumentSeparator);
+                return false;
+            }
+            return true;
+        }
+
+        // Checks if the child is an argument whose type cannot parse input starting with `next` (-1 at the end of input)
+        static inline bool IsInadmissible(CommandNode<S>* child, int next)
+        {
+            return next >= 0 && child->GetNodeType() == CommandNodeType::ArgumentCommandNode
+                && !static_cast<IArgumentCommandNode<S>*>(child)->CanStartWith(char(next));
+        }
+
+        enum class ParseStep
+        {
+            Candidates, // trying children of the node
+            Child, // waiting for the subtree of the current candidate
+            Redirect // waiting for the redirect target of the current candidate, which ends this level
+        };
+
+        // One level of ParseNodes, kept on an explicit stack instead of the call stack
+        struct ParseFrame
+        {
+            CommandNode<S>* node = nullptr;
+            ParseResults<S>* result = nullptr; // receives the outcome of this level
+            ParseResults<S>* target = nullptr; // with memoization `result` points to `scratch`, and the stored outcome is applied to `target`
+            std::optional<ParseResults<S>> scratch;
+            std::optional<ParseResults<S>> best_potential;
+            bool has_best_potential = false; // best_potential may hold recycled storage only
+            std::optional<ParseResults<S>> current_result_ctx;
+            std::optional<ParseResults<S>> redirect_result;
+            std::shared_ptr<CommandNode<S>>* relevant_nodes = nullptr;
+            size_t relevant_node_count = 0;
+            size_t index = 0; // of the current candidate in relevant_nodes
+            size_t redirect_scan = 0; // in fast mode, candidates before it have been checked for redirects, see IsFinished()
+            int cursor = 0;
+            int next = -1;
+            bool skipped = false;
+            ParseStep step = ParseStep::Candidates;
+        };
+
+        // Frames of all parses on a thread. Nested parses (e.g. from a requirement) continue above the frames of the outer one.
+        struct ParseStack
+        {
+            static constexpr size_t CACHED_FRAMES = 64; // kept allocated between parses
+            static constexpr size_t CACHED_WORDS = 1024; // same for the words of long inputs
+
+            std::deque<ParseFrame> frames; // references stay valid when frames are added
+            size_t size = 0;
+            std::deque<StringTokens> tokens; // one per parse in progress
+            size_t parses = 0;
+        };
+
+        static ParseStack& GetParseStack()
+        {
+            static thread_local ParseStack stack;
+            return stack;
+        }
+
+        void ParseNodes(CommandNode<S>* node, ParseResults<S>& result, ParseState& state)
+        {
+            ParseStack& stack = GetParseStack();
+            size_t base = stack.size;
+            struct Unwind
+            {
+                ParseStack& stack;
+                size_t base;
+                ~Unwind()
+                {
+                    while (stack.size > base) {
+                        RecycleFrame(stack.frames[--stack.size]);
+                    }
+                    if (base == 0 && stack.frames.size() > ParseStack::CACHED_FRAMES) {
+                        stack.frames.resize(ParseStack::CACHED_FRAMES);
+                    }
+                }
+            } unwind{ stack, base };
+
+            if (!PushFrame(stack, node, result, state))
+                return;
+
+            while (stack.size > base) {
+                ParseFrame& frame = stack.frames[stack.size - 1];
+                ParseResults<S>& level = *frame.result;
+
+                if (frame.step == ParseStep::Redirect) {
+                    --state.redirectDepth;
+                    level.context.Merge(std::move(frame.current_result_ctx->context));
+                    level.context.WithChildContext(std::move(frame.redirect_result->context));
+                    level.SetExceptions(std::move(frame.redirect_result->errors));
+                    level.reader = std::move(frame.redirect_result->reader);
+                    PopFrame(stack, state);
+                    continue;
+                }
+                if (frame.step == ParseStep::Child) {
+                    frame.step = ParseStep::Candidates;
+                    KeepBest(frame);
+                    ++frame.index;
+                }
+                if (ParseCandidates(frame, stack, state))
+                    continue;
+
+                if (frame.has_best_potential) {
+                    level.ClearExceptions();
+                    level.reader = std::move(frame.best_potential->reader);
+                    level.context.Merge(std::move(frame.best_potential->context));
+                }
+                else if (frame.skipped && !parseOptions.fastMode) {
+                    ReportSkipped(frame, state);
+                }
+                PopFrame(stack, state);
+            }
+        }
+
+        // Starts parsing below a node. Returns false if the outcome is already known, so no frame was added.
+        bool PushFrame(ParseStack& stack, CommandNode<S>* node, ParseResults<S>& result, ParseState& state)
+        {
+            if (!node)
+                return false;
+
+            int cursor = result.reader.GetCursor();
+            if (parseOptions.memoize) {
+                auto memo = state.memo.find(std::make_pair(node, cursor));
+                if (memo != state.memo.end()) {
+                    ApplyMemo(memo->second, result);
+                    return false;
+                }
+            }
+
+            if (stack.size == stack.frames.size())
+                stack.frames.emplace_back();
+            ParseFrame& frame = stack.frames[stack.size++];
+            frame.node = node;
+            frame.target = &result;
+            if (parseOptions.memoize) {
+                frame.scratch.emplace(CommandContext<S>(result.context.GetSource(), result.context.GetRootNode(), cursor), result.reader);
+                frame.result = &*frame.scratch;
+            }
+            else frame.result = &result;
+
+            auto [relevant_nodes, relevant_node_count] = node->GetRelevantNodes(state.tokens.GetWord(cursor));
+            frame.relevant_nodes = relevant_nodes;
+            frame.relevant_node_count = relevant_node_count;
+            frame.index = 0;
+            frame.redirect_scan = 0;
+            frame.cursor = cursor;
+            frame.next = result.reader.CanRead() ? static_cast<unsigned char>(result.reader.Peek()) : -1;
+            frame.skipped = false;
+            frame.has_best_potential = false;
+            frame.step = ParseStep::Candidates;
+            return true;
+        }
+
+        // Finishes the top frame, storing its outcome if memoization is enabled
+        void PopFrame(ParseStack& stack, ParseState& state)
+        {
+            ParseFrame& frame = stack.frames[stack.size - 1];
+            if (frame.scratch.has_value()) {
+                ParseResults<S>& scratch = *frame.scratch;
+                bool matched = scratch.context.HasNodes();
+                int cursor = scratch.reader.GetCursor();
+                auto memo = state.memo.emplace(std::make_pair(frame.node, frame.cursor), ParseMemo{ matched, cursor, std::move(scratch.context), std::move(scratch.errors) }).first;
+                ApplyMemo(memo->second, *frame.target);
+            }
+            RecycleFrame(frame);
+            --stack.size;
         }
 
-    private:
-        void ParseNodes(CommandNode<S>* node, ParseResults<S>& result)
+        // Frames keep the storage of their candidates for the next node parsed at the same depth, on this or a later parse.
+        // Parsed data and the source are released right away, so a pooled frame does not keep e.g. a player handle alive.
+        static void RecycleFrame(ParseFrame& frame)
         {
-            if (!node)
+            frame.scratch.reset();
+            Recycle(frame.best_potential);
+            Recycle(frame.current_result_ctx);
+            Recycle(frame.redirect_result);
+        }
+
+        static void Recycle(std::optional<ParseResults<S>>& slot)
+        {
+            if (!slot.has_value())
+                return;
+            if (!IsReusable(*slot)) {
+                // the context was handed over, e.g. as the child context of a redirect
+                slot.reset();
+                return;
+            }
+            if constexpr (!std::is_default_constructible_v<S>) {
+                // the source cannot be released without the context holding it
+                slot.reset();
                 return;
+            }
+            else {
+                slot->ClearExceptions();
+                slot->tree = nullptr;
+                slot->context.Reset();
+                slot->context.source = S();
+            }
+        }
 
-            S& source = result.context.GetSource();
+        static bool IsReusable(ParseResults<S> const& results)
+        {
+            return results.context.context && results.context.context.use_count() == 1;
+        }
 
-            std::optional<ParseResults<S>> best_potential = {};
-            std::optional<ParseResults<S>> current_result_ctx = {}; // delay initialization
+        // Resets a candidate to the state of the parent, reusing its storage if there is any
+        static ParseResults<S>& Prepare(std::optional<ParseResults<S>>& slot, S const& source, CommandNode<S>* root, StringRange range, StringReader const& reader)
+        {
+            if (slot.has_value() && IsReusable(*slot))
+                slot->Reset(source, root, range, reader);
+            else
+                slot.emplace(CommandContext<S>(source, root, range), reader);
+            return *slot;
+        }
 
-            int cursor = result.reader.GetCursor();
+        static void ApplyMemo(ParseMemo const& memo, ParseResults<S>& result)
+        {
+            if (memo.matched) {
+                result.SetExceptions(memo.exceptions);
+                result.reader.SetCursor(memo.cursor);
+                result.context.Merge(memo.context.Clone());
+            }
+            else {
+                for (auto& [child, ex] : memo.exceptions) {
+                    result.AddException(child, ex);
+                }
+            }
+        }
+
+        static void KeepBest(ParseFrame& frame)
+        {
+            // swapped rather than moved, because a moved-from context still shares its data with the new owner,
+            // and resetting it for the next candidate would clear the best potential
+            if (!frame.has_best_potential || frame.current_result_ctx->IsBetterThan(*frame.best_potential)) {
+                std::swap(frame.best_potential, frame.current_result_ctx);
+                frame.has_best_potential = true;
+            }
+        }
 
-            auto [relevant_nodes, relevant_node_count] = node->GetRelevantNodes(result.reader);
+        // In fast mode, a candidate that parsed the rest of the input without errors ends the frame, because ParseResults::IsBetterThan
+        // would not prefer any later sibling over it. A later sibling with a redirect is not compared though, it takes over the level
+        // once parsed (see ParseNodes()), so the frame goes on while any remaining candidate has one.
+        inline bool IsFinished(ParseFrame& frame) const
+        {
+            if (!parseOptions.fastMode || !frame.has_best_potential || frame.best_potential->reader.CanRead() || frame.best_potential->HasExceptions())
+                return false;
+            // each candidate is checked once, the scan stops at the next redirect until the candidates reach it
+            for (; frame.redirect_scan < frame.relevant_node_count; ++frame.redirect_scan) {
+                if (frame.redirect_scan >= frame.index && frame.relevant_nodes[frame.redirect_scan]->redirect != nullptr)
+                    return false;
+            }
+            return true;
+        }
 
-            for (size_t i = 0; i < relevant_node_count; ++i) {
-                auto& child = relevant_nodes[i];
+        // Tries the remaining candidates of a frame. Returns true when it has to wait for a subtree or a redirect target first.
+        bool ParseCandidates(ParseFrame& frame, ParseStack& stack, ParseState& state)
+        {
+            ParseResults<S>& result = *frame.result;
+            S& source = result.context.GetSource();
 
-                if (!child->CanUse(source)) {
-                    continue;
+            for (; frame.index < frame.relevant_node_count; ++frame.index) {
+                if (IsFinished(frame)) {
+                    frame.index = frame.relevant_node_count;
+                    break;
                 }
+                auto& child = frame.relevant_nodes[frame.index];
 
-                // initialize current context
-                if (current_result_ctx.has_value()) {
-                    // context already exists so we have to reset it (avoid memory reallocation)
-                    current_result_ctx->Reset(source, result.context.GetRootNode(), result.GetContext().GetRange(), result.GetReader());
+                if (IsInadmissible(child.get(), frame.next)) {
+                    frame.skipped = true;
+                    continue;
                 }
-                else {
-                    // create context
-                    current_result_ctx = ParseResults<S>(CommandContext<S>(source, result.GetContext().GetRootNode(), result.GetContext().GetRange()), result.GetReader());
+
+                if (!child->CanUse(source, state.permissions)) {
+                    continue;
                 }
 
-                auto& current_result = current_result_ctx.value();
+                state.budget.Visit(result.reader);
+
+                // the current and the best candidate swap their storage, so no sibling allocates a new context
+                auto& current_result = Prepare(frame.current_result_ctx, source, result.context.GetRootNode(), result.GetContext().GetRange(), result.GetReader());
 
                 StringReader& reader = current_result.reader;
                 CommandContext<S>& context = current_result.context;
 
-                try {
-                    try {
-                        child->Parse(reader, context);
-                    }
-                    catch (std::runtime_error const& ex) {
-                        throw CommandSyntaxException::BuiltInExceptions::DispatcherParseException(reader, ex.what());
-                    }
-                    if (reader.CanRead() && reader.Peek() != ARGUMENT_SEPARATOR_CHAR) {
-                        throw CommandSyntaxException::BuiltInExceptions::DispatcherExpectedArgumentSeparator(reader);
-                    }
-                }
-                catch (CommandSyntaxException ex) {
-                    result.exceptions.emplace(child.get(), std::move(ex));
-                    reader.SetCursor(cursor);
+                ExceptionRecord error;
+                if (!ParseCandidate(child.get(), reader, context, error)) {
+                    if (!parseOptions.fastMode)
+                        result.AddException(child.get(), std::move(error));
+                    reader.SetCursor(frame.cursor);
                     continue;
                 }
 
                 context.WithCommand(child->GetCommand());
 
-                if (reader.CanRead(child->GetRedirect() == nullptr ? 2 : 1)) {
+                // most nodes have no redirect, so the target is only looked up for the ones that have
+                CommandNode<S>* redirect = child->redirect == nullptr ? nullptr : child->GetRedirect().get();
+                if (reader.CanRead(redirect == nullptr ? 2 : 1)) {
                     reader.Skip();
-                    if (child->GetRedirect() != nullptr) {
-                        ParseResults<S> child_result(CommandContext<S>(source, child->GetRedirect().get(), reader.GetCursor()), reader);
-                        ParseNodes(child->GetRedirect().get(), child_result);
-                        result.context.Merge(std::move(context));
-                        result.context.WithChildContext(std::move(child_result.context));
-                        result.exceptions = std::move(child_result.exceptions);
-                        result.reader = std::move(child_result.reader);
-                        return;
+                    if (redirect != nullptr) {
+                        if (parseOptions.maxRedirectDepth > 0 && state.redirectDepth >= parseOptions.maxRedirectDepth) {
+                            throw CommandSyntaxException::BuiltInExceptions::DispatcherParseBudgetExceeded(reader, "redirect limit");
+                        }
+                        Prepare(frame.redirect_result, source, redirect, StringRange::At(reader.GetCursor()), reader);
+                        ++state.redirectDepth;
+                        frame.step = ParseStep::Redirect;
+                        PushFrame(stack, redirect, *frame.redirect_result, state);
+                        return true;
                     }
-                    else {
-                        ParseNodes(child.get(), current_result);
+                    else if (!child->ParseCompiled(reader, context, state.permissions, state.budget)) {
+                        frame.step = ParseStep::Child;
+                        PushFrame(stack, child.get(), current_result, state);
+                        return true;
                     }
                 }
 
-                if (best_potential.has_value()) {
-                    if (current_result.IsBetterThan(*best_potential)) {
-                        best_potential = std::move(current_result_ctx);
-                    }
-                }
-                else {
-                    best_potential = std::move(current_result_ctx);
-                }
+                KeepBest(frame);
             }
+            return false;
+        }
+
+        // Nothing matched, so the skipped arguments are parsed after all to explain why they failed
+        void ReportSkipped(ParseFrame& frame, ParseState& state)
+        {
+            ParseResults<S>& result = *frame.result;
+            S& source = result.context.GetSource();
+            for (size_t i = 0; i < frame.relevant_node_count; ++i) {
+                auto& child = frame.relevant_nodes[i];
+                if (!IsInadmissible(child.get(), frame.next) || !child->CanUse(source, state.permissions)) {
+                    continue;
+                }
 
-            if (best_potential.has_value()) {
-                result.exceptions.clear();
-                result.reader = std::move(best_potential->reader);
-                result.context.Merge(std::move(best_potential->context));
+                auto& candidate = Prepare(frame.current_result_ctx, source, result.context.GetRootNode(), result.GetContext().GetRange(), result.GetReader());
+                ExceptionRecord error;
+                if (!ParseCandidate(child.get(), candidate.reader, candidate.context, error)) {
+                    result.AddException(child.get(), std::move(error));
+                }
             }
         }
 
@@ -2671,18 +6447,24 @@ namespace brigadier
         std::vector<std::string> GetAllUsage(CommandNode<S>* node, S source, bool restricted)
         {
             std::vector<std::string> result;
-            GetAllUsage(node, std::move(source), result, {}, restricted);
+            PermissionMask permissions = GetPermissions(source);
+            GetAllUsage(node, std::move(source), permissions, result, {}, restricted);
             return result;
         }
 
     private:
-        void GetAllUsage(CommandNode<S>* node, S source, std::vector<std::string>& result, std::string prefix, bool restricted)
+        void GetAllUsage(CommandNode<S>* node, S source, PermissionMask permissions, std::vector<std::string>& result, std::string prefix, bool restricted)
         {
             if (!node)
                 return;
 
-            if (restricted && !node->CanUse(source))
-                return;
+            if (restricted) {
+                if (!node->CanUse(source, permissions))
+                    return;
+                // whole subtree is usable, no need to check nodes below
+                if (node->CanUseSubtree(permissions))
+                    restricted = false;
+            }
 
             if (node->GetCommand())
                 result.push_back(prefix);
@@ -2709,7 +6491,7 @@ namespace brigadier
                         next_prefix += ARGUMENT_SEPARATOR;
                     }
                     next_prefix += child->GetUsageText();
-                    GetAllUsage(child.get(), std::move(source), result, std::move(next_prefix), restricted);
+                    GetAllUsage(child.get(), source, permissions, result, std::move(next_prefix), restricted);
                 }
             }
         }
@@ -2737,9 +6519,10 @@ namespace brigadier
         std::map<CommandNode<S>*, std::string> GetSmartUsage(CommandNode<S>* node, S source)
         {
             std::map<CommandNode<S>*, std::string> result;
+            PermissionMask permissions = GetPermissions(source);
 
             for (auto const& [name, child] : node->GetChildren()) {
-                std::string usage = GetSmartUsage(child.get(), std::move(source), node->GetCommand() != nullptr, false);
+                std::string usage = GetSmartUsage(child.get(), source, permissions, node->GetCommand() != nullptr, false);
                 if (!usage.empty()) {
                     result[child.get()] = std::move(usage);
                 }
@@ -2748,12 +6531,12 @@ namespace brigadier
         }
 
     private:
-        std::string GetSmartUsage(CommandNode<S>* node, S source, bool optional, bool deep)
+        std::string GetSmartUsage(CommandNode<S>* node, S source, PermissionMask permissions, bool optional, bool deep)
         {
             if (!node)
                 return {};
 
-            if (!node->CanUse(source))
+            if (!node->CanUse(source, permissions))
                 return {};
 
             std::string self;
@@ -2784,12 +6567,12 @@ namespace brigadier
                 else {
                     std::vector<CommandNode<S>*> children;
                     for (auto const& [name, child] : node->GetChildren()) {
-                        if (child->CanUse(source)) {
+                        if (child->CanUse(source, permissions)) {
                             children.push_back(child.get());
                         }
                     }
                     if (children.size() == 1) {
-                        std::string usage = GetSmartUsage(children[0], source, childOptional, childOptional);
+                        std::string usage = GetSmartUsage(children[0], source, permissions, childOptional, childOptional);
                         if (!usage.empty()) {
                             self += ARGUMENT_SEPARATOR;
                             self += std::move(usage);
@@ -2799,7 +6582,7 @@ namespace brigadier
                     else if (children.size() > 1) {
                         std::set<std::string> childUsage;
                         for (auto child : children) {
-                            std::string usage = GetSmartUsage(child, source, childOptional, true);
+                            std::string usage = GetSmartUsage(child, source, permissions, childOptional, true);
                             if (!usage.empty()) {
                                 childUsage.insert(usage);
                             }
@@ -2879,7 +6662,8 @@ namespace brigadier
         */
         std::future<Suggestions> GetCompletionSuggestions(ParseResults<S>& parse, int cursor, bool* cancel = nullptr)
         {
-            return std::async(std::launch::async, [](ParseResults<S>* parse, int cursor, bool* cancel) {
+            PermissionMask permissions = GetPermissions(parse.GetContext().GetSource());
+            return std::async(std::launch::async, [](ParseResults<S>* parse, int cursor, PermissionMask permissions, bool* cancel) {
                 auto context = parse->GetContext();
 
                 SuggestionContext<S> nodeBeforeCursor = context.FindSuggestionContext(cursor);
@@ -2899,6 +6683,8 @@ namespace brigadier
                 futures.reserve(max_size);
                 builders.reserve(max_size);
                 for (auto const& [name, node] : parent->GetChildren()) {
+                    if (!node->HasPermissions(permissions))
+                        continue;
                     try {
                         builders.emplace_back(truncatedInput, truncatedInputLowerCase, start, cancel);
                         futures.push_back(node->ListSuggestions(context, builders.back()));
@@ -2912,7 +6698,7 @@ namespace brigadier
                     suggestions.emplace_back(future.get());
                 }
                 return Suggestions::Merge(fullInput, suggestions);
-                }, &parse, cursor, cancel);
+            }, &parse, cursor, permissions, cancel);
         }
 
         /**
@@ -2940,7 +6726,7 @@ namespace brigadier
                     result.reserve(list.size());
                     for (auto node : list) {
                         if (node != root.get()) {
-                            result.push_back(node->GetName());
+                            result.emplace_back(node->GetName());
                         }
                     }
                     return result;
@@ -2964,7 +6750,7 @@ namespace brigadier
         CommandNode<S>* FindNode(std::vector<std::string> const& path) {
             CommandNode<S>* node = root.get();
             for (auto& name : path) {
-                node = node->GetChild(name);
+                node = node->GetChild(name).get();
                 if (node == nullptr) {
                     return nullptr;
                 }
@@ -2988,6 +6774,522 @@ namespace brigadier
             root->FindAmbiguities(consumer);
         }
 
+    public:
+        /**
+        Defines a permission class: a group of sources that are granted the same permissions, such as an operator level.
+
+        Sources of the same class share one filtered view of the command tree (see GetFilteredRoot(size_t)),
+        instead of filtering the whole tree for each of them. Redefining a class with different permissions invalidates its view.
+
+        \param id identifier of the class
+        \param permissions permissions granted to sources of this class
+        */
+        void SetPermissionClass(size_t id, PermissionMask permissions)
+        {
+            auto& permissionClass = permissionClasses[id];
+            if (permissionClass.root != nullptr && permissionClass.permissions == permissions)
+                return;
+            permissionClass.permissions = permissions;
+            permissionClass.root = nullptr;
+        }
+
+        /**
+        Removes a permission class together with its cached view.
+
+        \param id identifier of the class
+        */
+        void RemovePermissionClass(size_t id)
+        {
+            permissionClasses.erase(id);
+        }
+
+        /**
+        Gets a read-only view of the command tree, containing only the nodes usable with permissions of a given permission class.
+
+        The view is built on first use and cached until either the command tree or the class changes.
+        Subtrees fully usable by the class are shared with the command tree, the remaining nodes are copies.
+        Shared subtrees are copied before the command tree modifies them, the same way as nodes shared with a copy of the dispatcher,
+        so builders obtained before cannot modify them any more (see CommandDispatcher(CommandDispatcher const&)).
+        Predicate requirements (ArgumentBuilder::Requires(Predicate)) cannot be checked without a source, so nodes having them are kept.
+        Redirects point to nodes of the view, or nowhere if their target is not a part of it.
+
+        The view cannot be modified.
+
+        \param id identifier of the class
+        \return root of the filtered tree, or nullptr if the class is not defined
+        */
+        std::shared_ptr<RootCommandNode<S>> GetFilteredRoot(size_t id)
+        {
+            auto found = permissionClasses.find(id);
+            if (found == permissionClasses.end())
+                return nullptr;
+
+            auto& permissionClass = found->second;
+            auto current = GetRoot();
+            size_t revision = current->GetSubtreeRevision();
+            if (permissionClass.root == nullptr || permissionClass.revision != revision) {
+                permissionClass.root = FilterTree(current, permissionClass.permissions);
+                permissionClass.revision = revision;
+            }
+            return permissionClass.root;
+        }
+
+    public:
+        /**
+        Gets the current version of the command tree.
+
+        The version grows with every change of the tree: added or removed nodes and changed commands, requirements or redirects.
+        Pass it to GetDelta(size_t) later to find out what changed since.
+
+        \return version of the command tree
+        */
+        size_t GetVersion()
+        {
+            return root->GetSubtreeRevision();
+        }
+
+        /**
+        Computes changes made to the command tree since a given version.
+
+        Only subtrees that changed since that version are visited, so the result is proportional to the number of changes.
+        Added and removed nodes are reported once for their whole subtree. The delta is net: a node added and removed again
+        since that version is not reported, and a node removed and added again is reported as added, which replaces it.
+        Version 0 reports every command as added.
+
+        Each node remembers about as many removed children as it has children, plus a fixed number. If older removals were
+        forgotten, the node is reported as added instead, with an empty path for the root.
+
+        \param since a version previously returned by GetVersion()
+        \return changes between the given and the current version
+        */
+        CommandTreeDelta<S> GetDelta(size_t since)
+        {
+            CommandTreeDelta<S> delta(since, GetVersion());
+            std::vector<std::string> path;
+            if (root->removedHorizon > since)
+                delta.entries.push_back({ CommandTreeChange::Added, path, root });
+            else
+                CollectDelta(root.get(), since, path, delta);
+            return delta;
+        }
+
+        /**
+        Forgets removals made before a given version.
+
+        Removed nodes are remembered by their parents, so that GetDelta(size_t) can report them. Their number is bounded,
+        see GetDelta(size_t), so calling this is optional. Call it once no one will ask for a delta since an older version. Visits the whole tree.
+
+        \param version the oldest version deltas will be computed from
+        */
+        void PruneDeltaHistory(size_t version)
+        {
+            PruneDeltaHistory(root.get(), version);
+        }
+
+    public:
+        /**
+        Merges structurally identical subtrees of the command tree, e.g. the same argument chains registered under many literals.
+
+        Nodes are identical if they have the same name, type, argument type parameters, custom suggestions, command,
+        requirements and redirect, and their children are identical. Merged nodes have several parents, so they are copied
+        before being modified through any of them, the same way as nodes shared by copies of a dispatcher.
+        Nodes of argument types that cannot be compared (see ArgumentParameters) and redirect targets are kept as they are.
+
+        Visits the whole tree once. It is best called after the tree is built, before the dispatcher is copied.
+
+        \return estimated number of bytes freed, counted the same way as by MemoryStats(size_t)
+        */
+        size_t Deduplicate()
+        {
+            OwnRoot();
+            DeduplicationState state{ { owner } };
+            std::set<CommandNode<S>*> visited;
+            ForEachRedirect(root.get(), visited, [&state](CommandNode<S>* source) { state.targets.insert(source->redirect.get()); });
+            DeduplicateNode(root, state);
+            RelinkRedirects(root, state.reload);
+            return state.saved;
+        }
+
+    public:
+        /**
+        Walks the command tree and estimates how much memory it uses.
+
+        \param fanOutCount number of nodes with the most children to report
+        \return memory used by nodes of each type, their strings, containers and control blocks
+        */
+        CommandTreeMemoryStats MemoryStats(size_t fanOutCount = 10)
+        {
+            CommandTreeMemoryStats stats;
+            std::set<CommandNode<S>*> visited;
+            std::set<std::string_view> names;
+            std::vector<std::string> path;
+            CountMemory(GetRoot().get(), stats, fanOutCount, visited, names, path);
+            for (auto name : names) {
+                stats.stringBytes += StringInterner::GetMemoryUsage(name);
+            }
+            return stats;
+        }
+
+    private:
+        // Names are collected in a set, so a name used by several nodes is counted once
+        void CountMemory(CommandNode<S>* node, CommandTreeMemoryStats& stats, size_t fanOutCount, std::set<CommandNode<S>*>& visited, std::set<std::string_view>& names, std::vector<std::string>& path)
+        {
+            if (!visited.insert(node).second)
+                return;
+
+            CountNodeMemory(node, stats);
+            names.insert(node->name);
+            for (auto& [name, removed] : node->removedChildren) {
+                names.insert(name);
+            }
+            switch (node->GetNodeType()) {
+            case CommandNodeType::RootCommandNode:     ++stats.rootNodes;     break;
+            case CommandNodeType::LiteralCommandNode:  ++stats.literalNodes;  names.insert(static_cast<LiteralCommandNode<S>*>(node)->lowerCase); break;
+            case CommandNodeType::ArgumentCommandNode: ++stats.argumentNodes; break;
+            }
+
+            auto& fanOut = stats.largestFanOut;
+            size_t children = node->children.size();
+            if (children > 0 && (fanOut.size() < fanOutCount || children > fanOut.back().children)) {
+                auto position = std::upper_bound(fanOut.begin(), fanOut.end(), children, [](size_t count, auto const& entry) { return count > entry.children; });
+                fanOut.insert(position, { path, children });
+                if (fanOut.size() > fanOutCount)
+                    fanOut.pop_back();
+            }
+
+            for (auto& [name, child] : node->children) {
+                path.emplace_back(name);
+                CountMemory(child.get(), stats, fanOutCount, visited, names, path);
+                path.pop_back();
+            }
+        }
+
+        // Counts memory used by a node alone, without its children and names, see CommandTreeMemoryStats.
+        // Used by MemoryStats() and to estimate the memory freed by Deduplicate().
+        static void CountNodeMemory(CommandNode<S>* node, CommandTreeMemoryStats& stats)
+        {
+            // layouts of the standard library are not visible, these are the sizes used by the common implementations
+            constexpr size_t CONTROL_BLOCK_SIZE = sizeof(void*) + 2 * sizeof(long); // virtual table and both counters, allocated with the node by std::make_shared
+            constexpr size_t MAP_NODE_SIZE = 3 * sizeof(void*) + sizeof(void*) + sizeof(typename decltype(node->children)::value_type); // links, color and the entry
+            stats.objectBytes += node->GetObjectSize();
+            stats.controlBlockBytes += CONTROL_BLOCK_SIZE;
+            stats.containerBytes += node->children.size() * MAP_NODE_SIZE;
+            stats.containerBytes += node->literals.capacity() * sizeof(node->literals[0]);
+            stats.containerBytes += node->arguments.capacity() * sizeof(node->arguments[0]);
+            stats.containerBytes += node->removedChildren.size() * (4 * sizeof(void*) + sizeof(typename decltype(node->removedChildren)::value_type));
+            stats.containerBytes += node->parents.capacity() * sizeof(node->parents[0]);
+        }
+
+    private:
+        void PruneDeltaHistory(CommandNode<S>* node, size_t version)
+        {
+            auto& removed = node->removedChildren;
+            for (auto entry = removed.begin(); entry != removed.end();) {
+                if (entry->second.removed <= version)
+                    entry = removed.erase(entry);
+                else
+                    ++entry;
+            }
+            for (auto& [name, child] : node->children) {
+                PruneDeltaHistory(child.get(), version);
+            }
+        }
+
+        void CollectDelta(CommandNode<S>* node, size_t since, std::vector<std::string>& path, CommandTreeDelta<S>& delta)
+        {
+            for (auto& [name, removed] : node->removedChildren) {
+                // children added after `since` did not exist then, and children added again are reported as added below
+                if (removed.attached <= since && removed.removed > since && node->children.count(name) == 0) {
+                    path.emplace_back(name);
+                    delta.entries.push_back({ CommandTreeChange::Removed, path, nullptr });
+                    path.pop_back();
+                }
+            }
+            for (auto& [name, child] : node->children) {
+                if (child->GetSubtreeRevision() <= since)
+                    continue;
+
+                path.emplace_back(name);
+                if (child->attachRevision > since || child->removedHorizon > since) {
+                    delta.entries.push_back({ CommandTreeChange::Added, path, child });
+                }
+                else {
+                    if (child->revision > since) {
+                        delta.entries.push_back({ CommandTreeChange::Changed, path, child });
+                    }
+                    CollectDelta(child.get(), since, path, delta);
+                }
+                path.pop_back();
+            }
+        }
+
+    private:
+        static void CollectSubtree(CommandNode<S>* node, std::set<CommandNode<S>*>& nodes)
+        {
+            if (!nodes.insert(node).second)
+                return;
+            for (auto& [name, child] : node->children) {
+                CollectSubtree(child.get(), nodes);
+            }
+        }
+
+        // Calls `visit` for every node of the tree that has a redirect, skipping subtrees without any
+        template<typename F>
+        static void ForEachRedirect(CommandNode<S>* node, std::set<CommandNode<S>*>& visited, F&& visit)
+        {
+            if (!node->subtree.redirect || !visited.insert(node).second)
+                return;
+            if (node->redirect != nullptr)
+                visit(node);
+            for (auto& [name, child] : node->children) {
+                ForEachRedirect(child.get(), visited, visit);
+            }
+        }
+
+        // Gets the root for modification, copying it first if it is shared with another dispatcher
+        RootCommandNode<S>* OwnRoot()
+        {
+            if (owner == nullptr || owner->IsSealed() || root->owner != owner) {
+                owner = std::make_shared<CommandTreeOwner>();
+                ReloadState state{ owner };
+                auto copy = CopyNode(root, state);
+                RelinkRedirects(copy, state);
+                std::atomic_store(&root, std::static_pointer_cast<RootCommandNode<S>>(std::move(copy)));
+            }
+            return root.get();
+        }
+
+        struct ReloadState
+        {
+            std::shared_ptr<CommandTreeOwner> owner; // owner of the copies
+            std::map<CommandNode<S>*, std::shared_ptr<CommandNode<S>>> copies; // original -> copy
+            std::set<CommandNode<S>*> owned; // copies that are not published yet, so they can be modified
+        };
+
+        static std::shared_ptr<CommandNode<S>> CopyNode(std::shared_ptr<CommandNode<S>> const& node, ReloadState& state)
+        {
+            auto copy = node->Clone();
+            copy->owner = state.owner;
+            state.copies.emplace(node.get(), copy);
+            state.owned.insert(copy.get());
+            return copy;
+        }
+
+        // Moves redirects of the tree to copies of their targets
+        static void RelinkRedirects(std::shared_ptr<CommandNode<S>> const& root, ReloadState& state)
+        {
+            // copies of redirecting nodes may be redirect targets themselves, so repeat until nothing is copied
+            size_t copied;
+            do {
+                copied = state.copies.size();
+                std::map<CommandNode<S>*, std::shared_ptr<CommandNode<S>>> visited;
+                RelinkRedirects(root, state, visited);
+            } while (state.copies.size() != copied);
+        }
+
+        // Moves redirects below `node` to copies of their targets, copying shared nodes on the way. Returns the node to use in place of `node`.
+        // Subtrees without redirects are skipped.
+        static std::shared_ptr<CommandNode<S>> RelinkRedirects(std::shared_ptr<CommandNode<S>> const& node, ReloadState& state,
+            std::map<CommandNode<S>*, std::shared_ptr<CommandNode<S>>>& visited)
+        {
+            auto found = visited.find(node.get());
+            if (found != visited.end())
+                return found->second;
+
+            std::shared_ptr<CommandNode<S>> result = node;
+            auto own = [&] {
+                if (state.owned.count(result.get()) == 0)
+                    result = CopyNode(node, state);
+            };
+            if (node->redirect != nullptr) {
+                auto target = state.copies.find(node->redirect.get());
+                if (target != state.copies.end()) {
+                    own();
+                    result->RelinkRedirect(target->second);
+                }
+            }
+            for (auto& [name, child] : node->children) {
+                if (!child->subtree.redirect)
+                    continue;
+                auto relinked = RelinkRedirects(child, state, visited);
+                if (relinked != child) {
+                    own();
+                    result->ReplaceChild(std::move(relinked));
+                }
+            }
+            visited.emplace(node.get(), result);
+            return result;
+        }
+
+    private:
+        struct DeduplicationState
+        {
+            ReloadState reload;
+            std::unordered_map<std::string, std::shared_ptr<CommandNode<S>>> nodes; // structure -> first node with it
+            std::map<CommandNode<S>*, std::shared_ptr<CommandNode<S>>> visited; // node -> node to use in its place
+            std::set<CommandNode<S>*> shared;
+            std::set<CommandNode<S>*> targets; // redirect targets, which are never merged
+            size_t saved = 0;
+        };
+
+        // Returns the node identical to `node` that is used in its place
+        std::shared_ptr<CommandNode<S>> DeduplicateNode(std::shared_ptr<CommandNode<S>> const& node, DeduplicationState& state)
+        {
+            auto found = state.visited.find(node.get());
+            if (found != state.visited.end())
+                return found->second;
+
+            std::shared_ptr<CommandNode<S>> result = node;
+            for (auto& [name, child] : node->children) {
+                auto identical = DeduplicateNode(child, state);
+                if (identical != child) {
+                    if (result->owner != state.reload.owner)
+                        result = CopyNode(node, state.reload);
+                    result->ReplaceChild(std::move(identical));
+                }
+            }
+
+            std::string key;
+            if (node != root && WriteNodeKey(result.get(), key)) {
+                bool target = state.targets.count(node.get()) != 0;
+                auto [first, added] = state.nodes.emplace(std::move(key), result);
+                if (!added && !target) {
+                    CommandTreeMemoryStats stats;
+                    CountNodeMemory(result.get(), stats);
+                    state.saved += stats.GetTotalBytes();
+                    MarkShared(first->second.get(), state.shared);
+                    result = first->second;
+                }
+            }
+            state.visited.emplace(node.get(), result);
+            return result;
+        }
+
+        static bool WriteNodeKey(CommandNode<S>* node, std::string& key)
+        {
+            auto append = [&key](auto const& value) { key.append(reinterpret_cast<const char*>(&value), sizeof(value)); };
+            append(node->GetNodeType());
+            append(node->command);
+            append(node->requirement);
+            append(node->redirect.get());
+            append(node->modifier);
+            append(node->forks);
+            append(node->permissions);
+            append(node->GetName().size());
+            key += node->GetName();
+            if (node->GetNodeType() == CommandNodeType::ArgumentCommandNode) {
+                if (!static_cast<IArgumentCommandNode<S>*>(node)->WriteArgumentKey(key))
+                    return false;
+            }
+            // literals are looked up by name, but arguments are tried in order
+            for (auto& [name, child] : node->children) {
+                if (child->GetNodeType() == CommandNodeType::LiteralCommandNode)
+                    append(child.get());
+            }
+            for (auto& argument : node->arguments) {
+                append(static_cast<CommandNode<S>*>(argument.get()));
+            }
+            return true;
+        }
+
+        // Nodes with several parents cannot be modified in place by any of them, and neither can nodes below them.
+        // Nodes that are not writable already are left as they are, they may be read by other dispatchers.
+        static void MarkShared(CommandNode<S>* node, std::set<CommandNode<S>*>& shared)
+        {
+            if (!node->IsWritable() || !shared.insert(node).second)
+                return;
+            node->owner = CommandTreeOwner::Shared();
+            for (auto& [name, child] : node->children) {
+                MarkShared(child.get(), shared);
+            }
+        }
+
+    private:
+        static std::shared_ptr<RootCommandNode<S>> FilterTree(std::shared_ptr<RootCommandNode<S>> const& root, PermissionMask permissions)
+        {
+            std::map<CommandNode<S>*, std::shared_ptr<CommandNode<S>>> copies;
+            std::vector<CommandNode<S>*> shared;
+            auto filtered = std::static_pointer_cast<RootCommandNode<S>>(FilterNode(root, permissions, copies, shared));
+
+            // redirects into shared subtrees are kept, the others are resolved once all shared subtrees are known
+            std::set<CommandNode<S>*> targets;
+            for (auto& [original, copy] : copies) {
+                if (copy->redirect == nullptr)
+                    continue;
+                auto target = copies.find(copy->redirect.get());
+                if (target != copies.end())
+                    copy->RelinkRedirect(target->second);
+                else
+                    targets.insert(copy->redirect.get());
+            }
+            if (!targets.empty()) {
+                std::set<CommandNode<S>*> visited;
+                for (auto node : shared)
+                    FindTargets(node, targets, visited);
+                for (auto& [original, copy] : copies) {
+                    if (copy->redirect != nullptr && targets.count(copy->redirect.get()) != 0)
+                        copy->SetRedirect(nullptr);
+                }
+            }
+
+            // shared subtrees must not change in place under the view, and the copies are read-only
+            std::set<CommandNode<S>*> marked;
+            for (auto node : shared)
+                MarkShared(node, marked);
+            for (auto& [original, copy] : copies)
+                copy->owner = CommandTreeOwner::Shared();
+            return filtered;
+        }
+
+        static std::shared_ptr<CommandNode<S>> FilterNode(std::shared_ptr<CommandNode<S>> const& node, PermissionMask permissions,
+            std::map<CommandNode<S>*, std::shared_ptr<CommandNode<S>>>& copies, std::vector<CommandNode<S>*>& shared)
+        {
+            // nodes added by MultiArgumentBuilder may have several parents
+            auto found = copies.find(node.get());
+            if (found != copies.end())
+                return found->second;
+
+            if (node->GetNodeType() != CommandNodeType::RootCommandNode && !node->subtree.redirect && (node->subtree.permissions & ~permissions) == 0) {
+                shared.push_back(node.get());
+                return node;
+            }
+
+            auto copy = node->Clone();
+            copy->children.clear();
+            copy->literals.clear();
+            copy->arguments.clear();
+            copy->removedChildren.clear(); // deltas are computed for the dispatcher's tree only
+            copies.emplace(node.get(), copy);
+
+            for (auto& literal : node->literals) {
+                if (literal->HasPermissions(permissions)) {
+                    auto child = FilterNode(literal, permissions, copies, shared);
+                    copy->children.emplace(child->GetName(), child);
+                    copy->literals.emplace_back(std::static_pointer_cast<LiteralCommandNode<S>>(std::move(child)));
+                }
+            }
+            for (auto& argument : node->arguments) {
+                if (argument->HasPermissions(permissions)) {
+                    auto child = FilterNode(argument, permissions, copies, shared);
+                    copy->children.emplace(child->GetName(), child);
+                    copy->arguments.emplace_back(std::static_pointer_cast<IArgumentCommandNode<S>>(std::move(child)));
+                }
+            }
+            copy->UpdateSubtree();
+            return copy;
+        }
+
+        // Removes nodes found in the subtree from `targets`
+        static void FindTargets(CommandNode<S>* node, std::set<CommandNode<S>*>& targets, std::set<CommandNode<S>*>& visited)
+        {
+            if (targets.empty() || !visited.insert(node).second)
+                return;
+            targets.erase(node);
+            for (auto& [name, child] : node->children) {
+                FindTargets(child.get(), targets, visited);
+            }
+        }
+
     private:
         void AddPaths(CommandNode<S>* node, std::vector<std::vector<CommandNode<S>*>>& result, std::vector<CommandNode<S>*> parents) {
             parents.push_back(node);
@@ -3000,6 +7302,17 @@ namespace brigadier
 
     private:
         std::shared_ptr<RootCommandNode<S>> root;
+        std::shared_ptr<CommandTreeOwner> owner; // allowed to modify the nodes of root in place, unless sealed
         ResultConsumer<S> consumer = [](CommandContext<S>& context, bool success, int result) {};
+        PermissionProvider<S> permissionProvider = nullptr;
+
+        struct PermissionClass
+        {
+            PermissionMask permissions = 0;
+            size_t revision = 0;
+            std::shared_ptr<RootCommandNode<S>> root;
+        };
+        std::map<size_t, PermissionClass> permissionClasses;
+        ParseOptions parseOptions;
     };
 }